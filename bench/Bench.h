@@ -0,0 +1,164 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#ifndef _INC_ASTRA_BENCH
+#define _INC_ASTRA_BENCH
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <ostream>
+
+namespace astra_bench {
+
+/**
+ * A single benchmark case. run() is called repeatedly and timed.
+ */
+class CBenchCase {
+public:
+	virtual ~CBenchCase() { }
+
+	/** Prepare for a timed run. Not included in the measured time.
+	 */
+	virtual void prepare() { }
+
+	/** The timed operation.
+	 */
+	virtual void run() = 0;
+};
+
+/**
+ * Parameters describing a benchmark case, written as a JSON object.
+ */
+class CBenchParams {
+public:
+	CBenchParams& add(const std::string& _sKey, const std::string& _sValue);
+	CBenchParams& add(const std::string& _sKey, const char* _sValue);
+	CBenchParams& add(const std::string& _sKey, int _iValue);
+	CBenchParams& add(const std::string& _sKey, double _fValue);
+
+	void writeJSON(std::ostream& _out) const;
+
+private:
+	// key, JSON-encoded value
+	std::vector<std::pair<std::string, std::string> > m_entries;
+};
+
+/**
+ * Options controlling the benchmark runner.
+ */
+struct SBenchOptions {
+	//< Only run cases whose "suite/name" contains this string
+	std::string sFilter;
+	//< Use small problem sizes
+	bool bQuick;
+	//< Minimum total measured time per case, in seconds
+	double fMinTime;
+	//< Minimum and maximum number of timed repetitions per case
+	int iMinRepetitions;
+	int iMaxRepetitions;
+	//< Number of worker pool threads, 0 for the default
+	int iThreads;
+
+	SBenchOptions() : bQuick(false), fMinTime(0.2), iMinRepetitions(3), iMaxRepetitions(100), iThreads(0) { }
+};
+
+/**
+ * Result of a single benchmark case.
+ */
+struct SBenchResult {
+	std::string sSuite;
+	std::string sName;
+	CBenchParams params;
+	int iRepetitions;
+	int iIterations;
+	double fMin;
+	double fMedian;
+	double fMean;
+};
+
+/**
+ * Times benchmark cases and collects the results.
+ */
+class CBenchRunner {
+public:
+	explicit CBenchRunner(const SBenchOptions& _options) : m_options(_options) { }
+
+	const SBenchOptions& getOptions() const { return m_options; }
+
+	/** Set the suite name used for subsequent measurements.
+	 */
+	void setSuite(const std::string& _sSuite) { m_sSuite = _sSuite; }
+
+	/** Does the filter select the case _sName of the current suite?
+	 */
+	bool wants(const std::string& _sName) const;
+
+	/** Time _case: one untimed warm-up run, then repeat until both the
+	 *  minimum repetition count and the minimum total time are reached.
+	 *  If a run performs _iIterations iterations of an algorithm, the
+	 *  reported times are per iteration.
+	 */
+	void measure(const std::string& _sName, const CBenchParams& _params, CBenchCase& _case, int _iIterations = 1);
+
+	/** Write all results as a JSON document.
+	 */
+	void writeJSON(std::ostream& _out) const;
+
+private:
+	SBenchOptions m_options;
+	std::string m_sSuite;
+	std::vector<SBenchResult> m_results;
+};
+
+/** Monotonic wall clock time in seconds.
+ */
+double getTime();
+
+typedef void (*BenchSuiteFunction)(CBenchRunner&);
+
+/**
+ * Registers a benchmark suite at static initialization time.
+ */
+struct SBenchRegistrar {
+	SBenchRegistrar(const char* _sName, BenchSuiteFunction _f);
+};
+
+/** Registered suites, in registration order.
+ */
+std::vector<std::pair<std::string, BenchSuiteFunction> >& getSuites();
+
+} // end namespace
+
+/** Define a benchmark suite. The body receives a CBenchRunner& named runner.
+ */
+#define ASTRA_BENCH_SUITE(name) \
+	static void bench_suite_##name(astra_bench::CBenchRunner& runner); \
+	static astra_bench::SBenchRegistrar bench_registrar_##name(#name, bench_suite_##name); \
+	static void bench_suite_##name(astra_bench::CBenchRunner& runner)
+
+#endif
@@ -0,0 +1,145 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#include "BenchProblems.h"
+
+#include "astra/ParallelProjectionGeometry2D.h"
+#include "astra/FanFlatProjectionGeometry2D.h"
+#include "astra/SparseMatrixProjectionGeometry2D.h"
+#include "astra/VolumeGeometry2D.h"
+#include "astra/SparseMatrix.h"
+#include "astra/Float32Data2D.h"
+
+#include "astra/ParallelBeamLineKernelProjector2D.h"
+#include "astra/ParallelBeamLinearKernelProjector2D.h"
+#include "astra/ParallelBeamStripKernelProjector2D.h"
+#include "astra/ParallelBeamBlobKernelProjector2D.h"
+#include "astra/SparseMatrixProjector2D.h"
+#include "astra/FanFlatBeamLineKernelProjector2D.h"
+#include "astra/FanFlatBeamStripKernelProjector2D.h"
+
+#include <cmath>
+
+using namespace astra;
+
+namespace astra_bench {
+
+//----------------------------------------------------------------------------------------
+CBenchProjector::CBenchProjector(const std::string& _sType, int _iSize, int _iAngles, int _iDetectors)
+{
+	m_pProjector = 0;
+	m_pMatrix = 0;
+
+	std::vector<float32> angles(_iAngles);
+	for (int i = 0; i < _iAngles; ++i)
+		angles[i] = i * PI32 / _iAngles;
+
+	CVolumeGeometry2D volGeom(_iSize, _iSize);
+	CParallelProjectionGeometry2D parGeom(_iAngles, _iDetectors, 1.0f, &angles[0]);
+
+	// fan beam with the source at twice the volume size, and a detector
+	// pixel width giving unit width at the origin
+	float32 fOriginSource = 2.0f * _iSize;
+	float32 fOriginDetector = 1.0f * _iSize;
+	float32 fMagnification = (fOriginSource + fOriginDetector) / fOriginSource;
+	CFanFlatProjectionGeometry2D fanGeom(_iAngles, _iDetectors, fMagnification, &angles[0], fOriginSource, fOriginDetector);
+
+	if (_sType == "line") {
+		m_pProjector = new CParallelBeamLineKernelProjector2D(&parGeom, &volGeom);
+	} else if (_sType == "linear") {
+		m_pProjector = new CParallelBeamLinearKernelProjector2D(&parGeom, &volGeom);
+	} else if (_sType == "strip") {
+		m_pProjector = new CParallelBeamStripKernelProjector2D(&parGeom, &volGeom);
+	} else if (_sType == "blob") {
+		// smooth bump of radius 2 pixels
+		const int iSamples = 64;
+		const float32 fBlobSize = 2.0f;
+		float32 values[iSamples];
+		for (int i = 0; i < iSamples; ++i) {
+			float32 r = i * fBlobSize / iSamples;
+			float32 x = 1.0f - (r * r) / (fBlobSize * fBlobSize);
+			values[i] = x * x;
+		}
+		m_pProjector = new CParallelBeamBlobKernelProjector2D(&parGeom, &volGeom, fBlobSize, fBlobSize / iSamples, iSamples, values);
+	} else if (_sType == "sparse_matrix") {
+		CParallelBeamLineKernelProjector2D line(&parGeom, &volGeom);
+		m_pMatrix = line.getMatrix();
+		CSparseMatrixProjectionGeometry2D matGeom(_iAngles, _iDetectors, m_pMatrix);
+		m_pProjector = new CSparseMatrixProjector2D(&matGeom, &volGeom);
+	} else if (_sType == "line_fanflat") {
+		m_pProjector = new CFanFlatBeamLineKernelProjector2D(&fanGeom, &volGeom);
+	} else if (_sType == "strip_fanflat") {
+		m_pProjector = new CFanFlatBeamStripKernelProjector2D(&fanGeom, &volGeom);
+	}
+}
+
+CBenchProjector::~CBenchProjector()
+{
+	delete m_pProjector;
+	delete m_pMatrix;
+}
+
+//----------------------------------------------------------------------------------------
+std::vector<std::string> getProjectorTypes()
+{
+	std::vector<std::string> types;
+	types.push_back("line");
+	types.push_back("linear");
+	types.push_back("strip");
+	types.push_back("blob");
+	types.push_back("sparse_matrix");
+	types.push_back("line_fanflat");
+	types.push_back("strip_fanflat");
+	return types;
+}
+
+std::vector<int> getProblemSizes(bool _bQuick)
+{
+	std::vector<int> sizes;
+	if (_bQuick) {
+		sizes.push_back(64);
+	} else {
+		sizes.push_back(128);
+		sizes.push_back(256);
+		sizes.push_back(512);
+	}
+	return sizes;
+}
+
+//----------------------------------------------------------------------------------------
+void fillData(CFloat32Data2D* _pData, unsigned int _iSeed)
+{
+	// simple LCG, so results do not depend on the C library
+	unsigned int x = 2463534242u ^ _iSeed;
+	float32* pfData = _pData->getData();
+	for (int i = 0; i < _pData->getSize(); ++i) {
+		x = 1664525u * x + 1013904223u;
+		pfData[i] = (x >> 8) * (1.0f / 16777216.0f);
+	}
+}
+
+} // end namespace
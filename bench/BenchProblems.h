@@ -0,0 +1,80 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#ifndef _INC_ASTRA_BENCHPROBLEMS
+#define _INC_ASTRA_BENCHPROBLEMS
+
+#include <string>
+#include <vector>
+
+#include "astra/Globals.h"
+
+namespace astra {
+class CProjector2D;
+class CSparseMatrix;
+class CFloat32Data2D;
+}
+
+namespace astra_bench {
+
+/**
+ * A 2D projector for an N x N volume, A angles over 180 degrees and D
+ * detectors, together with the objects it depends on.
+ */
+class CBenchProjector {
+public:
+	/** Create a projector of the given type ("line", "linear", "strip",
+	 *  "blob", "sparse_matrix", "line_fanflat", "strip_fanflat").
+	 */
+	CBenchProjector(const std::string& _sType, int _iSize, int _iAngles, int _iDetectors);
+	~CBenchProjector();
+
+	astra::CProjector2D* get() const { return m_pProjector; }
+
+private:
+	astra::CProjector2D* m_pProjector;
+	astra::CSparseMatrix* m_pMatrix;
+
+	CBenchProjector(const CBenchProjector&);
+	CBenchProjector& operator=(const CBenchProjector&);
+};
+
+/** The CPU projector types benchmarked by default.
+ */
+std::vector<std::string> getProjectorTypes();
+
+/** Problem sizes (volume width) to benchmark, depending on --quick.
+ */
+std::vector<int> getProblemSizes(bool _bQuick);
+
+/** Fill data with a fixed, reproducible pseudo-random pattern in [0,1).
+ */
+void fillData(astra::CFloat32Data2D* _pData, unsigned int _iSeed);
+
+} // end namespace
+
+#endif
@@ -0,0 +1,109 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#include "Bench.h"
+#include "BenchProblems.h"
+
+#include "astra/SirtAlgorithm.h"
+#include "astra/CglsAlgorithm.h"
+#include "astra/FilteredBackProjectionAlgorithm.h"
+#include "astra/Projector2D.h"
+#include "astra/Float32ProjectionData2D.h"
+#include "astra/Float32VolumeData2D.h"
+
+#include <vector>
+
+using namespace std;
+using namespace astra;
+using namespace astra_bench;
+
+namespace {
+
+class CAlgorithmCase : public CBenchCase {
+public:
+	CAlgorithmCase(CAlgorithm* _pAlg, int _iIterations) : m_pAlg(_pAlg), m_iIterations(_iIterations) { }
+	virtual void run() { m_pAlg->run(m_iIterations); }
+private:
+	CAlgorithm* m_pAlg;
+	int m_iIterations;
+};
+
+}
+
+ASTRA_BENCH_SUITE(algorithm2d)
+{
+	const int iIterations = 10;
+
+	vector<string> types;
+	types.push_back("line");
+	types.push_back("strip");
+
+	vector<int> sizes = getProblemSizes(runner.getOptions().bQuick);
+	for (size_t s = 0; s < sizes.size(); ++s) {
+		int N = sizes[s];
+		int D = N + N / 2;
+
+		for (size_t t = 0; t < types.size(); ++t) {
+			if (!runner.wants(types[t]))
+				continue;
+
+			CBenchProjector proj(types[t], N, N, D);
+
+			CFloat32VolumeData2D rec(proj.get()->getVolumeGeometry());
+			CFloat32ProjectionData2D sino(proj.get()->getProjectionGeometry());
+			fillData(&sino, 3);
+			rec.setData(0.0f);
+
+			CBenchParams params;
+			params.add("kernel", types[t]).add("volume", N).add("angles", N).add("detectors", D);
+
+			if (runner.wants(types[t] + "/sirt")) {
+				CSirtAlgorithm sirt;
+				if (sirt.initialize(proj.get(), &sino, &rec)) {
+					CAlgorithmCase c(&sirt, iIterations);
+					runner.measure(types[t] + "/sirt", params, c, iIterations);
+				}
+			}
+
+			if (runner.wants(types[t] + "/cgls")) {
+				CCglsAlgorithm cgls;
+				if (cgls.initialize(proj.get(), &sino, &rec)) {
+					CAlgorithmCase c(&cgls, iIterations);
+					runner.measure(types[t] + "/cgls", params, c, iIterations);
+				}
+			}
+
+			if (runner.wants(types[t] + "/fbp")) {
+				CFilteredBackProjectionAlgorithm fbp;
+				if (fbp.initialize(proj.get(), &rec, &sino)) {
+					CAlgorithmCase c(&fbp, 1);
+					runner.measure(types[t] + "/fbp", params, c);
+				}
+			}
+		}
+	}
+}
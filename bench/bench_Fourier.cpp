@@ -0,0 +1,100 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#include "Bench.h"
+
+#include "astra/Fourier.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace std;
+using namespace astra;
+using namespace astra_bench;
+
+namespace {
+
+class CFourierCase : public CBenchCase {
+public:
+	CFourierCase(int _iSize, int _iRows, bool _bReal)
+		: m_iSize(_iSize), m_iRows(_iRows), m_bReal(_bReal)
+	{
+		int iLen = m_bReal ? m_iSize : 2 * m_iSize;
+		m_data.resize((size_t)iLen * m_iRows);
+		m_input.resize(m_data.size());
+		for (size_t i = 0; i < m_input.size(); ++i)
+			m_input[i] = (float32)((i * 7919) % 1013) / 1013.0f;
+		m_ip.resize(2 + (int)sqrt((double)m_iSize) + 1);
+		m_w.resize(m_iSize);
+		m_ip[0] = 0;
+	}
+	virtual void prepare() { m_data = m_input; }
+	virtual void run() {
+		for (int r = 0; r < m_iRows; ++r) {
+			if (m_bReal) {
+				float32* pfRow = &m_data[(size_t)r * m_iSize];
+				rdft(m_iSize, 1, pfRow, &m_ip[0], &m_w[0]);
+				rdft(m_iSize, -1, pfRow, &m_ip[0], &m_w[0]);
+			} else {
+				float32* pfRow = &m_data[(size_t)r * 2 * m_iSize];
+				cdft(2 * m_iSize, -1, pfRow, &m_ip[0], &m_w[0]);
+				cdft(2 * m_iSize, 1, pfRow, &m_ip[0], &m_w[0]);
+			}
+		}
+	}
+private:
+	int m_iSize;
+	int m_iRows;
+	bool m_bReal;
+	vector<float32> m_data;
+	vector<float32> m_input;
+	vector<int> m_ip;
+	vector<float32> m_w;
+};
+
+}
+
+ASTRA_BENCH_SUITE(fourier)
+{
+	// forward and inverse transform of a batch of rows, as used by FBP filtering
+	int iMaxLog = runner.getOptions().bQuick ? 10 : 14;
+	for (int l = 6; l <= iMaxLog; l += 2) {
+		int n = 1 << l;
+		int rows = (1 << 20) / n / 4;
+		if (rows < 1)
+			rows = 1;
+
+		CBenchParams params;
+		params.add("size", n).add("rows", rows);
+
+		CFourierCase c(n, rows, false);
+		runner.measure("cdft", params, c);
+
+		CFourierCase r(n, rows, true);
+		runner.measure("rdft", params, r);
+	}
+}
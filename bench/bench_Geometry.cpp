@@ -0,0 +1,137 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#include "Bench.h"
+
+#include "astra/Config.h"
+#include "astra/XMLDocument.h"
+#include "astra/VolumeGeometry2D.h"
+#include "astra/ParallelProjectionGeometry2D.h"
+#include "astra/FanFlatProjectionGeometry2D.h"
+#include "astra/ParallelProjectionGeometry3D.h"
+#include "astra/ConeProjectionGeometry3D.h"
+#include "astra/VolumeGeometry3D.h"
+
+#include <vector>
+
+using namespace std;
+using namespace astra;
+using namespace astra_bench;
+
+namespace {
+
+/**
+ * Initialize a geometry of type T from the configuration of an existing one.
+ */
+template <typename T>
+class CParseCase : public CBenchCase {
+public:
+	explicit CParseCase(const T& _geom) { m_pConfig = _geom.getConfiguration(); }
+	~CParseCase() { delete m_pConfig; }
+	virtual void run() {
+		for (int i = 0; i < 10; ++i) {
+			T geom;
+			geom.initialize(*m_pConfig);
+		}
+	}
+private:
+	Config* m_pConfig;
+};
+
+/**
+ * Serialize the configuration of a geometry to XML text.
+ */
+template <typename T>
+class CConfigCase : public CBenchCase {
+public:
+	explicit CConfigCase(const T& _geom) : m_geom(_geom) { }
+	virtual void run() {
+		for (int i = 0; i < 10; ++i) {
+			Config* pConfig = m_geom.getConfiguration();
+			m_sXML = pConfig->self.toString();
+			delete pConfig;
+		}
+	}
+private:
+	const T& m_geom;
+	std::string m_sXML;
+};
+
+}
+
+ASTRA_BENCH_SUITE(geometry)
+{
+	int iAngles = runner.getOptions().bQuick ? 180 : 1800;
+	int iDet = 512;
+
+	vector<float32> angles(iAngles);
+	for (int i = 0; i < iAngles; ++i)
+		angles[i] = i * PI32 / iAngles;
+
+	CBenchParams params;
+	params.add("angles", iAngles).add("detectors", iDet).add("repeat", 10);
+
+	CVolumeGeometry2D vol2d(iDet, iDet);
+	CParallelProjectionGeometry2D par2d(iAngles, iDet, 1.0f, &angles[0]);
+	CFanFlatProjectionGeometry2D fan2d(iAngles, iDet, 1.5f, &angles[0], 1000.0f, 500.0f);
+	CVolumeGeometry3D vol3d(iDet, iDet, iDet);
+	CParallelProjectionGeometry3D par3d(iAngles, iDet, iDet, 1.0f, 1.0f, &angles[0]);
+	CConeProjectionGeometry3D cone3d(iAngles, iDet, iDet, 1.5f, 1.5f, &angles[0], 1000.0f, 500.0f);
+
+	{
+		CParseCase<CVolumeGeometry2D> c(vol2d);
+		runner.measure("parse/volume2d", params, c);
+	}
+	{
+		CParseCase<CParallelProjectionGeometry2D> c(par2d);
+		runner.measure("parse/parallel", params, c);
+	}
+	{
+		CParseCase<CFanFlatProjectionGeometry2D> c(fan2d);
+		runner.measure("parse/fanflat", params, c);
+	}
+	{
+		CParseCase<CVolumeGeometry3D> c(vol3d);
+		runner.measure("parse/volume3d", params, c);
+	}
+	{
+		CParseCase<CParallelProjectionGeometry3D> c(par3d);
+		runner.measure("parse/parallel3d", params, c);
+	}
+	{
+		CParseCase<CConeProjectionGeometry3D> c(cone3d);
+		runner.measure("parse/cone", params, c);
+	}
+	{
+		CConfigCase<CParallelProjectionGeometry2D> c(par2d);
+		runner.measure("config/parallel", params, c);
+	}
+	{
+		CConfigCase<CConeProjectionGeometry3D> c(cone3d);
+		runner.measure("config/cone", params, c);
+	}
+}
@@ -0,0 +1,118 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#include "Bench.h"
+#include "BenchProblems.h"
+
+#include "astra/DataProjector.h"
+#include "astra/DataProjectorPolicies.h"
+#include "astra/Float32ProjectionData2D.h"
+#include "astra/Float32VolumeData2D.h"
+
+#include <utility>
+
+using namespace std;
+
+namespace astra {
+#include "astra/Projector2DImpl.inl"
+}
+
+using namespace astra;
+using namespace astra_bench;
+
+namespace {
+
+class CProjectCase : public CBenchCase {
+public:
+	CProjectCase(CDataProjectorInterface* _pProjector, CFloat32Data2D* _pOutput, bool _bParallel)
+		: m_pProjector(_pProjector), m_pOutput(_pOutput), m_bParallel(_bParallel) { }
+	virtual void prepare() { m_pOutput->setData(0.0f); }
+	virtual void run() {
+		if (m_bParallel)
+			m_pProjector->projectParallel();
+		else
+			m_pProjector->project();
+	}
+private:
+	CDataProjectorInterface* m_pProjector;
+	CFloat32Data2D* m_pOutput;
+	bool m_bParallel;
+};
+
+}
+
+ASTRA_BENCH_SUITE(projector2d)
+{
+	vector<string> types = getProjectorTypes();
+	vector<int> sizes = getProblemSizes(runner.getOptions().bQuick);
+
+	// (volume size, detector count) combinations
+	vector<pair<int, int> > shapes;
+	for (size_t i = 0; i < sizes.size(); ++i) {
+		shapes.push_back(make_pair(sizes[i], sizes[i] + sizes[i] / 2));
+		if (i == 0)
+			shapes.push_back(make_pair(sizes[i], 3 * sizes[i]));
+	}
+
+	for (size_t s = 0; s < shapes.size(); ++s) {
+		int N = shapes[s].first;
+		int D = shapes[s].second;
+		int A = N;
+
+		for (size_t t = 0; t < types.size(); ++t) {
+			if (!runner.wants(types[t]))
+				continue;
+
+			CBenchProjector proj(types[t], N, A, D);
+			if (!proj.get() || !proj.get()->isInitialized())
+				continue;
+
+			CFloat32VolumeData2D vol(proj.get()->getVolumeGeometry());
+			CFloat32ProjectionData2D sino(proj.get()->getProjectionGeometry());
+			fillData(&vol, 1);
+			fillData(&sino, 2);
+
+			CBenchParams params;
+			params.add("kernel", types[t]).add("volume", N).add("angles", A).add("detectors", D);
+
+			CDataProjectorInterface* pFP = dispatchDataProjector(proj.get(), DefaultFPPolicy(&vol, &sino));
+			CDataProjectorInterface* pBP = dispatchDataProjector(proj.get(), DefaultBPPolicy(&vol, &sino));
+
+			CProjectCase fp(pFP, &sino, false);
+			runner.measure(types[t] + "/fp", params, fp);
+
+			CProjectCase fpParallel(pFP, &sino, true);
+			runner.measure(types[t] + "/fp_parallel", params, fpParallel);
+
+			CProjectCase bp(pBP, &vol, false);
+			runner.measure(types[t] + "/bp", params, bp);
+
+			delete pFP;
+			delete pBP;
+		}
+	}
+}
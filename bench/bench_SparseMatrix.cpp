@@ -0,0 +1,123 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#include "Bench.h"
+#include "BenchProblems.h"
+
+#include "astra/SparseMatrix.h"
+#include "astra/Projector2D.h"
+
+#include <vector>
+
+using namespace std;
+using namespace astra;
+using namespace astra_bench;
+
+namespace {
+
+class CBuildCase : public CBenchCase {
+public:
+	explicit CBuildCase(CProjector2D* _pProjector) : m_pProjector(_pProjector) { }
+	virtual void run() {
+		CSparseMatrix* pMatrix = m_pProjector->getMatrix();
+		delete pMatrix;
+	}
+private:
+	CProjector2D* m_pProjector;
+};
+
+class CSpMVCase : public CBenchCase {
+public:
+	CSpMVCase(const CSparseMatrix* _pMatrix, bool _bTransposed)
+		: m_pMatrix(_pMatrix), m_bTransposed(_bTransposed)
+	{
+		m_x.resize(m_bTransposed ? m_pMatrix->m_iHeight : m_pMatrix->m_iWidth);
+		m_y.resize(m_bTransposed ? m_pMatrix->m_iWidth : m_pMatrix->m_iHeight);
+		for (size_t i = 0; i < m_x.size(); ++i)
+			m_x[i] = (float32)((i * 7919) % 1013) / 1013.0f;
+	}
+	virtual void prepare() {
+		for (size_t i = 0; i < m_y.size(); ++i)
+			m_y[i] = 0.0f;
+	}
+	virtual void run() {
+		for (unsigned int iRow = 0; iRow < m_pMatrix->m_iHeight; ++iRow) {
+			unsigned int iSize;
+			const float32* pfValues;
+			const unsigned int* piCols;
+			m_pMatrix->getRowData(iRow, iSize, pfValues, piCols);
+			if (m_bTransposed) {
+				float32 x = m_x[iRow];
+				for (unsigned int i = 0; i < iSize; ++i)
+					m_y[piCols[i]] += pfValues[i] * x;
+			} else {
+				float32 fSum = 0.0f;
+				for (unsigned int i = 0; i < iSize; ++i)
+					fSum += pfValues[i] * m_x[piCols[i]];
+				m_y[iRow] = fSum;
+			}
+		}
+	}
+private:
+	const CSparseMatrix* m_pMatrix;
+	bool m_bTransposed;
+	vector<float32> m_x;
+	vector<float32> m_y;
+};
+
+}
+
+ASTRA_BENCH_SUITE(sparse_matrix)
+{
+	vector<int> sizes = getProblemSizes(runner.getOptions().bQuick);
+	for (size_t s = 0; s < sizes.size(); ++s) {
+		int N = sizes[s];
+		int D = N + N / 2;
+		CBenchProjector proj("line", N, N, D);
+
+		CBenchParams params;
+		params.add("kernel", "line").add("volume", N).add("angles", N).add("detectors", D);
+
+		CBuildCase build(proj.get());
+		runner.measure("build", params, build);
+
+		if (!runner.wants("spmv"))
+			continue;
+
+		CSparseMatrix* pMatrix = proj.get()->getMatrix();
+		CBenchParams mparams = params;
+		mparams.add("nonzeros", (double)pMatrix->m_plRowStarts[pMatrix->m_iHeight]);
+
+		CSpMVCase spmv(pMatrix, false);
+		runner.measure("spmv", mparams, spmv);
+
+		CSpMVCase spmvT(pMatrix, true);
+		runner.measure("spmv_transposed", mparams, spmvT);
+
+		delete pMatrix;
+	}
+}
@@ -0,0 +1,295 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#include "Bench.h"
+
+#include "astra/Globals.h"
+#include "astra/WorkerPool.h"
+#include "astra/Logging.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#include <time.h>
+#endif
+
+namespace astra_bench {
+
+//----------------------------------------------------------------------------------------
+static std::string jsonString(const std::string& _s)
+{
+	std::string res = "\"";
+	for (size_t i = 0; i < _s.size(); ++i) {
+		char c = _s[i];
+		if (c == '"' || c == '\\') {
+			res += '\\';
+			res += c;
+		} else if ((unsigned char)c < 0x20) {
+			char buf[8];
+			sprintf(buf, "\\u%04x", (unsigned int)c);
+			res += buf;
+		} else {
+			res += c;
+		}
+	}
+	res += "\"";
+	return res;
+}
+
+static std::string jsonNumber(double _f)
+{
+	char buf[32];
+	sprintf(buf, "%.9g", _f);
+	return buf;
+}
+
+//----------------------------------------------------------------------------------------
+CBenchParams& CBenchParams::add(const std::string& _sKey, const std::string& _sValue)
+{
+	m_entries.push_back(std::make_pair(_sKey, jsonString(_sValue)));
+	return *this;
+}
+
+CBenchParams& CBenchParams::add(const std::string& _sKey, const char* _sValue)
+{
+	return add(_sKey, std::string(_sValue));
+}
+
+CBenchParams& CBenchParams::add(const std::string& _sKey, int _iValue)
+{
+	std::ostringstream s;
+	s << _iValue;
+	m_entries.push_back(std::make_pair(_sKey, s.str()));
+	return *this;
+}
+
+CBenchParams& CBenchParams::add(const std::string& _sKey, double _fValue)
+{
+	m_entries.push_back(std::make_pair(_sKey, jsonNumber(_fValue)));
+	return *this;
+}
+
+void CBenchParams::writeJSON(std::ostream& _out) const
+{
+	_out << "{";
+	for (size_t i = 0; i < m_entries.size(); ++i) {
+		if (i > 0)
+			_out << ", ";
+		_out << jsonString(m_entries[i].first) << ": " << m_entries[i].second;
+	}
+	_out << "}";
+}
+
+//----------------------------------------------------------------------------------------
+double getTime()
+{
+#ifdef _WIN32
+	LARGE_INTEGER freq, count;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&count);
+	return (double)count.QuadPart / (double)freq.QuadPart;
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + 1e-9 * ts.tv_nsec;
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+bool CBenchRunner::wants(const std::string& _sName) const
+{
+	if (m_options.sFilter.empty())
+		return true;
+	std::string sFull = m_sSuite + "/" + _sName;
+	return sFull.find(m_options.sFilter) != std::string::npos;
+}
+
+void CBenchRunner::measure(const std::string& _sName, const CBenchParams& _params, CBenchCase& _case, int _iIterations)
+{
+	if (!wants(_sName))
+		return;
+
+	// warm-up
+	_case.prepare();
+	_case.run();
+
+	std::vector<double> times;
+	double fTotal = 0.0;
+	while ((int)times.size() < m_options.iMaxRepetitions &&
+	       ((int)times.size() < m_options.iMinRepetitions || fTotal < m_options.fMinTime))
+	{
+		_case.prepare();
+		double t0 = getTime();
+		_case.run();
+		double t = getTime() - t0;
+		times.push_back(t);
+		fTotal += t;
+	}
+
+	std::sort(times.begin(), times.end());
+
+	SBenchResult res;
+	res.sSuite = m_sSuite;
+	res.sName = _sName;
+	res.params = _params;
+	res.iRepetitions = times.size();
+	res.iIterations = _iIterations;
+	res.fMin = times[0] / _iIterations;
+	res.fMedian = times[times.size() / 2];
+	if (times.size() % 2 == 0)
+		res.fMedian = 0.5 * (times[times.size() / 2 - 1] + times[times.size() / 2]);
+	res.fMedian /= _iIterations;
+	res.fMean = fTotal / times.size() / _iIterations;
+	m_results.push_back(res);
+
+	std::ostringstream s;
+	_params.writeJSON(s);
+	fprintf(stderr, "%-12s %-28s %12.6f s  %s\n", m_sSuite.c_str(), _sName.c_str(), res.fMedian, s.str().c_str());
+}
+
+void CBenchRunner::writeJSON(std::ostream& _out) const
+{
+	_out << "{\n";
+	_out << "  \"astra_version\": " << jsonString(astra::getVersionString()) << ",\n";
+	_out << "  \"timestamp\": " << (long)time(0) << ",\n";
+	_out << "  \"threads\": " << astra::CWorkerPool::getSingleton().getThreadCount() << ",\n";
+	_out << "  \"quick\": " << (m_options.bQuick ? "true" : "false") << ",\n";
+	_out << "  \"results\": [";
+	for (size_t i = 0; i < m_results.size(); ++i) {
+		const SBenchResult& r = m_results[i];
+		_out << (i > 0 ? ",\n" : "\n");
+		_out << "    {\"suite\": " << jsonString(r.sSuite)
+		     << ", \"name\": " << jsonString(r.sName)
+		     << ", \"params\": ";
+		r.params.writeJSON(_out);
+		_out << ", \"repetitions\": " << r.iRepetitions
+		     << ", \"iterations\": " << r.iIterations
+		     << ", \"min_s\": " << jsonNumber(r.fMin)
+		     << ", \"median_s\": " << jsonNumber(r.fMedian)
+		     << ", \"mean_s\": " << jsonNumber(r.fMean)
+		     << "}";
+	}
+	_out << "\n  ]\n}\n";
+}
+
+//----------------------------------------------------------------------------------------
+std::vector<std::pair<std::string, BenchSuiteFunction> >& getSuites()
+{
+	static std::vector<std::pair<std::string, BenchSuiteFunction> > suites;
+	return suites;
+}
+
+SBenchRegistrar::SBenchRegistrar(const char* _sName, BenchSuiteFunction _f)
+{
+	getSuites().push_back(std::make_pair(std::string(_sName), _f));
+}
+
+} // end namespace
+
+//----------------------------------------------------------------------------------------
+static void usage(const char* _sProg)
+{
+	fprintf(stderr,
+	        "Usage: %s [options]\n"
+	        "  --filter STR        only run cases whose suite/name contains STR\n"
+	        "  --quick             use small problem sizes\n"
+	        "  --threads N         number of worker threads (default: all cores)\n"
+	        "  --min-time S        minimum measured time per case in seconds (default 0.2)\n"
+	        "  --repetitions N     minimum number of repetitions per case (default 3)\n"
+	        "  --output FILE       write JSON results to FILE instead of stdout\n"
+	        "  --list              list the benchmark suites\n",
+	        _sProg);
+}
+
+int main(int argc, char** argv)
+{
+	astra_bench::SBenchOptions options;
+	std::string sOutput;
+
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		bool bHasValue = (i + 1 < argc);
+		if (arg == "--filter" && bHasValue) {
+			options.sFilter = argv[++i];
+		} else if (arg == "--quick") {
+			options.bQuick = true;
+		} else if (arg == "--threads" && bHasValue) {
+			options.iThreads = atoi(argv[++i]);
+		} else if (arg == "--min-time" && bHasValue) {
+			options.fMinTime = atof(argv[++i]);
+		} else if (arg == "--repetitions" && bHasValue) {
+			options.iMinRepetitions = std::max(1, atoi(argv[++i]));
+			options.iMaxRepetitions = std::max(options.iMaxRepetitions, options.iMinRepetitions);
+		} else if (arg == "--output" && bHasValue) {
+			sOutput = argv[++i];
+		} else if (arg == "--list") {
+			for (size_t j = 0; j < astra_bench::getSuites().size(); ++j)
+				printf("%s\n", astra_bench::getSuites()[j].first.c_str());
+			return 0;
+		} else {
+			usage(argv[0]);
+			return (arg == "--help" || arg == "-h") ? 0 : 1;
+		}
+	}
+
+	astra::CLogger::setOutputScreen(2, astra::LOG_WARN);
+
+	if (options.iThreads > 0) {
+		astra::SWorkerPoolParams params = astra::CWorkerPool::getGlobalParams();
+		params.iThreadCount = options.iThreads;
+		astra::CWorkerPool::setGlobalParams(params);
+	}
+
+	astra_bench::CBenchRunner runner(options);
+	for (size_t i = 0; i < astra_bench::getSuites().size(); ++i) {
+		runner.setSuite(astra_bench::getSuites()[i].first);
+		astra_bench::getSuites()[i].second(runner);
+	}
+
+	if (sOutput.empty()) {
+		runner.writeJSON(std::cout);
+	} else {
+		std::ofstream f(sOutput.c_str());
+		if (!f) {
+			fprintf(stderr, "Unable to open %s\n", sOutput.c_str());
+			return 1;
+		}
+		runner.writeJSON(f);
+	}
+
+	return 0;
+}
@@ -182,17 +182,25 @@ P_astra["filters"]["CUDA\\cuda source"] = [
 P_astra["filters"]["Algorithms\\source"] = [
 "9df653ab-26c3-4bec-92a2-3dda22fda761",
 "src\\Algorithm.cpp",
+"src\\AlgorithmScheduler.cpp",
+"src\\AlgorithmTimings.cpp",
 "src\\ArtAlgorithm.cpp",
 "src\\AsyncAlgorithm.cpp",
 "src\\BackProjectionAlgorithm.cpp",
+"src\\BackProjectionAlgorithm3D.cpp",
+"src\\CenterOfRotationAlgorithm.cpp",
 "src\\CglsAlgorithm.cpp",
+"src\\CglsAlgorithm3D.cpp",
+"src\\FanParallelRebinAlgorithm.cpp",
 "src\\FilteredBackProjectionAlgorithm.cpp",
 "src\\ForwardProjectionAlgorithm.cpp",
+"src\\ForwardProjectionAlgorithm3D.cpp",
 "src\\PluginAlgorithm.cpp",
 "src\\ReconstructionAlgorithm2D.cpp",
 "src\\ReconstructionAlgorithm3D.cpp",
 "src\\SartAlgorithm.cpp",
 "src\\SirtAlgorithm.cpp",
+"src\\SirtAlgorithm3D.cpp",
 ]
 P_astra["filters"]["Data Structures\\source"] = [
 "95346487-8185-487b-a794-3e7fb5fcbd4c",
@@ -210,15 +218,27 @@ P_astra["filters"]["Data Structures\\source"] = [
 ]
 P_astra["filters"]["Global &amp; Other\\source"] = [
 "1546cb47-7e5b-42c2-b695-ef172024c14b",
+"src\\AnalyticPhantom.cpp",
 "src\\AstraObjectFactory.cpp",
 "src\\AstraObjectManager.cpp",
+"src\\BrickedVolume3D.cpp",
 "src\\CompositeGeometryManager.cpp",
 "src\\Config.cpp",
+"src\\DataBinning.cpp",
 "src\\Fourier.cpp",
 "src\\Globals.cpp",
+"src\\HostMemory.cpp",
+"src\\LinearKernel3D.cpp",
 "src\\Logging.cpp",
+"src\\MemoryBudget.cpp",
+"src\\NoiseSimulation.cpp",
+"src\\NumaPlacement.cpp",
 "src\\PlatformDepSystemCode.cpp",
+"src\\Reduction.cpp",
+"src\\ScratchArena.cpp",
+"src\\Tracing.cpp",
 "src\\Utilities.cpp",
+"src\\WorkerPool.cpp",
 "src\\XMLDocument.cpp",
 "src\\XMLNode.cpp",
 ]
@@ -242,16 +262,20 @@ P_astra["filters"]["Geometries\\source"] = [
 ]
 P_astra["filters"]["Projectors\\source"] = [
 "2d60e3c8-7874-4cee-b139-991ac15e811d",
+"src\\CpuProjection3D.cpp",
 "src\\DataProjector.cpp",
 "src\\DataProjectorPolicies.cpp",
 "src\\FanFlatBeamLineKernelProjector2D.cpp",
 "src\\FanFlatBeamStripKernelProjector2D.cpp",
+"src\\LinearKernelProjector3D.cpp",
 "src\\ParallelBeamBlobKernelProjector2D.cpp",
 "src\\ParallelBeamLinearKernelProjector2D.cpp",
 "src\\ParallelBeamLineKernelProjector2D.cpp",
 "src\\ParallelBeamStripKernelProjector2D.cpp",
+"src\\PixelDrivenBackProjector2D.cpp",
 "src\\Projector2D.cpp",
 "src\\Projector3D.cpp",
+"src\\SeparableFootprintProjector3D.cpp",
 "src\\SparseMatrixProjector2D.cpp",
 ]
 P_astra["filters"]["CUDA\\astra source"] = [
@@ -318,20 +342,28 @@ P_astra["filters"]["CUDA\\cuda headers"] = [
 P_astra["filters"]["Algorithms\\headers"] = [
 "a76ffd6d-3895-4365-b27e-fc9a72f2ed75",
 "include\\astra\\Algorithm.h",
+"include\\astra\\AlgorithmScheduler.h",
+"include\\astra\\AlgorithmTimings.h",
 "include\\astra\\AlgorithmTypelist.h",
 "include\\astra\\ArtAlgorithm.h",
 "include\\astra\\AsyncAlgorithm.h",
 "include\\astra\\BackProjectionAlgorithm.h",
+"include\\astra\\BackProjectionAlgorithm3D.h",
+"include\\astra\\CenterOfRotationAlgorithm.h",
 "include\\astra\\CglsAlgorithm.h",
+"include\\astra\\CglsAlgorithm3D.h",
 "include\\astra\\CudaBackProjectionAlgorithm.h",
 "include\\astra\\CudaBackProjectionAlgorithm3D.h",
+"include\\astra\\FanParallelRebinAlgorithm.h",
 "include\\astra\\FilteredBackProjectionAlgorithm.h",
 "include\\astra\\ForwardProjectionAlgorithm.h",
+"include\\astra\\ForwardProjectionAlgorithm3D.h",
 "include\\astra\\PluginAlgorithm.h",
 "include\\astra\\ReconstructionAlgorithm2D.h",
 "include\\astra\\ReconstructionAlgorithm3D.h",
 "include\\astra\\SartAlgorithm.h",
 "include\\astra\\SirtAlgorithm.h",
+"include\\astra\\SirtAlgorithm3D.h",
 ]
 P_astra["filters"]["Data Structures\\headers"] = [
 "444c44b0-6454-483a-be26-7cb9c8ab0b98",
@@ -349,19 +381,32 @@ P_astra["filters"]["Data Structures\\headers"] = [
 ]
 P_astra["filters"]["Global &amp; Other\\headers"] = [
 "1c52efc8-a77e-4c72-b9be-f6429a87e6d7",
+"include\\astra\\AnalyticPhantom.h",
 "include\\astra\\AstraObjectFactory.h",
 "include\\astra\\AstraObjectManager.h",
+"include\\astra\\BrickedVolume3D.h",
 "include\\astra\\clog.h",
 "include\\astra\\CompositeGeometryManager.h",
 "include\\astra\\Config.h",
+"include\\astra\\DataBinning.h",
 "include\\astra\\Fourier.h",
 "include\\astra\\Globals.h",
+"include\\astra\\HostMemory.h",
+"include\\astra\\LinearKernel3D.h",
 "include\\astra\\Logging.h",
+"include\\astra\\MemoryBudget.h",
+"include\\astra\\Mutex.h",
+"include\\astra\\NoiseSimulation.h",
+"include\\astra\\NumaPlacement.h",
 "include\\astra\\PlatformDepSystemCode.h",
+"include\\astra\\Reduction.h",
+"include\\astra\\ScratchArena.h",
 "include\\astra\\Singleton.h",
+"include\\astra\\Tracing.h",
 "include\\astra\\TypeList.h",
 "include\\astra\\Utilities.h",
 "include\\astra\\Vector3D.h",
+"include\\astra\\WorkerPool.h",
 "include\\astra\\XMLDocument.h",
 "include\\astra\\XMLNode.h",
 ]
@@ -385,17 +430,21 @@ P_astra["filters"]["Geometries\\headers"] = [
 ]
 P_astra["filters"]["Projectors\\headers"] = [
 "91ae2cfd-6b45-46eb-ad99-2f16e5ce4b1e",
+"include\\astra\\CpuProjection3D.h",
 "include\\astra\\DataProjector.h",
 "include\\astra\\DataProjectorPolicies.h",
 "include\\astra\\FanFlatBeamLineKernelProjector2D.h",
 "include\\astra\\FanFlatBeamStripKernelProjector2D.h",
+"include\\astra\\LinearKernelProjector3D.h",
 "include\\astra\\ParallelBeamBlobKernelProjector2D.h",
 "include\\astra\\ParallelBeamLinearKernelProjector2D.h",
 "include\\astra\\ParallelBeamLineKernelProjector2D.h",
 "include\\astra\\ParallelBeamStripKernelProjector2D.h",
+"include\\astra\\PixelDrivenBackProjector2D.h",
 "include\\astra\\Projector2D.h",
 "include\\astra\\Projector3D.h",
 "include\\astra\\ProjectorTypelist.h",
+"include\\astra\\SeparableFootprintProjector3D.h",
 "include\\astra\\SparseMatrixProjector2D.h",
 ]
 P_astra["filters"]["CUDA\\astra headers"] = [
@@ -32,9 +32,27 @@ along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
 
 #include "Globals.h"
 #include "Config.h"
+#include "AlgorithmTimings.h"
 
 namespace astra {
 
+class CAlgorithmCheckpoint;
+
+/**
+ * Receives progress reports from a running algorithm.
+ */
+class _AstraExport CAlgorithmProgress {
+public:
+	virtual ~CAlgorithmProgress() { }
+
+	/** Called from the thread running the algorithm.
+	 *
+	 * @param _fProgress fraction of the run that is done, in [0,1]
+	 * @param _ePhase phase the algorithm is in
+	 */
+	virtual void progress(float32 _fProgress, EAlgorithmPhase _ePhase) = 0;
+};
+
 /**
  * This class contains the interface for an algorithm implementation.
  */
@@ -105,6 +123,46 @@ public:
 	 */
 	virtual void signalAbort() { m_bShouldAbort = true; }
 
+	/** Has an abort been signalled?
+	 */
+	bool shouldAbort() const { return m_bShouldAbort; }
+
+	/** Signal an abort that also holds for runs starting after this call,
+	 *  until clearAbortRequest(). A plain signalAbort() is lost if run()
+	 *  clears the abort flag after it.
+	 */
+	void requestAbort() { m_bAbortRequested = true; signalAbort(); }
+
+	/** Withdraw a requestAbort().
+	 */
+	void clearAbortRequest() { m_bAbortRequested = false; }
+
+	/** Set an object receiving progress reports while the algorithm runs.
+	 *  The algorithms report progress between blocks of projections in
+	 *  their projection loops, where they also check for an abort.
+	 *  NULL disables reporting. The caller keeps ownership.
+	 */
+	virtual void setProgressCallback(CAlgorithmProgress* _pProgress) { m_pProgress = _pProgress; }
+
+	/** Estimate the host memory, in bytes, of the temporaries this
+	 *  algorithm allocates in initialize() and run(). The input and
+	 *  output data objects passed to it are not included. Only valid
+	 *  after initialization; the default is 0.
+	 *  This is also returned by getInformation("MemoryEstimate").
+	 */
+	virtual size_t getMemoryEstimate() const { return 0; }
+
+	/** Enable or disable collection of per-phase timings and counters.
+	 *  They are reset at the start of every run, and are returned by
+	 *  getInformation("Timings"). This can also be enabled with the
+	 *  Timings option of algorithms that support it.
+	 */
+	void setTimingsEnabled(bool _bEnabled) { m_timings.setEnabled(_bEnabled); }
+
+	/** Get the timings and counters of the last run.
+	 */
+	const CAlgorithmTimings& getTimings() const { return m_timings; }
+
 protected:
 
 	//< Has this class been initialized?
@@ -113,6 +171,34 @@ protected:
 	//< If this is set, the algorithm should try to abort as soon as possible.
 	volatile bool m_bShouldAbort;
 
+	//< Set by requestAbort(), survives the start of a run.
+	volatile bool m_bAbortRequested;
+
+	//< Per-phase timings and counters of the last run.
+	CAlgorithmTimings m_timings;
+
+	//< Receives progress reports, may be NULL.
+	CAlgorithmProgress* m_pProgress;
+
+	/** Clear the abort flag at the start of run(), unless requestAbort()
+	 *  is pending. The flag is cleared before the request is read, so a
+	 *  concurrent requestAbort() is never lost.
+	 */
+	void resetAbort() {
+		m_bShouldAbort = false;
+		if (m_bAbortRequested)
+			m_bShouldAbort = true;
+	}
+
+	/** Report progress to the progress callback, if any.
+	 */
+	void reportProgress(float32 _fProgress, EAlgorithmPhase _ePhase) {
+		if (m_pProgress)
+			m_pProgress->progress(_fProgress, _ePhase);
+	}
+
+	friend class CAlgorithmCheckpoint;
+
 private:
 	/**
 	 * Private copy constructor to prevent CAlgorithms from being copied.
@@ -130,6 +216,35 @@ private:
 
 };
 
+/**
+ * Checkpoint for a projection loop inside an algorithm run. The loop calls
+ * shouldAbort() between blocks of projections and stops if it returns
+ * true, and report() to report its progress, which is mapped to the range
+ * [_fFrom, _fTo] of the progress of the whole run.
+ */
+class _AstraExport CAlgorithmCheckpoint {
+public:
+	CAlgorithmCheckpoint(CAlgorithm* _pAlg, EAlgorithmPhase _ePhase, float32 _fFrom, float32 _fTo)
+		: m_pAlg(_pAlg), m_ePhase(_ePhase), m_fFrom(_fFrom), m_fTo(_fTo) { }
+
+	/** Should the loop stop? This is cheap enough to call often.
+	 */
+	bool shouldAbort() const { return m_pAlg->m_bShouldAbort; }
+
+	/** Report that _iDone of the _iTotal steps of the loop are done.
+	 */
+	void report(int _iDone, int _iTotal) const {
+		if (m_pAlg->m_pProgress && _iTotal > 0)
+			m_pAlg->m_pProgress->progress(m_fFrom + (m_fTo - m_fFrom) * _iDone / _iTotal, m_ePhase);
+	}
+
+private:
+	CAlgorithm* m_pAlg;
+	EAlgorithmPhase m_ePhase;
+	float32 m_fFrom;
+	float32 m_fTo;
+};
+
 // inline functions
 inline std::string CAlgorithm::description() const { return "Algorithm"; };
 inline bool CAlgorithm::isInitialized() const { return m_bIsInitialized; }
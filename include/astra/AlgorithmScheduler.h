@@ -0,0 +1,203 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#ifndef _INC_ASTRA_ALGORITHMSCHEDULER
+#define _INC_ASTRA_ALGORITHMSCHEDULER
+
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include "Globals.h"
+#include "Singleton.h"
+#include "Algorithm.h"
+#include "Mutex.h"
+
+namespace astra {
+
+class CAlgorithmScheduler;
+class CAlgorithmJobTask;
+
+/**
+ * Completion handle for an algorithm run submitted to the
+ * CAlgorithmScheduler.
+ */
+class _AstraExport CAlgorithmJob {
+public:
+	enum EState {
+		JOB_PENDING,     //< waiting for a free slot in the budget
+		JOB_RUNNING,     //< running on the worker pool
+		JOB_DONE,        //< finished
+		JOB_CANCELLED    //< cancelled, before or while running
+	};
+
+	/** Current state of the job.
+	 */
+	EState getState() const { return m_eState; }
+
+	/** Has the job finished or been cancelled?
+	 */
+	bool isDone() const { return m_eState == JOB_DONE || m_eState == JOB_CANCELLED; }
+
+	/** Block until the job has finished or been cancelled.
+	 */
+	void wait();
+
+	/** Cancel the job. A pending job is removed from the queue, and a job
+	 *  that is queued on the worker pool is skipped when its turn comes. A
+	 *  job whose run() has started is asked to stop through
+	 *  CAlgorithm::requestAbort(), which also holds if run() has only just
+	 *  started, and is done once run() returns.
+	 */
+	void cancel();
+
+	/** The algorithm this job runs.
+	 */
+	CAlgorithm* getAlgorithm() const { return m_pAlg; }
+
+	int getPriority() const { return m_iPriority; }
+	size_t getMemory() const { return m_iMemory; }
+
+private:
+	CAlgorithmJob();
+
+	CAlgorithm* m_pAlg;
+	int m_iIterations;
+	int m_iPriority;
+	size_t m_iMemory;
+	unsigned int m_iSequence;
+	volatile EState m_eState;
+	bool m_bStarted;
+	bool m_bCancelRequested;
+
+	friend class CAlgorithmScheduler;
+	friend class CAlgorithmJobTask;
+
+	CAlgorithmJob(const CAlgorithmJob&);
+	CAlgorithmJob& operator=(const CAlgorithmJob&);
+};
+
+/**
+ * Global scheduler settings.
+ */
+struct SAlgorithmSchedulerParams {
+	/** Maximum number of algorithms running at the same time. 0 means the
+	 *  number of worker pool threads.
+	 */
+	int iMaxRunning;
+
+	/** Maximum total memory, in bytes, of the algorithms running at the same
+	 *  time, based on the estimates given to submit(). 0 means unlimited.
+	 */
+	size_t iMemoryBudget;
+
+	SAlgorithmSchedulerParams() : iMaxRunning(0), iMemoryBudget(0) { }
+};
+
+/**
+ * Runs many initialized algorithms concurrently on the CWorkerPool.
+ *
+ * Jobs start in order of priority (higher first), and in order of
+ * submission for equal priorities, as long as the number of running jobs
+ * and their total memory stay within the budget. A job that doesn't fit in
+ * the memory budget on its own still runs, when nothing else is running.
+ *
+ * An algorithm must not be submitted again, or deleted, before its job is
+ * done.
+ */
+class _AstraExport CAlgorithmScheduler : public Singleton<CAlgorithmScheduler> {
+public:
+	typedef boost::shared_ptr<CAlgorithmJob> TJob;
+
+	CAlgorithmScheduler();
+	virtual ~CAlgorithmScheduler();
+
+	/** Submit an initialized algorithm.
+	 *
+	 * @param _pAlg algorithm to run
+	 * @param _iNrIterations number of iterations, passed to run()
+	 * @param _iPriority jobs with higher priority start first
+	 * @param _iMemory estimate of the memory the algorithm needs while running, in bytes;
+	 *        0 uses the algorithm's own getMemoryEstimate()
+	 * @return completion handle
+	 */
+	TJob submit(CAlgorithm* _pAlg, int _iNrIterations = 0, int _iPriority = 0, size_t _iMemory = 0);
+
+	/** Block until all submitted jobs are done.
+	 */
+	void waitAll();
+
+	/** Cancel all pending and running jobs.
+	 */
+	void cancelAll();
+
+	/** Number of jobs waiting to start.
+	 */
+	int getPendingCount();
+
+	/** Number of jobs running.
+	 */
+	int getRunningCount();
+
+	/** Set the budget for running jobs. Jobs that are already running are
+	 *  not affected.
+	 */
+	void setParams(const SAlgorithmSchedulerParams& _params);
+	SAlgorithmSchedulerParams getParams();
+
+private:
+	void _cancel(CAlgorithmJob* _pJob);
+	void _wait(CAlgorithmJob* _pJob);
+
+public:
+	// internal
+	bool _start(CAlgorithmJob* _pJob);
+	void _finished(CAlgorithmJob* _pJob);
+
+private:
+
+	// Start pending jobs that fit in the budget. Must be called with the
+	// mutex held.
+	void _dispatch();
+
+	// Protects everything below, and the state of all jobs
+	CMutex m_mutex;
+	// Signalled when a job changes state
+	CCondition m_condChanged;
+
+	SAlgorithmSchedulerParams m_params;
+	std::vector<TJob> m_pending;
+	std::vector<TJob> m_running;
+	size_t m_iMemoryInUse;
+	unsigned int m_iNextSequence;
+
+	friend class CAlgorithmJob;
+};
+
+} // end namespace
+
+#endif
@@ -0,0 +1,146 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#ifndef _INC_ASTRA_ALGORITHMTIMINGS
+#define _INC_ASTRA_ALGORITHMTIMINGS
+
+#include <map>
+#include <string>
+
+#include <boost/any.hpp>
+
+#include "Globals.h"
+#include "Tracing.h"
+
+namespace astra {
+
+/**
+ * Phases of an algorithm run that are timed separately.
+ */
+enum EAlgorithmPhase {
+	ALGPHASE_SETUP,       //< allocation and preparation of projectors
+	ALGPHASE_WEIGHTS,     //< precomputation of ray and pixel weights
+	ALGPHASE_FP,          //< forward projection
+	ALGPHASE_BP,          //< backprojection
+	ALGPHASE_VECTOROPS,   //< element-wise operations and reductions
+	ALGPHASE_FILTERING,   //< sinogram filtering
+	ALGPHASE_HOSTCOPY,    //< copies between buffers or to/from the GPU
+	ALGPHASE_COUNT
+};
+
+/**
+ * Aggregated time and counters per phase of an algorithm run.
+ *
+ * Collection is disabled by default, in which case all methods return
+ * immediately. The counters are not thread-safe; they are meant to be
+ * updated by the thread running the algorithm.
+ */
+class _AstraExport CAlgorithmTimings {
+public:
+	CAlgorithmTimings();
+
+	/** Enable or disable collection.
+	 */
+	void setEnabled(bool _bEnabled) { m_bEnabled = _bEnabled; }
+	bool isEnabled() const { return m_bEnabled; }
+
+	/** Clear all times and counters.
+	 */
+	void reset();
+
+	/** Add time spent in a phase. */
+	void addTime(EAlgorithmPhase _ePhase, double _fSeconds);
+
+	/** Add to the number of rays traced. */
+	void addRays(double _fCount) { if (m_bEnabled) m_fRays += _fCount; }
+
+	/** Add to the number of projection weights applied. */
+	void addWeights(double _fCount) { if (m_bEnabled) m_fWeights += _fCount; }
+
+	/** Add to the number of bytes read and written by vector operations and copies. */
+	void addBytes(double _fCount) { if (m_bEnabled) m_fBytes += _fCount; }
+
+	double getTime(EAlgorithmPhase _ePhase) const { return m_fTime[_ePhase]; }
+	int getCalls(EAlgorithmPhase _ePhase) const { return m_iCalls[_ePhase]; }
+	double getRays() const { return m_fRays; }
+	double getWeights() const { return m_fWeights; }
+	double getBytes() const { return m_fBytes; }
+
+	/** Get all times and counters, for getInformation("Timings").
+	 *  For each phase P there are entries P_time (seconds) and P_calls.
+	 */
+	std::map<std::string, boost::any> getInformation() const;
+
+	/** Name of a phase, as used in getInformation(). */
+	static const char* getPhaseName(EAlgorithmPhase _ePhase);
+
+	/** Monotonic wall clock time in seconds. */
+	static double getClock();
+
+private:
+	bool m_bEnabled;
+	double m_fTime[ALGPHASE_COUNT];
+	int m_iCalls[ALGPHASE_COUNT];
+	double m_fRays;
+	double m_fWeights;
+	double m_fBytes;
+};
+
+/**
+ * Adds the time between its construction and destruction to a phase, and
+ * records it as a trace event if tracing is enabled.
+ */
+class CPhaseTimer {
+public:
+	CPhaseTimer(CAlgorithmTimings& _timings, EAlgorithmPhase _ePhase)
+		: m_timings(_timings), m_ePhase(_ePhase)
+	{
+		m_fStart = m_timings.isEnabled() ? CAlgorithmTimings::getClock() : 0.0;
+		m_bTraced = CTracer::isEnabled();
+		if (m_bTraced)
+			CTracer::begin("algorithm", CAlgorithmTimings::getPhaseName(m_ePhase));
+	}
+	~CPhaseTimer()
+	{
+		if (m_timings.isEnabled())
+			m_timings.addTime(m_ePhase, CAlgorithmTimings::getClock() - m_fStart);
+		if (m_bTraced)
+			CTracer::end("algorithm", CAlgorithmTimings::getPhaseName(m_ePhase), std::string());
+	}
+private:
+	CAlgorithmTimings& m_timings;
+	EAlgorithmPhase m_ePhase;
+	double m_fStart;
+	bool m_bTraced;
+
+	CPhaseTimer(const CPhaseTimer&);
+	CPhaseTimer& operator=(const CPhaseTimer&);
+};
+
+} // end namespace
+
+#endif
@@ -37,6 +37,8 @@ along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
 #include "ForwardProjectionAlgorithm.h"
 #include "BackProjectionAlgorithm.h"
 #include "FilteredBackProjectionAlgorithm.h"
+#include "FanParallelRebinAlgorithm.h"
+#include "CenterOfRotationAlgorithm.h"
 #include "CudaBackProjectionAlgorithm.h"
 #include "CudaSartAlgorithm.h"
 #include "CudaSirtAlgorithm.h"
@@ -44,6 +46,10 @@ along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
 #include "CudaEMAlgorithm.h"
 #include "CudaForwardProjectionAlgorithm.h"
 #include "CglsAlgorithm.h"
+#include "ForwardProjectionAlgorithm3D.h"
+#include "BackProjectionAlgorithm3D.h"
+#include "SirtAlgorithm3D.h"
+#include "CglsAlgorithm3D.h"
 #include "CudaCglsAlgorithm3D.h"
 #include "CudaSirtAlgorithm3D.h"
 #include "CudaForwardProjectionAlgorithm3D.h"
@@ -61,7 +67,7 @@ namespace astra {
 
 #ifdef ASTRA_CUDA
 
-typedef TYPELIST_25(
+typedef TYPELIST_31(
 			CArtAlgorithm,
 			CSartAlgorithm,
 			CSirtAlgorithm,
@@ -86,20 +92,32 @@ typedef TYPELIST_25(
 			CCudaFDKAlgorithm3D,
 			CCudaSirtAlgorithm3D,
 			CCudaForwardProjectionAlgorithm3D,
-			CCudaBackProjectionAlgorithm3D
+			CCudaBackProjectionAlgorithm3D,
+			CFanParallelRebinAlgorithm,
+			CCenterOfRotationAlgorithm,
+			CForwardProjectionAlgorithm3D,
+			CBackProjectionAlgorithm3D,
+			CSirtAlgorithm3D,
+			CCglsAlgorithm3D
 			)
 	AlgorithmTypeList;
 
 #else
 
-typedef TYPELIST_7(
+typedef TYPELIST_13(
 			CArtAlgorithm,
 			CSartAlgorithm,
 			CSirtAlgorithm,
 			CCglsAlgorithm,
 			CBackProjectionAlgorithm,
 			CForwardProjectionAlgorithm,
-			CFilteredBackProjectionAlgorithm
+			CFilteredBackProjectionAlgorithm,
+			CFanParallelRebinAlgorithm,
+			CCenterOfRotationAlgorithm,
+			CForwardProjectionAlgorithm3D,
+			CBackProjectionAlgorithm3D,
+			CSirtAlgorithm3D,
+			CCglsAlgorithm3D
 			) AlgorithmTypeList;
 
 #endif
@@ -0,0 +1,157 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+#ifndef _INC_ASTRA_ANALYTICPHANTOM
+#define _INC_ASTRA_ANALYTICPHANTOM
+
+#include <vector>
+
+#include "Globals.h"
+
+namespace astra {
+
+class CFloat32VolumeData2D;
+class CFloat32ProjectionData2D;
+class CFloat32VolumeData3DMemory;
+class CFloat32ProjectionData3DMemory;
+
+/**
+ * An ellipse with a constant value, added to the phantom where it overlaps
+ * other ellipses. Angles are in radians, counterclockwise from the x axis.
+ */
+struct SEllipse {
+	float64 fValue;
+	float64 fCenterX, fCenterY;
+	float64 fSemiAxisX, fSemiAxisY;
+	float64 fAngle;
+};
+
+/**
+ * An ellipsoid with a constant value. The semi-axes are rotated by fAngle
+ * radians around the z axis.
+ */
+struct SEllipsoid {
+	float64 fValue;
+	float64 fCenterX, fCenterY, fCenterZ;
+	float64 fSemiAxisX, fSemiAxisY, fSemiAxisZ;
+	float64 fAngle;
+};
+
+/**
+ * A 2D phantom made of ellipses, with exact projections.
+ *
+ * The phantom can be rasterized onto any volume geometry, with each pixel
+ * set to the mean over a regular grid of sub-samples, and projected
+ * analytically onto parallel, parallel_vec, fanflat and fanflat_vec
+ * geometries. Projection values follow the convention of the 2D
+ * projectors: the line integral through the detector pixel centre times
+ * the detector pixel width. Both operations are threaded over rows or
+ * projection angles on the CWorkerPool.
+ */
+class _AstraExport CEllipsePhantom2D {
+public:
+	CEllipsePhantom2D() { }
+
+	/** The Shepp-Logan phantom, scaled to fit in a circle of radius _fRadius
+	 *  around the origin.
+	 *
+	 * @param _fRadius radius of the phantom, in world units
+	 * @param _bModified use the higher-contrast values of Toft's modified phantom
+	 */
+	static CEllipsePhantom2D createSheppLogan(float64 _fRadius, bool _bModified = true);
+
+	void addEllipse(const SEllipse& _ellipse) { m_ellipses.push_back(_ellipse); }
+
+	const std::vector<SEllipse>& getEllipses() const { return m_ellipses; }
+
+	/** Value at the point (_fX, _fY). */
+	float64 getValue(float64 _fX, float64 _fY) const;
+
+	/** Line integral along the line through (_fX, _fY) with direction (_fDX, _fDY). */
+	float64 getLineIntegral(float64 _fX, float64 _fY, float64 _fDX, float64 _fDY) const;
+
+	/** Rasterize the phantom with _iSuperSampling^2 samples per pixel.
+	 *
+	 * @return false if the arguments are invalid or a buffer could not be allocated
+	 */
+	bool rasterize(CFloat32VolumeData2D* _pVolume, int _iSuperSampling = 4) const;
+
+	/** Compute the exact projection of the phantom.
+	 *
+	 * @return false if the projection geometry is not supported
+	 */
+	bool project(CFloat32ProjectionData2D* _pProjection) const;
+
+private:
+	std::vector<SEllipse> m_ellipses;
+};
+
+/**
+ * A 3D phantom made of ellipsoids, with exact projections.
+ *
+ * As CEllipsePhantom2D, for parallel3d, parallel3d_vec, cone and cone_vec
+ * geometries. Projection values are the plain line integrals through the
+ * detector pixel centres, as for the 3D projectors.
+ */
+class _AstraExport CEllipsoidPhantom3D {
+public:
+	CEllipsoidPhantom3D() { }
+
+	/** The 3D Shepp-Logan phantom of Kak and Slaney, scaled to fit in a
+	 *  sphere of radius _fRadius around the origin.
+	 */
+	static CEllipsoidPhantom3D createSheppLogan(float64 _fRadius, bool _bModified = true);
+
+	void addEllipsoid(const SEllipsoid& _ellipsoid) { m_ellipsoids.push_back(_ellipsoid); }
+
+	const std::vector<SEllipsoid>& getEllipsoids() const { return m_ellipsoids; }
+
+	/** Value at the point (_fX, _fY, _fZ). */
+	float64 getValue(float64 _fX, float64 _fY, float64 _fZ) const;
+
+	/** Line integral along the line through (_fX, _fY, _fZ) with direction (_fDX, _fDY, _fDZ). */
+	float64 getLineIntegral(float64 _fX, float64 _fY, float64 _fZ,
+	                        float64 _fDX, float64 _fDY, float64 _fDZ) const;
+
+	/** Rasterize the phantom with _iSuperSampling^3 samples per voxel.
+	 *
+	 * @return false if the arguments are invalid or a buffer could not be allocated
+	 */
+	bool rasterize(CFloat32VolumeData3DMemory* _pVolume, int _iSuperSampling = 2) const;
+
+	/** Compute the exact projection of the phantom.
+	 *
+	 * @return false if the projection geometry is not supported
+	 */
+	bool project(CFloat32ProjectionData3DMemory* _pProjection) const;
+
+private:
+	std::vector<SEllipsoid> m_ellipsoids;
+};
+
+} // namespace astra
+
+#endif
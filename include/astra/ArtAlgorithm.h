@@ -164,6 +164,10 @@ public:
 	 */
 	virtual void run(int _iNrIterations = 0);
 
+	/** Estimate the host memory of the ray order and pixel weight buffers.
+	 */
+	virtual size_t getMemoryEstimate() const;
+
 	/** Get a description of the class.
 	 *
 	 * @return description string
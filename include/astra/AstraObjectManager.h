@@ -28,10 +28,16 @@ along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
 #ifndef _INC_ASTRA_ASTRAOBJECTMANAGER
 #define _INC_ASTRA_ASTRAOBJECTMANAGER
 
-#include <map>
+#include <algorithm>
 #include <sstream>
+#include <utility>
+#include <vector>
+
+#include <boost/functional/hash.hpp>
+#include <boost/unordered_map.hpp>
 
 #include "Globals.h"
+#include "Mutex.h"
 #include "Singleton.h"
 #include "Projector2D.h"
 #include "Projector3D.h"
@@ -42,6 +48,113 @@ along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
 
 namespace astra {
 
+/**
+ * Hash map that is split into shards with a lock each, so that threads
+ * accessing different keys rarely contend. Lookups, insertions and removals
+ * are O(1) on average and lock a single shard.
+ */
+template <typename K, typename V>
+class CShardedMap {
+public:
+	/** Insert a value, or replace the existing value for the key.
+	 */
+	void set(const K& _key, const V& _value) {
+		SShard& shard = _shard(_key);
+		CMutexLock lock(shard.mutex);
+		shard.table[_key] = _value;
+	}
+
+	/** Insert a value, unless the key is already present.
+	 *
+	 * @return true if the value was inserted
+	 */
+	bool insert(const K& _key, const V& _value) {
+		SShard& shard = _shard(_key);
+		CMutexLock lock(shard.mutex);
+		return shard.table.insert(std::make_pair(_key, _value)).second;
+	}
+
+	/** Look up the value for a key.
+	 *
+	 * @return false if the key is not present
+	 */
+	bool get(const K& _key, V& _value) const {
+		const SShard& shard = _shard(_key);
+		CMutexLock lock(shard.mutex);
+		typename TTable::const_iterator i = shard.table.find(_key);
+		if (i == shard.table.end())
+			return false;
+		_value = i->second;
+		return true;
+	}
+
+	/** Remove a key, and return its value.
+	 *
+	 * @return false if the key is not present
+	 */
+	bool take(const K& _key, V& _value) {
+		SShard& shard = _shard(_key);
+		CMutexLock lock(shard.mutex);
+		typename TTable::iterator i = shard.table.find(_key);
+		if (i == shard.table.end())
+			return false;
+		_value = i->second;
+		shard.table.erase(i);
+		return true;
+	}
+
+	/** Remove a key if it maps to the given value.
+	 */
+	void erase(const K& _key, const V& _value) {
+		SShard& shard = _shard(_key);
+		CMutexLock lock(shard.mutex);
+		typename TTable::iterator i = shard.table.find(_key);
+		if (i != shard.table.end() && i->second == _value)
+			shard.table.erase(i);
+	}
+
+	/** Get a copy of all entries, sorted by key.
+	 */
+	void getAll(std::vector<std::pair<K, V> >& _entries) const {
+		_entries.clear();
+		for (int i = 0; i < SHARD_COUNT; ++i) {
+			CMutexLock lock(m_shards[i].mutex);
+			_entries.insert(_entries.end(), m_shards[i].table.begin(), m_shards[i].table.end());
+		}
+		std::sort(_entries.begin(), _entries.end());
+	}
+
+	/** Remove all entries, and return them sorted by key.
+	 */
+	void takeAll(std::vector<std::pair<K, V> >& _entries) {
+		_entries.clear();
+		for (int i = 0; i < SHARD_COUNT; ++i) {
+			CMutexLock lock(m_shards[i].mutex);
+			_entries.insert(_entries.end(), m_shards[i].table.begin(), m_shards[i].table.end());
+			m_shards[i].table.clear();
+		}
+		std::sort(_entries.begin(), _entries.end());
+	}
+
+private:
+	typedef boost::unordered_map<K, V> TTable;
+
+	enum { SHARD_COUNT = 16 };
+
+	struct SShard {
+		mutable CMutex mutex;
+		TTable table;
+		// keep the locks of neighbouring shards on different cache lines
+		char pad[64];
+	};
+
+	SShard& _shard(const K& _key) { return m_shards[boost::hash<K>()(_key) % SHARD_COUNT]; }
+	const SShard& _shard(const K& _key) const { return m_shards[boost::hash<K>()(_key) % SHARD_COUNT]; }
+
+	SShard m_shards[SHARD_COUNT];
+};
+
+
 /**
  * This class contains functionality to store objects.  A unique index handle
  * will be assigned to each data object by which it can be accessed in the
@@ -49,6 +162,10 @@ namespace astra {
  *
  * We store them in a special common base class to make indices unique
  * among all ObjectManagers.
+ *
+ * All managers can be used from several threads at once. They do not manage
+ * the lifetime of the objects beyond remove(): an object must not be removed
+ * while another thread is still using it.
  */
 
 class CAstraObjectManagerBase {
@@ -64,31 +181,34 @@ public:
 	CAstraIndexManager() : m_iLastIndex(0) { }
 
 	int store(CAstraObjectManagerBase* m) {
-		m_table[++m_iLastIndex] = m;
-		return m_iLastIndex;
+		int index;
+		{
+			CMutexLock lock(m_indexMutex);
+			index = ++m_iLastIndex;
+		}
+		m_table.set(index, m);
+		return index;
 	}
 
 	CAstraObjectManagerBase* get(int index) const {
-		std::map<int, CAstraObjectManagerBase*>::const_iterator i;
-		i = m_table.find(index);
-		if (i != m_table.end())
-			return i->second;
+		CAstraObjectManagerBase* m;
+		if (m_table.get(index, m))
+			return m;
 		else
 			return 0;
 	}
 
 	void remove(int index) {
-		std::map<int, CAstraObjectManagerBase*>::iterator i;
-		i = m_table.find(index);
-		if (i != m_table.end())
-			m_table.erase(i);
+		CAstraObjectManagerBase* m;
+		m_table.take(index, m);
 	}
 
 private:
 	/** The index last handed out
 	 */
 	int m_iLastIndex;
-	std::map<int, CAstraObjectManagerBase*> m_table;
+	CMutex m_indexMutex;
+	CShardedMap<int, CAstraObjectManagerBase*> m_table;
 };
 
 
@@ -160,7 +280,11 @@ protected:
 
 	/** Map each data object to a unique index.
 	 */
-	std::map<int, T*> m_mIndexToObject;
+	CShardedMap<int, T*> m_mIndexToObject;
+
+	/** Map each data object back to its index, for getIndex.
+	 */
+	CShardedMap<const T*, int> m_mObjectToIndex;
 
 };
 
@@ -185,7 +309,8 @@ template <typename T>
 int CAstraObjectManager<T>::store(T* _pDataObject) 
 {
 	int iIndex = CAstraIndexManager::getSingleton().store(this);
-	m_mIndexToObject[iIndex] = _pDataObject;
+	m_mIndexToObject.set(iIndex, _pDataObject);
+	m_mObjectToIndex.insert(_pDataObject, iIndex);
 	return iIndex;
 }
 
@@ -194,8 +319,8 @@ int CAstraObjectManager<T>::store(T* _pDataObject)
 template <typename T>
 bool CAstraObjectManager<T>::hasIndex(int _iIndex) const
 {
-	typename std::map<int,T*>::const_iterator it = m_mIndexToObject.find(_iIndex);
-	return it != m_mIndexToObject.end();
+	T* pObject;
+	return m_mIndexToObject.get(_iIndex, pObject);
 }
 
 //----------------------------------------------------------------------------------------
@@ -203,9 +328,9 @@ bool CAstraObjectManager<T>::hasIndex(int _iIndex) const
 template <typename T>
 T* CAstraObjectManager<T>::get(int _iIndex) const
 {
-	typename std::map<int,T*>::const_iterator it = m_mIndexToObject.find(_iIndex);
-	if (it != m_mIndexToObject.end())
-		return it->second;
+	T* pObject;
+	if (m_mIndexToObject.get(_iIndex, pObject))
+		return pObject;
 	else
 		return 0;
 }
@@ -215,14 +340,13 @@ T* CAstraObjectManager<T>::get(int _iIndex) const
 template <typename T>
 void CAstraObjectManager<T>::remove(int _iIndex)
 {
-	// find data
-	typename std::map<int,T*>::iterator it = m_mIndexToObject.find(_iIndex);
-	if (it == m_mIndexToObject.end())
+	// find data, and delete from map
+	T* pObject;
+	if (!m_mIndexToObject.take(_iIndex, pObject))
 		return;
+	m_mObjectToIndex.erase(pObject, _iIndex);
 	// delete data
-	delete (*it).second;
-	// delete from map
-	m_mIndexToObject.erase(it);
+	delete pObject;
 
 	CAstraIndexManager::getSingleton().remove(_iIndex);
 }
@@ -232,9 +356,9 @@ void CAstraObjectManager<T>::remove(int _iIndex)
 template <typename T>
 int CAstraObjectManager<T>::getIndex(const T* _pObject) const
 {
-	for (typename std::map<int,T*>::const_iterator it = m_mIndexToObject.begin(); it != m_mIndexToObject.end(); it++) {
-		if ((*it).second == _pObject) return (*it).first;
-	}
+	int iIndex;
+	if (m_mObjectToIndex.get(_pObject, iIndex))
+		return iIndex;
 	return 0;
 }
 
@@ -244,23 +368,22 @@ int CAstraObjectManager<T>::getIndex(const T* _pObject) const
 template <typename T>
 void CAstraObjectManager<T>::clear()
 {
-	for (typename std::map<int,T*>::iterator it = m_mIndexToObject.begin(); it != m_mIndexToObject.end(); it++) {
+	std::vector<std::pair<int, T*> > objects;
+	m_mIndexToObject.takeAll(objects);
+	for (typename std::vector<std::pair<int, T*> >::iterator it = objects.begin(); it != objects.end(); it++) {
+		m_mObjectToIndex.erase(it->second, it->first);
 		// delete data
-		delete (*it).second;
-		(*it).second = 0;
+		delete it->second;
 	}
-
-	m_mIndexToObject.clear();
 }
 
 //----------------------------------------------------------------------------------------
 // Print info to string
 template <typename T>
 std::string CAstraObjectManager<T>::getInfo(int index) const {
-	typename std::map<int,T*>::const_iterator it = m_mIndexToObject.find(index);
-	if (it == m_mIndexToObject.end())
+	const T* pObject = get(index);
+	if (!pObject)
 		return "";
-	const T* pObject = it->second;
 	std::stringstream res;
 	res << index << " \t";
 	if (pObject->isInitialized()) {
@@ -274,10 +397,12 @@ std::string CAstraObjectManager<T>::getInfo(int index) const {
 
 template <typename T>
 std::string CAstraObjectManager<T>::info() {
+	std::vector<std::pair<int, T*> > objects;
+	m_mIndexToObject.getAll(objects);
 	std::stringstream res;
 	res << "id  init  description" << std::endl;
 	res << "-----------------------------------------" << std::endl;
-	for (typename std::map<int,T*>::const_iterator it = m_mIndexToObject.begin(); it != m_mIndexToObject.end(); it++) {
+	for (typename std::vector<std::pair<int, T*> >::const_iterator it = objects.begin(); it != objects.end(); it++) {
 		res << getInfo(it->first) << std::endl;
 	}
 	res << "-----------------------------------------" << std::endl;
@@ -30,12 +30,7 @@ along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
 
 #include "Config.h"
 #include "Algorithm.h"
-
-#ifdef USE_PTHREADS
-#include <pthread.h>
-#else
-#include <boost/thread.hpp>
-#endif
+#include "WorkerPool.h"
 
 namespace astra {
 	
@@ -84,6 +79,16 @@ public:
 	 */
 	void signalAbort();
 
+	/** Progress of the current or last run of the wrapped algorithm, in
+	 *  [0,1]. The progress callback set with setProgressCallback() also
+	 *  receives the progress reports of the wrapped algorithm.
+	 */
+	float32 getProgress() const { return m_fProgress; }
+
+	/** Phase of the current or last run of the wrapped algorithm.
+	 */
+	EAlgorithmPhase getPhase() const { return m_ePhase; }
+
 protected:
 	//< Has this class been initialized?
 	bool m_bInitialized;
@@ -96,24 +101,51 @@ protected:
 	
 	//< Is the wrapped algorithm done. 
 	volatile bool m_bDone;
+
+	//< Last progress reported by the wrapped algorithm.
+	volatile float32 m_fProgress;
+	volatile EAlgorithmPhase m_ePhase;
+
+	/**
+	 * Records the progress reports of the wrapped algorithm, and passes
+	 * them on to our own progress callback.
+	 */
+	class CProgressRecorder : public CAlgorithmProgress {
+	public:
+		CAsyncAlgorithm* m_pParent;
+		virtual void progress(float32 _fProgress, EAlgorithmPhase _ePhase);
+	};
+
+	//< Progress callback installed in the wrapped algorithm.
+	CProgressRecorder m_progressRecorder;
 	
-#ifndef USE_PTHREADS
-	//< Handle to boost thread object running the wrapped algorithm. 
-	boost::thread* m_pThread;
-#else
-	pthread_t m_thread;
-	struct AsyncThreadInfo {
+	/**
+	 * Task running the wrapped algorithm on the worker pool.
+	 */
+	class CRunTask : public CWorkerTask {
+	public:
+		CAsyncAlgorithm* m_pParent;
 		int m_iIterations;
-		CAlgorithm* m_pAlg;
-		volatile bool* m_pDone;
-	} m_ThreadInfo;
-	friend void* runAsync_pthreads(void*);
-#endif
+		virtual void run() { m_pParent->runWrapped(m_iIterations); }
+	};
+
+	//< Task running the wrapped algorithm.
+	CRunTask m_task;
+
+	//< Completion handle of the running task.
+	CTaskGroup m_group;
+
 	bool m_bThreadStarted;
 
+	//< Wait for a previous run to finish.
+	void waitRun();
+
 	//< Run the wrapped algorithm.
 	void runWrapped(int _iNrIterations);
 
+	//< Reset the progress, and install the progress recorder in the wrapped algorithm.
+	void initProgress();
+
 };
 
 }
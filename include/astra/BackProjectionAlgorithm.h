@@ -52,6 +52,7 @@ namespace astra {
  * \astra_xml_item{ReconstructionDataId, integer, Identifier of a volume data object as it is stored in the DataManager.}
  * \astra_xml_item_option{ReconstructionMaskId, integer, not used, Identifier of a volume data object that acts as a reconstruction mask. 1 = reconstruct on this pixel. 0 = don't reconstruct on this pixel.}
  * \astra_xml_item_option{SinogramMaskId, integer, not used, Identifier of a projection data object that acts as a projection mask. 1 = reconstruct using this ray. 0 = don't use this ray while reconstructing.}
+ * \astra_xml_item_option{PixelDriven, bool, false, Use the pixel-driven backprojector. Only for parallel and fan beam geometries.}
  *
  */
 class _AstraExport CBackProjectionAlgorithm : public CReconstructionAlgorithm2D {
@@ -0,0 +1,173 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#ifndef _INC_ASTRA_BRICKEDVOLUME3D
+#define _INC_ASTRA_BRICKEDVOLUME3D
+
+#include "Globals.h"
+
+namespace astra {
+
+class CFloat32Data3DMemory;
+class CVolumeGeometry3D;
+class CFloat32ProjectionData3DMemory;
+
+/**
+ * A 3D volume stored as 8x8x8 bricks, for CPU 3D kernels.
+ *
+ * In the plain x-fastest layout, a step in y or z jumps a row or a whole
+ * slice, so rays that are not aligned with x touch a new cache line (and
+ * often a new page) for every sample. Here each brick is one contiguous,
+ * cache line aligned block of 512 voxels, x fastest within the brick, and
+ * the bricks are stored x fastest as well. A ray in any direction stays
+ * inside one brick for several samples, and a brick is a natural unit of
+ * work for threads and for paging.
+ *
+ * Bricks at the upper borders extend past the volume; the voxels outside
+ * the volume are zero and stay zero. Use copyFrom() and copyTo() to convert
+ * from and to the linear layout of CFloat32Data3DMemory.
+ */
+class _AstraExport CBrickedVolume3D {
+public:
+	static const int BRICK_SHIFT = 3;
+	static const int BRICK_SIZE = 1 << BRICK_SHIFT;
+	static const int BRICK_VOXELS = BRICK_SIZE * BRICK_SIZE * BRICK_SIZE;
+
+	CBrickedVolume3D();
+
+	/** Create a zero volume of _iWidth x _iHeight x _iDepth voxels.
+	 */
+	CBrickedVolume3D(int _iWidth, int _iHeight, int _iDepth);
+
+	~CBrickedVolume3D();
+
+	/** (Re)allocate as a zero volume of _iWidth x _iHeight x _iDepth voxels.
+	 *
+	 * @return false if the allocation failed or exceeds the CMemoryBudget limit
+	 */
+	bool initialize(int _iWidth, int _iHeight, int _iDepth);
+
+	bool isInitialized() const { return m_pfData != 0; }
+
+	int getWidth() const { return m_iWidth; }
+	int getHeight() const { return m_iHeight; }
+	int getDepth() const { return m_iDepth; }
+
+	/** Number of bricks along x, y and z, and in total.
+	 */
+	int getBrickCountX() const { return m_iBricksX; }
+	int getBrickCountY() const { return m_iBricksY; }
+	int getBrickCountZ() const { return m_iBricksZ; }
+	int getBrickCount() const { return m_iBricksX * m_iBricksY * m_iBricksZ; }
+
+	/** The BRICK_VOXELS voxels of brick _iBrick. Brick (bx, by, bz) has
+	 *  index (bz * getBrickCountY() + by) * getBrickCountX() + bx.
+	 */
+	float32* getBrick(int _iBrick) { return m_pfData + (size_t)_iBrick * BRICK_VOXELS; }
+	const float32* getBrick(int _iBrick) const { return m_pfData + (size_t)_iBrick * BRICK_VOXELS; }
+
+	/** Offset of voxel (_iX, _iY, _iZ) in the data block.
+	 */
+	size_t index(int _iX, int _iY, int _iZ) const;
+
+	float32 getValue(int _iX, int _iY, int _iZ) const { return m_pfData[index(_iX, _iY, _iZ)]; }
+	void setValue(int _iX, int _iY, int _iZ, float32 _fValue) { m_pfData[index(_iX, _iY, _iZ)] = _fValue; }
+
+	/** Set all voxels to zero.
+	 */
+	void clearData();
+
+	/** Convert from the linear layout. _pData must have the same size.
+	 */
+	bool copyFrom(const CFloat32Data3DMemory* _pData);
+
+	/** Convert to the linear layout. _pData must have the same size.
+	 */
+	bool copyTo(CFloat32Data3DMemory* _pData) const;
+
+	/** Bytes of host memory allocated by this object.
+	 */
+	size_t getMemoryUsage() const;
+
+private:
+	int m_iWidth, m_iHeight, m_iDepth;
+	int m_iBricksX, m_iBricksY, m_iBricksZ;
+	float32* m_pfData;
+
+	void _free();
+
+	// not copyable
+	CBrickedVolume3D(const CBrickedVolume3D&);
+	CBrickedVolume3D& operator=(const CBrickedVolume3D&);
+};
+
+//----------------------------------------------------------------------------------------
+inline size_t CBrickedVolume3D::index(int _iX, int _iY, int _iZ) const
+{
+	const int iMask = BRICK_SIZE - 1;
+	const size_t iBrick = ((size_t)(_iZ >> BRICK_SHIFT) * m_iBricksY + (_iY >> BRICK_SHIFT)) * m_iBricksX + (_iX >> BRICK_SHIFT);
+	return iBrick * BRICK_VOXELS + ((((_iZ & iMask) << BRICK_SHIFT) + (_iY & iMask)) << BRICK_SHIFT) + (_iX & iMask);
+}
+
+/** Forward project a bricked volume with the linear (Joseph) kernel, see
+ *  traceLinearRay3D(). Supports parallel3d, parallel3d_vec, cone and
+ *  cone_vec geometries; the values are plain line integrals. Threaded over
+ *  detector rows of single projections.
+ *
+ * @param _pVolume volume, of the size of _pVolumeGeometry
+ * @param _pVolumeGeometry geometry of the volume
+ * @param _pProjection output projection data; its geometry selects the rays
+ * @return false on unsupported geometries or mismatched sizes
+ */
+_AstraExport bool forwardProjectBricked(const CBrickedVolume3D* _pVolume,
+                                        const CVolumeGeometry3D* _pVolumeGeometry,
+                                        CFloat32ProjectionData3DMemory* _pProjection);
+
+/** Voxel-driven backprojection into a bricked volume. Every voxel centre is
+ *  projected onto each detector and gets the sum of the bilinearly
+ *  interpolated projection values; detector values outside the detector
+ *  count as zero. The volume is overwritten. Threaded brick by brick, so
+ *  no two threads write to the same cache line.
+ *
+ *  This is NOT the adjoint of forwardProjectBricked(): the two use
+ *  different kernels and weights (there is no ray length factor here), so
+ *  <A x, y> != <x, A' y>. Use it where an unmatched backprojector is
+ *  acceptable, such as FBP-like backprojection or SIRT, but not for
+ *  algorithms like CGLS that rely on an exact transpose.
+ *
+ * @param _pProjection projection data; its geometry selects the rays
+ * @param _pVolumeGeometry geometry of the volume
+ * @param _pVolume output volume, of the size of _pVolumeGeometry
+ * @return false on unsupported geometries or mismatched sizes
+ */
+_AstraExport bool backprojectBricked(const CFloat32ProjectionData3DMemory* _pProjection,
+                                     const CVolumeGeometry3D* _pVolumeGeometry,
+                                     CBrickedVolume3D* _pVolume);
+
+} // end namespace astra
+
+#endif
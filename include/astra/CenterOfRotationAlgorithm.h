@@ -0,0 +1,177 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#ifndef _INC_ASTRA_CENTEROFROTATIONALGORITHM
+#define _INC_ASTRA_CENTEROFROTATIONALGORITHM
+
+#include "Globals.h"
+#include "Config.h"
+#include "Algorithm.h"
+
+namespace astra {
+
+class CFloat32ProjectionData2D;
+
+/**
+ * \brief
+ * This class searches the centre of rotation of a parallel beam sinogram.
+ *
+ * The result is the detector offset, in detector pixels, to apply to the
+ * geometry, as done by astra_geom_postalignment. Candidate offsets are
+ * scored by the sharpness of their FBP reconstructions. The search starts
+ * on a binned sinogram over the whole search range, and then refines
+ * around the best offset with less binning and smaller steps, until the
+ * step is below the requested precision. The reconstructions have pixels
+ * of the binned detector size, and cover at most the central 256 by 256
+ * pixels, so the cost of the finer levels stays bounded.
+ *
+ * As a detector offset does not change the filtered sinogram, it is
+ * filtered only once per level, and the candidates of a level are
+ * backprojected concurrently on the worker pool.
+ *
+ * \par XML Configuration
+ * \astra_xml_item{ProjectionDataId, integer, Identifier of a parallel or parallel_vec projection data object as it is stored in the DataManager.}
+ * \astra_xml_item_option{SearchRange, float, detector count / 4, Search offsets in [-SearchRange, SearchRange] detector pixels.}
+ * \astra_xml_item_option{Precision, float, 0.25, Final step size in detector pixels.}
+ * \astra_xml_item_option{Binning, integer, automatic, Detector binning of the coarsest level. A power of two; the default bins to at least 128 detector pixels.}
+ *
+ * \par MATLAB example
+ * \astra_code{
+ *		cfg = astra_struct('CenterOfRotation');\n
+ *		cfg.ProjectionDataId = sino_id;\n
+ *		alg_id = astra_mex_algorithm('create'\, cfg);\n
+ *		astra_mex_algorithm('run'\, alg_id);\n
+ *		offset = astra_mex_algorithm('get_center_of_rotation'\, alg_id);\n
+ *		astra_mex_algorithm('delete'\, alg_id);\n
+ *		proj_geom = astra_geom_postalignment(proj_geom\, offset);\n
+ * }
+ */
+class _AstraExport CCenterOfRotationAlgorithm : public CAlgorithm {
+
+public:
+
+	// type of the algorithm, needed to register with CAlgorithmFactory
+	static std::string type;
+
+	/** Default constructor, containing no code.
+	 */
+	CCenterOfRotationAlgorithm();
+
+	/** Destructor.
+	 */
+	virtual ~CCenterOfRotationAlgorithm();
+
+	/** Initialize the algorithm with a config object.
+	 *
+	 * @param _cfg Configuration Object
+	 * @return initialization successful?
+	 */
+	virtual bool initialize(const Config& _cfg);
+
+	/** Initialize class.
+	 *
+	 * @param _pSinogram	parallel beam sinogram.
+	 * @param _fSearchRange	search offsets in [-_fSearchRange, _fSearchRange], or 0 for a quarter of the detector.
+	 * @param _fPrecision	final step size.
+	 * @param _iBinning		binning of the coarsest level, or 0 for automatic.
+	 * @return initialization successful?
+	 */
+	bool initialize(CFloat32ProjectionData2D* _pSinogram,
+	                float32 _fSearchRange = 0.0f,
+	                float32 _fPrecision = 0.25f,
+	                int _iBinning = 0);
+
+	/** Get all information parameters
+	 *
+	 * @return map with all boost::any object
+	 */
+	virtual std::map<std::string,boost::any> getInformation();
+
+	/** Get a single piece of information represented as a boost::any.
+	 * "Offset" is the offset found by the last run.
+	 *
+	 * @param _sIdentifier identifier string to specify which piece of information you want
+	 * @return boost::any object
+	 */
+	virtual boost::any getInformation(std::string _sIdentifier);
+
+	/** Search the centre of rotation.
+	 *
+	 * @param _iNrIterations not used.
+	 */
+	virtual void run(int _iNrIterations = 0);
+
+	/** Get the offset found by the last run, in detector pixels.
+	 */
+	float32 getOffset() const { return m_fOffset; }
+
+	/** Get the number of candidate reconstructions of the last run.
+	 */
+	int getCandidateCount() const { return m_iCandidateCount; }
+
+	/** Sharpness of a reconstruction inside the inscribed disk of its
+	 * grid: the maximum entropy minus the entropy of the histogram of its
+	 * values. Misalignment spreads the values out, which raises the entropy.
+	 *
+	 * @param _pfData reconstruction of _iSize by _iSize pixels
+	 */
+	static double sharpness(const float32* _pfData, int _iSize);
+
+	/** Get a description of the class.
+	 *
+	 * @return description string
+	 */
+	virtual std::string description() const;
+
+protected:
+
+	/** Initial clearing. Only to be used by constructors.
+	 */
+	void _clear();
+
+	/** Check this object.
+	 *
+	 * @return object initialized
+	 */
+	bool _check();
+
+	CFloat32ProjectionData2D* m_pSinogram;
+	float32 m_fSearchRange;
+	float32 m_fPrecision;
+	int m_iBinning;
+
+	float32 m_fOffset;
+	int m_iCandidateCount;
+
+};
+
+// inline functions
+inline std::string CCenterOfRotationAlgorithm::description() const { return CCenterOfRotationAlgorithm::type; };
+
+} // end namespace
+
+#endif
@@ -100,6 +100,11 @@ protected:
 
 	int m_iIteration;
 
+	/** The last run was aborted during the backprojection of an iteration,
+	 * after x and r were already updated. The next run resumes there.
+	 */
+	bool m_bResumeAtBP;
+
 public:
 	
 	// type of the algorithm, needed to register with CAlgorithmFactory
@@ -164,6 +169,18 @@ public:
 	 */
 	virtual void run(int _iNrIterations = 0);
 
+	/** Estimate the host memory of the r, w, z and p temporaries.
+	 */
+	virtual size_t getMemoryEstimate() const;
+
+	/** Get the norm of the residual sinogram b - A*x, computed with a
+	 *  deterministic reduction.
+	 *
+	 * @param _fNorm the norm is returned here
+	 * @return true if at least one iteration has been started
+	 */
+	virtual bool getResidualNorm(float32& _fNorm);
+
 	/** Get a description of the class.
 	 *
 	 * @return description string
@@ -0,0 +1,184 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#ifndef _INC_ASTRA_CGLSALGORITHM3D
+#define _INC_ASTRA_CGLSALGORITHM3D
+
+#include "Globals.h"
+#include "Config.h"
+
+#include "Algorithm.h"
+#include "ReconstructionAlgorithm3D.h"
+#include "CpuProjection3D.h"
+
+#include "Float32ProjectionData3DMemory.h"
+#include "Float32VolumeData3DMemory.h"
+
+namespace astra {
+
+/**
+ * \brief
+ * This class contains the CPU implementation of the 3D CGLS (Conjugate Gradient Least Squares) algorithm.
+ *
+ * The projections are done by CCpuProjection3D. For parallel beam
+ * geometries without detector tilt, and with an sf3d projector, the
+ * backprojection is the exact transpose of the forward projection. For
+ * other geometries it is only approximately so, and CGLS may stagnate
+ * after some iterations.
+ *
+ * Successive calls to run() continue the same CGLS iteration.
+ *
+ * \par XML Configuration
+ * \astra_xml_item{ProjectorId, integer, (optional) Identifier of a projector as it is stored in the ProjectorManager.}
+ * \astra_xml_item{ProjectionDataId, integer, Identifier of a projection data object as it is stored in the DataManager.}
+ * \astra_xml_item{ReconstructionDataId, integer, Identifier of a volume data object as it is stored in the DataManager.}
+ * \astra_xml_item_option{ReconstructionMaskId, integer, not used, Identifier of a volume data object that acts as a reconstruction mask. 1 = reconstruct on this voxel. 0 = don't reconstruct on this voxel.}
+ * \astra_xml_item_option{SinogramMaskId, integer, not used, Identifier of a projection data object that acts as a projection mask. 1 = reconstruct using this ray. 0 = don't use this ray while reconstructing.}
+ *
+ * \par MATLAB example
+ * \astra_code{
+ *		cfg = astra_struct('CGLS3D');\n
+ *		cfg.ProjectionDataId = sino_id;\n
+ *		cfg.ReconstructionDataId = recon_id;\n
+ *		alg_id = astra_mex_algorithm('create'\, cfg);\n
+ *		astra_mex_algorithm('iterate'\, alg_id\, 10);\n
+ *		astra_mex_algorithm('delete'\, alg_id);\n
+ * }
+ */
+class _AstraExport CCglsAlgorithm3D : public CReconstructionAlgorithm3D {
+
+protected:
+
+	/** Allocate the temporary data objects and prepare the projections.
+	 */
+	virtual void _init();
+
+	/** Check the values of this object.  If everything is ok, the object can be set to the initialized state.
+	 * The following statements are then guaranteed to hold:
+	 * - valid, packed data objects in memory
+	 * - a supported geometry
+	 */
+	virtual bool _check();
+
+	/** Apply the sinogram mask, if any. */
+	void _maskSinogram(CFloat32ProjectionData3DMemory* _pData);
+
+	/** Apply the reconstruction mask, if any. */
+	void _maskVolume(CFloat32VolumeData3DMemory* _pData);
+
+	CCpuProjection3D m_projection;
+
+	/** CGLS vectors: residual and projected search direction
+	 */
+	CFloat32ProjectionData3DMemory* r;
+	CFloat32ProjectionData3DMemory* w;
+
+	/** CGLS vectors: backprojected residual and search direction
+	 */
+	CFloat32VolumeData3DMemory* z;
+	CFloat32VolumeData3DMemory* p;
+
+	float32 gamma;
+
+	/** The number of performed iterations, 0 if CGLS has to be (re)started
+	 */
+	int m_iIteration;
+
+public:
+	
+	// type of the algorithm, needed to register with CAlgorithmFactory
+	static std::string type;
+	
+	/** Default constructor, does not initialize the object.
+	 */
+	CCglsAlgorithm3D();
+
+	/** Destructor.
+	 */
+	virtual ~CCglsAlgorithm3D();
+
+	/** Clear this class.
+	 */
+	virtual void clear();
+
+	/** Initialize the algorithm with a config object.
+	 *
+	 * @param _cfg Configuration Object
+	 * @return initialization successful?
+	 */
+	virtual bool initialize(const Config& _cfg);
+
+	/** Initialize class.
+	 *
+	 * @param _pProjector		Projector Object (optional).
+	 * @param _pSinogram		ProjectionData3D object containing the projection data.
+	 * @param _pReconstruction	VolumeData3D object for storing the reconstructed volume.
+	 * @return initialization successful?
+	 */
+	bool initialize(CProjector3D* _pProjector, 
+					CFloat32ProjectionData3DMemory* _pSinogram, 
+					CFloat32VolumeData3DMemory* _pReconstruction);
+
+	/** Get all information parameters
+	 *
+	 * @return map with all boost::any object
+	 */
+	virtual std::map<std::string,boost::any> getInformation();
+
+	/** Get a single piece of information represented as a boost::any
+	 *
+	 * @param _sIdentifier identifier string to specify which piece of information you want
+	 * @return boost::any object
+	 */
+	virtual boost::any getInformation(std::string _sIdentifier);
+
+	/** Perform a number of iterations.
+	 *
+	 * @param _iNrIterations amount of iterations to perform.
+	 */
+	virtual void run(int _iNrIterations = 0);
+
+	/** Get a description of the class.
+	 *
+	 * @return description string
+	 */
+	virtual std::string description() const;
+
+	/** Get the norm of the residual.
+	 *
+	 * @param _fNorm if available, the norm is returned here
+	 * @return true if CGLS has been started
+	 */
+	virtual bool getResidualNorm(float32& _fNorm);
+};
+
+// inline functions
+inline std::string CCglsAlgorithm3D::description() const { return CCglsAlgorithm3D::type; };
+
+} // end namespace
+
+#endif
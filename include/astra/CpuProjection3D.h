@@ -0,0 +1,142 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#ifndef _INC_ASTRA_CPUPROJECTION3D
+#define _INC_ASTRA_CPUPROJECTION3D
+
+#include <vector>
+
+#include "Globals.h"
+
+namespace astra {
+
+class CProjectionGeometry3D;
+class CVolumeGeometry3D;
+class CSparseMatrix;
+class CBrickedVolume3D;
+class CProjector3D;
+class CSeparableFootprintProjector3D;
+class CFloat32ProjectionData3DMemory;
+class CFloat32VolumeData3DMemory;
+
+/**
+ * Forward and backprojection of 3D data on the CPU, as used by the CPU 3D
+ * algorithms.
+ *
+ * Parallel beam geometries without detector tilt, where every detector row
+ * lies in one volume slice, are a stack of independent 2D problems. They
+ * are detected automatically by isSliceDecomposable(). For those, the
+ * linear3d weights of a single slice are computed once, as a sparse 2D
+ * system matrix, and applied to all slices in batches; the backprojection
+ * is then the exact transpose of the forward projection.
+ *
+ * When given an sf3d projector, its separable footprint forward and
+ * backprojection are used instead.
+ *
+ * All other geometries are forward projected with forwardProjectBricked(),
+ * and backprojected ray by ray with the same weights, so the
+ * backprojection is the exact transpose there as well. The backprojection
+ * is threaded over groups of angles, each scattering into its own copy of
+ * the volume, with as many copies as fit in the memory budget.
+ *
+ * Both paths require packed (unpitched) data objects.
+ */
+class _AstraExport CCpuProjection3D {
+public:
+	CCpuProjection3D();
+	~CCpuProjection3D();
+
+	/** Is this combination of geometries a stack of independent 2D slices?
+	 * This is the case for parallel3d, and for parallel3d_vec without z
+	 * component in the ray and detector u directions, when detector row i
+	 * lies in the centre plane of volume slice i.
+	 */
+	static bool isSliceDecomposable(const CProjectionGeometry3D* _pProjGeom,
+	                                const CVolumeGeometry3D* _pVolGeom);
+
+	/** Prepare for the given geometries. For decomposable geometries this
+	 * computes the 2D slice weights.
+	 *
+	 * @param _pProjector optional projector; only sf3d projectors change
+	 *                    the kernel, and they must match the geometries
+	 * @return false if the geometry is not supported or memory runs out
+	 */
+	bool initialize(const CProjectionGeometry3D* _pProjGeom,
+	                const CVolumeGeometry3D* _pVolGeom,
+	                CProjector3D* _pProjector = 0);
+
+	void clear();
+
+	bool isInitialized() const { return m_bInitialized; }
+
+	/** Does this use the 2D slice path? */
+	bool isSliceDecomposed() const { return m_pSliceMatrix != 0; }
+
+	/** Overwrite _pProjection with the forward projection of _pVolume.
+	 */
+	bool forwardProject(const CFloat32VolumeData3DMemory* _pVolume,
+	                    CFloat32ProjectionData3DMemory* _pProjection);
+
+	/** Overwrite _pVolume with the backprojection of _pProjection.
+	 */
+	bool backProject(const CFloat32ProjectionData3DMemory* _pProjection,
+	                 CFloat32VolumeData3DMemory* _pVolume);
+
+protected:
+	bool _checkData(const CFloat32VolumeData3DMemory* _pVolume,
+	                const CFloat32ProjectionData3DMemory* _pProjection) const;
+	bool _allocateBricked();
+	void _allocateScatterBuffers();
+	void _freeScatterBuffers();
+	bool _backProjectRays(const CFloat32ProjectionData3DMemory* _pProjection,
+	                      CFloat32VolumeData3DMemory* _pVolume);
+
+	bool m_bInitialized;
+	CProjectionGeometry3D* m_pProjGeom;
+	CVolumeGeometry3D* m_pVolGeom;
+
+	//< weights of one slice; rows are [angle][col], columns are [y][x]
+	CSparseMatrix* m_pSliceMatrix;
+
+	//< separable footprint projector, not owned
+	CSeparableFootprintProjector3D* m_pFootprintProjector;
+
+	//< scratch volume for the general path, allocated on first use
+	CBrickedVolume3D* m_pBricked;
+
+	//< volumes the general backprojection accumulates into, allocated on
+	//< first use; the first is the output volume and not owned
+	std::vector<float32*> m_pfScatterBuffers;
+
+private:
+	CCpuProjection3D(const CCpuProjection3D&);
+	CCpuProjection3D& operator=(const CCpuProjection3D&);
+};
+
+} // end namespace astra
+
+#endif
@@ -107,6 +107,8 @@ public:
 	void projectSingleProjection(int _iProjection, Policy& _policy) {}
 	template <typename Policy>
 	void projectSingleRay(int _iProjection, int _iDetector, Policy& _policy) {}
+	template <typename Policy>
+	void projectProjectionRange(int _iProjFrom, int _iProjTo, Policy& _policy) {}
 
 
 	/** Return the  type of this projector.
@@ -0,0 +1,110 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#ifndef _INC_ASTRA_DATABINNING
+#define _INC_ASTRA_DATABINNING
+
+#include "Globals.h"
+
+namespace astra {
+
+class CProjectionGeometry2D;
+class CVolumeGeometry2D;
+class CProjectionGeometry3D;
+class CVolumeGeometry3D;
+class CFloat32ProjectionData2D;
+class CFloat32VolumeData2D;
+class CFloat32ProjectionData3DMemory;
+class CFloat32VolumeData3DMemory;
+
+/**
+ * Binning of data objects by integer factors along each axis, with the
+ * matching geometries.
+ *
+ * Every factor must divide the size of its axis. A binned detector pixel
+ * or voxel covers the same area as the pixels it combines, and a binned
+ * projection has the mean of the vectors or angles of its projections.
+ *
+ * Volumes are averaged. 2D projections are summed over the detector and
+ * averaged over the angles, since the 2D projectors scale a ray by its
+ * detector width, as astra_downsample_sinogram does. 3D projections are
+ * averaged, since the 3D projectors give plain line integrals. With these
+ * conventions, binning the projection of a volume approximates projecting
+ * it with the binned geometry.
+ *
+ * The data functions return a new object with a new geometry, or NULL
+ * if the geometry is not supported, a factor does not divide its axis, or
+ * memory could not be allocated.
+ * The geometry functions return a new geometry, or NULL. The caller owns
+ * the results. The binning is threaded over the output rows on the
+ * CWorkerPool, and the inner loops are contiguous so they vectorize.
+ *
+ * Supported projection geometries are parallel, parallel_vec, fanflat,
+ * fanflat_vec, parallel3d, parallel3d_vec, cone and cone_vec.
+ */
+
+_AstraExport CProjectionGeometry2D* binProjectionGeometry2D(const CProjectionGeometry2D* _pGeometry,
+                                                            int _iAngleFactor, int _iDetectorFactor);
+
+_AstraExport CVolumeGeometry2D* binVolumeGeometry2D(const CVolumeGeometry2D* _pGeometry,
+                                                    int _iFactorX, int _iFactorY);
+
+_AstraExport CProjectionGeometry3D* binProjectionGeometry3D(const CProjectionGeometry3D* _pGeometry,
+                                                            int _iDetectorColFactor, int _iAngleFactor,
+                                                            int _iDetectorRowFactor);
+
+_AstraExport CVolumeGeometry3D* binVolumeGeometry3D(const CVolumeGeometry3D* _pGeometry,
+                                                    int _iFactorX, int _iFactorY, int _iFactorZ);
+
+_AstraExport CFloat32ProjectionData2D* binProjectionData2D(const CFloat32ProjectionData2D* _pData,
+                                                           int _iAngleFactor, int _iDetectorFactor);
+
+_AstraExport CFloat32VolumeData2D* binVolumeData2D(const CFloat32VolumeData2D* _pData,
+                                                   int _iFactorX, int _iFactorY);
+
+_AstraExport CFloat32ProjectionData3DMemory* binProjectionData3D(const CFloat32ProjectionData3DMemory* _pData,
+                                                                 int _iDetectorColFactor, int _iAngleFactor,
+                                                                 int _iDetectorRowFactor);
+
+_AstraExport CFloat32VolumeData3DMemory* binVolumeData3D(const CFloat32VolumeData3DMemory* _pData,
+                                                         int _iFactorX, int _iFactorY, int _iFactorZ);
+
+/** Sum blocks of _iFactorX by _iFactorY by _iFactorZ values of a
+ * _iWidth by _iHeight by _iDepth array, x fastest, and multiply by _fScale.
+ * The sizes must be multiples of the factors. The rows of the input and
+ * output start _iInPitch and _iOutPitch elements apart; 0 means packed rows.
+ *
+ * @return false if a buffer could not be allocated; the output is then incomplete
+ */
+_AstraExport bool binArray3D(const float32* _pfIn, int _iWidth, int _iHeight, int _iDepth,
+                             int _iFactorX, int _iFactorY, int _iFactorZ,
+                             float32 _fScale, float32* _pfOut,
+                             int _iInPitch = 0, int _iOutPitch = 0);
+
+}
+
+#endif
@@ -28,6 +28,8 @@ along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
 #ifndef _INC_ASTRA_DATAPROJECTOR
 #define _INC_ASTRA_DATAPROJECTOR
 
+#include <algorithm>
+
 #include "Projector2D.h"
 
 #include "TypeList.h"
@@ -36,6 +38,10 @@ along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
 
 #include "DataProjectorPolicies.h"
 
+#include "Algorithm.h"
+
+#include "WorkerPool.h"
+
 namespace astra
 {
 
@@ -50,6 +56,10 @@ public:
 	virtual void project() = 0;
 	virtual void projectSingleProjection(int _iProjection) = 0;
 	virtual void projectSingleRay(int _iProjection, int _iDetector) = 0;
+	virtual void projectProjectionRange(int _iProjFrom, int _iProjTo) = 0;
+	virtual void projectParallel() = 0;
+	virtual bool project(const CAlgorithmCheckpoint& _checkpoint) = 0;
+	virtual bool projectParallel(const CAlgorithmCheckpoint& _checkpoint) = 0;
 //	virtual void projectSingleVoxel(int _iRow, int _iCol) = 0;
 //	virtual void projectAllVoxels() = 0;
 };
@@ -78,6 +88,30 @@ public:
 
 	virtual void projectSingleRay(int _iProjection, int _iDetector);
 
+	virtual void projectProjectionRange(int _iProjFrom, int _iProjTo);
+
+	/** Compute projection of all rays, distributing the projections over
+	 * the worker pool. Each range of projections uses its own copy of the
+	 * policy, so this is only valid for policies that write exclusively to
+	 * ray-indexed data (forward projection), and not for policies that
+	 * accumulate into pixels (backprojection, pixel weights).
+	 */
+	virtual void projectParallel();
+
+	/** Compute projection of all rays in blocks of projections, checking
+	 * for an abort and reporting progress between blocks.
+	 *
+	 * @return false if the projection was aborted
+	 */
+	virtual bool project(const CAlgorithmCheckpoint& _checkpoint);
+
+	/** Like projectParallel(), checking for an abort between blocks of
+	 * projections. Progress is reported when all projections are done.
+	 *
+	 * @return false if the projection was aborted
+	 */
+	virtual bool projectParallel(const CAlgorithmCheckpoint& _checkpoint);
+
 //	virtual void projectSingleVoxel(int _iRow, int _iCol);
 
 //	virtual void projectAllVoxels();
@@ -134,6 +168,102 @@ void CDataProjector<Projector,Policy>::projectSingleRay(int _iProjection, int _i
 	m_pProjector->projectSingleRay(_iProjection, _iDetector, m_pPolicy);
 }
 
+//----------------------------------------------------------------------------------------
+/**
+ * Compute projection of a range of projections using the algorithm specific to the projector type
+*/
+template <typename Projector, typename Policy>
+void CDataProjector<Projector,Policy>::projectProjectionRange(int _iProjFrom, int _iProjTo)
+{
+	m_pProjector->projectProjectionRange(_iProjFrom, _iProjTo, m_pPolicy);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Number of projections between two checkpoints
+*/
+inline int checkpointBlockSize(int _iProjectionCount)
+{
+	// at most 64 checkpoints per pass over all projection angles
+	return (_iProjectionCount + 63) / 64;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Compute projection in blocks of projections, with checkpoints in between
+*/
+template <typename Projector, typename Policy>
+bool CDataProjector<Projector,Policy>::project(const CAlgorithmCheckpoint& _checkpoint)
+{
+	int iCount = m_pProjector->getProjectionGeometry()->getProjectionAngleCount();
+	int iBlock = checkpointBlockSize(iCount);
+	for (int iFrom = 0; iFrom < iCount; iFrom += iBlock) {
+		if (_checkpoint.shouldAbort())
+			return false;
+		int iTo = std::min(iFrom + iBlock, iCount);
+		m_pProjector->projectProjectionRange(iFrom, iTo, m_pPolicy);
+		_checkpoint.report(iTo, iCount);
+	}
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Functor projecting a range of projections with a private copy of the policy
+*/
+template <typename Projector, typename Policy>
+struct SProjectionRangeFunctor {
+	Projector* m_pProjector;
+	const Policy* m_pPolicy;
+	const CAlgorithmCheckpoint* m_pCheckpoint;
+	void operator()(int _iFrom, int _iTo) const {
+		Policy p = *m_pPolicy;
+		if (!m_pCheckpoint) {
+			m_pProjector->projectProjectionRange(_iFrom, _iTo, p);
+			return;
+		}
+		int iBlock = checkpointBlockSize(m_pProjector->getProjectionGeometry()->getProjectionAngleCount());
+		for (int iFrom = _iFrom; iFrom < _iTo; iFrom += iBlock) {
+			if (m_pCheckpoint->shouldAbort())
+				return;
+			m_pProjector->projectProjectionRange(iFrom, std::min(iFrom + iBlock, _iTo), p);
+		}
+	}
+};
+
+//----------------------------------------------------------------------------------------
+/**
+ * Compute projection, distributing the projections over the worker pool
+*/
+template <typename Projector, typename Policy>
+void CDataProjector<Projector,Policy>::projectParallel()
+{
+	SProjectionRangeFunctor<Projector, Policy> f;
+	f.m_pProjector = m_pProjector;
+	f.m_pPolicy = &m_pPolicy;
+	f.m_pCheckpoint = 0;
+	CWorkerPool::getSingleton().parallelFor(0, m_pProjector->getProjectionGeometry()->getProjectionAngleCount(), f);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Compute projection on the worker pool, with checkpoints
+*/
+template <typename Projector, typename Policy>
+bool CDataProjector<Projector,Policy>::projectParallel(const CAlgorithmCheckpoint& _checkpoint)
+{
+	SProjectionRangeFunctor<Projector, Policy> f;
+	f.m_pProjector = m_pProjector;
+	f.m_pPolicy = &m_pPolicy;
+	f.m_pCheckpoint = &_checkpoint;
+	int iCount = m_pProjector->getProjectionGeometry()->getProjectionAngleCount();
+	CWorkerPool::getSingleton().parallelFor(0, iCount, f);
+	if (_checkpoint.shouldAbort())
+		return false;
+	_checkpoint.report(iCount, iCount);
+	return true;
+}
+
 //----------------------------------------------------------------------------------------
 //template <typename Projector, typename Policy>
 //void CDataProjector<Projector,Policy>::projectSingleVoxel(int _iRow, int _iCol) 
@@ -318,6 +448,20 @@ static void projectData(CProjector2D* _pProjector, const Policy& _policy)
 	delete dp;
 }
 
+/**
+ * Data Projector Project, with checkpoints
+ *
+ * @return false if the projection was aborted
+ */
+template <typename Policy>
+static bool projectData(CProjector2D* _pProjector, const Policy& _policy, const CAlgorithmCheckpoint& _checkpoint)
+{
+	CDataProjectorInterface* dp = dispatchDataProjector(_pProjector, _policy);
+	bool bDone = dp->project(_checkpoint);
+	delete dp;
+	return bDone;
+}
+
 
 
 
@@ -196,6 +196,26 @@ public:
 	FORCEINLINE void pixelPosterior(int _iVolumeIndex);
 };
 
+//----------------------------------------------------------------------------------------
+/** Policy For Counting the Number of Weights
+ */
+class CountWeightsPolicy {
+
+	size_t* m_piCount;
+
+public:
+
+	FORCEINLINE CountWeightsPolicy();
+	FORCEINLINE CountWeightsPolicy(size_t* _piCount);
+	FORCEINLINE ~CountWeightsPolicy();
+
+	FORCEINLINE bool rayPrior(int _iRayIndex);
+	FORCEINLINE bool pixelPrior(int _iVolumeIndex);
+	FORCEINLINE void addWeight(int _iRayIndex, int _iVolumeIndex, float32 weight);
+	FORCEINLINE void rayPosterior(int _iRayIndex);
+	FORCEINLINE void pixelPosterior(int _iVolumeIndex);
+};
+
 
 //----------------------------------------------------------------------------------------
 /** Policy For Combining Two Policies
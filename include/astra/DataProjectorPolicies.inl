@@ -378,6 +378,51 @@ void TotalRayLengthPolicy::pixelPosterior(int _iVolumeIndex)
 //----------------------------------------------------------------------------------------
 
 
+//----------------------------------------------------------------------------------------
+// COUNT WEIGHTS (Ray+Pixel Driven)
+//----------------------------------------------------------------------------------------
+CountWeightsPolicy::CountWeightsPolicy() 
+{
+	m_piCount = 0;
+}
+//----------------------------------------------------------------------------------------
+CountWeightsPolicy::CountWeightsPolicy(size_t* _piCount) 
+{
+	m_piCount = _piCount;
+}
+//----------------------------------------------------------------------------------------	
+CountWeightsPolicy::~CountWeightsPolicy() 
+{
+
+}
+//----------------------------------------------------------------------------------------	
+bool CountWeightsPolicy::rayPrior(int _iRayIndex) 
+{
+	return true;
+}
+//----------------------------------------------------------------------------------------
+bool CountWeightsPolicy::pixelPrior(int _iVolumeIndex) 
+{
+	return true;
+}
+//----------------------------------------------------------------------------------------	
+void CountWeightsPolicy::addWeight(int _iRayIndex, int _iVolumeIndex, float32 _fWeight) 
+{
+	(*m_piCount)++;
+}
+//----------------------------------------------------------------------------------------
+void CountWeightsPolicy::rayPosterior(int _iRayIndex) 
+{
+	// nothing
+}
+//----------------------------------------------------------------------------------------
+void CountWeightsPolicy::pixelPosterior(int _iVolumeIndex) 
+{
+	// nothing
+}
+//----------------------------------------------------------------------------------------
+
+
 
 
 
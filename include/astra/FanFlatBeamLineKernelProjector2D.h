@@ -169,6 +169,16 @@ public:
 	template <typename Policy>
 	void projectSingleRay(int _iProjection, int _iDetector, Policy& _policy);
 
+	/** Policy-based projection of all rays of a range of projections.  This function will calculate
+	 * each non-zero projection weight and use this value for a task provided by the policy object.
+	 *
+	 * @param _iProjFrom First projection to project (inclusive).
+	 * @param _iProjTo Last projection to project (exclusive).
+	 * @param _policy Policy object.  Should contain prior, addWeight and posterior function.
+	 */
+	template <typename Policy>
+	void projectProjectionRange(int _iProjFrom, int _iProjTo, Policy& _policy);
+
 	/** Return the type of this projector.
 	 *
 	 * @return identification type of this projector
@@ -48,6 +48,13 @@ void CFanFlatBeamLineKernelProjector2D::projectSingleRay(int _iProjection, int _
 	                      _iDetector, _iDetector + 1, p);
 }
 
+template <typename Policy>
+void CFanFlatBeamLineKernelProjector2D::projectProjectionRange(int _iProjFrom, int _iProjTo, Policy& p)
+{
+	projectBlock_internal(_iProjFrom, _iProjTo,
+	                      0, m_pProjectionGeometry->getDetectorCount(), p);
+}
+
 //----------------------------------------------------------------------------------------
 // PROJECT BLOCK - vector projection geometry
 template <typename Policy>
@@ -47,6 +47,13 @@ void CFanFlatBeamStripKernelProjector2D::projectSingleRay(int _iProjection, int
 	                      _iDetector, _iDetector + 1, p);
 }
 
+template <typename Policy>
+void CFanFlatBeamStripKernelProjector2D::projectProjectionRange(int _iProjFrom, int _iProjTo, Policy& p)
+{
+	projectBlock_internal(_iProjFrom, _iProjTo,
+	                      0, m_pProjectionGeometry->getDetectorCount(), p);
+}
+
 //----------------------------------------------------------------------------------------
 // PROJECT BLOCK
 template <typename Policy>
@@ -0,0 +1,175 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#ifndef _INC_ASTRA_FANPARALLELREBINALGORITHM
+#define _INC_ASTRA_FANPARALLELREBINALGORITHM
+
+#include <vector>
+
+#include "Globals.h"
+#include "Config.h"
+#include "Algorithm.h"
+
+namespace astra {
+
+class CProjectionGeometry2D;
+class CParallelProjectionGeometry2D;
+class CFloat32ProjectionData2D;
+
+/**
+ * \brief
+ * This class rebins a fan beam sinogram into a parallel beam sinogram.
+ *
+ * Every parallel ray is a line through the circle of source positions, so
+ * it is measured by the fan projections where it meets that circle. Its
+ * value is interpolated bilinearly in source angle and fan angle from the
+ * two nearest fan projections. Rays outside of the measured range get 0.
+ * Like the projectors, every value is a line integral times the detector
+ * pixel size, so the values are rescaled to the parallel detector.
+ *
+ * The source positions must lie on a circle around the origin, in order of
+ * angle. The interpolation tables are computed once when initializing, so
+ * running is a gather of four samples per ray, threaded over the angles.
+ *
+ * \par XML Configuration
+ * \astra_xml_item{ProjectionDataId, integer, Identifier of the fan beam (fanflat or fanflat_vec) projection data object as it is stored in the DataManager.}
+ * \astra_xml_item{ParallelProjectionDataId, integer, Identifier of the resulting parallel beam (parallel or parallel_vec) projection data object as it is stored in the DataManager.}
+ *
+ * \par MATLAB example
+ * \astra_code{
+ *		cfg = astra_struct('FanParallelRebin');\n
+ *		cfg.ProjectionDataId = fan_sino_id;\n
+ *		cfg.ParallelProjectionDataId = par_sino_id;\n
+ *		alg_id = astra_mex_algorithm('create'\, cfg);\n
+ *		astra_mex_algorithm('run'\, alg_id);\n
+ *		astra_mex_algorithm('delete'\, alg_id);\n
+ * }
+ */
+class _AstraExport CFanParallelRebinAlgorithm : public CAlgorithm {
+
+public:
+
+	// type of the algorithm, needed to register with CAlgorithmFactory
+	static std::string type;
+
+	/** Default constructor, containing no code.
+	 */
+	CFanParallelRebinAlgorithm();
+
+	/** Destructor.
+	 */
+	virtual ~CFanParallelRebinAlgorithm();
+
+	/** Initialize the algorithm with a config object.
+	 *
+	 * @param _cfg Configuration Object
+	 * @return initialization successful?
+	 */
+	virtual bool initialize(const Config& _cfg);
+
+	/** Initialize class.
+	 *
+	 * @param _pFanSinogram			fan beam sinogram to rebin.
+	 * @param _pParallelSinogram	parallel beam sinogram for the result.
+	 * @return initialization successful?
+	 */
+	bool initialize(CFloat32ProjectionData2D* _pFanSinogram,
+	                CFloat32ProjectionData2D* _pParallelSinogram);
+
+	/** Get all information parameters
+	 *
+	 * @return map with all boost::any object
+	 */
+	virtual std::map<std::string,boost::any> getInformation();
+
+	/** Get a single piece of information represented as a boost::any
+	 *
+	 * @param _sIdentifier identifier string to specify which piece of information you want
+	 * @return boost::any object
+	 */
+	virtual boost::any getInformation(std::string _sIdentifier);
+
+	/** Rebin the fan beam sinogram into the parallel beam sinogram.
+	 *
+	 * @param _iNrIterations not used.
+	 */
+	virtual void run(int _iNrIterations = 0);
+
+	/** Estimate the host memory of the interpolation tables.
+	 */
+	virtual size_t getMemoryEstimate() const;
+
+	/** Get a description of the class.
+	 *
+	 * @return description string
+	 */
+	virtual std::string description() const;
+
+	/** Create a parallel beam geometry matching a fan beam geometry: the
+	 * detector is scaled to the origin, and the angles cover half a circle
+	 * with the same angular step. The caller owns the result.
+	 *
+	 * @param _pFanGeometry fanflat or fanflat_vec geometry.
+	 * @return parallel geometry, or NULL if the fan geometry is not supported
+	 *         or has fewer than two angles
+	 */
+	static CParallelProjectionGeometry2D* createParallelGeometry(CProjectionGeometry2D* _pFanGeometry);
+
+	/** Interpolation table entry for one parallel ray: the fan sinogram
+	 * offsets of four samples and their weights. Unused samples have
+	 * offset 0 and weight 0.
+	 */
+	struct SRebinEntry {
+		int iOffset[4];
+		float32 fWeight[4];
+	};
+
+protected:
+
+	/** Initial clearing. Only to be used by constructors.
+	 */
+	void _clear();
+
+	/** Check this object, and compute the interpolation tables.
+	 *
+	 * @return object initialized
+	 */
+	bool _check();
+
+	CFloat32ProjectionData2D* m_pFanSinogram;
+	CFloat32ProjectionData2D* m_pParallelSinogram;
+
+	std::vector<SRebinEntry> m_table;
+
+};
+
+// inline functions
+inline std::string CFanParallelRebinAlgorithm::description() const { return CFanParallelRebinAlgorithm::type; };
+
+} // end namespace
+
+#endif
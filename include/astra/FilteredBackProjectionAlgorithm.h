@@ -44,11 +44,18 @@ namespace astra {
  * This class contains the implementation of the filtered back projection (FBP)
  * reconstruction algorithm.
  *
+ * For fan beam geometries (fanflat and fanflat_vec), the sinogram is cosine
+ * weighted, Parker weighted for short scans, ramp filtered on the detector
+ * scaled to the origin, and backprojected pixel-driven with the inverse
+ * squared distance weighting.
+ *
  * \par XML Configuration
  * \astra_xml_item{ProjectorId, integer, Identifier of a projector as it is stored in the ProjectorManager.}
  * \astra_xml_item{VolumeDataId, integer, Identifier of the volume data object as it is stored in the DataManager.}
  * \astra_xml_item{ReconstructionDataId, integer, Identifier of the resulting projection data object as it is stored in the DataManager.}
  * \astra_xml_item_option{ProjectionIndex, integer, 0, Only reconstruct this specific projection angle. }
+ * \astra_xml_item_option{Timings, bool, false, Collect per-phase timings and counters for getInformation("Timings").}
+ * \astra_xml_item_option{PixelDriven, bool, false, Use the pixel-driven backprojector. Only for parallel and fan beam geometries.}
 
  * \par MATLAB example
  * \astra_code{
@@ -132,11 +139,32 @@ public:
 	 */
 	virtual void run(int _iNrIterations = 0);
 
+	/** Estimate the host memory of the filtered sinogram and filtering buffers.
+	 */
+	virtual size_t getMemoryEstimate() const;
+
 	/** Performs the filtering of the projection data.
 	 *
 	 * @param _pFilteredSinogram will contain filtered sinogram afterwards
+	 * @return false if the filtering buffers could not be allocated
+	 */
+	bool performFiltering(CFloat32ProjectionData2D * _pFilteredSinogram);
+
+	/** Ramp filters the rows of a sinogram in place, on the worker pool.
+	 *
+	 * @param _pfData sinogram data, _iAngleCount rows of _iDetectorCount values
+	 * @return false if the filtering buffers could not be allocated
+	 */
+	static bool rampFilter(float32* _pfData, int _iAngleCount, int _iDetectorCount);
+
+	/** Applies the fan beam cosine weights, Parker's short scan weights
+	 * when the source does not go round the full circle, and the angular
+	 * step and detector scaling, before filtering.
+	 *
+	 * @param _pFilteredSinogram sinogram to weight in place
+	 * @return success
 	 */
-	void performFiltering(CFloat32ProjectionData2D * _pFilteredSinogram);
+	bool performFanBeamWeighting(CFloat32ProjectionData2D * _pFilteredSinogram);
 
 	/** Get a description of the class.
 	 *
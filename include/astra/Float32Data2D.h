@@ -54,12 +54,13 @@ protected:
 	int m_iWidth;			///< width of the data (x)
 	int m_iHeight;			///< height of the data (y)
 	int m_iSize;			///< total size of the data
+	int m_iPitch;			///< distance between the starts of two rows, in elements
 
 	/** Pointer to the data block, represented as a 1-dimensional array.
 	 * Note that the data memory is "owned" by this class, meaning that the 
 	 * class is responsible for deallocation of the memory involved.
 	 * To access element (ix, iy) internally, use 
-	 * m_pData[iy * m_iWidth + ix]
+	 * m_pData[iy * m_iPitch + ix]
 	 */
 	float32* m_pfData;	
 
@@ -75,11 +76,13 @@ protected:
 
 	/** Allocate memory for m_pfData and m_ppfData2D arrays.
 	 *
-	 * The allocated block consists of m_iSize float32s. The block is
+	 * The allocated block consists of m_iPitch * m_iHeight float32s. The block is
 	 * not cleared after allocation and its contents is undefined. 
 	 * This function may NOT be called if memory has already been allocated.
+	 *
+	 * @return false if the allocation failed or exceeds the CMemoryBudget limit
 	 */
-	void _allocateData();
+	bool _allocateData();
 
 	/** Free memory for m_pfData and m_ppfData2D arrays.
 	 *
@@ -361,6 +364,35 @@ public:
 	 */
 	int getSize() const;
 
+	/** Get the number of bytes of host memory allocated by this object.
+	 *  Custom memory passed in at initialization is not included.
+	 *
+	 * @return size of the allocated memory, in bytes
+	 */
+	size_t getMemoryUsage() const;
+
+	/** Get the distance between the starts of two consecutive rows, in
+	 *  elements. This is the width, unless setRowPitch() padded the rows.
+	 */
+	int getRowPitch() const;
+
+	/** Are the rows stored without padding, so that getData() is a plain
+	 *  width x height array? Kernels that index getData() directly need
+	 *  this; row kernels should use getData2D() or the row pitch.
+	 */
+	bool isPacked() const;
+
+	/** Store the rows _iPitch elements apart, keeping the data. The padding
+	 *  after each row is zero. With _iPitch 0 the rows are padded to a
+	 *  multiple of DATA_ALIGNMENT bytes, so that every row starts on a
+	 *  cache line and threads writing different rows never share one.
+	 *  Not supported for custom memory.
+	 *
+	 * @param _iPitch new row pitch, at least the width, or 0
+	 * @return false if the pitch is invalid or the reallocation failed
+	 */
+	bool setRowPitch(int _iPitch = 0);
+
 	/** which type is this class?
 	 *
 	 * @return DataType: ASTRA_DATATYPE_FLOAT32_PROJECTION or
@@ -503,6 +535,31 @@ inline int CFloat32Data2D::getSize() const
 	return m_iSize;
 }
 
+//----------------------------------------------------------------------------------------
+// Get the number of bytes of host memory allocated by this object.
+inline size_t CFloat32Data2D::getMemoryUsage() const
+{
+	if (!m_bInitialized || m_pCustomMemory)
+		return 0;
+	return (size_t)m_iPitch * m_iHeight * sizeof(float32) + m_iHeight * sizeof(float32*);
+}
+
+//----------------------------------------------------------------------------------------
+// Get the distance between the starts of two rows.
+inline int CFloat32Data2D::getRowPitch() const
+{
+	ASTRA_ASSERT(m_bInitialized);
+	return m_iPitch;
+}
+
+//----------------------------------------------------------------------------------------
+// Are the rows stored without padding?
+inline bool CFloat32Data2D::isPacked() const
+{
+	ASTRA_ASSERT(m_bInitialized);
+	return m_iPitch == m_iWidth;
+}
+
 //----------------------------------------------------------------------------------------
 // Get a pointer to the data block, represented as a 1-dimensional array of float32 values.
 inline float32* CFloat32Data2D::getData()
@@ -97,6 +97,14 @@ public:
 	 */
 	int getSize() const;
 
+	/** Get the number of bytes of host memory allocated by this object.
+	 *  Custom memory passed in at initialization, and GPU memory, are not
+	 *  included.
+	 *
+	 * @return size of the allocated memory, in bytes
+	 */
+	virtual size_t getMemoryUsage() const { return 0; }
+
 	/** Which type is this class?
 	 *
 	 * @return DataType: PROJECTION or VOLUME
@@ -48,20 +48,24 @@ protected:
 	 * Note that the data memory is "owned" by this class, meaning that the 
 	 * class is responsible for deallocation of the memory involved.
 	 * To access element (ix, iy, iz) internally, use 
-	 * m_pData[iz * m_iWidth * m_iHeight + iy * m_iWidth + ix] 
+	 * m_pData[(iz * m_iHeight + iy) * m_iPitch + ix] 
 	 */
 	 float32* m_pfData;	
 
+	int m_iPitch;			///< distance between the starts of two rows, in elements
+
 	float32 m_fGlobalMin;	///< minimum value of the data
 	float32 m_fGlobalMax;	///< maximum value of the data
 
 	/** Allocate memory for m_pfData.
 	 *
-	 * The allocated block consists of m_iSize float32s. The block is
+	 * The allocated block consists of m_iPitch * m_iHeight * m_iDepth float32s. The block is
 	 * not cleared after allocation and its contents is undefined. 
 	 * This function may NOT be called if memory has already been allocated.
+	 *
+	 * @return false if the allocation failed or exceeds the CMemoryBudget limit
 	 */
-	void _allocateData();
+	bool _allocateData();
 
 	/** Free memory for m_pfData.
 	 *
@@ -237,6 +241,35 @@ public:
 	 */
 	virtual EDataType getType() const;
 
+	/** Get the number of bytes of host memory allocated by this object.
+	 *  Custom memory passed in at initialization is not included.
+	 */
+	virtual size_t getMemoryUsage() const { return (m_bInitialized && !m_pCustomMemory) ? (size_t)m_iPitch * m_iHeight * m_iDepth * sizeof(float32) : 0; }
+
+	/** Get the distance between the starts of two consecutive rows, in
+	 *  elements. This is the width, unless setRowPitch() padded the rows.
+	 */
+	int getRowPitch() const;
+
+	/** Are the rows stored without padding, so that getData() is a plain
+	 *  width x height x depth array?
+	 */
+	bool isPacked() const;
+
+	/** Get a pointer to row iy of slice iz.
+	 */
+	float32* getRow(int iy, int iz);
+	const float32* getRowConst(int iy, int iz) const;
+
+	/** Store the rows _iPitch elements apart, keeping the data. The padding
+	 *  after each row is zero. With _iPitch 0 the rows are padded to a
+	 *  multiple of DATA_ALIGNMENT bytes. Not supported for custom memory.
+	 *
+	 * @param _iPitch new row pitch, at least the width, or 0
+	 * @return false if the pitch is invalid or the reallocation failed
+	 */
+	bool setRowPitch(int _iPitch = 0);
+
 	/**
 	 * Clamp data to minimum value
 	 *
@@ -287,6 +320,38 @@ inline const float32* CFloat32Data3DMemory::getDataConst() const
 	return (const float32*)m_pfData;
 }
 
+//----------------------------------------------------------------------------------------
+// Get the distance between the starts of two rows.
+inline int CFloat32Data3DMemory::getRowPitch() const
+{
+	ASTRA_ASSERT(m_bInitialized);
+	return m_iPitch;
+}
+
+//----------------------------------------------------------------------------------------
+// Are the rows stored without padding?
+inline bool CFloat32Data3DMemory::isPacked() const
+{
+	ASTRA_ASSERT(m_bInitialized);
+	return m_iPitch == m_iWidth;
+}
+
+//----------------------------------------------------------------------------------------
+// Get a pointer to row iy of slice iz.
+inline float32* CFloat32Data3DMemory::getRow(int iy, int iz)
+{
+	ASTRA_ASSERT(m_bInitialized);
+	ASTRA_ASSERT(iy >= 0 && iy < m_iHeight && iz >= 0 && iz < m_iDepth);
+	return m_pfData + ((size_t)iz * m_iHeight + iy) * m_iPitch;
+}
+
+inline const float32* CFloat32Data3DMemory::getRowConst(int iy, int iz) const
+{
+	ASTRA_ASSERT(m_bInitialized);
+	ASTRA_ASSERT(iy >= 0 && iy < m_iHeight && iz >= 0 && iz < m_iDepth);
+	return m_pfData + ((size_t)iz * m_iHeight + iy) * m_iPitch;
+}
+
 } // end namespace astra
 
 #endif // _INC_ASTRA_FLOAT32DATA2D
@@ -0,0 +1,142 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#ifndef _INC_ASTRA_FORWARDPROJECTIONALGORITHM3D
+#define _INC_ASTRA_FORWARDPROJECTIONALGORITHM3D
+
+#include "Globals.h"
+
+#include "Algorithm.h"
+#include "CpuProjection3D.h"
+
+#include "Float32ProjectionData3DMemory.h"
+#include "Float32VolumeData3DMemory.h"
+
+namespace astra {
+
+class CProjector3D;
+
+/**
+ * \brief
+ * This class computes the 3D forward projection of a volume on the CPU.
+ *
+ * Parallel beam geometries without detector tilt are projected slice by
+ * slice with 2D weights, see CCpuProjection3D; other geometries use the
+ * bricked linear kernel. The weights are those of the linear3d projector.
+ *
+ * \par XML Configuration
+ * \astra_xml_item{ProjectorId, integer, (optional) Identifier of a projector as it is stored in the ProjectorManager.}
+ * \astra_xml_item{ProjectionDataId, integer, Identifier of the projection data object as it is stored in the DataManager.}
+ * \astra_xml_item{VolumeDataId, integer, Identifier of the volume data object as it is stored in the DataManager.}
+ *
+ * \par MATLAB example
+ * \astra_code{
+ *		cfg = astra_struct('FP3D');\n
+ *		cfg.ProjectionDataId = sino_id;\n
+ *		cfg.VolumeDataId = vol_id;\n
+ *		alg_id = astra_mex_algorithm('create'\, cfg);\n
+ *		astra_mex_algorithm('run'\, alg_id);\n
+ * }
+ */
+class _AstraExport CForwardProjectionAlgorithm3D : public CAlgorithm
+{
+public:
+
+	// type of the algorithm, needed to register with CAlgorithmFactory
+	static std::string type;
+	
+	/** Default constructor, containing no code.
+	 */
+	CForwardProjectionAlgorithm3D();
+	
+	/** Destructor.
+	 */
+	virtual ~CForwardProjectionAlgorithm3D();
+
+	/** Initialize the algorithm with a config object.
+	 *
+	 * @param _cfg Configuration Object
+	 * @return initialization successful?
+	 */
+	virtual bool initialize(const Config& _cfg);
+
+	/** Initialize class.
+	 *
+	 * @param _pProjector		Projector Object (optional).
+	 * @param _pProjections		ProjectionData3D object for storing the projection data.
+	 * @param _pVolume			VolumeData3D object containing the volume.
+	 * @return initialization successful?
+	 */
+	bool initialize(CProjector3D* _pProjector, 
+					CFloat32ProjectionData3D* _pProjections, 
+					CFloat32VolumeData3D* _pVolume);
+
+	/** Get all information parameters
+	 *
+	 * @return map with all boost::any object
+	 */
+	virtual std::map<std::string,boost::any> getInformation();
+
+	/** Get a single piece of information represented as a boost::any
+	 *
+	 * @param _sIdentifier identifier string to specify which piece of information you want
+	 * @return boost::any object
+	 */
+	virtual boost::any getInformation(std::string _sIdentifier);
+
+	/** Compute the forward projection.
+	 *
+	 * @param _iNrIterations Not used.
+	 */
+	virtual void run(int _iNrIterations = 0);
+
+	/** Get a description of the class.
+	 *
+	 * @return description string
+	 */
+	virtual std::string description() const;
+
+	/** Check this object.
+	 *
+	 * @return object initialized
+	 */
+	bool check();
+
+protected:
+	CProjector3D* m_pProjector;
+	CFloat32ProjectionData3DMemory* m_pProjections;
+	CFloat32VolumeData3DMemory* m_pVolume;
+
+	CCpuProjection3D m_projection;
+};
+
+// inline functions
+inline std::string CForwardProjectionAlgorithm3D::description() const { return CForwardProjectionAlgorithm3D::type; };
+
+} // end namespace
+
+#endif
@@ -89,6 +89,13 @@ along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
 
 #endif
 
+// thread-local storage for POD types
+#ifdef _MSC_VER
+#define ASTRA_THREAD_LOCAL __declspec(thread)
+#else
+#define ASTRA_THREAD_LOCAL __thread
+#endif
+
 
 //----------------------------------------------------------------------------------------
 // typedefs
@@ -0,0 +1,85 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+#ifndef _INC_ASTRA_HOSTMEMORY
+#define _INC_ASTRA_HOSTMEMORY
+
+#include <cstddef>
+
+#include "Globals.h"
+
+namespace astra {
+
+/**
+ * Allocation of the large host blocks of data objects and sparse matrices,
+ * optionally backed by huge pages to reduce TLB misses.
+ *
+ * HUGEPAGES_NONE: plain aligned allocation.
+ * HUGEPAGES_TRANSPARENT: the block is aligned to 2 MiB and marked with
+ * madvise(MADV_HUGEPAGE), so that the kernel can back it with transparent
+ * huge pages even when THP is set to "madvise" only.
+ * HUGEPAGES_EXPLICIT_2M, HUGEPAGES_EXPLICIT_1G: the block is mapped from
+ * the hugetlbfs pool of that page size. These need pages reserved by the
+ * administrator (vm.nr_hugepages); if none are available, the allocation
+ * falls back to transparent huge pages.
+ *
+ * The policy can also be set with the ASTRA_HUGEPAGES environment variable
+ * (none, thp, 2m or 1g). It only applies to blocks of at least
+ * HUGEPAGE_MIN_BYTES, and outside Linux all policies fall back to plain
+ * allocation.
+ */
+enum EHugePagePolicy {
+	HUGEPAGES_NONE,
+	HUGEPAGES_TRANSPARENT,
+	HUGEPAGES_EXPLICIT_2M,
+	HUGEPAGES_EXPLICIT_1G
+};
+
+const size_t HUGEPAGE_MIN_BYTES = 8 << 20;
+
+/** Alignment of the data blocks of data objects: one cache line, and the
+ *  width of an AVX-512 register.
+ */
+const size_t DATA_ALIGNMENT = 64;
+
+_AstraExport void setHugePagePolicy(EHugePagePolicy _ePolicy);
+_AstraExport EHugePagePolicy getHugePagePolicy();
+
+/** Allocate _iBytes bytes aligned to _iAlignment (a power of two), with the
+ *  current huge page policy.
+ *
+ * @return the block, or NULL if it could not be allocated
+ */
+_AstraExport void* allocateHostMemory(size_t _iBytes, size_t _iAlignment = 16);
+
+/** Free a block from allocateHostMemory. _iBytes is the size it was
+ *  allocated with.
+ */
+_AstraExport void freeHostMemory(void* _pData, size_t _iBytes);
+
+} // namespace astra
+
+#endif
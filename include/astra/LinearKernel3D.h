@@ -0,0 +1,188 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#ifndef _INC_ASTRA_LINEARKERNEL3D
+#define _INC_ASTRA_LINEARKERNEL3D
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "Globals.h"
+#include "GeometryUtil3D.h"
+
+namespace astra {
+
+class CVolumeGeometry3D;
+class CProjectionGeometry3D;
+
+/**
+ * The voxel grid of a 3D volume geometry. Voxel (x, y, z) has its centre at
+ * (fMinX + (x + 0.5) * fPixelX, fMinY + (y + 0.5) * fPixelY, ...).
+ */
+struct _AstraExport SVolumeGrid3D {
+	int iCols, iRows, iSlices;
+	double fMinX, fMinY, fMinZ;
+	double fPixelX, fPixelY, fPixelZ;
+
+	void set(const CVolumeGeometry3D* _pGeom);
+};
+
+/**
+ * The projection vectors of a parallel3d(_vec) or cone(_vec) geometry, in
+ * the form of GeometryUtil3D.
+ */
+struct _AstraExport SProjectionVectors3D {
+	bool bCone;
+	int iAngles, iRows, iCols;
+	std::vector<SPar3DProjection> par;
+	std::vector<SConeProjection> cone;
+
+	/** @return false if the geometry is not one of the four supported types
+	 */
+	bool set(const CProjectionGeometry3D* _pGeom);
+
+	/** The ray through the centre of detector pixel (_iCol, _iRow) of
+	 *  projection _iAngle: a point on the ray and its direction. For cone
+	 *  beams the point is the source and the direction ends on the detector.
+	 */
+	void getRay(int _iAngle, int _iRow, int _iCol, double& _fX, double& _fY, double& _fZ,
+	            double& _fDX, double& _fDY, double& _fDZ) const;
+};
+
+//----------------------------------------------------------------------------------------
+// Visit one voxel; AXIS is the axis the ray is stepping along.
+template <int AXIS, class V>
+inline void _visitLinear3D(V& _visit, int _iA, int _i1, int _i2, float32 _fWeight)
+{
+	if (AXIS == 0)
+		_visit(_iA, _i1, _i2, _fWeight);
+	else if (AXIS == 1)
+		_visit(_i1, _iA, _i2, _fWeight);
+	else
+		_visit(_i1, _i2, _iA, _fWeight);
+}
+
+template <int AXIS, class V>
+void _traceLinearRay3D(int _iN, int _iN1, int _iN2, double _fC, double _fD,
+                       double _fC1, double _fD1, double _fC2, double _fD2,
+                       double _fLength, V& _visit)
+{
+	// position in the other two axes per unit step along the main axis
+	const double fS1 = _fD1 / _fD;
+	const double fS2 = _fD2 / _fD;
+	const float32 fWeight = (float32)(_fLength / std::fabs(_fD));
+
+	// restrict to the planes where both coordinates are within (-1, N)
+	double fLo = 0.0, fHi = _iN - 1;
+	const double fN[2] = { (double)_iN1, (double)_iN2 };
+	const double fC[2] = { _fC1 - _fC * fS1, _fC2 - _fC * fS2 };
+	const double fS[2] = { fS1, fS2 };
+	for (int k = 0; k < 2; ++k) {
+		if (fS[k] == 0.0) {
+			if (fC[k] <= -1.0 || fC[k] >= fN[k])
+				return;
+			continue;
+		}
+		double fA = (-1.0 - fC[k]) / fS[k];
+		double fB = (fN[k] - fC[k]) / fS[k];
+		if (fA > fB)
+			std::swap(fA, fB);
+		if (fA > fLo) fLo = fA;
+		if (fB < fHi) fHi = fB;
+	}
+	if (fLo > fHi)
+		return;
+
+	const int iFirst = (int)std::floor(fLo);
+	const int iLast = (int)std::ceil(fHi);
+	for (int i = (iFirst < 0 ? 0 : iFirst); i <= iLast && i < _iN; ++i) {
+		const double fP1 = fC[0] + i * fS1;
+		const double fP2 = fC[1] + i * fS2;
+		if (fP1 <= -1.0 || fP1 >= _iN1 || fP2 <= -1.0 || fP2 >= _iN2)
+			continue;
+		const int i1 = (int)std::floor(fP1);
+		const int i2 = (int)std::floor(fP2);
+		const float32 f1 = (float32)(fP1 - i1);
+		const float32 f2 = (float32)(fP2 - i2);
+		if (i2 >= 0) {
+			if (i1 >= 0)
+				_visitLinear3D<AXIS>(_visit, i, i1, i2, fWeight * (1.0f - f1) * (1.0f - f2));
+			if (i1 + 1 < _iN1)
+				_visitLinear3D<AXIS>(_visit, i, i1 + 1, i2, fWeight * f1 * (1.0f - f2));
+		}
+		if (i2 + 1 < _iN2) {
+			if (i1 >= 0)
+				_visitLinear3D<AXIS>(_visit, i, i1, i2 + 1, fWeight * (1.0f - f1) * f2);
+			if (i1 + 1 < _iN1)
+				_visitLinear3D<AXIS>(_visit, i, i1 + 1, i2 + 1, fWeight * f1 * f2);
+		}
+	}
+}
+
+/**
+ * Trace a ray through a voxel grid with the linear (Joseph) kernel.
+ *
+ * The ray steps through the planes of voxels perpendicular to the axis it
+ * is most aligned with. In every plane it is sampled where it crosses the
+ * voxel centres, and the four surrounding voxels get bilinear weights times
+ * the length of the ray between two planes. Voxels outside the grid count
+ * as zero. The visitor is called as _visit(x, y, z, weight) for every
+ * voxel with a (possibly zero) weight, in order along the main axis.
+ *
+ * @param _grid voxel grid
+ * @param _fX,_fY,_fZ a point on the ray
+ * @param _fDX,_fDY,_fDZ direction of the ray, of any nonzero length
+ * @param _visit functor receiving the voxels and weights
+ */
+template <class V>
+void traceLinearRay3D(const SVolumeGrid3D& _grid, double _fX, double _fY, double _fZ,
+                      double _fDX, double _fDY, double _fDZ, V& _visit)
+{
+	// in voxel units, with voxel i centred at coordinate i
+	const double fCX = (_fX - _grid.fMinX) / _grid.fPixelX - 0.5;
+	const double fCY = (_fY - _grid.fMinY) / _grid.fPixelY - 0.5;
+	const double fCZ = (_fZ - _grid.fMinZ) / _grid.fPixelZ - 0.5;
+	const double fDX = _fDX / _grid.fPixelX;
+	const double fDY = _fDY / _grid.fPixelY;
+	const double fDZ = _fDZ / _grid.fPixelZ;
+	const double fLength = std::sqrt(_fDX * _fDX + _fDY * _fDY + _fDZ * _fDZ);
+
+	const double fAX = std::fabs(fDX), fAY = std::fabs(fDY), fAZ = std::fabs(fDZ);
+	if (fAX == 0.0 && fAY == 0.0 && fAZ == 0.0)
+		return;
+	if (fAX >= fAY && fAX >= fAZ)
+		_traceLinearRay3D<0>(_grid.iCols, _grid.iRows, _grid.iSlices, fCX, fDX, fCY, fDY, fCZ, fDZ, fLength, _visit);
+	else if (fAY >= fAZ)
+		_traceLinearRay3D<1>(_grid.iRows, _grid.iCols, _grid.iSlices, fCY, fDY, fCX, fDX, fCZ, fDZ, fLength, _visit);
+	else
+		_traceLinearRay3D<2>(_grid.iSlices, _grid.iCols, _grid.iRows, fCZ, fDZ, fCX, fDX, fCY, fDY, fLength, _visit);
+}
+
+} // end namespace astra
+
+#endif
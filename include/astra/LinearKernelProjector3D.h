@@ -0,0 +1,142 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#ifndef _INC_ASTRA_LINEARKERNELPROJECTOR3D
+#define _INC_ASTRA_LINEARKERNELPROJECTOR3D
+
+#include "Projector3D.h"
+#include "LinearKernel3D.h"
+
+namespace astra
+{
+
+class CProjectionGeometry3D;
+class CVolumeGeometry3D;
+
+/** This class implements a three-dimensional CPU projector based on a
+ * linearly interpolated (Joseph) kernel, see traceLinearRay3D(). It
+ * supports parallel3d, parallel3d_vec, cone and cone_vec geometries, and
+ * computes the weights of single rays, so that explicit system matrices
+ * can be built with CProjector3D::getMatrix() and writeMatrix(). Voxels
+ * are indexed as (z * rows + y) * cols + x. The weights are plain
+ * intersection lengths.
+ *
+ * \par XML Configuration
+ * \astra_xml_item{ProjectionGeometry, xml node, The geometry of the projection.}
+ * \astra_xml_item{VolumeGeometry, xml node, The geometry of the volume.}
+ *
+ * \par MATLAB example
+ * \astra_code{
+ *		cfg = astra_struct('linear3d');\n
+ *		cfg.ProjectionGeometry = proj_geom;\n
+ *		cfg.VolumeGeometry = vol_geom;\n
+ *		proj_id = astra_mex_projector3d('create'\, cfg);\n
+ * }
+ */
+class _AstraExport CLinearKernelProjector3D : public CProjector3D {
+protected:
+	/** Initial clearing. Only to be used by constructors.
+	 */
+	void _clear();
+
+	/** Check the values of this object, and set up the ray vectors.
+	 */
+	bool _check();
+
+	SVolumeGrid3D m_grid;
+	SProjectionVectors3D m_vectors;
+
+public:
+	// type of the projector, needed to register with CProjectorFactory
+	static std::string type;
+
+	/** Default constructor.
+	 */
+	CLinearKernelProjector3D();
+
+	/** Constructor.
+	 *
+	 * @param _pProjectionGeometry Geometry of the projection. Will be HARDCOPIED.
+	 * @param _pVolumeGeometry Geometry of the volume. Will be HARDCOPIED.
+	 */
+	CLinearKernelProjector3D(const CProjectionGeometry3D* _pProjectionGeometry,
+	                         const CVolumeGeometry3D* _pVolumeGeometry);
+
+	/** Destructor.
+	 */
+	virtual ~CLinearKernelProjector3D();
+
+	/** Initialize the projector with a config object.
+	 *
+	 * @param _cfg Configuration Object
+	 * @return initialization successful?
+	 */
+	virtual bool initialize(const Config& _cfg);
+
+	/** Initialize the projector.
+	 *
+	 * @param _pProjectionGeometry Geometry of the projection. Will be HARDCOPIED.
+	 * @param _pVolumeGeometry Geometry of the volume. Will be HARDCOPIED.
+	 * @return initialization successful?
+	 */
+	bool initialize(const CProjectionGeometry3D* _pProjectionGeometry,
+	                const CVolumeGeometry3D* _pVolumeGeometry);
+
+	/** Clear this class.
+	 */
+	void clear();
+
+	/** Compute the voxel weights of the ray through the centre of detector
+	 *  pixel (_iDetectorIndex, _iSliceIndex) of projection _iProjectionIndex.
+	 *  Voxels with zero weight are left out. This function may be called
+	 *  from several threads at once.
+	 */
+	virtual void computeSingleRayWeights(int _iProjectionIndex, int _iSliceIndex, int _iDetectorIndex,
+	                                     SPixelWeight* _pWeightedPixels, int _iMaxPixelCount,
+	                                     int& _iStoredPixelCount);
+
+	/** Upper bound on the number of weights of a single ray: four voxels in
+	 *  every plane along the longest axis of the volume.
+	 */
+	virtual int getProjectionWeightsCount(int _iProjectionIndex);
+
+	/** Return the type of this projector.
+	 *
+	 * @return identification type of this projector
+	 */
+	virtual std::string getType() { return type; }
+
+	/** get a description of the class
+	 *
+	 * @return description string
+	 */
+	virtual std::string description() const;
+};
+
+} // namespace astra
+
+#endif
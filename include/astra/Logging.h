@@ -30,7 +30,16 @@ along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
 
 #include "astra/Globals.h"
 
+#include <cstdarg>
+
+// Debug messages are only compiled in when ASTRA_DEBUG_LOG is defined
+// (configure --enable-debug-log), or in MSVC debug builds. Otherwise the
+// call is removed by the compiler, but its arguments are still type-checked.
+#if defined(ASTRA_DEBUG_LOG) || defined(_DEBUG)
 #define ASTRA_DEBUG(...) astra::CLogger::debug(__FILE__,__LINE__, __VA_ARGS__)
+#else
+#define ASTRA_DEBUG(...) do { if (false) astra::CLogger::debug(__FILE__,__LINE__, __VA_ARGS__); } while (false)
+#endif
 #define ASTRA_INFO(...) astra::CLogger::info(__FILE__,__LINE__, __VA_ARGS__)
 #define ASTRA_WARN(...) astra::CLogger::warn(__FILE__,__LINE__, __VA_ARGS__)
 #define ASTRA_ERROR(...) astra::CLogger::error(__FILE__,__LINE__, __VA_ARGS__)
@@ -53,8 +62,13 @@ class _AstraExport CLogger
   static bool m_bEnabledScreen;
   static bool m_bFileProvided;
   static bool m_bInitialized;
+  static bool m_bAsync;
+  static bool m_bCallbackScreen;
+  static log_level m_eLevelScreen;
+  static log_level m_eLevelFile;
   static void _assureIsInitialized();
   static void _setLevel(int id, log_level m_eLevel);
+  static void _log(log_level m_eLevel, const char *sfile, int sline, const char *fmt, va_list ap);
 
 public:
 
@@ -151,6 +165,25 @@ public:
    */
   static bool setCallbackScreen(void (*cb)(const char *msg, size_t len));
 
+  /**
+   * Enable or disable asynchronous logging (enabled by default).
+   *
+   * In asynchronous mode, a log call only formats the message and puts it
+   * in a lock-free queue. A background thread writes the queued messages.
+   * If the queue is full, messages are dropped and the number of dropped
+   * messages is logged later. Messages to a screen callback are always
+   * written synchronously, since callbacks such as mexPrintf may only be
+   * called from the host application's thread.
+   *
+   */
+  static void setAsync(bool async);
+
+  /**
+   * Write all queued messages. Returns when the queue is empty.
+   *
+   */
+  static void flush();
+
 };
 
 }
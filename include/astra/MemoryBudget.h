@@ -0,0 +1,91 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#ifndef _INC_ASTRA_MEMORYBUDGET
+#define _INC_ASTRA_MEMORYBUDGET
+
+#include <cstddef>
+
+#include "Globals.h"
+#include "Singleton.h"
+#include "Mutex.h"
+
+namespace astra {
+
+/**
+ * Accounting of the host memory allocated by the library for data objects
+ * and scratch buffers, with an optional cap.
+ *
+ * Allocations that would exceed the cap fail cleanly: the data object
+ * isn't initialized, and algorithms fail to initialize or run. The cap can
+ * also be set with the ASTRA_MEMORY_LIMIT environment variable, in bytes.
+ */
+class _AstraExport CMemoryBudget : public Singleton<CMemoryBudget> {
+public:
+	CMemoryBudget();
+	virtual ~CMemoryBudget();
+
+	/** Account for an allocation of _iBytes bytes.
+	 *
+	 * @return false if this would exceed the limit, in which case nothing is accounted
+	 */
+	bool reserve(size_t _iBytes);
+
+	/** Account for freeing _iBytes bytes obtained from reserve().
+	 */
+	void release(size_t _iBytes);
+
+	/** Would an allocation of _iBytes bytes fit in the limit?
+	 */
+	bool fits(size_t _iBytes);
+
+	/** Set the maximum number of bytes accounted at the same time. 0 means
+	 *  unlimited. Memory that is already allocated is not affected.
+	 */
+	void setLimit(size_t _iBytes);
+	size_t getLimit();
+
+	/** Number of bytes currently accounted.
+	 */
+	size_t getUsed();
+
+	/** Highest number of bytes accounted at the same time since the last
+	 *  call to resetPeak().
+	 */
+	size_t getPeak();
+	void resetPeak();
+
+private:
+	CMutex m_mutex;
+	size_t m_iUsed;
+	size_t m_iPeak;
+	size_t m_iLimit;
+};
+
+} // end namespace
+
+#endif
@@ -0,0 +1,114 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#ifndef _INC_ASTRA_MUTEX
+#define _INC_ASTRA_MUTEX
+
+#include "Globals.h"
+
+#ifdef USE_PTHREADS
+#include <pthread.h>
+#else
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#endif
+
+namespace astra {
+
+/**
+ * A non-recursive mutex.
+ */
+class CMutex {
+public:
+#ifdef USE_PTHREADS
+	CMutex() { pthread_mutex_init(&m_mutex, 0); }
+	~CMutex() { pthread_mutex_destroy(&m_mutex); }
+	void lock() { pthread_mutex_lock(&m_mutex); }
+	void unlock() { pthread_mutex_unlock(&m_mutex); }
+private:
+	pthread_mutex_t m_mutex;
+#else
+	void lock() { m_mutex.lock(); }
+	void unlock() { m_mutex.unlock(); }
+private:
+	boost::mutex m_mutex;
+#endif
+
+	CMutex(const CMutex&);
+	CMutex& operator=(const CMutex&);
+
+	friend class CCondition;
+};
+
+/**
+ * Locks a mutex for the lifetime of the object.
+ */
+class CMutexLock {
+public:
+	explicit CMutexLock(CMutex& _mutex) : m_mutex(_mutex) { m_mutex.lock(); }
+	~CMutexLock() { m_mutex.unlock(); }
+private:
+	CMutex& m_mutex;
+
+	CMutexLock(const CMutexLock&);
+	CMutexLock& operator=(const CMutexLock&);
+};
+
+/**
+ * A condition variable, used together with a CMutex.
+ */
+class CCondition {
+public:
+#ifdef USE_PTHREADS
+	CCondition() { pthread_cond_init(&m_cond, 0); }
+	~CCondition() { pthread_cond_destroy(&m_cond); }
+	/** Atomically unlock the mutex and wait. The mutex must be locked by
+	 *  the calling thread, and is locked again when this returns. */
+	void wait(CMutex& _mutex) { pthread_cond_wait(&m_cond, &_mutex.m_mutex); }
+	void notifyAll() { pthread_cond_broadcast(&m_cond); }
+private:
+	pthread_cond_t m_cond;
+#else
+	/** Atomically unlock the mutex and wait. The mutex must be locked by
+	 *  the calling thread, and is locked again when this returns. */
+	void wait(CMutex& _mutex) {
+		boost::unique_lock<boost::mutex> lock(_mutex.m_mutex, boost::adopt_lock);
+		m_cond.wait(lock);
+		lock.release();
+	}
+	void notifyAll() { m_cond.notify_all(); }
+private:
+	boost::condition_variable m_cond;
+#endif
+
+	CCondition(const CCondition&);
+	CCondition& operator=(const CCondition&);
+};
+
+} // end namespace
+
+#endif
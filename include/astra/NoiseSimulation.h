@@ -0,0 +1,105 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+#ifndef _INC_ASTRA_NOISESIMULATION
+#define _INC_ASTRA_NOISESIMULATION
+
+#include <stdint.h>
+
+#include "Globals.h"
+
+namespace astra {
+
+class CFloat32ProjectionData2D;
+class CFloat32ProjectionData3DMemory;
+
+/**
+ * Simulation of measurement noise on projection data, in place.
+ *
+ * The random numbers come from a counter-based generator (Philox4x32-10)
+ * keyed by the seed. The numbers for element i depend only on the seed,
+ * the stream and i, so the result is the same for any number of threads
+ * and any split of the work. Different streams with the same seed give
+ * independent realisations, for example one stream per noisy copy of
+ * a sinogram. The elements are processed in parallel on the CWorkerPool.
+ *
+ * The functions return false, and leave the data untouched, if a
+ * parameter is out of range or a data object has padded rows.
+ */
+
+/** Apply transmission Poisson noise.
+ *
+ * A projection value p is taken to correspond to I = I0 * exp(-p * scale)
+ * detected photons. A Poisson sample N with mean I replaces it by
+ * -log(N / I0) / scale. N = 0 is counted as a single photon, so that
+ * the result stays finite.
+ *
+ * @param _pfData data to add noise to
+ * @param _iSize number of elements
+ * @param _fI0 incident (flat field) photon count per detector pixel
+ * @param _fScale factor converting the projection values to line integrals of the attenuation
+ * @param _iSeed generator seed
+ * @param _iStream index of the realisation
+ */
+_AstraExport bool addPoissonNoise(float32* _pfData, size_t _iSize, float32 _fI0, float32 _fScale,
+                                  uint64_t _iSeed, unsigned int _iStream = 0);
+
+/** Add zero-mean Gaussian noise with standard deviation _fSigma.
+ *
+ * @param _pfData data to add noise to
+ * @param _iSize number of elements
+ * @param _fSigma standard deviation of the noise
+ * @param _iSeed generator seed
+ * @param _iStream index of the realisation
+ */
+_AstraExport bool addGaussianNoise(float32* _pfData, size_t _iSize, float32 _fSigma,
+                                   uint64_t _iSeed, unsigned int _iStream = 0);
+
+/** Apply transmission Poisson noise to a 2D projection data object.
+ *  See addPoissonNoise(float32*, ...).
+ */
+_AstraExport bool addPoissonNoise(CFloat32ProjectionData2D* _pData, float32 _fI0, float32 _fScale,
+                                  uint64_t _iSeed, unsigned int _iStream = 0);
+
+/** Apply transmission Poisson noise to a 3D projection data object.
+ *  See addPoissonNoise(float32*, ...).
+ */
+_AstraExport bool addPoissonNoise(CFloat32ProjectionData3DMemory* _pData, float32 _fI0, float32 _fScale,
+                                  uint64_t _iSeed, unsigned int _iStream = 0);
+
+/** Add Gaussian noise to a 2D projection data object.
+ */
+_AstraExport bool addGaussianNoise(CFloat32ProjectionData2D* _pData, float32 _fSigma,
+                                   uint64_t _iSeed, unsigned int _iStream = 0);
+
+/** Add Gaussian noise to a 3D projection data object.
+ */
+_AstraExport bool addGaussianNoise(CFloat32ProjectionData3DMemory* _pData, float32 _fSigma,
+                                   uint64_t _iSeed, unsigned int _iStream = 0);
+
+} // namespace astra
+
+#endif
@@ -0,0 +1,97 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+#ifndef _INC_ASTRA_NUMAPLACEMENT
+#define _INC_ASTRA_NUMAPLACEMENT
+
+#include <cstddef>
+
+#include "Globals.h"
+
+namespace astra {
+
+/**
+ * Placement of the pages of large data objects on NUMA nodes.
+ *
+ * NUMA_FIRST_TOUCH (the default): data objects are initialized, filled
+ * and copied in parallel on the CWorkerPool, with the rows split in the
+ * same contiguous ranges as CWorkerPool::parallelFor uses for the
+ * kernels, so that each page lands on the node of the worker that
+ * processes it. Objects created without initial data are zeroed this way.
+ *
+ * NUMA_INTERLEAVE: pages are spread round-robin over all nodes. This suits
+ * data that all threads access without a fixed partition, such as a
+ * volume that is backprojected into from every angle.
+ *
+ * NUMA_LOCAL: all pages are placed on the node of the allocating thread,
+ * and initialization is serial, as before.
+ *
+ * The policy can also be set with the ASTRA_NUMA_POLICY environment
+ * variable (firsttouch, interleave or local). It only applies to data
+ * of at least NUMA_MIN_BYTES; smaller objects are handled serially.
+ * Without NUMA support (or on one node), the policies only differ in
+ * whether initialization is parallel.
+ */
+enum ENumaPolicy {
+	NUMA_FIRST_TOUCH,
+	NUMA_INTERLEAVE,
+	NUMA_LOCAL
+};
+
+const size_t NUMA_MIN_BYTES = 4 << 20;
+
+_AstraExport void setNumaPolicy(ENumaPolicy _ePolicy);
+_AstraExport ENumaPolicy getNumaPolicy();
+
+/** Number of NUMA nodes in the system, 1 if unknown. */
+_AstraExport int getNumaNodeCount();
+
+/** Apply the policy to a newly allocated block, before anything writes to
+ *  it. For NUMA_INTERLEAVE this binds the pages; otherwise it does nothing.
+ */
+_AstraExport void bindPages(float32* _pfData, size_t _iSize);
+
+/** Set _iRows rows of _iRowSize elements to zero, if the policy is
+ *  NUMA_FIRST_TOUCH, to place a newly allocated block without initial data.
+ */
+_AstraExport void touchRows(float32* _pfData, size_t _iRows, size_t _iRowSize);
+
+/** Set _iRows rows of _iRowSize elements to _fValue, following the policy.
+ *  Rows start _iPitch elements apart, or _iRowSize if _iPitch is 0. The
+ *  padding between rows is not written.
+ */
+_AstraExport void fillRows(float32* _pfData, size_t _iRows, size_t _iRowSize, float32 _fValue,
+                           size_t _iPitch = 0);
+
+/** Copy _iRows rows of _iRowSize elements, following the policy. The rows
+ *  start _iDstPitch and _iSrcPitch elements apart, or _iRowSize if 0.
+ */
+_AstraExport void copyRows(float32* _pfDst, const float32* _pfSrc, size_t _iRows, size_t _iRowSize,
+                           size_t _iDstPitch = 0, size_t _iSrcPitch = 0);
+
+} // namespace astra
+
+#endif
@@ -48,6 +48,13 @@ void CParallelBeamLinearKernelProjector2D::projectSingleRay(int _iProjection, in
 	                      _iDetector, _iDetector + 1, p);
 }
 
+template <typename Policy>
+void CParallelBeamLinearKernelProjector2D::projectProjectionRange(int _iProjFrom, int _iProjTo, Policy& p)
+{
+	projectBlock_internal(_iProjFrom, _iProjTo,
+	                      0, m_pProjectionGeometry->getDetectorCount(), p);
+}
+
 
 
 //----------------------------------------------------------------------------------------
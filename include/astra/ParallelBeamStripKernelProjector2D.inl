@@ -46,6 +46,13 @@ void CParallelBeamStripKernelProjector2D::projectSingleRay(int _iProjection, int
 	                      _iDetector, _iDetector + 1, p);
 }
 
+template <typename Policy>
+void CParallelBeamStripKernelProjector2D::projectProjectionRange(int _iProjFrom, int _iProjTo, Policy& p)
+{
+	projectBlock_internal(_iProjFrom, _iProjTo,
+	                      0, m_pProjectionGeometry->getDetectorCount(), p);
+}
+
 //----------------------------------------------------------------------------------------
 /* PROJECT BLOCK
    
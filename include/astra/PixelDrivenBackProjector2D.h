@@ -0,0 +1,134 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+
+#ifndef _INC_ASTRA_PIXELDRIVENBACKPROJECTOR2D
+#define _INC_ASTRA_PIXELDRIVENBACKPROJECTOR2D
+
+#include <vector>
+
+#include "Globals.h"
+#include "Algorithm.h"
+
+namespace astra {
+
+class CProjectionGeometry2D;
+class CVolumeGeometry2D;
+class CFloat32ProjectionData2D;
+class CFloat32VolumeData2D;
+
+/**
+ * Pixel-driven backprojector for 2D parallel and fan beam geometries.
+ *
+ * Instead of scattering every ray over the pixels it crosses, every pixel
+ * computes its detector coordinate for each angle and gathers the
+ * linearly interpolated sinogram value, as the CUDA backprojectors do.
+ * The detector coordinate is affine in the pixel position for parallel
+ * beams, and a ratio of two affine functions for fan beams, so only a few
+ * coefficients per angle are precomputed.
+ *
+ * By default the weights are scaled to match the line kernel projectors,
+ * so this is an approximation of their transpose. With the FBP weighting,
+ * parallel beam weights are 1, and fan beam weights are the squared ratio
+ * of the source-origin distance to the source-pixel distance, both measured
+ * perpendicular to the detector, as needed by fan beam FBP. The volume is
+ * processed in bands of rows on the CWorkerPool; every band is written by a
+ * single thread, so no synchronization is needed.
+ */
+class _AstraExport CPixelDrivenBackProjector2D {
+public:
+
+	enum EWeighting {
+		WEIGHT_LINE,	///< match the line kernel projectors
+		WEIGHT_FBP		///< distance weighting for filtered backprojection
+	};
+
+	/** Precompute the per-angle coefficients.
+	 *  Check isInitialized() for unsupported geometries.
+	 */
+	CPixelDrivenBackProjector2D(CProjectionGeometry2D* _pProjectionGeometry,
+	                            CVolumeGeometry2D* _pVolumeGeometry,
+	                            EWeighting _eWeighting = WEIGHT_LINE);
+
+	~CPixelDrivenBackProjector2D();
+
+	/** Is the projection geometry one of parallel, parallel_vec, fanflat
+	 *  or fanflat_vec?
+	 */
+	static bool isSupported(const CProjectionGeometry2D* _pProjectionGeometry);
+
+	bool isInitialized() const { return m_bInitialized; }
+
+	/** Add the backprojection of a sinogram to a volume.
+	 *
+	 * @param _pSinogram projection data to backproject
+	 * @param _pVolume volume data the backprojection is added to
+	 * @param _pSinogramMask if not NULL, rays where this is 0 are not used
+	 * @param _pVolumeMask if not NULL, pixels where this is 0 are not changed
+	 * @param _pCheckpoint if not NULL, checked for an abort between bands of rows
+	 * @return false if the backprojection was aborted, or a buffer could not be allocated
+	 */
+	bool backProject(const CFloat32ProjectionData2D* _pSinogram,
+	                 CFloat32VolumeData2D* _pVolume,
+	                 const CFloat32ProjectionData2D* _pSinogramMask = 0,
+	                 const CFloat32VolumeData2D* _pVolumeMask = 0,
+	                 const CAlgorithmCheckpoint* _pCheckpoint = 0) const;
+
+	/** Per-angle coefficients. The detector coordinate of the pixel at
+	 *  (row, col), in detector pixels from the centre of the first one, is
+	 *  num / den with num = fNum0 + col * fNumCol + row * fNumRow and den
+	 *  likewise; den is 1 for parallel beams. The weight is fWeight for
+	 *  parallel beams, and fWeight * |src - pixel| / den^2 for fan beams,
+	 *  or fWeight / den^2 with the FBP weighting.
+	 */
+	struct SAngle {
+		float32 fNum0, fNumCol, fNumRow;
+		float32 fDen0, fDenCol, fDenRow;
+		float32 fSrcDX0, fSrcDY0;
+		float32 fWeight;
+	};
+
+private:
+	bool m_bInitialized;
+	bool m_bFan;
+	EWeighting m_eWeighting;
+	int m_iDetectorCount;
+	int m_iRowCount;
+	int m_iColCount;
+	float32 m_fPixelLengthX;
+	float32 m_fPixelLengthY;
+	std::vector<SAngle> m_angles;
+
+	CPixelDrivenBackProjector2D(const CPixelDrivenBackProjector2D&);
+	CPixelDrivenBackProjector2D& operator=(const CPixelDrivenBackProjector2D&);
+
+	friend struct SPixelDrivenBandFunctor;
+};
+
+} // end namespace
+
+#endif
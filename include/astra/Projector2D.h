@@ -169,6 +169,12 @@ public:
 	 */
 	CSparseMatrix* getMatrix();
 
+	/** Returns the host memory, in bytes, held by the projector and its
+	 *  projection geometry: angles, projection vectors and explicit
+	 *  matrices or kernel tables. The volume geometry is negligible.
+	 */
+	virtual size_t getMemoryUsage() const;
+
 	/** Has the projector been initialized?
 	 *
 	 * @return initialized successfully
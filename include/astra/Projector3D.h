@@ -29,6 +29,7 @@ along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
 #define INC_ASTRA_PROJECTOR3D
 
 #include <cmath>
+#include <string>
 #include <vector>
 
 #include "Globals.h"
@@ -148,6 +149,33 @@ public:
 	 */
 	virtual int getProjectionWeightsCount(int _iProjectionIndex) = 0;
 
+	/** Build the explicit system matrix of this projector, using
+	 * computeSingleRayWeights(). There is one row per detector pixel, in the
+	 * [row][angle][col] order of 3D projection data, and one column per voxel.
+	 * The rays are traced once to count their weights, so that the matrix is
+	 * allocated with its exact size, and once more to fill it. Both passes
+	 * are threaded over the rays.
+	 *
+	 * @return the matrix, owned by the caller, or 0 if it can't be built
+	 */
+	CSparseMatrix* getMatrix();
+
+	/** Stream the system matrix of getMatrix() to a binary file, without
+	 * holding all of it in memory. The file contains, in native byte order:
+	 * - the magic "ASTRASPM", then uint32 version (1), rows, columns and
+	 *   number of row blocks, and uint64 number of nonzeros;
+	 * - uint64 row starts, one per row plus the final total;
+	 * - per row block: uint32 first row and row count, then the uint32
+	 *   column indices and float32 values of its nonzeros.
+	 * A row block is a slab of whole detector rows, computed in parallel.
+	 *
+	 * @param _sFilename output file
+	 * @param _iSlabRows detector rows per block, or 0 for blocks of about
+	 *                   16M nonzeros
+	 * @return false if the matrix can't be built or written
+	 */
+	bool writeMatrix(const std::string& _sFilename, int _iSlabRows = 0);
+
 	/** Has the projector been initialized?
 	 *
 	 * @return initialized successfully
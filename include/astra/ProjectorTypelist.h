@@ -76,18 +76,26 @@ namespace astra{
 // Projector3D
 #include "Projector3D.h"
 #include "CudaProjector3D.h"
+#include "LinearKernelProjector3D.h"
+#include "SeparableFootprintProjector3D.h"
 
 namespace astra {
 
 #ifdef ASTRA_CUDA
 
-	typedef TYPELIST_1(
+	typedef TYPELIST_3(
+				CLinearKernelProjector3D,
+				CSeparableFootprintProjector3D,
 				CCudaProjector3D
 			)
 			Projector3DTypeList;
 #else
 
-	typedef TYPELIST_0 Projector3DTypeList;
+	typedef TYPELIST_2(
+				CLinearKernelProjector3D,
+				CSeparableFootprintProjector3D
+			)
+			Projector3DTypeList;
 
 #endif
 
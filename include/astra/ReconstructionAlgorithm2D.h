@@ -53,6 +53,7 @@ namespace astra {
  * \astra_xml_item_option{MinConstraintValue, float, 0, Minimum constraint value.}
  * \astra_xml_item_option{UseMaxConstraint, bool, false, Use maximum value constraint.}
  * \astra_xml_item_option{MaxConstraintValue, float, 255, Maximum constraint value.}
+ * \astra_xml_item_option{Timings, bool, false, Collect per-phase timings and counters for getInformation("Timings").}
  */
 class _AstraExport CReconstructionAlgorithm2D : public CAlgorithm {
 
@@ -97,7 +98,8 @@ public:
 	void setConstraints(bool _bUseMin, float32 _fMinValue, bool _bUseMax, float32 _fMaxValue);
 
 	/** Set a fixed reconstruction mask. A pixel will only be used in the reconstruction if the 
-	 * corresponding value in the mask is 1.
+	 * corresponding value in the mask is 1. Masks with padded rows are
+	 * rejected.
 	 *
 	 * @param _pMask Volume Data object containing fixed reconstruction mask
 	 * @param _bEnable enable the use of this mask
@@ -105,13 +107,22 @@ public:
 	void setReconstructionMask(CFloat32VolumeData2D* _pMask, bool _bEnable = true);
 
 	/** Set a fixed sinogram mask. A detector value will only be used in the reconstruction if the 
-	 * corresponding value in the mask is 1.
+	 * corresponding value in the mask is 1. Masks with padded rows are
+	 * rejected.
 	 *
 	 * @param _pMask Projection Data object containing fixed sinogram mask
 	 * @param _bEnable enable the use of this mask
 	 */
 	void setSinogramMask(CFloat32ProjectionData2D* _pMask, bool _bEnable = true);
 
+	/** Use the pixel-driven backprojector (CPixelDrivenBackProjector2D)
+	 * instead of the projector's ray-driven one. This is used by the BP, FBP
+	 * and SIRT algorithms, for parallel and fan beam geometries only.
+	 *
+	 * @param _bPixelDriven enable pixel-driven backprojection
+	 */
+	void setPixelDriven(bool _bPixelDriven) { m_bPixelDriven = _bPixelDriven; }
+
 	/** Get all information parameters.
 	 *
 	 * @return map with all boost::any object
@@ -181,6 +192,12 @@ protected:
 	 */
 	void _clear();
 
+	/** Add the rays and weights of one full forward or backprojection to
+	 *  the timing counters. The weights are counted on first use, with an
+	 *  extra projection that is timed as setup.
+	 */
+	void addProjectionCounts();
+
 	//< Projector object.
 	CProjector2D* m_pProjector;
 	//< ProjectionData2D object containing the sinogram.
@@ -207,6 +224,11 @@ protected:
 	//< Use the fixed reconstruction mask?
 	bool m_bUseSinogramMask;
 
+	//< Use the pixel-driven backprojector?
+	bool m_bPixelDriven;
+
+	//< Number of weights applied by a single projection, or -1 if not counted yet.
+	double m_fWeightsPerProjection;
 
 	//< Specify if initialize/check should check for a valid Projector
 	virtual bool requiresProjector() const { return true; }
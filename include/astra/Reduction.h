@@ -0,0 +1,56 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+#ifndef _INC_ASTRA_REDUCTION
+#define _INC_ASTRA_REDUCTION
+
+#include "Globals.h"
+
+namespace astra {
+
+/**
+ * Deterministic parallel reductions over float32 arrays.
+ *
+ * The array is split into blocks of a fixed size that do not depend on
+ * the number of threads. Each block is summed pairwise with double
+ * precision partial sums, the blocks in parallel on the CWorkerPool, and
+ * the block sums are combined pairwise in a fixed tree. The result is
+ * therefore bitwise identical for any thread count, and the rounding
+ * error grows with the log of the size instead of the size.
+ */
+
+/** Sum of the elements. */
+_AstraExport float64 reduceSum(const float32* _pfData, size_t _iSize);
+
+/** Dot product of two arrays of the same size. */
+_AstraExport float64 reduceDot(const float32* _pfA, const float32* _pfB, size_t _iSize);
+
+/** Squared Euclidean norm, the dot product of an array with itself. */
+_AstraExport float64 reduceSquaredNorm(const float32* _pfData, size_t _iSize);
+
+} // namespace astra
+
+#endif
@@ -200,6 +200,10 @@ public:
 	 */
 	virtual void run(int _iNrIterations = 1);
 
+	/** Estimate the host memory of the weight and difference temporaries.
+	 */
+	virtual size_t getMemoryEstimate() const;
+
 	/** Get a description of the class.
 	 *
 	 * @return description string
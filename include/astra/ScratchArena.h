@@ -0,0 +1,147 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#ifndef _INC_ASTRA_SCRATCHARENA
+#define _INC_ASTRA_SCRATCHARENA
+
+#include <map>
+#include <vector>
+#include <cstddef>
+
+#include "Globals.h"
+#include "Singleton.h"
+#include "Mutex.h"
+#include "Float32Data2D.h"
+
+namespace astra {
+
+class CFloat32ProjectionData2D;
+class CFloat32VolumeData2D;
+class CProjectionGeometry2D;
+class CVolumeGeometry2D;
+
+/**
+ * Library-wide cache of 64-byte aligned scratch buffers.
+ *
+ * Requests are rounded up to a size class, and released buffers are kept
+ * on a free list per size class, so algorithms that repeatedly need
+ * temporaries of the same geometry size reuse the same memory instead of
+ * allocating (and page faulting) it again. The total size of the cached
+ * buffers is bounded by the cache limit.
+ *
+ * All buffers, including the cached ones, are accounted in the
+ * CMemoryBudget. When the budget is exhausted, the cache is emptied before
+ * an allocation fails.
+ */
+class _AstraExport CScratchArena : public Singleton<CScratchArena> {
+public:
+	CScratchArena();
+	virtual ~CScratchArena();
+
+	/** Alignment of all buffers, in bytes.
+	 */
+	static const size_t ALIGNMENT = 64;
+
+	/** Borrow a buffer of at least _iBytes bytes. The contents are undefined.
+	 *
+	 * @param _iBytes requested size
+	 * @param _iClassBytes set to the size of the returned buffer, which must be passed to release()
+	 * @return buffer, or NULL if the allocation failed
+	 */
+	void* allocate(size_t _iBytes, size_t& _iClassBytes);
+
+	/** Return a buffer obtained from allocate().
+	 */
+	void release(void* _pBuffer, size_t _iClassBytes);
+
+	/** Free all cached buffers.
+	 */
+	void trim();
+
+	/** Set the maximum total size of the cached buffers, in bytes. Buffers
+	 *  released while the cache is full are freed.
+	 */
+	void setCacheLimit(size_t _iBytes);
+	size_t getCacheLimit();
+
+	/** Total size of the cached buffers, in bytes.
+	 */
+	size_t getCachedBytes();
+
+	/** Size class a request of _iBytes bytes is rounded up to.
+	 */
+	static size_t getClassSize(size_t _iBytes);
+
+	/** Wrap a borrowed buffer of _iCount floats as custom memory for the
+	 *  CFloat32Data2D classes. The buffer is returned to the arena when the
+	 *  data object is deleted.
+	 */
+	CFloat32CustomMemory* createCustomMemory(size_t _iCount);
+
+	/** Create a data object with memory borrowed from the arena. If the
+	 *  memory can't be allocated, the returned object is not initialized.
+	 */
+	CFloat32ProjectionData2D* createProjectionData2D(CProjectionGeometry2D* _pGeometry);
+	CFloat32VolumeData2D* createVolumeData2D(CVolumeGeometry2D* _pGeometry);
+
+private:
+	void _freeAll();
+
+	CMutex m_mutex;
+	std::map<size_t, std::vector<void*> > m_freeLists;
+	size_t m_iCachedBytes;
+	size_t m_iCacheLimit;
+};
+
+/**
+ * Scratch buffer of _iCount elements of type T borrowed from the
+ * CScratchArena for the lifetime of the object.
+ */
+template <typename T>
+class CScratchBuffer {
+public:
+	explicit CScratchBuffer(size_t _iCount) {
+		m_pData = (T*)CScratchArena::getSingleton().allocate(_iCount * sizeof(T), m_iClassBytes);
+	}
+	~CScratchBuffer() {
+		CScratchArena::getSingleton().release(m_pData, m_iClassBytes);
+	}
+
+	T* get() const { return m_pData; }
+	operator T*() const { return m_pData; }
+
+private:
+	T* m_pData;
+	size_t m_iClassBytes;
+
+	CScratchBuffer(const CScratchBuffer&);
+	CScratchBuffer& operator=(const CScratchBuffer&);
+};
+
+} // end namespace
+
+#endif
@@ -0,0 +1,184 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#ifndef _INC_ASTRA_SEPARABLEFOOTPRINTPROJECTOR3D
+#define _INC_ASTRA_SEPARABLEFOOTPRINTPROJECTOR3D
+
+#include "Projector3D.h"
+#include "LinearKernel3D.h"
+
+namespace astra
+{
+
+class CProjectionGeometry3D;
+class CVolumeGeometry3D;
+class CFloat32ProjectionData3DMemory;
+class CFloat32VolumeData3DMemory;
+
+/** This class implements a three-dimensional CPU cone beam projector with
+ * separable footprints (SF-TR and SF-TT, Long, Fessler and Balter, IEEE
+ * TMI 29(11), 2010).
+ *
+ * The shadow of a voxel on the detector is approximated by the product of
+ * a transaxial footprint, a trapezoid in u spanned by the projections of
+ * the four corners of the voxel column, and an axial footprint in v. The
+ * axial footprint is a rectangle (TR) or a trapezoid (TT) that includes the
+ * change of magnification across the voxel. Both are integrated exactly
+ * over the detector pixels, and scaled by the length of the central ray
+ * through the voxel, so that the weights are area weighted intersection
+ * lengths. The transaxial footprint and the magnification only depend on
+ * the voxel column, so they are computed once per column and projection,
+ * and the axial footprints follow linearly along z.
+ *
+ * The forward projection and backprojection use the same weights, so one
+ * is the exact transpose of the other. Both are voxel driven and run on the
+ * CWorkerPool; the CPU 3D algorithms use them when given this projector.
+ *
+ * It supports cone and cone_vec geometries whose detector rows are
+ * horizontal and whose detector columns are vertical (no detector tilt
+ * out of the z axis).
+ *
+ * \par XML Configuration
+ * \astra_xml_item{ProjectionGeometry, xml node, The geometry of the projection.}
+ * \astra_xml_item{VolumeGeometry, xml node, The geometry of the volume.}
+ * \astra_xml_item_option{Footprint, string, TR, Axial footprint: TR (rectangle) or TT (trapezoid).}
+ *
+ * \par MATLAB example
+ * \astra_code{
+ *		cfg = astra_struct('sf3d');\n
+ *		cfg.ProjectionGeometry = proj_geom;\n
+ *		cfg.VolumeGeometry = vol_geom;\n
+ *		cfg.option.Footprint = 'TT';\n
+ *		proj_id = astra_mex_projector3d('create'\, cfg);\n
+ * }
+ */
+class _AstraExport CSeparableFootprintProjector3D : public CProjector3D {
+protected:
+	/** Initial clearing. Only to be used by constructors.
+	 */
+	void _clear();
+
+	/** Check the values of this object, and set up the projection vectors.
+	 */
+	bool _check();
+
+	SVolumeGrid3D m_grid;
+	SProjectionVectors3D m_vectors;
+
+	//< trapezoidal (TT) instead of rectangular (TR) axial footprints
+	bool m_bTrapezoidAxial;
+
+public:
+	// type of the projector, needed to register with CProjectorFactory
+	static std::string type;
+
+	/** Default constructor.
+	 */
+	CSeparableFootprintProjector3D();
+
+	/** Constructor.
+	 *
+	 * @param _pProjectionGeometry Geometry of the projection. Will be HARDCOPIED.
+	 * @param _pVolumeGeometry Geometry of the volume. Will be HARDCOPIED.
+	 * @param _bTrapezoidAxial Use SF-TT instead of SF-TR.
+	 */
+	CSeparableFootprintProjector3D(const CProjectionGeometry3D* _pProjectionGeometry,
+	                               const CVolumeGeometry3D* _pVolumeGeometry,
+	                               bool _bTrapezoidAxial = false);
+
+	/** Destructor.
+	 */
+	virtual ~CSeparableFootprintProjector3D();
+
+	/** Initialize the projector with a config object.
+	 *
+	 * @param _cfg Configuration Object
+	 * @return initialization successful?
+	 */
+	virtual bool initialize(const Config& _cfg);
+
+	/** Initialize the projector.
+	 *
+	 * @param _pProjectionGeometry Geometry of the projection. Will be HARDCOPIED.
+	 * @param _pVolumeGeometry Geometry of the volume. Will be HARDCOPIED.
+	 * @param _bTrapezoidAxial Use SF-TT instead of SF-TR.
+	 * @return initialization successful?
+	 */
+	bool initialize(const CProjectionGeometry3D* _pProjectionGeometry,
+	                const CVolumeGeometry3D* _pVolumeGeometry,
+	                bool _bTrapezoidAxial = false);
+
+	/** Clear this class.
+	 */
+	void clear();
+
+	/** Does this projector use SF-TT?
+	 */
+	bool isTrapezoidAxial() const { return m_bTrapezoidAxial; }
+
+	/** Overwrite _pProjection with the forward projection of _pVolume.
+	 *  The data objects must match the geometries of the projector.
+	 */
+	bool forwardProject(const CFloat32VolumeData3DMemory* _pVolume,
+	                    CFloat32ProjectionData3DMemory* _pProjection) const;
+
+	/** Overwrite _pVolume with the backprojection of _pProjection, the exact
+	 *  transpose of forwardProject().
+	 */
+	bool backProject(const CFloat32ProjectionData3DMemory* _pProjection,
+	                 CFloat32VolumeData3DMemory* _pVolume) const;
+
+	/** Compute the voxel weights of detector pixel (_iDetectorIndex,
+	 *  _iSliceIndex) of projection _iProjectionIndex. This visits every
+	 *  voxel column, so it is meant for building explicit matrices of small
+	 *  problems. It may be called from several threads at once.
+	 */
+	virtual void computeSingleRayWeights(int _iProjectionIndex, int _iSliceIndex, int _iDetectorIndex,
+	                                     SPixelWeight* _pWeightedPixels, int _iMaxPixelCount,
+	                                     int& _iStoredPixelCount);
+
+	/** Upper bound on the number of weights of a detector pixel in
+	 *  projection _iProjectionIndex, from the footprints of all voxel columns.
+	 */
+	virtual int getProjectionWeightsCount(int _iProjectionIndex);
+
+	/** Return the type of this projector.
+	 *
+	 * @return identification type of this projector
+	 */
+	virtual std::string getType() { return type; }
+
+	/** get a description of the class
+	 *
+	 * @return description string
+	 */
+	virtual std::string description() const;
+};
+
+} // namespace astra
+
+#endif
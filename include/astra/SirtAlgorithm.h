@@ -62,6 +62,7 @@ namespace astra {
  * \astra_xml_item_option{UseMaxConstraint, bool, false, Use maximum value constraint.}
  * \astra_xml_item_option{MaxConstraintValue, float, 255, Maximum constraint value.}
  * \astra_xml_item_option{Relaxation, float, 1, The relaxation factor.}
+ * \astra_xml_item_option{PixelDriven, bool, false, Use the pixel-driven backprojector. Only for parallel and fan beam geometries.}
  *
  * \par XML Example
  * \astra_code{
@@ -206,6 +207,10 @@ public:
 	 */
 	virtual void run(int _iNrIterations = 0);
 
+	/** Estimate the host memory of the weight and difference temporaries.
+	 */
+	virtual size_t getMemoryEstimate() const;
+
 	/** Get a description of the class.
 	 *
 	 * @return description string
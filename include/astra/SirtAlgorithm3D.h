@@ -0,0 +1,204 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#ifndef _INC_ASTRA_SIRTALGORITHM3D
+#define _INC_ASTRA_SIRTALGORITHM3D
+
+#include "Globals.h"
+#include "Config.h"
+
+#include "Algorithm.h"
+#include "ReconstructionAlgorithm3D.h"
+#include "CpuProjection3D.h"
+
+#include "Float32ProjectionData3DMemory.h"
+#include "Float32VolumeData3DMemory.h"
+
+namespace astra {
+
+/**
+ * \brief
+ * This class contains the CPU implementation of the 3D SIRT (Simultaneous Iterative Reconstruction Technique) algorithm.
+ *
+ * The update step of pixel \f$v_j\f$ for iteration \f$k\f$ is given by:
+ * \f[
+ *	v_j^{(k+1)} = v_j^{(k)} + \lambda \sum_{i=1}^{M} \left( \frac{w_{ij}\left( p_i - \sum_{r=1}^{N} w_{ir}v_r^{(k)}\right)}{\sum_{k=1}^{N} w_{ik}} \right) \frac{1}{\sum_{l=1}^{M}w_{lj}}
+ * \f]
+ *
+ * The projections are done by CCpuProjection3D, which splits parallel beam
+ * geometries without detector tilt into independent 2D slices.
+ *
+ * \par XML Configuration
+ * \astra_xml_item{ProjectorId, integer, (optional) Identifier of a projector as it is stored in the ProjectorManager.}
+ * \astra_xml_item{ProjectionDataId, integer, Identifier of a projection data object as it is stored in the DataManager.}
+ * \astra_xml_item{ReconstructionDataId, integer, Identifier of a volume data object as it is stored in the DataManager.}
+ * \astra_xml_item_option{ReconstructionMaskId, integer, not used, Identifier of a volume data object that acts as a reconstruction mask. 1 = reconstruct on this voxel. 0 = don't reconstruct on this voxel.}
+ * \astra_xml_item_option{SinogramMaskId, integer, not used, Identifier of a projection data object that acts as a projection mask. 1 = reconstruct using this ray. 0 = don't use this ray while reconstructing.}
+ * \astra_xml_item_option{MinConstraint, float, not used, Minimum constraint value.}
+ * \astra_xml_item_option{MaxConstraint, float, not used, Maximum constraint value.}
+ * \astra_xml_item_option{Relaxation, float, 1, The relaxation factor.}
+ *
+ * \par MATLAB example
+ * \astra_code{
+ *		cfg = astra_struct('SIRT3D');\n
+ *		cfg.ProjectionDataId = sino_id;\n
+ *		cfg.ReconstructionDataId = recon_id;\n
+ *		cfg.option.MinConstraint = 0;\n
+ *		alg_id = astra_mex_algorithm('create'\, cfg);\n
+ *		astra_mex_algorithm('iterate'\, alg_id\, 10);\n
+ *		astra_mex_algorithm('delete'\, alg_id);\n
+ * }
+ *
+ * \par References
+ * [1] "Computational Analysis and Improvement of SIRT", J. Gregor, T. Benson, IEEE Transactions on Medical Imaging, Vol. 22, No. 7, July 2008.
+ */
+class _AstraExport CSirtAlgorithm3D : public CReconstructionAlgorithm3D {
+
+protected:
+
+	/** Allocate the temporary data objects and prepare the projections.
+	 */
+	virtual void _init();
+
+	/** Check the values of this object.  If everything is ok, the object can be set to the initialized state.
+	 * The following statements are then guaranteed to hold:
+	 * - valid, packed data objects in memory
+	 * - a supported geometry
+	 */
+	virtual bool _check();
+
+	/** Compute the inverse total ray lengths and pixel weights.
+	 */
+	bool _computeWeights();
+
+	CCpuProjection3D m_projection;
+
+	/** Temporary data object for storing the (inverse) total ray lengths
+	 */
+	CFloat32ProjectionData3DMemory* m_pTotalRayLength;
+
+	/** Temporary data object for storing the (inverse) total pixel weights
+	 */
+	CFloat32VolumeData3DMemory* m_pTotalPixelWeight;
+
+	/** Temporary data object for storing the difference between the forward projected
+	 * reconstruction, and the measured projection data
+	 */
+	CFloat32ProjectionData3DMemory* m_pDiffSinogram;
+
+	/** Temporary data object for storing volume data
+	 */
+	CFloat32VolumeData3DMemory* m_pTmpVolume;
+
+	bool m_bWeightsComputed;
+
+	/** The number of performed iterations
+	 */
+	int m_iIterationCount;
+
+	/** Relaxation parameter
+	 */
+	float m_fLambda;
+
+	/** Norm of the residual before the last iteration, or -1
+	 */
+	float32 m_fResidualNorm;
+
+public:
+	
+	// type of the algorithm, needed to register with CAlgorithmFactory
+	static std::string type;
+	
+	/** Default constructor, does not initialize the object.
+	 */
+	CSirtAlgorithm3D();
+
+	/** Destructor.
+	 */
+	virtual ~CSirtAlgorithm3D();
+
+	/** Clear this class.
+	 */
+	virtual void clear();
+
+	/** Initialize the algorithm with a config object.
+	 *
+	 * @param _cfg Configuration Object
+	 * @return initialization successful?
+	 */
+	virtual bool initialize(const Config& _cfg);
+
+	/** Initialize class.
+	 *
+	 * @param _pProjector		Projector Object (optional).
+	 * @param _pSinogram		ProjectionData3D object containing the projection data.
+	 * @param _pReconstruction	VolumeData3D object for storing the reconstructed volume.
+	 * @return initialization successful?
+	 */
+	bool initialize(CProjector3D* _pProjector, 
+					CFloat32ProjectionData3DMemory* _pSinogram, 
+					CFloat32VolumeData3DMemory* _pReconstruction);
+
+	/** Get all information parameters
+	 *
+	 * @return map with all boost::any object
+	 */
+	virtual std::map<std::string,boost::any> getInformation();
+
+	/** Get a single piece of information represented as a boost::any
+	 *
+	 * @param _sIdentifier identifier string to specify which piece of information you want
+	 * @return boost::any object
+	 */
+	virtual boost::any getInformation(std::string _sIdentifier);
+
+	/** Perform a number of iterations.
+	 *
+	 * @param _iNrIterations amount of iterations to perform.
+	 */
+	virtual void run(int _iNrIterations = 0);
+
+	/** Get a description of the class.
+	 *
+	 * @return description string
+	 */
+	virtual std::string description() const;
+
+	/** Get the norm of the residual, before the last iteration.
+	 *
+	 * @param _fNorm if available, the norm is returned here
+	 * @return true if at least one iteration has been run
+	 */
+	virtual bool getResidualNorm(float32& _fNorm);
+};
+
+// inline functions
+inline std::string CSirtAlgorithm3D::description() const { return CSirtAlgorithm3D::type; };
+
+} // end namespace
+
+#endif
@@ -76,6 +76,11 @@ public:
 	 */
 	std::string description() const;
 
+	/** get the host memory, in bytes, of the values, column indices
+	 *  and row starts
+	 */
+	size_t getMemoryUsage() const;
+
 	/** get the data for a single row. Entries are stored from left to right.
 	 *
 	 * @param _iRow the row
@@ -134,6 +139,10 @@ protected:
 	/** Is the class initialized?
 	 */
 	bool m_bInitialized;
+
+	/** Free the arrays, and mark the matrix as uninitialized.
+	 */
+	void _freeData();
 };
 
 
@@ -87,3 +87,16 @@ void CSparseMatrixProjector2D::projectSingleRay(int _iProjection, int _iDetector
 	// POLICY: RAY POSTERIOR
 	p.rayPosterior(iRayIndex);
 }
+
+
+//----------------------------------------------------------------------------------------
+// PROJECT RANGE OF PROJECTIONS
+template <typename Policy>
+void CSparseMatrixProjector2D::projectProjectionRange(int _iProjFrom, int _iProjTo, Policy& p)
+{
+	ASTRA_ASSERT(m_bIsInitialized);
+
+	for (int i = _iProjFrom; i < _iProjTo; ++i)
+		for (int j = 0; j < m_pProjectionGeometry->getDetectorCount(); ++j)
+			projectSingleRay(i, j, p);
+}
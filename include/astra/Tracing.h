@@ -0,0 +1,134 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#ifndef _INC_ASTRA_TRACING
+#define _INC_ASTRA_TRACING
+
+#include <string>
+
+#include "Globals.h"
+
+namespace astra {
+
+/**
+ * Collects begin/end events of algorithm phases, composite jobs and worker
+ * pool tasks, and writes them as a Chrome trace JSON file. The file can be
+ * loaded in chrome://tracing or https://ui.perfetto.dev to inspect how work
+ * is spread over threads.
+ *
+ * Tracing is disabled by default. It can be started with start(), or by
+ * setting the environment variable ASTRA_TRACE to the name of the output
+ * file, in which case the trace is written when the library is unloaded.
+ *
+ * While disabled, the cost of a trace point is a single flag check.
+ */
+class _AstraExport CTracer {
+public:
+	/** Start collecting events, discarding any events collected earlier.
+	 *
+	 * @param _sFilename file that flush() and stop() write to
+	 */
+	static void start(const std::string& _sFilename);
+
+	/** Stop collecting events and write them to the output file.
+	 *
+	 * @return false if tracing wasn't started or the file couldn't be written
+	 */
+	static bool stop();
+
+	/** Write all events collected so far to the output file, overwriting
+	 *  it. Collection continues.
+	 */
+	static bool flush();
+
+	/** Is tracing enabled?
+	 */
+	static bool isEnabled() { return s_bEnabled; }
+
+	/** Set the name under which the calling thread is shown in the trace.
+	 */
+	static void setThreadName(const std::string& _sName);
+
+	/** Record the start of a duration event on the calling thread.
+	 *
+	 * @param _sCategory category, must be a string literal
+	 * @param _sName name of the event
+	 */
+	static void begin(const char* _sCategory, const std::string& _sName);
+
+	/** Record the end of a duration event on the calling thread.
+	 *
+	 * @param _sCategory category, must be a string literal
+	 * @param _sName name of the event
+	 * @param _sArgs JSON object members to attach to the event, may be empty
+	 */
+	static void end(const char* _sCategory, const std::string& _sName, const std::string& _sArgs);
+
+private:
+	static volatile bool s_bEnabled;
+};
+
+/**
+ * Records a duration event from its construction to its destruction.
+ * Arguments added in between are attached to the event.
+ */
+class _AstraExport CTraceScope {
+public:
+	CTraceScope(const char* _sCategory, const char* _sName);
+	CTraceScope(const char* _sCategory, const std::string& _sName);
+	~CTraceScope();
+
+	/** Attach a numerical argument to the event. NaN and infinite
+	 * values are written as null.
+	 */
+	void addArg(const char* _sKey, double _fValue);
+
+	/** Attach a string argument to the event.
+	 */
+	void addArg(const char* _sKey, const std::string& _sValue);
+
+	/** Attach dimensions, shown as "x x y x z".
+	 */
+	void addDims(const char* _sKey, size_t _iX, size_t _iY, size_t _iZ);
+
+	/** Is this event being recorded?
+	 */
+	bool isActive() const { return m_bActive; }
+
+private:
+	bool m_bActive;
+	const char* m_sCategory;
+	std::string m_sName;
+	std::string m_sArgs;
+
+	CTraceScope(const CTraceScope&);
+	CTraceScope& operator=(const CTraceScope&);
+};
+
+} // end namespace
+
+#endif
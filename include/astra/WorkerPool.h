@@ -0,0 +1,218 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#ifndef _INC_ASTRA_WORKERPOOL
+#define _INC_ASTRA_WORKERPOOL
+
+#include <vector>
+
+#include "Globals.h"
+#include "Singleton.h"
+
+namespace astra {
+
+class CTaskGroup;
+class CWorkerPool;
+struct SWorkerPoolState;
+
+/**
+ * A unit of work that can be submitted to the CWorkerPool.
+ */
+class _AstraExport CWorkerTask {
+public:
+	CWorkerTask() : m_pGroup(0), m_bAutoDelete(false) { }
+	virtual ~CWorkerTask() { }
+
+	/** Execute the task. This is called exactly once, on an arbitrary thread.
+	 */
+	virtual void run() = 0;
+
+private:
+	CTaskGroup* m_pGroup;
+	bool m_bAutoDelete;
+	friend class CWorkerPool;
+};
+
+/**
+ * Completion handle for a set of tasks submitted to the CWorkerPool.
+ *
+ * A thread waiting on a task group helps executing queued tasks, so it is
+ * safe to wait from inside a task running on the pool.
+ */
+class _AstraExport CTaskGroup {
+public:
+	CTaskGroup();
+
+	/** Destructor. Waits for all tasks in the group to finish.
+	 */
+	~CTaskGroup();
+
+	/** Block until all tasks submitted to this group have finished.
+	 */
+	void wait();
+
+	/** Have all tasks submitted to this group finished?
+	 */
+	bool isDone() const { return m_iPending == 0; }
+
+private:
+	volatile int m_iPending;
+	friend class CWorkerPool;
+
+	CTaskGroup(const CTaskGroup&);
+	CTaskGroup& operator=(const CTaskGroup&);
+};
+
+/**
+ * Global worker pool settings.
+ */
+struct SWorkerPoolParams {
+	/** Number of worker threads. 0 means one per available CPU core.
+	 */
+	int iThreadCount;
+
+	/** CPU cores to pin the workers to. Worker i is pinned to core
+	 *  affinity[i % affinity.size()]. Empty means no pinning.
+	 */
+	std::vector<int> affinity;
+
+	SWorkerPoolParams() : iThreadCount(0) { }
+};
+
+/**
+ * Library-wide pool of persistent worker threads with a work-stealing
+ * scheduler.
+ *
+ * The threads are started lazily on first use. Each worker owns a task
+ * queue; tasks submitted from a worker go to its own queue, and idle
+ * workers steal from the other queues.
+ */
+class _AstraExport CWorkerPool : public Singleton<CWorkerPool> {
+public:
+	CWorkerPool();
+	virtual ~CWorkerPool();
+
+	/** Submit a task to the pool.
+	 *
+	 * @param _pTask task to execute
+	 * @param _pGroup group to register the task with, may be NULL
+	 * @param _bAutoDelete delete the task after it has run
+	 */
+	void submit(CWorkerTask* _pTask, CTaskGroup* _pGroup, bool _bAutoDelete = false);
+
+	/** Run _f(iFrom, iTo) on consecutive subranges of [_iBegin, _iEnd) in
+	 *  parallel, and return when all of them have finished. The calling
+	 *  thread executes one of the subranges itself.
+	 *
+	 * @param _iBegin start of the range (inclusive)
+	 * @param _iEnd end of the range (exclusive)
+	 * @param _f functor with an operator()(int, int) const
+	 * @param _iGrain minimum size of a subrange
+	 */
+	template <typename F>
+	void parallelFor(int _iBegin, int _iEnd, const F& _f, int _iGrain = 1);
+
+	/** Number of worker threads (after starting the pool if needed).
+	 */
+	int getThreadCount();
+
+	/** Is the calling thread one of the pool workers?
+	 */
+	static bool isWorkerThread();
+
+	/** Stop all workers. The pool restarts on its next use, with the
+	 *  current global parameters.
+	 */
+	void shutdown();
+
+	/** Set the parameters for the pool. If the pool is already running
+	 *  with different settings, it is restarted.
+	 */
+	static void setGlobalParams(const SWorkerPoolParams& _params);
+
+	/** Get the parameters the pool will start with.
+	 */
+	static SWorkerPoolParams getGlobalParams();
+
+	// internal
+	bool runOneTask();
+	void workerLoop(int _iIndex);
+
+private:
+	void _start();
+	void _finish(CWorkerTask* _pTask);
+	void _wait(CTaskGroup* _pGroup);
+	int _chunkCount(int _iSize, int _iGrain);
+
+	SWorkerPoolState* m_pState;
+
+	static SWorkerPoolParams s_params;
+
+	friend class CTaskGroup;
+};
+
+
+template <typename F>
+class CParallelForTask : public CWorkerTask {
+public:
+	CParallelForTask() : m_pF(0), m_iFrom(0), m_iTo(0) { }
+	CParallelForTask(const F* _pF, int _iFrom, int _iTo) : m_pF(_pF), m_iFrom(_iFrom), m_iTo(_iTo) { }
+	virtual void run() { (*m_pF)(m_iFrom, m_iTo); }
+private:
+	const F* m_pF;
+	int m_iFrom;
+	int m_iTo;
+};
+
+template <typename F>
+void CWorkerPool::parallelFor(int _iBegin, int _iEnd, const F& _f, int _iGrain)
+{
+	if (_iEnd <= _iBegin)
+		return;
+
+	int iChunks = _chunkCount(_iEnd - _iBegin, _iGrain);
+	if (iChunks <= 1) {
+		_f(_iBegin, _iEnd);
+		return;
+	}
+
+	int iSize = _iEnd - _iBegin;
+	std::vector<CParallelForTask<F> > tasks(iChunks);
+	CTaskGroup group;
+	for (int i = 1; i < iChunks; ++i) {
+		int iFrom = _iBegin + (int)(((long long)iSize * i) / iChunks);
+		int iTo = _iBegin + (int)(((long long)iSize * (i+1)) / iChunks);
+		tasks[i] = CParallelForTask<F>(&_f, iFrom, iTo);
+		submit(&tasks[i], &group);
+	}
+	_f(_iBegin, _iBegin + (int)(iSize / iChunks));
+	group.wait();
+}
+
+} // end namespace
+
+#endif
@@ -178,6 +178,26 @@ void clog_info(const char *sfile, int sline, int id, const char *fmt, va_list ap
 void clog_warn(const char *sfile, int sline, int id, const char *fmt, va_list ap);
 void clog_error(const char *sfile, int sline, int id, const char *fmt, va_list ap);
 
+/**
+ * Write an already formatted message to a logger.
+ *
+ * @param sfile
+ * The name of the source file making this log call (e.g. __FILE__).
+ *
+ * @param sline
+ * The line number of the call in the source code (e.g. __LINE__).
+ *
+ * @param level
+ * The level of the message.
+ *
+ * @param id
+ * The id of the logger to write to.
+ *
+ * @param msg
+ * The message text.
+ */
+void clog_write(const char *sfile, int sline, enum clog_level level, int id, const char *msg);
+
 /**
  * Set the minimum level of messages that should be written to the log.
  * Messages below this level will not be written.  By default, loggers are
@@ -585,8 +605,8 @@ _clog_log(const char *sfile, int sline, enum clog_level level,
     char buf[4096];
     size_t buf_size = 4096;
     char *dynbuf = buf;
-    char *message;
     int result;
+    va_list ap2;
     struct clog *logger = _clog_loggers[id];
 
     if (!logger) {
@@ -599,52 +619,73 @@ _clog_log(const char *sfile, int sline, enum clog_level level,
     }
 
     /* Format the message text with the argument list. */
+    va_copy(ap2, ap);
     result = vsnprintf(dynbuf, buf_size, fmt, ap);
     if ((size_t) result >= buf_size) {
         buf_size = result + 1;
         dynbuf = (char *) malloc(buf_size);
-        result = vsnprintf(dynbuf, buf_size, fmt, ap);
+        result = vsnprintf(dynbuf, buf_size, fmt, ap2);
         if ((size_t) result >= buf_size) {
             /* Formatting failed -- too large */
             _clog_err("Formatting failed (1).\n");
             free(dynbuf);
+            va_end(ap2);
             return;
         }
     }
+    va_end(ap2);
+
+    clog_write(sfile, sline, level, id, dynbuf);
+
+    if (dynbuf != buf) {
+        free(dynbuf);
+    }
+}
+
+void
+clog_write(const char *sfile, int sline, enum clog_level level, int id,
+           const char *msg)
+{
+    char message_buf[4096];
+    char *message;
+    int result;
+    struct clog *logger = _clog_loggers[id];
+
+    if (!logger) {
+        _clog_err("No such logger: %d\n", id);
+        return;
+    }
+
+    if (level < logger->level) {
+        return;
+    }
 
     /* Format according to log format and write to log */
-    {
-        char message_buf[4096];
-        message = _clog_format(logger, message_buf, 4096, sfile, sline,
-                               CLOG_LEVEL_NAMES[level], dynbuf);
-        if (!message) {
-            _clog_err("Formatting failed (2).\n");
-            if (dynbuf != buf) {
-                free(dynbuf);
-            }
-            return;
-        }
-        result = write(logger->fd, message, strlen(message));
-        if (logger->cb) logger->cb(message,strlen(message));
-        if (result == -1) {
-            _clog_err("Unable to write to log file: %s\n", strerror(errno));
-        }
-        if (message != message_buf) {
-            free(message);
-        }
-        if (dynbuf != buf) {
-            free(dynbuf);
-        }
+    message = _clog_format(logger, message_buf, 4096, sfile, sline,
+                           CLOG_LEVEL_NAMES[level], msg);
+    if (!message) {
+        _clog_err("Formatting failed (2).\n");
+        return;
+    }
+    result = write(logger->fd, message, strlen(message));
+    if (logger->cb) logger->cb(message,strlen(message));
+    if (result == -1) {
+        _clog_err("Unable to write to log file: %s\n", strerror(errno));
+    }
+    if (message != message_buf) {
+        free(message);
+    }
 #ifndef _MSC_VER
-        fsync(logger->fd);
+    fsync(logger->fd);
 #else
+    {
         HANDLE h = (HANDLE) _get_osfhandle(logger->fd);
         if (h != INVALID_HANDLE_VALUE) {
             // This call will fail on a console fd, but that's ok.
             FlushFileBuffers(h);
         }
-#endif
     }
+#endif
 }
 
 void
@@ -57,6 +57,8 @@ extern "C" { bool utIsInterruptPending(); }
 #include "astra/XMLNode.h"
 #include "astra/XMLDocument.h"
 
+#include "astra/CenterOfRotationAlgorithm.h"
+
 using namespace std;
 using namespace astra;
 //-----------------------------------------------------------------------------------------
@@ -262,6 +264,61 @@ void astra_mex_algorithm_get_res_norm(int nlhs, mxArray* plhs[], int nrhs, const
 	plhs[0] = mxCreateDoubleScalar(res);
 }
 
+//-----------------------------------------------------------------------------------------
+/** bytes = astra_mex_algorithm('get_memory_estimate', id);
+ *
+ * Get the host memory the algorithm allocates for its temporaries,
+ * excluding the data objects passed to it.
+ */
+void astra_mex_algorithm_get_memory_estimate(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
+{
+	if (nrhs < 2) {
+		mexErrMsgTxt("Not enough arguments.  See the help document for a detailed argument list. \n");
+		return;
+	}
+	int iAid = (int)(mxGetScalar(prhs[1]));
+
+	CAlgorithm* pAlg = CAlgorithmManager::getSingleton().get(iAid);
+	if (!pAlg) {
+		mexErrMsgTxt("Invalid algorithm ID.\n");
+		return;
+	}
+	if (!pAlg->isInitialized()) {
+		mexErrMsgTxt("Algorithm not initialized. \n");
+		return;
+	}
+
+	plhs[0] = mxCreateDoubleScalar((double)pAlg->getMemoryEstimate());
+}
+
+//-----------------------------------------------------------------------------------------
+/** offset = astra_mex_algorithm('get_center_of_rotation', id);
+ *
+ * Get the detector offset found by a CenterOfRotation algorithm, to be
+ * applied with astra_geom_postalignment.
+ */
+void astra_mex_algorithm_get_center_of_rotation(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
+{
+	if (nrhs < 2) {
+		mexErrMsgTxt("Not enough arguments.  See the help document for a detailed argument list. \n");
+		return;
+	}
+	int iAid = (int)(mxGetScalar(prhs[1]));
+
+	CAlgorithm* pAlg = CAlgorithmManager::getSingleton().get(iAid);
+	if (!pAlg) {
+		mexErrMsgTxt("Invalid algorithm ID.\n");
+		return;
+	}
+	CCenterOfRotationAlgorithm* pCor = dynamic_cast<CCenterOfRotationAlgorithm*>(pAlg);
+	if (!pCor) {
+		mexErrMsgTxt("Operation not supported.\n");
+		return;
+	}
+
+	plhs[0] = mxCreateDoubleScalar((double)pCor->getOffset());
+}
+
 //-----------------------------------------------------------------------------------------
 /** astra_mex_algorithm('delete', id1, id2, ...);
  *
@@ -306,7 +363,7 @@ void astra_mex_algorithm_info(int nlhs, mxArray* plhs[], int nrhs, const mxArray
 static void printHelp()
 {
 	mexPrintf("Please specify a mode of operation.\n");
-	mexPrintf("Valid modes: create, info, delete, clear, run/iterate, get_res_norm\n");
+	mexPrintf("Valid modes: create, info, delete, clear, run/iterate, get_res_norm, get_memory_estimate, get_center_of_rotation\n");
 }
 
 //-----------------------------------------------------------------------------------------
@@ -340,6 +397,10 @@ void mexFunction(int nlhs, mxArray* plhs[],
 		astra_mex_algorithm_run(nlhs, plhs, nrhs, prhs);
 	} else if (sMode == "get_res_norm") {
 		astra_mex_algorithm_get_res_norm(nlhs, plhs, nrhs, prhs);
+	} else if (sMode == "get_memory_estimate") {
+		astra_mex_algorithm_get_memory_estimate(nlhs, plhs, nrhs, prhs);
+	} else if (sMode == "get_center_of_rotation") {
+		astra_mex_algorithm_get_center_of_rotation(nlhs, plhs, nrhs, prhs);
 	} else {
 		printHelp();
 	}
@@ -36,6 +36,8 @@ along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
 
 #include "astra/Globals.h"
 #include "astra/AstraObjectManager.h"
+#include "astra/Tracing.h"
+#include "astra/MemoryBudget.h"
 
 #ifdef ASTRA_CUDA
 #include "astra/cuda/2d/astra.h"
@@ -201,14 +203,72 @@ void astra_mex_delete(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[]
 
 }
 
+//-----------------------------------------------------------------------------------------
+/** astra_mex('start_trace', filename);
+ * 
+ * Start recording a Chrome trace of algorithm phases and jobs.
+ */
+void astra_mex_start_trace(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
+{
+	if (nrhs < 2) {
+		mexErrMsgTxt("Usage: astra_mex('start_trace', filename);\n");
+		return;
+	}
+
+	CTracer::start(mexToString(prhs[1]));
+}
+
+//-----------------------------------------------------------------------------------------
+/** astra_mex('stop_trace');
+ * 
+ * Stop recording and write the trace to the file given to start_trace.
+ */
+void astra_mex_stop_trace(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
+{
+	if (!CTracer::stop())
+		mexErrMsgTxt("Unable to write trace. Was start_trace called?\n");
+}
 
+//-----------------------------------------------------------------------------------------
+/** astra_mex('set_memory_limit', bytes);
+ * 
+ * Set the maximum host memory for data objects and algorithm temporaries.
+ * 0 means no limit.
+ */
+void astra_mex_set_memory_limit(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
+{
+	if (nrhs < 2) {
+		mexErrMsgTxt("Usage: astra_mex('set_memory_limit', bytes);\n");
+		return;
+	}
+
+	CMemoryBudget::getSingleton().setLimit((size_t)mxGetScalar(prhs[1]));
+}
+
+//-----------------------------------------------------------------------------------------
+/** usage = astra_mex('get_memory_usage');
+ * 
+ * Get the host memory accounted for data objects and algorithm
+ * temporaries, as a struct with fields used, peak and limit, in bytes.
+ */
+void astra_mex_get_memory_usage(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[])
+{
+	CMemoryBudget& budget = CMemoryBudget::getSingleton();
+
+	const char* fieldnames[] = { "used", "peak", "limit" };
+	mxArray* res = mxCreateStructMatrix(1, 1, 3, fieldnames);
+	mxSetField(res, 0, "used", mxCreateDoubleScalar((double)budget.getUsed()));
+	mxSetField(res, 0, "peak", mxCreateDoubleScalar((double)budget.getPeak()));
+	mxSetField(res, 0, "limit", mxCreateDoubleScalar((double)budget.getLimit()));
+	plhs[0] = res;
+}
 
 //-----------------------------------------------------------------------------------------
 
 static void printHelp()
 {
 	mexPrintf("Please specify a mode of operation.\n");
-	mexPrintf("   Valid modes: version, use_cuda, credits, set_gpu_index, info, delete\n");
+	mexPrintf("   Valid modes: version, use_cuda, credits, set_gpu_index, info, delete, start_trace, stop_trace, set_memory_limit, get_memory_usage\n");
 }
 
 //-----------------------------------------------------------------------------------------
@@ -245,6 +305,14 @@ void mexFunction(int nlhs, mxArray* plhs[],
 		astra_mex_info(nlhs, plhs, nrhs, prhs);
 	} else if (sMode == std::string("delete")) {
 		astra_mex_delete(nlhs, plhs, nrhs, prhs);
+	} else if (sMode == std::string("start_trace")) {
+		astra_mex_start_trace(nlhs, plhs, nrhs, prhs);
+	} else if (sMode == std::string("stop_trace")) {
+		astra_mex_stop_trace(nlhs, plhs, nrhs, prhs);
+	} else if (sMode == std::string("set_memory_limit")) {
+		astra_mex_set_memory_limit(nlhs, plhs, nrhs, prhs);
+	} else if (sMode == std::string("get_memory_usage")) {
+		astra_mex_get_memory_usage(nlhs, plhs, nrhs, prhs);
 	} else {
 		printHelp();
 	}
@@ -199,9 +199,7 @@ void astra_mex_data2d_create(int& nlhs, mxArray* plhs[], int& nrhs, const mxArra
 
 	// Store data
 	if (nrhs == 3) {
-		for (int i = 0; i < pDataObject2D->getSize(); ++i) {
-			pDataObject2D->getData()[i] = 0.0f;
-		}
+		pDataObject2D->setData(0.0f);
 	}
 
 	// Store data
@@ -209,9 +207,7 @@ void astra_mex_data2d_create(int& nlhs, mxArray* plhs[], int& nrhs, const mxArra
 		// fill with scalar value
 		if (mexIsScalar(prhs[3])) {
 			float32 fValue = (float32)mxGetScalar(prhs[3]);
-			for (int i = 0; i < pDataObject2D->getSize(); ++i) {
-				pDataObject2D->getData()[i] = fValue;
-			}
+			pDataObject2D->setData(fValue);
 		}
 		// fill with array value
 		else {
@@ -311,9 +307,7 @@ void astra_mex_data2d_store(int nlhs, mxArray* plhs[], int nrhs, const mxArray*
 	// fill with scalar value
 	if (mexIsScalar(prhs[2])) {
 		float32 fValue = (float32)mxGetScalar(prhs[2]);
-		for (int i = 0; i < pDataObject->getSize(); ++i) {
-			pDataObject->getData()[i] = fValue;
-		}
+		pDataObject->setData(fValue);
 	} else {
 		// Check Data dimensions
 		if (pDataObject->getWidth() != mxGetN(prhs[2]) || pDataObject->getHeight() != mxGetM(prhs[2])) {
@@ -229,6 +229,10 @@ void astra_mex_data3d_store(int nlhs, mxArray* plhs[], int nrhs, const mxArray*
 		mexErrMsgTxt("Data object not found or not initialized properly.\n");
 		return;
 	}
+	if (!pDataObject->isPacked()) {
+		mexErrMsgTxt("Data objects with padded rows are not supported.\n");
+		return;
+	}
 
 	copyMexToCFloat32Array(prhs[2], pDataObject->getData(), pDataObject->getSize());
 }
@@ -76,6 +76,10 @@ void generic_astra_mex_data3d_get(int nlhs, mxArray* plhs[], int nrhs,
 		mexErrMsgTxt("Data object not found or not initialized properly.\n");
 		return;
 	}
+	if (!pDataObject->isPacked()) {
+		mexErrMsgTxt("Data objects with padded rows are not supported.\n");
+		return;
+	}
 
 	// create output
 	if (1 <= nlhs) {
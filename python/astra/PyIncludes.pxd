@@ -109,8 +109,10 @@ cdef extern from "astra/Float32Data2D.h" namespace "astra":
         int getSize()
         float32 *getData()
         float32 **getData2D()
+        void setData(float32)
         int getWidth()
         int getHeight()
+        int getRowPitch()
         TWOEDataType getType()
 
 
@@ -151,6 +153,7 @@ cdef extern from "astra/Algorithm.h" namespace "astra":
         bool initialize(Config)
         void run(int) nogil
         bool isInitialized()
+        size_t getMemoryEstimate()
 
 cdef extern from "astra/ReconstructionAlgorithm2D.h" namespace "astra":
     cdef cppclass CReconstructionAlgorithm2D:
@@ -160,6 +163,10 @@ cdef extern from "astra/ReconstructionAlgorithm3D.h" namespace "astra":
     cdef cppclass CReconstructionAlgorithm3D:
         bool getResidualNorm(float32&)
 
+cdef extern from "astra/CenterOfRotationAlgorithm.h" namespace "astra":
+    cdef cppclass CCenterOfRotationAlgorithm:
+        float32 getOffset()
+
 cdef extern from "astra/Projector2D.h" namespace "astra":
     cdef cppclass CProjector2D:
         bool isInitialized()
@@ -174,6 +181,8 @@ cdef extern from "astra/Projector3D.h" namespace "astra":
         bool initialize(Config)
         CProjectionGeometry3D* getProjectionGeometry()
         CVolumeGeometry3D* getVolumeGeometry()
+        CSparseMatrix* getMatrix()
+        bool writeMatrix(string, int)
 
 IF HAVE_CUDA==True:
     cdef extern from "astra/CudaProjector3D.h" namespace "astra":
@@ -215,6 +224,8 @@ cdef extern from "astra/Float32Data3DMemory.h" namespace "astra":
         CFloat32Data3DMemory()
         void updateStatistics()
         float32 *getData()
+        void setData(float32)
+        int getRowPitch()
         THREEEDataType getType()
 
 
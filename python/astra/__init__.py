@@ -27,7 +27,7 @@ from . import matlab as m
 from .creators import astra_dict,create_vol_geom, create_proj_geom, create_backprojection, create_sino, create_reconstruction, create_projector,create_sino3d_gpu, create_backprojection3d_gpu
 from .functions import data_op, add_noise_to_sino, clear, move_vol_geom, geom_size, geom_2vec, geom_postalignment
 from .extrautils import clipCircle
-from .astra import set_gpu_index, get_gpu_info, use_cuda
+from .astra import set_gpu_index, get_gpu_info, use_cuda, start_trace, stop_trace, set_memory_limit, get_memory_usage
 from . import data2d
 from . import astra
 from . import data3d
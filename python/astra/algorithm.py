@@ -56,6 +56,30 @@ def get_res_norm(i):
     """
     
     return a.get_res_norm(i)
+
+def get_memory_estimate(i):
+    """Get the host memory the algorithm allocates for its temporaries.
+
+    The data objects passed to the algorithm are not included.
+
+    :param i: ID of object.
+    :type i: :class:`int`
+    :returns: :class:`int` -- The estimate in bytes.
+
+    """
+    return a.get_memory_estimate(i)
+
+def get_center_of_rotation(i):
+    """Get the detector offset found by a CenterOfRotation algorithm.
+
+    Apply it with :func:`astra.functions.geom_postalignment`.
+
+    :param i: ID of object.
+    :type i: :class:`int`
+    :returns: :class:`float` -- The offset in detector pixels.
+
+    """
+    return a.get_center_of_rotation(i)
     
 def delete(ids):
     """Delete a matrix object.
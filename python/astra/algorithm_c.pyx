@@ -46,6 +46,7 @@ cdef CAlgorithmManager * manAlg = <CAlgorithmManager * >PyAlgorithmManager.getSi
 cdef extern from *:
     CReconstructionAlgorithm2D * dynamic_cast_recAlg2D "dynamic_cast<astra::CReconstructionAlgorithm2D*>" (CAlgorithm * )
     CReconstructionAlgorithm3D * dynamic_cast_recAlg3D "dynamic_cast<astra::CReconstructionAlgorithm3D*>" (CAlgorithm * )
+    CCenterOfRotationAlgorithm * dynamic_cast_corAlg "dynamic_cast<astra::CCenterOfRotationAlgorithm*>" (CAlgorithm * )
 
 
 def create(config):
@@ -96,6 +97,17 @@ def get_res_norm(i):
     return res
 
 
+def get_memory_estimate(i):
+    cdef CAlgorithm * alg = getAlg(i)
+    return alg.getMemoryEstimate()
+
+
+def get_center_of_rotation(i):
+    cdef CCenterOfRotationAlgorithm * pAlg = dynamic_cast_corAlg(getAlg(i))
+    if pAlg == NULL:
+        raise Exception("Operation not supported.")
+    return pAlg.getOffset()
+
 def delete(ids):
     try:
         for i in ids:
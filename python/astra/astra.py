@@ -73,4 +73,37 @@ def info(ids):
     """
     return a.info(ids)
 
+def start_trace(filename):
+    """Start recording a trace of algorithm phases and jobs.
 
+    The trace is written in Chrome trace JSON format, and can be viewed in
+    chrome://tracing or https://ui.perfetto.dev .
+
+    :param filename: Output file, written by :func:`stop_trace`.
+    :type filename: :class:`str`
+    """
+    a.start_trace(filename)
+
+def stop_trace():
+    """Stop recording the trace started by :func:`start_trace`, and write it."""
+    a.stop_trace()
+
+def set_memory_limit(limit):
+    """Set the maximum host memory for data objects and algorithm temporaries.
+
+    Allocations over the limit fail: creating data or initializing an
+    algorithm raises an exception. Memory already allocated is not affected.
+
+    :param limit: Limit in bytes, or 0 for no limit.
+    :type limit: :class:`int`
+    """
+    a.set_memory_limit(limit)
+
+def get_memory_usage(reset_peak=False):
+    """Get the host memory accounted for data objects and algorithm temporaries.
+
+    :param reset_peak: Start a new peak measurement afterwards.
+    :type reset_peak: :class:`bool`
+    :returns: :class:`dict` -- Bytes currently 'used', the 'peak' usage and the 'limit'.
+    """
+    return a.get_memory_usage(reset_peak)
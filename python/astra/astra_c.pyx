@@ -57,6 +57,20 @@ cdef extern from "astra/CompositeGeometryManager.h" namespace "astra":
 cdef extern from "astra/CompositeGeometryManager.h" namespace "astra::CCompositeGeometryManager":
     void setGlobalGPUParams(SGPUParams&)
 
+cdef extern from "astra/Tracing.h":
+    void startTrace "astra::CTracer::start"(string)
+    bool stopTrace "astra::CTracer::stop"()
+
+cdef extern from "astra/MemoryBudget.h" namespace "astra":
+    cdef cppclass CMemoryBudget:
+        void setLimit(size_t)
+        size_t getLimit()
+        size_t getUsed()
+        size_t getPeak()
+        void resetPeak()
+cdef extern from "astra/MemoryBudget.h" namespace "astra::CMemoryBudget":
+    CMemoryBudget& getMemoryBudget "astra::CMemoryBudget::getSingleton"()
+
 
 def credits():
     six.print_("""The ASTRA Toolbox has been developed at the University of Antwerp and CWI, Amsterdam by
@@ -118,3 +132,20 @@ def info(ids):
         if ptr:
             s = ptr.getType() + six.b("\t") + ptr.getInfo(i)
             six.print_(wrap_from_bytes(s))
+
+def start_trace(filename):
+    startTrace(six.b(filename))
+
+def stop_trace():
+    if not stopTrace():
+        raise RuntimeError("Unable to write trace. Was start_trace called?")
+
+def set_memory_limit(limit):
+    getMemoryBudget().setLimit(limit)
+
+def get_memory_usage(reset_peak=False):
+    cdef CMemoryBudget* budget = &getMemoryBudget()
+    res = { 'used': budget.getUsed(), 'peak': budget.getPeak(), 'limit': budget.getLimit() }
+    if reset_peak:
+        budget.resetPeak()
+    return res
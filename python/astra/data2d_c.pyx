@@ -151,15 +151,13 @@ cdef fillDataObject(CFloat32Data2D * obj, data):
             fillDataObjectScalar(obj, np.float32(data))
 
 cdef fillDataObjectScalar(CFloat32Data2D * obj, float s):
-    cdef int i
-    for i in range(obj.getSize()):
-        obj.getData()[i] = s
+    obj.setData(s)
 
 @cython.boundscheck(False)
 @cython.wraparound(False)
 cdef fillDataObjectArray(CFloat32Data2D * obj, float [:,::1] data):
-    cdef float [:,::1] cView =  <float[:data.shape[0],:data.shape[1]]> obj.getData2D()[0]
-    cView[:] = data
+    cdef float [:,::1] cView =  <float[:data.shape[0],:obj.getRowPitch()]> obj.getData2D()[0]
+    cView[:,:data.shape[1]] = data
 
 cdef CFloat32Data2D * getObject(i) except NULL:
     cdef CFloat32Data2D * pDataObject = man2d.get(i)
@@ -272,16 +270,17 @@ def get(i):
     cdef CFloat32Data2D * pDataObject = getObject(i)
     outArr = np.empty((pDataObject.getHeight(), pDataObject.getWidth()),dtype=np.float32,order='C')
     cdef float [:,::1] mView = outArr
-    cdef float [:,::1] cView =  <float[:outArr.shape[0],:outArr.shape[1]]> pDataObject.getData2D()[0]
-    mView[:] = cView
+    cdef float [:,::1] cView =  <float[:outArr.shape[0],:pDataObject.getRowPitch()]> pDataObject.getData2D()[0]
+    mView[:] = cView[:,:outArr.shape[1]]
     return outArr
 
 def get_shared(i):
     cdef CFloat32Data2D * pDataObject = getObject(i)
     cdef np.npy_intp shape[2]
     shape[0] = <np.npy_intp> pDataObject.getHeight()
-    shape[1] = <np.npy_intp> pDataObject.getWidth()
-    return np.PyArray_SimpleNewFromData(2,shape,np.NPY_FLOAT32,<void *>pDataObject.getData2D()[0])
+    shape[1] = <np.npy_intp> pDataObject.getRowPitch()
+    # Padded rows are hidden by slicing the full block
+    return np.PyArray_SimpleNewFromData(2,shape,np.NPY_FLOAT32,<void *>pDataObject.getData2D()[0])[:,:pDataObject.getWidth()]
 
 
 def get_single(i):
@@ -247,15 +247,13 @@ cdef fillDataObject(CFloat32Data3DMemory * obj, data):
             fillDataObjectScalar(obj, np.float32(data))
 
 cdef fillDataObjectScalar(CFloat32Data3DMemory * obj, float s):
-    cdef int i
-    for i in range(obj.getSize()):
-        obj.getData()[i] = s
+    obj.setData(s)
 
 @cython.boundscheck(False)
 @cython.wraparound(False)
 cdef fillDataObjectArray(CFloat32Data3DMemory * obj, float [:,:,::1] data):
-    cdef float [:,:,::1] cView = <float[:data.shape[0],:data.shape[1],:data.shape[2]]> obj.getData()
-    cView[:] = data
+    cdef float [:,:,::1] cView = <float[:data.shape[0],:data.shape[1],:obj.getRowPitch()]> obj.getData()
+    cView[:,:,:data.shape[2]] = data
 
 cdef CFloat32Data3D * getObject(i) except NULL:
     cdef CFloat32Data3D * pDataObject = man3d.get(i)
@@ -271,8 +269,8 @@ def get(i):
     cdef CFloat32Data3DMemory * pDataObject = dynamic_cast_mem_safe(getObject(i))
     outArr = np.empty((pDataObject.getDepth(),pDataObject.getHeight(), pDataObject.getWidth()),dtype=np.float32,order='C')
     cdef float [:,:,::1] mView = outArr
-    cdef float [:,:,::1] cView = <float[:outArr.shape[0],:outArr.shape[1],:outArr.shape[2]]> pDataObject.getData()
-    mView[:] = cView
+    cdef float [:,:,::1] cView = <float[:outArr.shape[0],:outArr.shape[1],:pDataObject.getRowPitch()]> pDataObject.getData()
+    mView[:] = cView[:,:,:outArr.shape[2]]
     return outArr
 
 def get_shared(i):
@@ -281,8 +279,9 @@ def get_shared(i):
     cdef np.npy_intp shape[3]
     shape[0] = <np.npy_intp> pDataObject.getDepth()
     shape[1] = <np.npy_intp> pDataObject.getHeight()
-    shape[2] = <np.npy_intp> pDataObject.getWidth()
-    return np.PyArray_SimpleNewFromData(3,shape,np.NPY_FLOAT32,<void *>pDataObject.getData())
+    shape[2] = <np.npy_intp> pDataObject.getRowPitch()
+    # Padded rows are hidden by slicing the full block
+    return np.PyArray_SimpleNewFromData(3,shape,np.NPY_FLOAT32,<void *>pDataObject.getData())[:,:,:pDataObject.getWidth()]
 
 def get_single(i):
     raise NotImplementedError("Not yet implemented")
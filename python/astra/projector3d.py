@@ -98,3 +98,30 @@ def is_cuda(i):
 
     """
     return p.is_cuda(i)
+
+
+def matrix(i):
+    """Get sparse matrix of a projector, with one row per detector pixel in
+    the (row, angle, column) order of 3D projection data.
+
+    :param i: ID of projector.
+    :type i: :class:`int`
+    :returns: :class:`int` -- ID of sparse matrix.
+
+    """
+    return p.matrix(i)
+
+
+def write_matrix(i, filename, slab_rows=0):
+    """Write the sparse matrix of a projector to a binary file, in blocks of
+    detector rows, without keeping the whole matrix in memory.
+
+    :param i: ID of projector.
+    :type i: :class:`int`
+    :param filename: Name of the output file.
+    :type filename: :class:`string`
+    :param slab_rows: Detector rows per block, or 0 to choose automatically.
+    :type slab_rows: :class:`int`
+
+    """
+    p.write_matrix(i, filename, slab_rows)
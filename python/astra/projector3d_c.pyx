@@ -41,7 +41,11 @@ from .PyProjector3DManager cimport CProjector3DManager
 cimport PyXMLDocument
 from .PyXMLDocument cimport XMLDocument
 
+cimport PyMatrixManager
+from .PyMatrixManager cimport CMatrixManager
+
 cdef CProjector3DManager * manProj = <CProjector3DManager * >PyProjector3DManager.getSingletonPtr()
+cdef CMatrixManager * manM = <CMatrixManager * >PyMatrixManager.getSingletonPtr()
 
 include "config.pxi"
 
@@ -116,6 +120,21 @@ def weights_projection(i, projection_index):
 def splat(i, row, col):
     raise Exception("Not yet implemented")
 
+def matrix(i):
+    cdef CProjector3D * proj = getObject(i)
+    cdef CSparseMatrix * mat = proj.getMatrix()
+    if mat == NULL:
+        raise Exception("Projector3D can't compute a system matrix.")
+    if not mat.isInitialized():
+        del mat
+        raise Exception("Data object not initialized properly.")
+    return manM.store(mat)
+
+def write_matrix(i, filename, slab_rows=0):
+    cdef CProjector3D * proj = getObject(i)
+    if not proj.writeMatrix(six.b(filename), slab_rows):
+        raise Exception("Unable to write the system matrix.")
+
 def is_cuda(i):
     cdef CProjector3D * proj = getObject(i)
     IF HAVE_CUDA==True:
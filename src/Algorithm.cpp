@@ -33,7 +33,7 @@ namespace astra {
 
 //----------------------------------------------------------------------------------------
 // Constructor
-CAlgorithm::CAlgorithm() : m_bShouldAbort(false), configCheckData(0) {
+CAlgorithm::CAlgorithm() : m_bShouldAbort(false), m_bAbortRequested(false), m_pProgress(0), configCheckData(0) {
 	
 }
 
@@ -49,6 +49,9 @@ map<string,boost::any> CAlgorithm::getInformation()
 {
 	map<string, boost::any> result;
 	result["Initialized"] = getInformation("Initialized");
+	result["MemoryEstimate"] = getInformation("MemoryEstimate");
+	if (m_timings.isEnabled())
+		result["Timings"] = getInformation("Timings");
 	return result;
 };
 
@@ -57,6 +60,11 @@ map<string,boost::any> CAlgorithm::getInformation()
 boost::any CAlgorithm::getInformation(std::string _sIdentifier)
 {
 	if (_sIdentifier == "Initialized") { return m_bIsInitialized ? "yes" : "no"; } 
+	if (_sIdentifier == "MemoryEstimate") { return (float32)getMemoryEstimate(); }
+	if (_sIdentifier == "Timings") {
+		if (!m_timings.isEnabled()) return std::string("not enabled");
+		return m_timings.getInformation();
+	}
 	return std::string("not found");
 }
 
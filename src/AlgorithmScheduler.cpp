@@ -0,0 +1,283 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#include "astra/AlgorithmScheduler.h"
+#include "astra/WorkerPool.h"
+#include "astra/Tracing.h"
+
+namespace astra {
+
+DEFINE_SINGLETON(CAlgorithmScheduler)
+
+//----------------------------------------------------------------------------------------
+// Task running a job on the worker pool. It holds a reference to the job,
+// so the job stays alive until the task has finished.
+class CAlgorithmJobTask : public CWorkerTask {
+public:
+	CAlgorithmJobTask(const CAlgorithmScheduler::TJob& _pJob) : m_pJob(_pJob) { }
+	virtual void run();
+private:
+	CAlgorithmScheduler::TJob m_pJob;
+};
+
+void CAlgorithmJobTask::run()
+{
+	// A job cancelled while it was queued on the pool doesn't run at all.
+	// Once it has started, cancellation uses requestAbort(), which survives
+	// the reset of the abort flag at the start of run().
+	if (CAlgorithmScheduler::getSingleton()._start(m_pJob.get())) {
+		CTraceScope trace("algorithm", "scheduled job");
+		trace.addArg("priority", m_pJob->getPriority());
+		m_pJob->getAlgorithm()->run(m_pJob->m_iIterations);
+	}
+	CAlgorithmScheduler::getSingleton()._finished(m_pJob.get());
+}
+
+//----------------------------------------------------------------------------------------
+CAlgorithmJob::CAlgorithmJob()
+{
+	m_pAlg = 0;
+	m_iIterations = 0;
+	m_iPriority = 0;
+	m_iMemory = 0;
+	m_iSequence = 0;
+	m_eState = JOB_PENDING;
+	m_bStarted = false;
+	m_bCancelRequested = false;
+}
+
+void CAlgorithmJob::wait()
+{
+	CAlgorithmScheduler::getSingleton()._wait(this);
+}
+
+void CAlgorithmJob::cancel()
+{
+	CAlgorithmScheduler::getSingleton()._cancel(this);
+}
+
+//----------------------------------------------------------------------------------------
+CAlgorithmScheduler::CAlgorithmScheduler()
+{
+	m_iMemoryInUse = 0;
+	m_iNextSequence = 0;
+}
+
+CAlgorithmScheduler::~CAlgorithmScheduler()
+{
+
+}
+
+//----------------------------------------------------------------------------------------
+CAlgorithmScheduler::TJob CAlgorithmScheduler::submit(CAlgorithm* _pAlg, int _iNrIterations, int _iPriority, size_t _iMemory)
+{
+	TJob pJob(new CAlgorithmJob());
+	pJob->m_pAlg = _pAlg;
+	pJob->m_iIterations = _iNrIterations;
+	pJob->m_iPriority = _iPriority;
+	pJob->m_iMemory = _iMemory ? _iMemory : _pAlg->getMemoryEstimate();
+
+	CMutexLock lock(m_mutex);
+	pJob->m_iSequence = m_iNextSequence++;
+	m_pending.push_back(pJob);
+	_dispatch();
+
+	return pJob;
+}
+
+//----------------------------------------------------------------------------------------
+void CAlgorithmScheduler::_dispatch()
+{
+	int iMaxRunning = m_params.iMaxRunning;
+	if (iMaxRunning <= 0)
+		iMaxRunning = CWorkerPool::getSingleton().getThreadCount();
+
+	while (!m_pending.empty() && (int)m_running.size() < iMaxRunning) {
+		// highest priority first, then first submitted
+		size_t iBest = 0;
+		for (size_t i = 1; i < m_pending.size(); ++i) {
+			const CAlgorithmJob* a = m_pending[i].get();
+			const CAlgorithmJob* b = m_pending[iBest].get();
+			if (a->m_iPriority > b->m_iPriority || (a->m_iPriority == b->m_iPriority && a->m_iSequence < b->m_iSequence))
+				iBest = i;
+		}
+
+		TJob pJob = m_pending[iBest];
+
+		// Don't let smaller jobs overtake a job that is waiting for memory,
+		// so it can't starve.
+		if (m_params.iMemoryBudget > 0 && !m_running.empty() &&
+		    m_iMemoryInUse + pJob->m_iMemory > m_params.iMemoryBudget)
+			break;
+
+		m_pending.erase(m_pending.begin() + iBest);
+		m_running.push_back(pJob);
+		m_iMemoryInUse += pJob->m_iMemory;
+		pJob->m_eState = CAlgorithmJob::JOB_RUNNING;
+
+		CWorkerPool::getSingleton().submit(new CAlgorithmJobTask(pJob), 0, true);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+bool CAlgorithmScheduler::_start(CAlgorithmJob* _pJob)
+{
+	CMutexLock lock(m_mutex);
+
+	if (_pJob->m_bCancelRequested)
+		return false;
+	_pJob->m_bStarted = true;
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+void CAlgorithmScheduler::_finished(CAlgorithmJob* _pJob)
+{
+	CMutexLock lock(m_mutex);
+
+	for (size_t i = 0; i < m_running.size(); ++i) {
+		if (m_running[i].get() == _pJob) {
+			m_running.erase(m_running.begin() + i);
+			break;
+		}
+	}
+	m_iMemoryInUse -= _pJob->m_iMemory;
+	_pJob->m_eState = _pJob->m_bCancelRequested ? CAlgorithmJob::JOB_CANCELLED : CAlgorithmJob::JOB_DONE;
+	if (_pJob->m_bCancelRequested && _pJob->m_bStarted)
+		_pJob->m_pAlg->clearAbortRequest();
+
+	_dispatch();
+	m_condChanged.notifyAll();
+}
+
+//----------------------------------------------------------------------------------------
+void CAlgorithmScheduler::_cancel(CAlgorithmJob* _pJob)
+{
+	CMutexLock lock(m_mutex);
+
+	if (_pJob->m_eState == CAlgorithmJob::JOB_PENDING) {
+		for (size_t i = 0; i < m_pending.size(); ++i) {
+			if (m_pending[i].get() == _pJob) {
+				m_pending.erase(m_pending.begin() + i);
+				break;
+			}
+		}
+		_pJob->m_eState = CAlgorithmJob::JOB_CANCELLED;
+		m_condChanged.notifyAll();
+	} else if (_pJob->m_eState == CAlgorithmJob::JOB_RUNNING) {
+		_pJob->m_bCancelRequested = true;
+		if (_pJob->m_bStarted)
+			_pJob->m_pAlg->requestAbort();
+	}
+}
+
+//----------------------------------------------------------------------------------------
+void CAlgorithmScheduler::_wait(CAlgorithmJob* _pJob)
+{
+	bool bWorker = CWorkerPool::isWorkerThread();
+
+	m_mutex.lock();
+	while (!_pJob->isDone()) {
+		// A pool worker helps executing queued tasks, so waiting from
+		// inside a task can't starve the pool.
+		if (bWorker) {
+			m_mutex.unlock();
+			bool bRan = CWorkerPool::getSingleton().runOneTask();
+			m_mutex.lock();
+			if (bRan)
+				continue;
+		}
+		if (!_pJob->isDone())
+			m_condChanged.wait(m_mutex);
+	}
+	m_mutex.unlock();
+}
+
+//----------------------------------------------------------------------------------------
+void CAlgorithmScheduler::waitAll()
+{
+	for (;;) {
+		TJob pJob;
+		{
+			CMutexLock lock(m_mutex);
+			if (!m_running.empty())
+				pJob = m_running.front();
+			else if (!m_pending.empty())
+				pJob = m_pending.front();
+			else
+				return;
+		}
+		_wait(pJob.get());
+	}
+}
+
+//----------------------------------------------------------------------------------------
+void CAlgorithmScheduler::cancelAll()
+{
+	CMutexLock lock(m_mutex);
+
+	for (size_t i = 0; i < m_pending.size(); ++i)
+		m_pending[i]->m_eState = CAlgorithmJob::JOB_CANCELLED;
+	m_pending.clear();
+
+	for (size_t i = 0; i < m_running.size(); ++i) {
+		m_running[i]->m_bCancelRequested = true;
+		if (m_running[i]->m_bStarted)
+			m_running[i]->m_pAlg->requestAbort();
+	}
+
+	m_condChanged.notifyAll();
+}
+
+//----------------------------------------------------------------------------------------
+int CAlgorithmScheduler::getPendingCount()
+{
+	CMutexLock lock(m_mutex);
+	return (int)m_pending.size();
+}
+
+int CAlgorithmScheduler::getRunningCount()
+{
+	CMutexLock lock(m_mutex);
+	return (int)m_running.size();
+}
+
+//----------------------------------------------------------------------------------------
+void CAlgorithmScheduler::setParams(const SAlgorithmSchedulerParams& _params)
+{
+	CMutexLock lock(m_mutex);
+	m_params = _params;
+	_dispatch();
+}
+
+SAlgorithmSchedulerParams CAlgorithmScheduler::getParams()
+{
+	CMutexLock lock(m_mutex);
+	return m_params;
+}
+
+} // end namespace
@@ -0,0 +1,120 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#include "astra/AlgorithmTimings.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <time.h>
+#include <sys/time.h>
+#endif
+
+namespace astra {
+
+//----------------------------------------------------------------------------------------
+CAlgorithmTimings::CAlgorithmTimings()
+{
+	m_bEnabled = false;
+	reset();
+}
+
+//----------------------------------------------------------------------------------------
+void CAlgorithmTimings::reset()
+{
+	for (int i = 0; i < ALGPHASE_COUNT; ++i) {
+		m_fTime[i] = 0.0;
+		m_iCalls[i] = 0;
+	}
+	m_fRays = 0.0;
+	m_fWeights = 0.0;
+	m_fBytes = 0.0;
+}
+
+//----------------------------------------------------------------------------------------
+void CAlgorithmTimings::addTime(EAlgorithmPhase _ePhase, double _fSeconds)
+{
+	if (!m_bEnabled)
+		return;
+	m_fTime[_ePhase] += _fSeconds;
+	m_iCalls[_ePhase]++;
+}
+
+//----------------------------------------------------------------------------------------
+std::map<std::string, boost::any> CAlgorithmTimings::getInformation() const
+{
+	std::map<std::string, boost::any> res;
+	double fTotal = 0.0;
+	for (int i = 0; i < ALGPHASE_COUNT; ++i) {
+		std::string sName = getPhaseName((EAlgorithmPhase)i);
+		res[sName + "_time"] = m_fTime[i];
+		res[sName + "_calls"] = m_iCalls[i];
+		fTotal += m_fTime[i];
+	}
+	res["total_time"] = fTotal;
+	res["rays"] = m_fRays;
+	res["weights"] = m_fWeights;
+	res["bytes"] = m_fBytes;
+	return res;
+}
+
+//----------------------------------------------------------------------------------------
+const char* CAlgorithmTimings::getPhaseName(EAlgorithmPhase _ePhase)
+{
+	switch (_ePhase) {
+	case ALGPHASE_SETUP: return "setup";
+	case ALGPHASE_WEIGHTS: return "weights";
+	case ALGPHASE_FP: return "fp";
+	case ALGPHASE_BP: return "bp";
+	case ALGPHASE_VECTOROPS: return "vectorops";
+	case ALGPHASE_FILTERING: return "filtering";
+	case ALGPHASE_HOSTCOPY: return "hostcopy";
+	default: return "unknown";
+	}
+}
+
+//----------------------------------------------------------------------------------------
+double CAlgorithmTimings::getClock()
+{
+#ifdef _WIN32
+	LARGE_INTEGER freq, count;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&count);
+	return (double)count.QuadPart / (double)freq.QuadPart;
+#elif defined(CLOCK_MONOTONIC)
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + 1e-9 * ts.tv_nsec;
+#else
+	struct timeval tv;
+	gettimeofday(&tv, 0);
+	return tv.tv_sec + 1e-6 * tv.tv_usec;
+#endif
+}
+
+} // end namespace
@@ -0,0 +1,558 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+#include "astra/AnalyticPhantom.h"
+
+#include <cmath>
+
+#include "astra/ParallelProjectionGeometry2D.h"
+#include "astra/ParallelVecProjectionGeometry2D.h"
+#include "astra/FanFlatProjectionGeometry2D.h"
+#include "astra/FanFlatVecProjectionGeometry2D.h"
+#include "astra/ParallelProjectionGeometry3D.h"
+#include "astra/ParallelVecProjectionGeometry3D.h"
+#include "astra/ConeProjectionGeometry3D.h"
+#include "astra/ConeVecProjectionGeometry3D.h"
+#include "astra/GeometryUtil3D.h"
+#include "astra/VolumeGeometry2D.h"
+#include "astra/VolumeGeometry3D.h"
+#include "astra/Float32VolumeData2D.h"
+#include "astra/Float32ProjectionData2D.h"
+#include "astra/Float32VolumeData3DMemory.h"
+#include "astra/Float32ProjectionData3DMemory.h"
+#include "astra/ScratchArena.h"
+#include "astra/WorkerPool.h"
+#include "astra/Logging.h"
+
+namespace astra {
+
+//----------------------------------------------------------------------------------------
+// Shepp-Logan ellipses on [-1,1]^2: value, value of the modified phantom,
+// semi-axes, centre, angle in degrees. The 3D phantom adds a z semi-axis
+// and centre.
+static const double s_sheppLogan[10][9] = {
+	//  A      mod A    a       b      c       x0     y0      z0    phi
+	{  2.0,   1.0,  0.6900, 0.920, 0.810,  0.00,  0.0000,  0.00,   0.0 },
+	{ -0.98, -0.8,  0.6624, 0.874, 0.780,  0.00, -0.0184,  0.00,   0.0 },
+	{ -0.02, -0.2,  0.1100, 0.310, 0.220,  0.22,  0.0000,  0.00, -18.0 },
+	{ -0.02, -0.2,  0.1600, 0.410, 0.280, -0.22,  0.0000,  0.00,  18.0 },
+	{  0.01,  0.1,  0.2100, 0.250, 0.410,  0.00,  0.3500, -0.15,   0.0 },
+	{  0.01,  0.1,  0.0460, 0.046, 0.050,  0.00,  0.1000,  0.25,   0.0 },
+	{  0.01,  0.1,  0.0460, 0.046, 0.050,  0.00, -0.1000,  0.25,   0.0 },
+	{  0.01,  0.1,  0.0460, 0.023, 0.050, -0.08, -0.6050,  0.00,   0.0 },
+	{  0.01,  0.1,  0.0230, 0.023, 0.020,  0.00, -0.6060,  0.00,   0.0 },
+	{  0.01,  0.1,  0.0230, 0.046, 0.020,  0.06, -0.6050,  0.00,   0.0 }
+};
+
+//----------------------------------------------------------------------------------------
+// An ellipse or ellipsoid as the affine image of the unit sphere. 2D
+// ellipses have a unit z semi-axis and are evaluated in the plane z = 0.
+struct SQuadric {
+	double fValue;
+	double fCX, fCY, fCZ;
+	double fInvX, fInvY, fInvZ;
+	double fCos, fSin;
+
+	void init(double _fValue, double _fCX, double _fCY, double _fCZ,
+	          double _fAX, double _fAY, double _fAZ, double _fAngle)
+	{
+		fValue = _fValue;
+		fCX = _fCX; fCY = _fCY; fCZ = _fCZ;
+		fInvX = 1.0 / _fAX; fInvY = 1.0 / _fAY; fInvZ = 1.0 / _fAZ;
+		fCos = cos(_fAngle);
+		fSin = sin(_fAngle);
+	}
+
+	// The parameters t0 < t1 where the line p + t d enters and leaves
+	bool intersect(double px, double py, double pz, double dx, double dy, double dz,
+	               double& t0, double& t1) const
+	{
+		px -= fCX; py -= fCY; pz -= fCZ;
+		const double qx = (fCos * px + fSin * py) * fInvX;
+		const double qy = (fCos * py - fSin * px) * fInvY;
+		const double qz = pz * fInvZ;
+		const double ex = (fCos * dx + fSin * dy) * fInvX;
+		const double ey = (fCos * dy - fSin * dx) * fInvY;
+		const double ez = dz * fInvZ;
+
+		const double a = ex * ex + ey * ey + ez * ez;
+		const double b = qx * ex + qy * ey + qz * ez;
+		const double c = qx * qx + qy * qy + qz * qz - 1.0;
+		const double fDisc = b * b - a * c;
+		if (fDisc <= 0.0 || a <= 0.0)
+			return false;
+		const double s = sqrt(fDisc);
+		t0 = (-b - s) / a;
+		t1 = (-b + s) / a;
+		return true;
+	}
+
+	bool contains(double px, double py, double pz) const
+	{
+		px -= fCX; py -= fCY; pz -= fCZ;
+		const double qx = (fCos * px + fSin * py) * fInvX;
+		const double qy = (fCos * py - fSin * px) * fInvY;
+		const double qz = pz * fInvZ;
+		return qx * qx + qy * qy + qz * qz <= 1.0;
+	}
+};
+
+//----------------------------------------------------------------------------------------
+static std::vector<SQuadric> toQuadrics(const std::vector<SEllipse>& _ellipses)
+{
+	std::vector<SQuadric> quadrics(_ellipses.size());
+	for (size_t i = 0; i < _ellipses.size(); ++i) {
+		const SEllipse& e = _ellipses[i];
+		quadrics[i].init(e.fValue, e.fCenterX, e.fCenterY, 0.0, e.fSemiAxisX, e.fSemiAxisY, 1.0, e.fAngle);
+	}
+	return quadrics;
+}
+
+static std::vector<SQuadric> toQuadrics(const std::vector<SEllipsoid>& _ellipsoids)
+{
+	std::vector<SQuadric> quadrics(_ellipsoids.size());
+	for (size_t i = 0; i < _ellipsoids.size(); ++i) {
+		const SEllipsoid& e = _ellipsoids[i];
+		quadrics[i].init(e.fValue, e.fCenterX, e.fCenterY, e.fCenterZ,
+		                 e.fSemiAxisX, e.fSemiAxisY, e.fSemiAxisZ, e.fAngle);
+	}
+	return quadrics;
+}
+
+//----------------------------------------------------------------------------------------
+static double lineIntegral(const std::vector<SQuadric>& _quadrics,
+                           double px, double py, double pz, double dx, double dy, double dz)
+{
+	double fSum = 0.0;
+	double t0, t1;
+	for (size_t i = 0; i < _quadrics.size(); ++i)
+		if (_quadrics[i].intersect(px, py, pz, dx, dy, dz, t0, t1))
+			fSum += _quadrics[i].fValue * (t1 - t0);
+	return fSum * sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+//----------------------------------------------------------------------------------------
+// Rasterize one volume row (fixed y and z) per index. Every sub-sample row
+// crosses each quadric in one interval of x, so the cost is proportional
+// to the covered sub-samples rather than to all of them times the number
+// of quadrics.
+struct SRasterizeFunctor {
+	const std::vector<SQuadric>* m_pQuadrics;
+	float32* m_pfOut;
+	int m_iCols, m_iRows;
+	int m_iPitch;
+	double m_fMinX, m_fPixelX;
+	double m_fY0, m_fStepY, m_fPixelY;
+	double m_fZ0, m_fPixelZ;
+	int m_iSuperSampling;
+	bool m_b3D;
+	volatile bool* m_pbFailed;
+
+	void operator()(int _iFrom, int _iTo) const {
+		const int s = m_iSuperSampling;
+		const int sz = m_b3D ? s : 1;
+		const int iSubCols = m_iCols * s;
+		const double h = m_fPixelX / s;
+		const double fWeight = 1.0 / ((double)s * s * sz);
+		CScratchBuffer<double> acc(m_iCols);
+		if (!acc) {
+			*m_pbFailed = true;
+			return;
+		}
+
+		for (int iLine = _iFrom; iLine < _iTo; ++iLine) {
+			const int y = iLine % m_iRows;
+			const int z = iLine / m_iRows;
+			double* pfAcc = acc;
+			for (int x = 0; x < m_iCols; ++x)
+				pfAcc[x] = 0.0;
+
+			for (int jz = 0; jz < sz; ++jz) {
+				const double fZ = m_b3D ? m_fZ0 + (z + (jz + 0.5) / s) * m_fPixelZ : 0.0;
+				for (int jy = 0; jy < s; ++jy) {
+					const double fY = m_fY0 + m_fStepY * (y + (jy + 0.5) / s) * m_fPixelY;
+					for (size_t i = 0; i < m_pQuadrics->size(); ++i) {
+						const SQuadric& q = (*m_pQuadrics)[i];
+						double t0, t1;
+						if (!q.intersect(0.0, fY, fZ, 1.0, 0.0, 0.0, t0, t1))
+							continue;
+						// sub-sample k is at m_fMinX + (k + 0.5) h
+						int k0 = (int)ceil((t0 - m_fMinX) / h - 0.5);
+						int k1 = (int)floor((t1 - m_fMinX) / h - 0.5);
+						if (k0 < 0) k0 = 0;
+						if (k1 >= iSubCols) k1 = iSubCols - 1;
+						for (int k = k0; k <= k1; ++k)
+							pfAcc[k / s] += q.fValue;
+					}
+				}
+			}
+
+			float32* pfOut = m_pfOut + (size_t)iLine * m_iPitch;
+			for (int x = 0; x < m_iCols; ++x)
+				pfOut[x] = (float32)(fWeight * pfAcc[x]);
+		}
+	}
+};
+
+//----------------------------------------------------------------------------------------
+struct SProjectPar2DFunctor {
+	const std::vector<SQuadric>* m_pQuadrics;
+	const SParProjection* m_pProjs;
+	float32* m_pfOut;
+	int m_iDetCount;
+	int m_iPitch;
+
+	void operator()(int _iFrom, int _iTo) const {
+		for (int a = _iFrom; a < _iTo; ++a) {
+			const SParProjection& p = m_pProjs[a];
+			const double fDetSize = sqrt((double)p.fDetUX * p.fDetUX + (double)p.fDetUY * p.fDetUY);
+			for (int i = 0; i < m_iDetCount; ++i) {
+				double fX = p.fDetSX + (i + 0.5) * p.fDetUX;
+				double fY = p.fDetSY + (i + 0.5) * p.fDetUY;
+				m_pfOut[(size_t)a * m_iPitch + i] = (float32)(fDetSize * lineIntegral(*m_pQuadrics, fX, fY, 0.0, p.fRayX, p.fRayY, 0.0));
+			}
+		}
+	}
+};
+
+struct SProjectFan2DFunctor {
+	const std::vector<SQuadric>* m_pQuadrics;
+	const SFanProjection* m_pProjs;
+	float32* m_pfOut;
+	int m_iDetCount;
+	int m_iPitch;
+
+	void operator()(int _iFrom, int _iTo) const {
+		for (int a = _iFrom; a < _iTo; ++a) {
+			const SFanProjection& p = m_pProjs[a];
+			const double fDetSize = sqrt((double)p.fDetUX * p.fDetUX + (double)p.fDetUY * p.fDetUY);
+			for (int i = 0; i < m_iDetCount; ++i) {
+				double fDX = p.fDetSX + (i + 0.5) * p.fDetUX - p.fSrcX;
+				double fDY = p.fDetSY + (i + 0.5) * p.fDetUY - p.fSrcY;
+				m_pfOut[(size_t)a * m_iPitch + i] = (float32)(fDetSize * lineIntegral(*m_pQuadrics, p.fSrcX, p.fSrcY, 0.0, fDX, fDY, 0.0));
+			}
+		}
+	}
+};
+
+//----------------------------------------------------------------------------------------
+// 3D projection data is stored as [row][angle][column]
+struct SProjectPar3DFunctor {
+	const std::vector<SQuadric>* m_pQuadrics;
+	const SPar3DProjection* m_pProjs;
+	float32* m_pfOut;
+	int m_iCols, m_iAngles, m_iRows;
+	int m_iPitch;
+
+	void operator()(int _iFrom, int _iTo) const {
+		for (int a = _iFrom; a < _iTo; ++a) {
+			const SPar3DProjection& p = m_pProjs[a];
+			for (int v = 0; v < m_iRows; ++v) {
+				float32* pfOut = m_pfOut + ((size_t)v * m_iAngles + a) * m_iPitch;
+				for (int u = 0; u < m_iCols; ++u) {
+					double fX = p.fDetSX + (u + 0.5) * p.fDetUX + (v + 0.5) * p.fDetVX;
+					double fY = p.fDetSY + (u + 0.5) * p.fDetUY + (v + 0.5) * p.fDetVY;
+					double fZ = p.fDetSZ + (u + 0.5) * p.fDetUZ + (v + 0.5) * p.fDetVZ;
+					pfOut[u] = (float32)lineIntegral(*m_pQuadrics, fX, fY, fZ, p.fRayX, p.fRayY, p.fRayZ);
+				}
+			}
+		}
+	}
+};
+
+struct SProjectConeFunctor {
+	const std::vector<SQuadric>* m_pQuadrics;
+	const SConeProjection* m_pProjs;
+	float32* m_pfOut;
+	int m_iCols, m_iAngles, m_iRows;
+	int m_iPitch;
+
+	void operator()(int _iFrom, int _iTo) const {
+		for (int a = _iFrom; a < _iTo; ++a) {
+			const SConeProjection& p = m_pProjs[a];
+			for (int v = 0; v < m_iRows; ++v) {
+				float32* pfOut = m_pfOut + ((size_t)v * m_iAngles + a) * m_iPitch;
+				for (int u = 0; u < m_iCols; ++u) {
+					double fDX = p.fDetSX + (u + 0.5) * p.fDetUX + (v + 0.5) * p.fDetVX - p.fSrcX;
+					double fDY = p.fDetSY + (u + 0.5) * p.fDetUY + (v + 0.5) * p.fDetVY - p.fSrcY;
+					double fDZ = p.fDetSZ + (u + 0.5) * p.fDetUZ + (v + 0.5) * p.fDetVZ - p.fSrcZ;
+					pfOut[u] = (float32)lineIntegral(*m_pQuadrics, p.fSrcX, p.fSrcY, p.fSrcZ, fDX, fDY, fDZ);
+				}
+			}
+		}
+	}
+};
+
+//----------------------------------------------------------------------------------------
+CEllipsePhantom2D CEllipsePhantom2D::createSheppLogan(float64 _fRadius, bool _bModified)
+{
+	CEllipsePhantom2D phantom;
+	for (int i = 0; i < 10; ++i) {
+		const double* r = s_sheppLogan[i];
+		SEllipse e;
+		e.fValue = _bModified ? r[1] : r[0];
+		e.fSemiAxisX = r[2] * _fRadius;
+		e.fSemiAxisY = r[3] * _fRadius;
+		e.fCenterX = r[5] * _fRadius;
+		e.fCenterY = r[6] * _fRadius;
+		e.fAngle = r[8] * PI / 180.0;
+		phantom.addEllipse(e);
+	}
+	return phantom;
+}
+
+//----------------------------------------------------------------------------------------
+float64 CEllipsePhantom2D::getValue(float64 _fX, float64 _fY) const
+{
+	std::vector<SQuadric> quadrics = toQuadrics(m_ellipses);
+	double fSum = 0.0;
+	for (size_t i = 0; i < quadrics.size(); ++i)
+		if (quadrics[i].contains(_fX, _fY, 0.0))
+			fSum += quadrics[i].fValue;
+	return fSum;
+}
+
+//----------------------------------------------------------------------------------------
+float64 CEllipsePhantom2D::getLineIntegral(float64 _fX, float64 _fY, float64 _fDX, float64 _fDY) const
+{
+	return lineIntegral(toQuadrics(m_ellipses), _fX, _fY, 0.0, _fDX, _fDY, 0.0);
+}
+
+//----------------------------------------------------------------------------------------
+bool CEllipsePhantom2D::rasterize(CFloat32VolumeData2D* _pVolume, int _iSuperSampling) const
+{
+	if (!_pVolume || _iSuperSampling < 1) {
+		ASTRA_ERROR("CEllipsePhantom2D::rasterize: invalid arguments");
+		return false;
+	}
+
+	const CVolumeGeometry2D* pGeom = _pVolume->getGeometry();
+	std::vector<SQuadric> quadrics = toQuadrics(m_ellipses);
+
+	// row 0 is at the top of the volume
+	SRasterizeFunctor f;
+	f.m_pQuadrics = &quadrics;
+	f.m_pfOut = _pVolume->getData();
+	f.m_iCols = pGeom->getGridColCount();
+	f.m_iRows = pGeom->getGridRowCount();
+	f.m_iPitch = _pVolume->getRowPitch();
+	f.m_fMinX = pGeom->getWindowMinX();
+	f.m_fPixelX = pGeom->getPixelLengthX();
+	f.m_fY0 = pGeom->getWindowMaxY();
+	f.m_fStepY = -1.0;
+	f.m_fPixelY = pGeom->getPixelLengthY();
+	f.m_fZ0 = 0.0;
+	f.m_fPixelZ = 0.0;
+	f.m_iSuperSampling = _iSuperSampling;
+	f.m_b3D = false;
+	volatile bool bFailed = false;
+	f.m_pbFailed = &bFailed;
+	CWorkerPool::getSingleton().parallelFor(0, f.m_iRows, f);
+
+	if (bFailed) {
+		ASTRA_ERROR("CEllipsePhantom2D::rasterize: unable to allocate the row buffers");
+		return false;
+	}
+
+	_pVolume->updateStatistics();
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+bool CEllipsePhantom2D::project(CFloat32ProjectionData2D* _pProjection) const
+{
+	CProjectionGeometry2D* pGeom = _pProjection->getGeometry();
+	const int iAngleCount = pGeom->getProjectionAngleCount();
+	std::vector<SQuadric> quadrics = toQuadrics(m_ellipses);
+
+	CParallelProjectionGeometry2D* pPar = dynamic_cast<CParallelProjectionGeometry2D*>(pGeom);
+	CParallelVecProjectionGeometry2D* pParVec = dynamic_cast<CParallelVecProjectionGeometry2D*>(pGeom);
+	CFanFlatProjectionGeometry2D* pFan = dynamic_cast<CFanFlatProjectionGeometry2D*>(pGeom);
+	CFanFlatVecProjectionGeometry2D* pFanVec = dynamic_cast<CFanFlatVecProjectionGeometry2D*>(pGeom);
+
+	if (pPar || pParVec) {
+		CParallelVecProjectionGeometry2D* pVec = pPar ? pPar->toVectorGeometry() : pParVec;
+		SProjectPar2DFunctor f;
+		f.m_pQuadrics = &quadrics;
+		f.m_pProjs = pVec->getProjectionVectors();
+		f.m_pfOut = _pProjection->getData();
+		f.m_iDetCount = pGeom->getDetectorCount();
+		f.m_iPitch = _pProjection->getRowPitch();
+		CWorkerPool::getSingleton().parallelFor(0, iAngleCount, f);
+		if (pPar)
+			delete pVec;
+	} else if (pFan || pFanVec) {
+		CFanFlatVecProjectionGeometry2D* pVec = pFan ? pFan->toVectorGeometry() : pFanVec;
+		SProjectFan2DFunctor f;
+		f.m_pQuadrics = &quadrics;
+		f.m_pProjs = pVec->getProjectionVectors();
+		f.m_pfOut = _pProjection->getData();
+		f.m_iDetCount = pGeom->getDetectorCount();
+		f.m_iPitch = _pProjection->getRowPitch();
+		CWorkerPool::getSingleton().parallelFor(0, iAngleCount, f);
+		if (pFan)
+			delete pVec;
+	} else {
+		ASTRA_ERROR("CEllipsePhantom2D::project: unsupported projection geometry");
+		return false;
+	}
+
+	_pProjection->updateStatistics();
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+CEllipsoidPhantom3D CEllipsoidPhantom3D::createSheppLogan(float64 _fRadius, bool _bModified)
+{
+	CEllipsoidPhantom3D phantom;
+	for (int i = 0; i < 10; ++i) {
+		const double* r = s_sheppLogan[i];
+		SEllipsoid e;
+		e.fValue = _bModified ? r[1] : r[0];
+		e.fSemiAxisX = r[2] * _fRadius;
+		e.fSemiAxisY = r[3] * _fRadius;
+		e.fSemiAxisZ = r[4] * _fRadius;
+		e.fCenterX = r[5] * _fRadius;
+		e.fCenterY = r[6] * _fRadius;
+		e.fCenterZ = r[7] * _fRadius;
+		e.fAngle = r[8] * PI / 180.0;
+		phantom.addEllipsoid(e);
+	}
+	return phantom;
+}
+
+//----------------------------------------------------------------------------------------
+float64 CEllipsoidPhantom3D::getValue(float64 _fX, float64 _fY, float64 _fZ) const
+{
+	std::vector<SQuadric> quadrics = toQuadrics(m_ellipsoids);
+	double fSum = 0.0;
+	for (size_t i = 0; i < quadrics.size(); ++i)
+		if (quadrics[i].contains(_fX, _fY, _fZ))
+			fSum += quadrics[i].fValue;
+	return fSum;
+}
+
+//----------------------------------------------------------------------------------------
+float64 CEllipsoidPhantom3D::getLineIntegral(float64 _fX, float64 _fY, float64 _fZ,
+                                             float64 _fDX, float64 _fDY, float64 _fDZ) const
+{
+	return lineIntegral(toQuadrics(m_ellipsoids), _fX, _fY, _fZ, _fDX, _fDY, _fDZ);
+}
+
+//----------------------------------------------------------------------------------------
+bool CEllipsoidPhantom3D::rasterize(CFloat32VolumeData3DMemory* _pVolume, int _iSuperSampling) const
+{
+	if (!_pVolume || _iSuperSampling < 1) {
+		ASTRA_ERROR("CEllipsoidPhantom3D::rasterize: invalid arguments");
+		return false;
+	}
+
+	const CVolumeGeometry3D* pGeom = _pVolume->getGeometry();
+	std::vector<SQuadric> quadrics = toQuadrics(m_ellipsoids);
+
+	SRasterizeFunctor f;
+	f.m_pQuadrics = &quadrics;
+	f.m_pfOut = _pVolume->getData();
+	f.m_iCols = pGeom->getGridColCount();
+	f.m_iRows = pGeom->getGridRowCount();
+	f.m_iPitch = _pVolume->getRowPitch();
+	f.m_fMinX = pGeom->getWindowMinX();
+	f.m_fPixelX = pGeom->getPixelLengthX();
+	f.m_fY0 = pGeom->getWindowMinY();
+	f.m_fStepY = 1.0;
+	f.m_fPixelY = pGeom->getPixelLengthY();
+	f.m_fZ0 = pGeom->getWindowMinZ();
+	f.m_fPixelZ = pGeom->getPixelLengthZ();
+	f.m_iSuperSampling = _iSuperSampling;
+	f.m_b3D = true;
+	volatile bool bFailed = false;
+	f.m_pbFailed = &bFailed;
+	CWorkerPool::getSingleton().parallelFor(0, f.m_iRows * pGeom->getGridSliceCount(), f);
+
+	if (bFailed) {
+		ASTRA_ERROR("CEllipsoidPhantom3D::rasterize: unable to allocate the row buffers");
+		return false;
+	}
+
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+bool CEllipsoidPhantom3D::project(CFloat32ProjectionData3DMemory* _pProjection) const
+{
+	const CProjectionGeometry3D* pGeom = _pProjection->getGeometry();
+	const int iAngleCount = pGeom->getProjectionCount();
+	const int iCols = pGeom->getDetectorColCount();
+	const int iRows = pGeom->getDetectorRowCount();
+	std::vector<SQuadric> quadrics = toQuadrics(m_ellipsoids);
+
+	const CParallelProjectionGeometry3D* pPar = dynamic_cast<const CParallelProjectionGeometry3D*>(pGeom);
+	const CParallelVecProjectionGeometry3D* pParVec = dynamic_cast<const CParallelVecProjectionGeometry3D*>(pGeom);
+	const CConeProjectionGeometry3D* pCone = dynamic_cast<const CConeProjectionGeometry3D*>(pGeom);
+	const CConeVecProjectionGeometry3D* pConeVec = dynamic_cast<const CConeVecProjectionGeometry3D*>(pGeom);
+
+	if (pPar || pParVec) {
+		SPar3DProjection* pOwned = 0;
+		if (pPar)
+			pOwned = genPar3DProjections(iAngleCount, iCols, iRows,
+			                             pPar->getDetectorSpacingX(), pPar->getDetectorSpacingY(),
+			                             pPar->getProjectionAngles());
+		SProjectPar3DFunctor f;
+		f.m_pQuadrics = &quadrics;
+		f.m_pProjs = pPar ? pOwned : pParVec->getProjectionVectors();
+		f.m_pfOut = _pProjection->getData();
+		f.m_iCols = iCols;
+		f.m_iAngles = iAngleCount;
+		f.m_iRows = iRows;
+		f.m_iPitch = _pProjection->getRowPitch();
+		CWorkerPool::getSingleton().parallelFor(0, iAngleCount, f);
+		delete[] pOwned;
+	} else if (pCone || pConeVec) {
+		SConeProjection* pOwned = 0;
+		if (pCone)
+			pOwned = genConeProjections(iAngleCount, iCols, iRows,
+			                            pCone->getOriginSourceDistance(), pCone->getOriginDetectorDistance(),
+			                            pCone->getDetectorSpacingX(), pCone->getDetectorSpacingY(),
+			                            pCone->getProjectionAngles());
+		SProjectConeFunctor f;
+		f.m_pQuadrics = &quadrics;
+		f.m_pProjs = pCone ? pOwned : pConeVec->getProjectionVectors();
+		f.m_pfOut = _pProjection->getData();
+		f.m_iCols = iCols;
+		f.m_iAngles = iAngleCount;
+		f.m_iRows = iRows;
+		f.m_iPitch = _pProjection->getRowPitch();
+		CWorkerPool::getSingleton().parallelFor(0, iAngleCount, f);
+		delete[] pOwned;
+	} else {
+		ASTRA_ERROR("CEllipsoidPhantom3D::project: unsupported projection geometry");
+		return false;
+	}
+
+	return true;
+}
+
+} // namespace astra
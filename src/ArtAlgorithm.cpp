@@ -27,6 +27,8 @@ along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
 
 #include "astra/ArtAlgorithm.h"
 
+#include <algorithm>
+
 #include "astra/AstraObjectManager.h"
 
 using namespace std;
@@ -257,12 +259,24 @@ boost::any CArtAlgorithm::getInformation(std::string _sIdentifier)
 	return CAlgorithm::getInformation(_sIdentifier);
 };
 
+//----------------------------------------------------------------------------------------
+size_t CArtAlgorithm::getMemoryEstimate() const
+{
+	if (!m_bIsInitialized)
+		return 0;
+
+	size_t iPixelBufferSize = m_pProjector->getProjectionWeightsCount(0);
+	return iPixelBufferSize * sizeof(SPixelWeight) + 2 * (size_t)m_iRayCount * sizeof(int);
+}
+
 //----------------------------------------------------------------------------------------
 // Iterate
 void CArtAlgorithm::run(int _iNrIterations)
 {
 	// check initialized
 	assert(m_bIsInitialized);
+
+	resetAbort();
 	
 	// variables
 	int iIteration, iPixel;
@@ -274,8 +288,14 @@ void CArtAlgorithm::run(int _iNrIterations)
 	int iPixelBufferSize = m_pProjector->getProjectionWeightsCount(0);
 	SPixelWeight* pPixels = new SPixelWeight[iPixelBufferSize];
 
+	// every iteration handles a single ray, so report progress in blocks
+	const int iReportInterval = std::max(_iNrIterations / 64, 1);
+
 	// start iterations
-	for (iIteration = _iNrIterations-1; iIteration >= 0; --iIteration) {
+	for (iIteration = _iNrIterations-1; iIteration >= 0 && !m_bShouldAbort; --iIteration) {
+
+		if (m_pProgress && iIteration % iReportInterval == 0)
+			reportProgress((float32)(_iNrIterations-1 - iIteration) / _iNrIterations, ALGPHASE_FP);
 
 		// step0: compute single weight rays
 		iProjection = m_piProjectionOrder[m_iCurrentRay];
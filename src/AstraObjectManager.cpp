@@ -39,4 +39,24 @@ DEFINE_SINGLETON(CMatrixManager)
 
 DEFINE_SINGLETON(CAstraIndexManager)
 
+namespace {
+
+// Construct the managers when the library is loaded, since the lazy
+// construction in Singleton::getSingleton is not thread-safe.
+struct SConstructManagers {
+	SConstructManagers() {
+		CAstraIndexManager::getSingleton();
+		CProjector2DManager::getSingleton();
+		CProjector3DManager::getSingleton();
+		CData2DManager::getSingleton();
+		CData3DManager::getSingleton();
+		CAlgorithmManager::getSingleton();
+		CMatrixManager::getSingleton();
+	}
+};
+
+SConstructManagers g_constructManagers;
+
+}
+
 } // end namespace
@@ -28,47 +28,45 @@ along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
 #include "astra/AsyncAlgorithm.h"
 #include "astra/AstraObjectFactory.h"
 
-#ifndef USE_PTHREAD
-#include <boost/bind.hpp>
-#endif
-
 namespace astra {
 
 CAsyncAlgorithm::CAsyncAlgorithm()
 {
 	m_bInitialized = false;
-#ifndef USE_PTHREADS
-	m_pThread = 0;
-#endif
 	m_bThreadStarted = false;
+	m_pAlg = 0;
+	initProgress();
 }
 
 CAsyncAlgorithm::CAsyncAlgorithm(CAlgorithm* _pAlg)
 {
 	m_pAlg = _pAlg;
 	m_bInitialized = (m_pAlg != 0);
-#ifndef USE_PTHREADS
-	m_pThread = 0;
-#endif
 	m_bThreadStarted = false;
 	m_bDone = false;
 	m_bAutoFree = false;
+	initProgress();
+}
+
+void CAsyncAlgorithm::initProgress()
+{
+	m_fProgress = 0.0f;
+	m_ePhase = ALGPHASE_SETUP;
+	m_progressRecorder.m_pParent = this;
+	if (m_pAlg)
+		m_pAlg->setProgressCallback(&m_progressRecorder);
+}
+
+void CAsyncAlgorithm::CProgressRecorder::progress(float32 _fProgress, EAlgorithmPhase _ePhase)
+{
+	m_pParent->m_fProgress = _fProgress;
+	m_pParent->m_ePhase = _ePhase;
+	m_pParent->reportProgress(_fProgress, _ePhase);
 }
 
 bool CAsyncAlgorithm::initialize(const Config& _cfg)
 {
-	if (m_bInitialized && m_bThreadStarted) {
-#ifndef USE_PTHREADS
-		m_pThread->join();
-		delete m_pThread;
-#else
-		pthread_join(m_thread, 0);
-#endif
-	}
-#ifndef USE_PTHREADS
-	m_pThread = 0;
-#endif
-	m_bThreadStarted = false;
+	waitRun();
 	m_pAlg = 0;
 	m_bDone = false;
 
@@ -82,45 +80,25 @@ bool CAsyncAlgorithm::initialize(const Config& _cfg)
 	}
 	m_bInitialized = (m_pAlg != 0);
 	m_bAutoFree = true;
+	initProgress();
 	return m_bInitialized;
 }
 
 bool CAsyncAlgorithm::initialize(CAlgorithm* _pAlg)
 {
-	if (m_bInitialized && m_bThreadStarted) {
-#ifndef USE_PTHREADS
-		m_pThread->join();
-		delete m_pThread;
-#else
-		pthread_join(m_thread, 0);
-#endif
-	}
-#ifndef USE_PTHREADS
-	m_pThread = 0;
-#endif
-	m_bThreadStarted = false;
+	waitRun();
 	m_bDone = false;
 
 	m_pAlg = _pAlg;
 	m_bInitialized = (m_pAlg != 0);
 	m_bAutoFree = false;
+	initProgress();
 	return m_bInitialized;
 }
 
 CAsyncAlgorithm::~CAsyncAlgorithm()
 {
-	if (m_bInitialized && m_bThreadStarted) {
-#ifndef USE_PTHREADS
-		m_pThread->join();
-		delete m_pThread;
-#else
-		pthread_join(m_thread, 0);
-#endif
-	}
-#ifndef USE_PTHREADS
-	m_pThread = 0;
-#endif
-	m_bThreadStarted = false;
+	waitRun();
 
 	if (m_bInitialized && m_bAutoFree) {
 		delete m_pAlg;
@@ -128,36 +106,34 @@ CAsyncAlgorithm::~CAsyncAlgorithm()
 	}
 }
 
-#ifdef USE_PTHREADS
-void* runAsync_pthreads(void* data)
+void CAsyncAlgorithm::waitRun()
 {
-	CAsyncAlgorithm::AsyncThreadInfo *info = (CAsyncAlgorithm::AsyncThreadInfo*)data;
-	info->m_pAlg->run(info->m_iIterations);
-	*info->m_pDone = true;
-	return 0;
+	if (m_bThreadStarted)
+		m_group.wait();
+	m_bThreadStarted = false;
 }
-#endif
 
 void CAsyncAlgorithm::run(int _iNrIterations)
 {
 	if (!m_bInitialized)
 		return;
 
-#ifndef USE_PTHREADS
-	m_pThread = new boost::thread(
-	         boost::bind(&CAsyncAlgorithm::runWrapped,
-	                     this, _iNrIterations));
-#else
-	m_ThreadInfo.m_iIterations = _iNrIterations;
-	m_ThreadInfo.m_pAlg = m_pAlg;
-	m_ThreadInfo.m_pDone = &this->m_bDone;
-	pthread_create(&m_thread, 0, runAsync_pthreads, &this->m_ThreadInfo);
-#endif
+	waitRun();
+
+	m_bDone = false;
+	m_fProgress = 0.0f;
+	m_ePhase = ALGPHASE_SETUP;
+	m_task.m_pParent = this;
+	m_task.m_iIterations = _iNrIterations;
+	m_bThreadStarted = true;
+	CWorkerPool::getSingleton().submit(&m_task, &m_group);
 }
 
 void CAsyncAlgorithm::runWrapped(int _iNrIterations)
 {
 	m_pAlg->run(_iNrIterations);
+	if (!m_pAlg->shouldAbort())
+		m_fProgress = 1.0f;
 	m_bDone = true;
 }
 
@@ -29,6 +29,7 @@ along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
 
 #include "astra/AstraObjectManager.h"
 #include "astra/DataProjectorPolicies.h"
+#include "astra/PixelDrivenBackProjector2D.h"
 
 using namespace std;
 
@@ -106,6 +107,9 @@ bool CBackProjectionAlgorithm::initialize(const Config& _cfg)
 		return false;
 	}
 
+	m_bPixelDriven = _cfg.self.getOptionBool("PixelDriven", false);
+	CC.markOptionParsed("PixelDriven");
+
 	// init data objects and data projectors
 	_init();
 
@@ -167,7 +171,20 @@ void CBackProjectionAlgorithm::run(int _iNrIterations)
 	// check initialized
 	ASTRA_ASSERT(m_bIsInitialized);
 
-	m_bShouldAbort = false;
+	resetAbort();
+
+	if (m_bPixelDriven) {
+		CPixelDrivenBackProjector2D bp(m_pProjector->getProjectionGeometry(), m_pProjector->getVolumeGeometry());
+		if (bp.isInitialized()) {
+			CAlgorithmCheckpoint checkpoint(this, ALGPHASE_BP, 0.0f, 1.0f);
+			m_pReconstruction->setData(0.0f);
+			bp.backProject(m_pSinogram, m_pReconstruction,
+			               m_bUseSinogramMask ? m_pSinogramMask : 0,
+			               m_bUseReconstructionMask ? m_pReconstructionMask : 0,
+			               &checkpoint);
+			return;
+		}
+	}
 
 	CDataProjectorInterface* pBackProjector;
 
@@ -180,7 +197,7 @@ void CBackProjectionAlgorithm::run(int _iNrIterations)
 		); 
 
 	m_pReconstruction->setData(0.0f);
-	pBackProjector->project();
+	pBackProjector->project(CAlgorithmCheckpoint(this, ALGPHASE_BP, 0.0f, 1.0f));
 
 	ASTRA_DELETE(pBackProjector);
 }
@@ -0,0 +1,176 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#include "astra/BackProjectionAlgorithm3D.h"
+
+#include "astra/AstraObjectManager.h"
+#include "astra/Projector3D.h"
+
+#include "astra/Logging.h"
+
+using namespace std;
+
+namespace astra {
+
+// type of the algorithm, needed to register with CAlgorithmFactory
+std::string CBackProjectionAlgorithm3D::type = "BP3D";
+
+//----------------------------------------------------------------------------------------
+// Constructor
+CBackProjectionAlgorithm3D::CBackProjectionAlgorithm3D() 
+{
+	m_bIsInitialized = false;
+	m_pProjector = 0;
+	m_pProjections = 0;
+	m_pVolume = 0;
+}
+
+//----------------------------------------------------------------------------------------
+// Destructor
+CBackProjectionAlgorithm3D::~CBackProjectionAlgorithm3D() 
+{
+
+}
+
+//---------------------------------------------------------------------------------------
+// Initialize - Config
+bool CBackProjectionAlgorithm3D::initialize(const Config& _cfg)
+{
+	ASTRA_ASSERT(_cfg.self);
+	ConfigStackCheck<CAlgorithm> CC("BackProjectionAlgorithm3D", this, _cfg);	
+
+	XMLNode node;
+	int id;
+
+	// sinogram data
+	node = _cfg.self.getSingleNode("ProjectionDataId");
+	ASTRA_CONFIG_CHECK(node, "BP3D", "No ProjectionDataId tag specified.");
+	id = node.getContentInt();
+	m_pProjections = dynamic_cast<CFloat32ProjectionData3DMemory*>(CData3DManager::getSingleton().get(id));
+	CC.markNodeParsed("ProjectionDataId");
+
+	// reconstruction data
+	node = _cfg.self.getSingleNode("ReconstructionDataId");
+	ASTRA_CONFIG_CHECK(node, "BP3D", "No ReconstructionDataId tag specified.");
+	id = node.getContentInt();
+	m_pVolume = dynamic_cast<CFloat32VolumeData3DMemory*>(CData3DManager::getSingleton().get(id));
+	CC.markNodeParsed("ReconstructionDataId");
+
+	// optional: projector
+	node = _cfg.self.getSingleNode("ProjectorId");
+	m_pProjector = 0;
+	if (node) {
+		id = node.getContentInt();
+		m_pProjector = CProjector3DManager::getSingleton().get(id);
+	}
+	CC.markNodeParsed("ProjectorId");
+
+	// success
+	m_bIsInitialized = check();
+	return m_bIsInitialized;
+}
+
+//----------------------------------------------------------------------------------------
+// Initialize - C++
+bool CBackProjectionAlgorithm3D::initialize(CProjector3D* _pProjector, 
+                                               CFloat32ProjectionData3D* _pProjections, 
+                                               CFloat32VolumeData3D* _pVolume)
+{
+	m_pProjector = _pProjector;
+	m_pProjections = dynamic_cast<CFloat32ProjectionData3DMemory*>(_pProjections);
+	m_pVolume = dynamic_cast<CFloat32VolumeData3DMemory*>(_pVolume);
+
+	// success
+	m_bIsInitialized = check();
+	return m_bIsInitialized;
+}
+
+//----------------------------------------------------------------------------------------
+// Check
+bool CBackProjectionAlgorithm3D::check() 
+{
+	// check pointers
+	ASTRA_CONFIG_CHECK(m_pProjections, "BP3D", "Invalid Projection Data Object.");
+	ASTRA_CONFIG_CHECK(m_pVolume, "BP3D", "Invalid Reconstruction Data Object.");
+
+	// check initializations
+	ASTRA_CONFIG_CHECK(m_pProjections->isInitialized(), "BP3D", "Projection Data Object Not Initialized.");
+	ASTRA_CONFIG_CHECK(m_pVolume->isInitialized(), "BP3D", "Reconstruction Data Object Not Initialized.");
+	ASTRA_CONFIG_CHECK(m_pProjections->isPacked() && m_pVolume->isPacked(), "BP3D", "Data objects with a row pitch are not supported.");
+
+	// check compatibility between projector and data classes
+	if (m_pProjector) {
+		ASTRA_CONFIG_CHECK(m_pProjections->getGeometry()->isEqual(m_pProjector->getProjectionGeometry()), "BP3D", "Projection Data not compatible with the specified Projector.");
+		ASTRA_CONFIG_CHECK(m_pVolume->getGeometry()->isEqual(m_pProjector->getVolumeGeometry()), "BP3D", "Reconstruction Data not compatible with the specified Projector.");
+	}
+
+	ASTRA_CONFIG_CHECK(m_projection.initialize(m_pProjections->getGeometry(), m_pVolume->getGeometry(), m_pProjector), "BP3D", "Unsupported geometry.");
+
+	// success
+	m_bIsInitialized = true;
+	return true;
+}
+
+//---------------------------------------------------------------------------------------
+// Information - All
+map<string,boost::any> CBackProjectionAlgorithm3D::getInformation()
+{
+	map<string,boost::any> res;
+	res["ProjectionDataId"] = getInformation("ProjectionDataId");
+	res["ReconstructionDataId"] = getInformation("ReconstructionDataId");
+	return mergeMap<string,boost::any>(CAlgorithm::getInformation(), res);
+}
+
+//---------------------------------------------------------------------------------------
+// Information - Specific
+boost::any CBackProjectionAlgorithm3D::getInformation(std::string _sIdentifier)
+{
+	if (_sIdentifier == "ProjectionDataId") {
+		int iIndex = CData3DManager::getSingleton().getIndex(m_pProjections);
+		if (iIndex != 0) return iIndex;
+		return std::string("not in manager");
+	}
+	if (_sIdentifier == "ReconstructionDataId") {
+		int iIndex = CData3DManager::getSingleton().getIndex(m_pVolume);
+		if (iIndex != 0) return iIndex;
+		return std::string("not in manager");
+	}
+	return CAlgorithm::getInformation(_sIdentifier);
+}
+
+//----------------------------------------------------------------------------------------
+// Run
+void CBackProjectionAlgorithm3D::run(int)
+{
+	// check initialized
+	ASTRA_ASSERT(m_bIsInitialized);
+
+	if (!m_projection.backProject(m_pProjections, m_pVolume))
+		ASTRA_ERROR("BP3D: backprojection failed");
+}
+
+} // namespace astra
@@ -0,0 +1,391 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#include "astra/BrickedVolume3D.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "astra/Float32Data3DMemory.h"
+#include "astra/Float32ProjectionData3DMemory.h"
+#include "astra/VolumeGeometry3D.h"
+#include "astra/LinearKernel3D.h"
+#include "astra/HostMemory.h"
+#include "astra/MemoryBudget.h"
+#include "astra/NumaPlacement.h"
+#include "astra/WorkerPool.h"
+#include "astra/Logging.h"
+
+namespace astra {
+
+//----------------------------------------------------------------------------------------
+CBrickedVolume3D::CBrickedVolume3D()
+{
+	m_iWidth = m_iHeight = m_iDepth = 0;
+	m_iBricksX = m_iBricksY = m_iBricksZ = 0;
+	m_pfData = 0;
+}
+
+//----------------------------------------------------------------------------------------
+CBrickedVolume3D::CBrickedVolume3D(int _iWidth, int _iHeight, int _iDepth)
+{
+	m_iWidth = m_iHeight = m_iDepth = 0;
+	m_iBricksX = m_iBricksY = m_iBricksZ = 0;
+	m_pfData = 0;
+	initialize(_iWidth, _iHeight, _iDepth);
+}
+
+//----------------------------------------------------------------------------------------
+CBrickedVolume3D::~CBrickedVolume3D()
+{
+	_free();
+}
+
+//----------------------------------------------------------------------------------------
+void CBrickedVolume3D::_free()
+{
+	if (m_pfData) {
+		freeHostMemory(m_pfData, getMemoryUsage());
+		CMemoryBudget::getSingleton().release(getMemoryUsage());
+	}
+	m_pfData = 0;
+	m_iWidth = m_iHeight = m_iDepth = 0;
+	m_iBricksX = m_iBricksY = m_iBricksZ = 0;
+}
+
+//----------------------------------------------------------------------------------------
+bool CBrickedVolume3D::initialize(int _iWidth, int _iHeight, int _iDepth)
+{
+	_free();
+	if (_iWidth <= 0 || _iHeight <= 0 || _iDepth <= 0) {
+		ASTRA_ERROR("CBrickedVolume3D: invalid size %d x %d x %d", _iWidth, _iHeight, _iDepth);
+		return false;
+	}
+
+	const int iBricksX = (_iWidth + BRICK_SIZE - 1) >> BRICK_SHIFT;
+	const int iBricksY = (_iHeight + BRICK_SIZE - 1) >> BRICK_SHIFT;
+	const int iBricksZ = (_iDepth + BRICK_SIZE - 1) >> BRICK_SHIFT;
+	const size_t iBricks = (size_t)iBricksX * iBricksY * iBricksZ;
+	const size_t iBytes = iBricks * BRICK_VOXELS * sizeof(float32);
+
+	if (!CMemoryBudget::getSingleton().reserve(iBytes)) {
+		ASTRA_ERROR("Allocating %llu bytes would exceed the host memory limit", (unsigned long long)iBytes);
+		return false;
+	}
+	m_pfData = (float32*)allocateHostMemory(iBytes, DATA_ALIGNMENT);
+	if (!m_pfData) {
+		CMemoryBudget::getSingleton().release(iBytes);
+		ASTRA_ERROR("Unable to allocate %llu bytes", (unsigned long long)iBytes);
+		return false;
+	}
+	bindPages(m_pfData, iBricks * BRICK_VOXELS);
+
+	m_iWidth = _iWidth;
+	m_iHeight = _iHeight;
+	m_iDepth = _iDepth;
+	m_iBricksX = iBricksX;
+	m_iBricksY = iBricksY;
+	m_iBricksZ = iBricksZ;
+
+	// one brick per row, so the pages are first touched by the threads
+	// that will process those bricks
+	fillRows(m_pfData, iBricks, BRICK_VOXELS, 0.0f);
+
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+size_t CBrickedVolume3D::getMemoryUsage() const
+{
+	return (size_t)m_iBricksX * m_iBricksY * m_iBricksZ * BRICK_VOXELS * sizeof(float32);
+}
+
+//----------------------------------------------------------------------------------------
+void CBrickedVolume3D::clearData()
+{
+	ASTRA_ASSERT(m_pfData);
+	fillRows(m_pfData, (size_t)getBrickCount(), BRICK_VOXELS, 0.0f);
+}
+
+//----------------------------------------------------------------------------------------
+// Copy the voxel rows of a range of bricks between the two layouts.
+struct SBrickConvertFunctor {
+	const CBrickedVolume3D* m_pBricked;
+	float32* m_pfBricks;
+	CFloat32Data3DMemory* m_pLinear;
+	bool m_bToBricks;
+
+	void operator()(int _iFrom, int _iTo) const {
+		const int iS = CBrickedVolume3D::BRICK_SIZE;
+		const int iBricksX = m_pBricked->getBrickCountX();
+		const int iBricksY = m_pBricked->getBrickCountY();
+		for (int b = _iFrom; b < _iTo; ++b) {
+			const int iX0 = (b % iBricksX) * iS;
+			const int iY0 = ((b / iBricksX) % iBricksY) * iS;
+			const int iZ0 = (b / iBricksX / iBricksY) * iS;
+			const int iW = std::min(iS, m_pBricked->getWidth() - iX0);
+			const int iH = std::min(iS, m_pBricked->getHeight() - iY0);
+			const int iD = std::min(iS, m_pBricked->getDepth() - iZ0);
+			float32* pfBrick = m_pfBricks + (size_t)b * CBrickedVolume3D::BRICK_VOXELS;
+			for (int z = 0; z < iD; ++z) {
+				for (int y = 0; y < iH; ++y) {
+					float32* pfRow = pfBrick + (z * iS + y) * iS;
+					float32* pfLinear = m_pLinear->getRow(iY0 + y, iZ0 + z) + iX0;
+					if (m_bToBricks)
+						memcpy(pfRow, pfLinear, iW * sizeof(float32));
+					else
+						memcpy(pfLinear, pfRow, iW * sizeof(float32));
+				}
+			}
+		}
+	}
+};
+
+//----------------------------------------------------------------------------------------
+bool CBrickedVolume3D::copyFrom(const CFloat32Data3DMemory* _pData)
+{
+	ASTRA_ASSERT(m_pfData);
+	if (_pData->getWidth() != m_iWidth || _pData->getHeight() != m_iHeight || _pData->getDepth() != m_iDepth) {
+		ASTRA_ERROR("CBrickedVolume3D::copyFrom: size mismatch");
+		return false;
+	}
+
+	SBrickConvertFunctor f;
+	f.m_pBricked = this;
+	f.m_pfBricks = m_pfData;
+	// only read from in this direction
+	f.m_pLinear = const_cast<CFloat32Data3DMemory*>(_pData);
+	f.m_bToBricks = true;
+	CWorkerPool::getSingleton().parallelFor(0, getBrickCount(), f);
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+bool CBrickedVolume3D::copyTo(CFloat32Data3DMemory* _pData) const
+{
+	ASTRA_ASSERT(m_pfData);
+	if (_pData->getWidth() != m_iWidth || _pData->getHeight() != m_iHeight || _pData->getDepth() != m_iDepth) {
+		ASTRA_ERROR("CBrickedVolume3D::copyTo: size mismatch");
+		return false;
+	}
+
+	SBrickConvertFunctor f;
+	f.m_pBricked = this;
+	f.m_pfBricks = m_pfData;
+	f.m_pLinear = _pData;
+	f.m_bToBricks = false;
+	CWorkerPool::getSingleton().parallelFor(0, getBrickCount(), f);
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+// Sum of the voxel values times the weights along a ray.
+struct SBrickedSampler {
+	const CBrickedVolume3D* m_pVolume;
+	float32 m_fSum;
+
+	void operator()(int _iX, int _iY, int _iZ, float32 _fWeight) {
+		m_fSum += _fWeight * m_pVolume->getValue(_iX, _iY, _iZ);
+	}
+};
+
+struct SBrickedFPFunctor {
+	const CBrickedVolume3D* m_pVolume;
+	const SVolumeGrid3D* m_pGrid;
+	const SProjectionVectors3D* m_pVectors;
+	CFloat32ProjectionData3DMemory* m_pProjection;
+
+	void operator()(int _iFrom, int _iTo) const {
+		for (int i = _iFrom; i < _iTo; ++i) {
+			// rows of one projection are consecutive work items
+			const int a = i / m_pVectors->iRows;
+			const int v = i % m_pVectors->iRows;
+			float32* pfOut = m_pProjection->getRow(a, v);
+			for (int u = 0; u < m_pVectors->iCols; ++u) {
+				double fX, fY, fZ, fDX, fDY, fDZ;
+				m_pVectors->getRay(a, v, u, fX, fY, fZ, fDX, fDY, fDZ);
+				SBrickedSampler s;
+				s.m_pVolume = m_pVolume;
+				s.m_fSum = 0.0f;
+				traceLinearRay3D(*m_pGrid, fX, fY, fZ, fDX, fDY, fDZ, s);
+				pfOut[u] = s.m_fSum;
+			}
+		}
+	}
+};
+
+//----------------------------------------------------------------------------------------
+bool forwardProjectBricked(const CBrickedVolume3D* _pVolume,
+                           const CVolumeGeometry3D* _pVolumeGeometry,
+                           CFloat32ProjectionData3DMemory* _pProjection)
+{
+	SVolumeGrid3D grid;
+	grid.set(_pVolumeGeometry);
+	if (grid.iCols != _pVolume->getWidth() || grid.iRows != _pVolume->getHeight() || grid.iSlices != _pVolume->getDepth()) {
+		ASTRA_ERROR("forwardProjectBricked: the volume doesn't match its geometry");
+		return false;
+	}
+	SProjectionVectors3D vectors;
+	if (!vectors.set(_pProjection->getGeometry())) {
+		ASTRA_ERROR("forwardProjectBricked: unsupported projection geometry");
+		return false;
+	}
+
+	SBrickedFPFunctor f;
+	f.m_pVolume = _pVolume;
+	f.m_pGrid = &grid;
+	f.m_pVectors = &vectors;
+	f.m_pProjection = _pProjection;
+	CWorkerPool::getSingleton().parallelFor(0, vectors.iAngles * vectors.iRows, f);
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+// Per projection: detector coordinates (in pixels) of a point as the ratio
+// of two affine functions, u = (U . p) / (D . p) and v = (V . p) / (D . p).
+// For parallel beams D is constant 1.
+struct SDetectorMap {
+	double fU[4], fV[4], fD[4];
+};
+
+struct SBrickedBPFunctor {
+	const CBrickedVolume3D* m_pVolume;
+	float32* m_pfBricks;
+	const SVolumeGrid3D* m_pGrid;
+	const std::vector<SDetectorMap>* m_pMaps;
+	const float32* m_pfProjection;
+	size_t m_iPitch;
+	int m_iAngles, m_iDetRows, m_iDetCols;
+
+	void operator()(int _iFrom, int _iTo) const {
+		const int iS = CBrickedVolume3D::BRICK_SIZE;
+		const int iBricksX = m_pVolume->getBrickCountX();
+		const int iBricksY = m_pVolume->getBrickCountY();
+		float32 fAcc[CBrickedVolume3D::BRICK_VOXELS];
+		for (int b = _iFrom; b < _iTo; ++b) {
+			const int iX0 = (b % iBricksX) * iS;
+			const int iY0 = ((b / iBricksX) % iBricksY) * iS;
+			const int iZ0 = (b / iBricksX / iBricksY) * iS;
+			const int iW = std::min(iS, m_pVolume->getWidth() - iX0);
+			const int iH = std::min(iS, m_pVolume->getHeight() - iY0);
+			const int iD = std::min(iS, m_pVolume->getDepth() - iZ0);
+			memset(fAcc, 0, sizeof(fAcc));
+
+			for (int a = 0; a < m_iAngles; ++a) {
+				const SDetectorMap& m = (*m_pMaps)[a];
+				for (int z = 0; z < iD; ++z) {
+					const double fZ = m_pGrid->fMinZ + (iZ0 + z + 0.5) * m_pGrid->fPixelZ;
+					for (int y = 0; y < iH; ++y) {
+						const double fY = m_pGrid->fMinY + (iY0 + y + 0.5) * m_pGrid->fPixelY;
+						float32* pfAcc = fAcc + (z * iS + y) * iS;
+						for (int x = 0; x < iW; ++x) {
+							const double fX = m_pGrid->fMinX + (iX0 + x + 0.5) * m_pGrid->fPixelX;
+							const double fDen = m.fD[0] * fX + m.fD[1] * fY + m.fD[2] * fZ + m.fD[3];
+							// sample positions, with pixel i centred at i
+							const double fU = (m.fU[0] * fX + m.fU[1] * fY + m.fU[2] * fZ + m.fU[3]) / fDen - 0.5;
+							const double fV = (m.fV[0] * fX + m.fV[1] * fY + m.fV[2] * fZ + m.fV[3]) / fDen - 0.5;
+							if (!(fU > -1.0 && fU < m_iDetCols && fV > -1.0 && fV < m_iDetRows))
+								continue;
+							const int iU = (int)std::floor(fU);
+							const int iV = (int)std::floor(fV);
+							const float32 fFU = (float32)(fU - iU);
+							const float32 fFV = (float32)(fV - iV);
+							float32 fSum = 0.0f;
+							if (iV >= 0) {
+								const float32* pfRow = m_pfProjection + ((size_t)iV * m_iAngles + a) * m_iPitch;
+								if (iU >= 0)
+									fSum += (1.0f - fFU) * (1.0f - fFV) * pfRow[iU];
+								if (iU + 1 < m_iDetCols)
+									fSum += fFU * (1.0f - fFV) * pfRow[iU + 1];
+							}
+							if (iV + 1 < m_iDetRows) {
+								const float32* pfRow = m_pfProjection + ((size_t)(iV + 1) * m_iAngles + a) * m_iPitch;
+								if (iU >= 0)
+									fSum += (1.0f - fFU) * fFV * pfRow[iU];
+								if (iU + 1 < m_iDetCols)
+									fSum += fFU * fFV * pfRow[iU + 1];
+							}
+							pfAcc[x] += fSum;
+						}
+					}
+				}
+			}
+
+			memcpy(m_pfBricks + (size_t)b * CBrickedVolume3D::BRICK_VOXELS, fAcc, sizeof(fAcc));
+		}
+	}
+};
+
+//----------------------------------------------------------------------------------------
+bool backprojectBricked(const CFloat32ProjectionData3DMemory* _pProjection,
+                        const CVolumeGeometry3D* _pVolumeGeometry,
+                        CBrickedVolume3D* _pVolume)
+{
+	SVolumeGrid3D grid;
+	grid.set(_pVolumeGeometry);
+	if (grid.iCols != _pVolume->getWidth() || grid.iRows != _pVolume->getHeight() || grid.iSlices != _pVolume->getDepth()) {
+		ASTRA_ERROR("backprojectBricked: the volume doesn't match its geometry");
+		return false;
+	}
+	SProjectionVectors3D vectors;
+	if (!vectors.set(_pProjection->getGeometry())) {
+		ASTRA_ERROR("backprojectBricked: unsupported projection geometry");
+		return false;
+	}
+
+	std::vector<SDetectorMap> maps(vectors.iAngles);
+	for (int a = 0; a < vectors.iAngles; ++a) {
+		SDetectorMap& m = maps[a];
+		if (vectors.bCone) {
+			computeBP_UV_Coeffs(vectors.cone[a], m.fU[0], m.fU[1], m.fU[2], m.fU[3],
+			                    m.fV[0], m.fV[1], m.fV[2], m.fV[3],
+			                    m.fD[0], m.fD[1], m.fD[2], m.fD[3]);
+		} else {
+			computeBP_UV_Coeffs(vectors.par[a], m.fU[0], m.fU[1], m.fU[2], m.fU[3],
+			                    m.fV[0], m.fV[1], m.fV[2], m.fV[3]);
+			m.fD[0] = m.fD[1] = m.fD[2] = 0.0;
+			m.fD[3] = 1.0;
+		}
+	}
+
+	SBrickedBPFunctor f;
+	f.m_pVolume = _pVolume;
+	f.m_pfBricks = _pVolume->getBrick(0);
+	f.m_pGrid = &grid;
+	f.m_pMaps = &maps;
+	f.m_pfProjection = _pProjection->getDataConst();
+	f.m_iPitch = _pProjection->getRowPitch();
+	f.m_iAngles = vectors.iAngles;
+	f.m_iDetRows = vectors.iRows;
+	f.m_iDetCols = vectors.iCols;
+	CWorkerPool::getSingleton().parallelFor(0, _pVolume->getBrickCount(), f);
+	return true;
+}
+
+} // end namespace astra
@@ -0,0 +1,385 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#include "astra/CenterOfRotationAlgorithm.h"
+
+#include <math.h>
+#include <vector>
+#include <algorithm>
+
+#include "astra/AstraObjectManager.h"
+#include "astra/Float32ProjectionData2D.h"
+#include "astra/Float32VolumeData2D.h"
+#include "astra/ParallelProjectionGeometry2D.h"
+#include "astra/ParallelVecProjectionGeometry2D.h"
+#include "astra/VolumeGeometry2D.h"
+#include "astra/FilteredBackProjectionAlgorithm.h"
+#include "astra/PixelDrivenBackProjector2D.h"
+#include "astra/ScratchArena.h"
+#include "astra/WorkerPool.h"
+#include "astra/Logging.h"
+
+using namespace std;
+
+namespace astra {
+
+// type of the algorithm, needed to register with CAlgorithmFactory
+std::string CCenterOfRotationAlgorithm::type = "CenterOfRotation";
+
+// the automatic binning keeps at least this many detector pixels
+static const int COR_MIN_BINNED_DETECTORS = 128;
+
+// the finer levels reconstruct a central region of at most this many pixels square
+static const int COR_MAX_GRID_SIZE = 256;
+
+// bins of the histogram for the sharpness
+static const int COR_HISTOGRAM_BINS = 256;
+
+// candidates on each side of the best offset when refining
+static const int COR_REFINE_CANDIDATES = 2;
+
+//----------------------------------------------------------------------------------------
+// Constructor
+CCenterOfRotationAlgorithm::CCenterOfRotationAlgorithm()
+{
+	_clear();
+}
+
+//----------------------------------------------------------------------------------------
+// Destructor
+CCenterOfRotationAlgorithm::~CCenterOfRotationAlgorithm()
+{
+
+}
+
+//---------------------------------------------------------------------------------------
+// Clear - Constructors
+void CCenterOfRotationAlgorithm::_clear()
+{
+	m_pSinogram = NULL;
+	m_fSearchRange = 0.0f;
+	m_fPrecision = 0.25f;
+	m_iBinning = 0;
+	m_fOffset = 0.0f;
+	m_iCandidateCount = 0;
+	m_bIsInitialized = false;
+}
+
+//---------------------------------------------------------------------------------------
+// Initialize - Config
+bool CCenterOfRotationAlgorithm::initialize(const Config& _cfg)
+{
+	ASTRA_ASSERT(_cfg.self);
+	ConfigStackCheck<CAlgorithm> CC("CenterOfRotationAlgorithm", this, _cfg);
+
+	// sinogram data
+	XMLNode node = _cfg.self.getSingleNode("ProjectionDataId");
+	ASTRA_CONFIG_CHECK(node, "CenterOfRotation", "No ProjectionDataId tag specified.");
+	int id = node.getContentInt();
+	m_pSinogram = dynamic_cast<CFloat32ProjectionData2D*>(CData2DManager::getSingleton().get(id));
+	CC.markNodeParsed("ProjectionDataId");
+
+	m_fSearchRange = _cfg.self.getOptionNumerical("SearchRange", 0.0f);
+	CC.markOptionParsed("SearchRange");
+	m_fPrecision = _cfg.self.getOptionNumerical("Precision", 0.25f);
+	CC.markOptionParsed("Precision");
+	m_iBinning = (int)_cfg.self.getOptionNumerical("Binning", 0);
+	CC.markOptionParsed("Binning");
+
+	m_bIsInitialized = _check();
+	return m_bIsInitialized;
+}
+
+//---------------------------------------------------------------------------------------
+// Initialize - C++
+bool CCenterOfRotationAlgorithm::initialize(CFloat32ProjectionData2D* _pSinogram,
+                                            float32 _fSearchRange, float32 _fPrecision, int _iBinning)
+{
+	m_pSinogram = _pSinogram;
+	m_fSearchRange = _fSearchRange;
+	m_fPrecision = _fPrecision;
+	m_iBinning = _iBinning;
+
+	m_bIsInitialized = _check();
+	return m_bIsInitialized;
+}
+
+//----------------------------------------------------------------------------------------
+// Check
+bool CCenterOfRotationAlgorithm::_check()
+{
+	ASTRA_CONFIG_CHECK(m_pSinogram, "CenterOfRotation", "Invalid ProjectionDataId.");
+	ASTRA_CONFIG_CHECK(m_pSinogram->isInitialized(), "CenterOfRotation", "Projection data not initialized.");
+	CProjectionGeometry2D* pGeometry = m_pSinogram->getGeometry();
+	ASTRA_CONFIG_CHECK(dynamic_cast<CParallelProjectionGeometry2D*>(pGeometry) || dynamic_cast<CParallelVecProjectionGeometry2D*>(pGeometry),
+	                   "CenterOfRotation", "ProjectionDataId must have a parallel or parallel_vec geometry.");
+	ASTRA_CONFIG_CHECK(m_fSearchRange >= 0.0f, "CenterOfRotation", "SearchRange must not be negative.");
+	ASTRA_CONFIG_CHECK(m_fPrecision > 0.0f, "CenterOfRotation", "Precision must be positive.");
+	ASTRA_CONFIG_CHECK(m_iBinning >= 0 && (m_iBinning & (m_iBinning - 1)) == 0, "CenterOfRotation", "Binning must be a power of two.");
+	ASTRA_CONFIG_CHECK(m_iBinning <= m_pSinogram->getDetectorCount(), "CenterOfRotation", "Binning exceeds the detector count.");
+
+	// success
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+double CCenterOfRotationAlgorithm::sharpness(const float32* _pfData, int _iSize)
+{
+	double fRadius = 0.5 * _iSize - 1.0;
+	std::vector<size_t> indices;
+	float32 fMin = 0.0f, fMax = 0.0f;
+	for (int y = 0; y < _iSize; ++y) {
+		double fY = y + 0.5 - 0.5 * _iSize;
+		for (int x = 0; x < _iSize; ++x) {
+			double fX = x + 0.5 - 0.5 * _iSize;
+			if (fX * fX + fY * fY > fRadius * fRadius)
+				continue;
+			size_t i = (size_t)y * _iSize + x;
+			if (indices.empty() || _pfData[i] < fMin)
+				fMin = _pfData[i];
+			if (indices.empty() || _pfData[i] > fMax)
+				fMax = _pfData[i];
+			indices.push_back(i);
+		}
+	}
+	if (indices.empty() || fMax <= fMin)
+		return 0.0;
+
+	std::vector<int> histogram(COR_HISTOGRAM_BINS, 0);
+	double fScale = (COR_HISTOGRAM_BINS - 1e-3) / ((double)fMax - fMin);
+	for (size_t k = 0; k < indices.size(); ++k)
+		histogram[(int)((_pfData[indices[k]] - fMin) * fScale)]++;
+
+	double fEntropy = 0.0;
+	for (int b = 0; b < COR_HISTOGRAM_BINS; ++b) {
+		if (histogram[b] == 0)
+			continue;
+		double p = (double)histogram[b] / indices.size();
+		fEntropy -= p * log(p);
+	}
+	return log((double)COR_HISTOGRAM_BINS) - fEntropy;
+}
+
+//----------------------------------------------------------------------------------------
+// One level of the search: a binned and filtered sinogram, and the
+// reconstruction grid with pixels of the binned detector size.
+struct SCorLevel {
+	const SParProjection* pBinnedProjections;
+	CFloat32ProjectionData2D* pFiltered;
+	CVolumeGeometry2D* pVolumeGeometry;
+	int iAngleCount;
+	int iDetectorCount;
+	int iBinning;
+	int iGridSize;
+};
+
+//----------------------------------------------------------------------------------------
+// Reconstruct and score a range of candidate offsets.
+struct SCorCandidateFunctor {
+	const SCorLevel* m_pLevel;
+	const double* m_pfOffsets;
+	double* m_pfScores;
+	const CAlgorithm* m_pAlg;
+
+	void operator()(int _iFrom, int _iTo) const {
+		const SCorLevel& l = *m_pLevel;
+		CFloat32VolumeData2D* pVolume = CScratchArena::getSingleton().createVolumeData2D(l.pVolumeGeometry);
+		std::vector<SParProjection> shifted(l.iAngleCount);
+		for (int i = _iFrom; i < _iTo; ++i) {
+			m_pfScores[i] = -1.0;
+			if (!pVolume->isInitialized() || m_pAlg->shouldAbort())
+				continue;
+
+			// shift the detector by the offset in unbinned pixels
+			float32 fShift = (float32)(m_pfOffsets[i] / l.iBinning);
+			for (int j = 0; j < l.iAngleCount; ++j) {
+				shifted[j] = l.pBinnedProjections[j];
+				shifted[j].fDetSX += fShift * shifted[j].fDetUX;
+				shifted[j].fDetSY += fShift * shifted[j].fDetUY;
+			}
+			CParallelVecProjectionGeometry2D geometry(l.iAngleCount, l.iDetectorCount, &shifted[0]);
+			CPixelDrivenBackProjector2D bp(&geometry, l.pVolumeGeometry, CPixelDrivenBackProjector2D::WEIGHT_FBP);
+			pVolume->setData(0.0f);
+			if (bp.backProject(l.pFiltered, pVolume))
+				m_pfScores[i] = CCenterOfRotationAlgorithm::sharpness(pVolume->getDataConst(), l.iGridSize);
+		}
+		delete pVolume;
+	}
+};
+
+//----------------------------------------------------------------------------------------
+// Iterate
+void CCenterOfRotationAlgorithm::run(int _iNrIterations)
+{
+	ASTRA_ASSERT(m_bIsInitialized);
+
+	resetAbort();
+	m_timings.reset();
+	m_iCandidateCount = 0;
+
+	CProjectionGeometry2D* pGeometry = m_pSinogram->getGeometry();
+	CParallelVecProjectionGeometry2D* pVecGeometry = dynamic_cast<CParallelVecProjectionGeometry2D*>(pGeometry);
+	CParallelVecProjectionGeometry2D* pOwnedGeometry = 0;
+	if (!pVecGeometry)
+		pOwnedGeometry = pVecGeometry = dynamic_cast<CParallelProjectionGeometry2D*>(pGeometry)->toVectorGeometry();
+	const SParProjection* pProjections = pVecGeometry->getProjectionVectors();
+
+	const int iAngleCount = m_pSinogram->getAngleCount();
+	const int iDetectorCount = m_pSinogram->getDetectorCount();
+	const float32 fDetSize = sqrt(pProjections[0].fDetUX * pProjections[0].fDetUX + pProjections[0].fDetUY * pProjections[0].fDetUY);
+
+	int iBinning = m_iBinning;
+	if (iBinning == 0) {
+		iBinning = 1;
+		while (iDetectorCount / (2 * iBinning) >= COR_MIN_BINNED_DETECTORS)
+			iBinning *= 2;
+	}
+	double fRange = (m_fSearchRange > 0.0f) ? m_fSearchRange : 0.25 * iDetectorCount;
+
+	// The coarsest level steps one binned pixel over the whole range,
+	// the next levels halve the binning and the step around the best offset.
+	double fStep = iBinning;
+	double fBest = 0.0;
+	std::vector<double> offsets;
+	for (int k = (int)-floor(fRange / fStep); k * fStep <= fRange; ++k)
+		offsets.push_back(k * fStep);
+
+	std::vector<SParProjection> binned(iAngleCount);
+	bool bFirst = true;
+	while (!m_bShouldAbort) {
+		SCorLevel level;
+		level.iAngleCount = iAngleCount;
+		level.iDetectorCount = iDetectorCount / iBinning;
+		level.iBinning = iBinning;
+
+		for (int j = 0; j < iAngleCount; ++j) {
+			binned[j] = pProjections[j];
+			binned[j].fDetUX *= iBinning;
+			binned[j].fDetUY *= iBinning;
+		}
+		level.pBinnedProjections = &binned[0];
+
+		level.iGridSize = std::min(level.iDetectorCount, COR_MAX_GRID_SIZE);
+		float32 fHalfWidth = 0.5f * level.iGridSize * iBinning * fDetSize;
+		CVolumeGeometry2D volumeGeometry(level.iGridSize, level.iGridSize,
+		                                 -fHalfWidth, -fHalfWidth, fHalfWidth, fHalfWidth);
+		level.pVolumeGeometry = &volumeGeometry;
+
+		// bin and filter
+		CParallelVecProjectionGeometry2D binnedGeometry(iAngleCount, level.iDetectorCount, &binned[0]);
+		CFloat32ProjectionData2D* pFiltered = CScratchArena::getSingleton().createProjectionData2D(&binnedGeometry);
+		if (!pFiltered->isInitialized()) {
+			ASTRA_ERROR("CenterOfRotation: unable to allocate the binned sinogram");
+			delete pFiltered;
+			break;
+		}
+		{
+			CPhaseTimer timer(m_timings, ALGPHASE_FILTERING);
+			float32* pfOut = pFiltered->getData();
+			for (int j = 0; j < iAngleCount; ++j) {
+				const float32* pfIn = m_pSinogram->getData2DConst()[j];
+				for (int d = 0; d < level.iDetectorCount; ++d) {
+					float32 fSum = 0.0f;
+					for (int b = 0; b < iBinning; ++b)
+						fSum += pfIn[d * iBinning + b];
+					pfOut[(size_t)j * level.iDetectorCount + d] = fSum / iBinning;
+				}
+			}
+			if (!CFilteredBackProjectionAlgorithm::rampFilter(pfOut, iAngleCount, level.iDetectorCount)) {
+				delete pFiltered;
+				break;
+			}
+		}
+		level.pFiltered = pFiltered;
+
+		// score all candidates of this level
+		std::vector<double> scores(offsets.size());
+		{
+			CPhaseTimer timer(m_timings, ALGPHASE_BP);
+			SCorCandidateFunctor f;
+			f.m_pLevel = &level;
+			f.m_pfOffsets = &offsets[0];
+			f.m_pfScores = &scores[0];
+			f.m_pAlg = this;
+			CWorkerPool::getSingleton().parallelFor(0, (int)offsets.size(), f);
+		}
+		delete pFiltered;
+		m_iCandidateCount += (int)offsets.size();
+
+		int iBest = -1;
+		for (size_t i = 0; i < offsets.size(); ++i)
+			if (scores[i] >= 0.0 && (iBest < 0 || scores[i] > scores[iBest]))
+				iBest = (int)i;
+		if (iBest < 0)
+			break;
+		fBest = offsets[iBest];
+		bFirst = false;
+
+		reportProgress((float32)(m_fPrecision / fStep), ALGPHASE_BP);
+		if (fStep <= m_fPrecision)
+			break;
+
+		if (iBinning > 1)
+			iBinning /= 2;
+		fStep *= 0.5;
+		offsets.clear();
+		for (int k = -COR_REFINE_CANDIDATES; k <= COR_REFINE_CANDIDATES; ++k)
+			offsets.push_back(fBest + k * fStep);
+	}
+
+	delete pOwnedGeometry;
+
+	if (bFirst)
+		ASTRA_WARN("CenterOfRotation: no candidate could be scored");
+	m_fOffset = (float32)fBest;
+}
+
+//---------------------------------------------------------------------------------------
+// Information - All
+map<string,boost::any> CCenterOfRotationAlgorithm::getInformation()
+{
+	map<string, boost::any> result;
+	result["ProjectionDataId"] = getInformation("ProjectionDataId");
+	result["Offset"] = getInformation("Offset");
+	return mergeMap<string,boost::any>(CAlgorithm::getInformation(), result);
+}
+
+//---------------------------------------------------------------------------------------
+// Information - Specific
+boost::any CCenterOfRotationAlgorithm::getInformation(std::string _sIdentifier)
+{
+	if (_sIdentifier == "ProjectionDataId") {
+		int iIndex = CData2DManager::getSingleton().getIndex(m_pSinogram);
+		if (iIndex != 0) return iIndex;
+		return std::string("not in manager");
+	} else if (_sIdentifier == "Offset") {
+		return m_fOffset;
+	}
+	return CAlgorithm::getInformation(_sIdentifier);
+}
+
+} // namespace astra
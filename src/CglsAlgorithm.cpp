@@ -28,6 +28,7 @@ along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
 #include "astra/CglsAlgorithm.h"
 
 #include "astra/AstraObjectManager.h"
+#include "astra/Reduction.h"
 
 using namespace std;
 
@@ -75,6 +76,7 @@ void CCglsAlgorithm::_clear()
 	beta = 0.0f;
 	gamma = 0.0f;
 	m_iIteration = 0;
+	m_bResumeAtBP = false;
 	m_bIsInitialized = false;
 }
 
@@ -91,6 +93,7 @@ void CCglsAlgorithm::clear()
 	beta = 0.0f;
 	gamma = 0.0f;
 	m_iIteration = 0;
+	m_bResumeAtBP = false;
 	m_bIsInitialized = false;
 }
 
@@ -101,6 +104,10 @@ bool CCglsAlgorithm::_check()
 	// check base class
 	ASTRA_CONFIG_CHECK(CReconstructionAlgorithm2D::_check(), "CGLS", "Error in ReconstructionAlgorithm2D initialization");
 
+	// check temporaries, which fail to allocate when over the memory budget
+	ASTRA_CONFIG_CHECK(r && r->isInitialized() && w && w->isInitialized(), "CGLS", "Unable to allocate temporary sinograms");
+	ASTRA_CONFIG_CHECK(z && z->isInitialized() && p && p->isInitialized(), "CGLS", "Unable to allocate temporary volumes");
+
 	return true;
 }
 
@@ -178,6 +185,26 @@ boost::any CCglsAlgorithm::getInformation(std::string _sIdentifier)
 	return CAlgorithm::getInformation(_sIdentifier);
 };
 
+//----------------------------------------------------------------------------------------
+size_t CCglsAlgorithm::getMemoryEstimate() const
+{
+	if (!m_bIsInitialized)
+		return 0;
+
+	return (2 * (size_t)m_pSinogram->getSize() + 2 * (size_t)m_pReconstruction->getSize()) * sizeof(float32);
+}
+
+//----------------------------------------------------------------------------------------
+bool CCglsAlgorithm::getResidualNorm(float32& _fNorm)
+{
+	if (!m_bIsInitialized || m_iIteration == 0)
+		return false;
+
+	// r = b - A*x is kept up to date by the iterations
+	_fNorm = (float32)sqrt(reduceSquaredNorm(r->getData(), r->getSize()));
+	return true;
+}
+
 //----------------------------------------------------------------------------------------
 // Iterate
 void CCglsAlgorithm::run(int _iNrIterations)
@@ -185,109 +212,160 @@ void CCglsAlgorithm::run(int _iNrIterations)
 	// check initialized
 	ASTRA_ASSERT(m_bIsInitialized);
 
+	resetAbort();
+	m_timings.reset();
+
+	CTraceScope trace("algorithm", "CGLS");
+	trace.addArg("iterations", _iNrIterations);
+
+	// sizes, for counting bytes moved by vector operations
+	const double fVolBytes = (double)m_pReconstruction->getSize() * sizeof(float32);
+	const double fSinoBytes = (double)m_pSinogram->getSize() * sizeof(float32);
+
 	// data projectors
 	CDataProjectorInterface* pForwardProjector;
 	CDataProjectorInterface* pBackProjector;
 
-	// forward projection data projector
-	pForwardProjector = dispatchDataProjector(
-		m_pProjector, 
-			SinogramMaskPolicy(m_pSinogramMask),					// sinogram mask
-			ReconstructionMaskPolicy(m_pReconstructionMask),		// reconstruction mask
-			DefaultFPPolicy(p, w),									// forward projection
-			m_bUseSinogramMask, m_bUseReconstructionMask, true		// options on/off
-		); 
-
-	// backprojection data projector
-	pBackProjector = dispatchDataProjector(
+	{
+		CPhaseTimer timer(m_timings, ALGPHASE_SETUP);
+
+		// forward projection data projector
+		pForwardProjector = dispatchDataProjector(
 			m_pProjector, 
-			SinogramMaskPolicy(m_pSinogramMask),														// sinogram mask
-			ReconstructionMaskPolicy(m_pReconstructionMask),											// reconstruction mask
-			DefaultBPPolicy(z, r),																		//  backprojection
-			m_bUseSinogramMask, m_bUseReconstructionMask, true // options on/off
-		); 
+				SinogramMaskPolicy(m_pSinogramMask),					// sinogram mask
+				ReconstructionMaskPolicy(m_pReconstructionMask),		// reconstruction mask
+				DefaultFPPolicy(p, w),									// forward projection
+				m_bUseSinogramMask, m_bUseReconstructionMask, true		// options on/off
+			); 
+
+		// backprojection data projector
+		pBackProjector = dispatchDataProjector(
+				m_pProjector, 
+				SinogramMaskPolicy(m_pSinogramMask),														// sinogram mask
+				ReconstructionMaskPolicy(m_pReconstructionMask),											// reconstruction mask
+				DefaultBPPolicy(z, r),																		//  backprojection
+				m_bUseSinogramMask, m_bUseReconstructionMask, true // options on/off
+			); 
+	}
 
 
 
 	int i;
 
+	// progress: every iteration is a forward and a backprojection
+	const float32 fStep = 0.5f / std::max(_iNrIterations, 1);
+	bool bAborted = false;
+
 	if (m_iIteration == 0) {
 		// r = b;
-		r->copyData(m_pSinogram->getData());
+		{
+			CPhaseTimer timer(m_timings, ALGPHASE_HOSTCOPY);
+			r->copyData(m_pSinogram->getData());
+			m_timings.addBytes(2 * fSinoBytes);
+		}
 
 		// z = A'*b;
-		z->setData(0.0f);
-		pBackProjector->project();
-		if (m_bUseMinConstraint)
-			z->clampMin(m_fMinValue);
-		if (m_bUseMaxConstraint)
-			z->clampMax(m_fMaxValue);
-
-		// p = z;
-		p->copyData(z->getData());
-
-		// gamma = dot(z,z);
-		gamma = 0.0f;
-		for (i = 0; i < z->getSize(); ++i) {
-			gamma += z->getData()[i] * z->getData()[i];
+		{
+			CPhaseTimer timer(m_timings, ALGPHASE_BP);
+			z->setData(0.0f);
+			bAborted = !pBackProjector->project(CAlgorithmCheckpoint(this, ALGPHASE_BP, 0.0f, 0.0f));
+		}
+		addProjectionCounts();
+
+		if (!bAborted) {
+			CPhaseTimer timer(m_timings, ALGPHASE_VECTOROPS);
+			if (m_bUseMinConstraint)
+				z->clampMin(m_fMinValue);
+			if (m_bUseMaxConstraint)
+				z->clampMax(m_fMaxValue);
+
+			// p = z;
+			p->copyData(z->getData());
+
+			// gamma = dot(z,z);
+			gamma = (float32)reduceSquaredNorm(z->getData(), z->getSize());
+			m_timings.addBytes(3 * fVolBytes);
+			m_iIteration++;
 		}
-		m_iIteration++;
 	}
 
 
 	// start iterations
-	for (int iIteration = _iNrIterations-1; iIteration >= 0; --iIteration) {
-	
-		// w = A*p;
-		pForwardProjector->project();
+	for (int iIteration = _iNrIterations-1; iIteration >= 0 && !bAborted; --iIteration) {
+		const float32 fProgress = 2 * (_iNrIterations-1 - iIteration) * fStep;
 	
-		// alpha = gamma/dot(w,w);
-		float32 tmp = 0;
-		for (i = 0; i < w->getSize(); ++i) {
-			tmp += w->getData()[i] * w->getData()[i];
+		// x and r are already updated if the previous run was aborted
+		// during the backprojection below
+		if (!m_bResumeAtBP) {
+			// w = A*p;
+			{
+				CPhaseTimer timer(m_timings, ALGPHASE_FP);
+				if (!pForwardProjector->projectParallel(CAlgorithmCheckpoint(this, ALGPHASE_FP, fProgress, fProgress + fStep)))
+					break;
+			}
+			addProjectionCounts();
+
+			{
+				CPhaseTimer timer(m_timings, ALGPHASE_VECTOROPS);
+
+				// alpha = gamma/dot(w,w);
+				float32 tmp = (float32)reduceSquaredNorm(w->getData(), w->getSize());
+				alpha = gamma / tmp;
+
+				// x = x + alpha*p;
+				for (i = 0; i < m_pReconstruction->getSize(); ++i) {
+					m_pReconstruction->getData()[i] += alpha * p->getData()[i];
+				}
+
+				// r = r - alpha*w;
+				for (i = 0; i < r->getSize(); ++i) {
+					r->getData()[i] -= alpha * w->getData()[i];
+				}
+				m_timings.addBytes(3 * fVolBytes + 4 * fSinoBytes);
+			}
+			m_bResumeAtBP = true;
 		}
-		alpha = gamma / tmp;
 
-		// x = x + alpha*p;
-		for (i = 0; i < m_pReconstruction->getSize(); ++i) {
-			m_pReconstruction->getData()[i] += alpha * p->getData()[i];
+		// z = A'*r;
+		{
+			CPhaseTimer timer(m_timings, ALGPHASE_BP);
+			z->setData(0.0f);
+			if (!pBackProjector->project(CAlgorithmCheckpoint(this, ALGPHASE_BP, fProgress + fStep, fProgress + 2 * fStep)))
+				break;
 		}
+		addProjectionCounts();
 
-		// r = r - alpha*w;
-		for (i = 0; i < r->getSize(); ++i) {
-			r->getData()[i] -= alpha * w->getData()[i];
-		}
+		{
+			CPhaseTimer timer(m_timings, ALGPHASE_VECTOROPS);
 
-		// z = A'*r;
-		z->setData(0.0f);
-		pBackProjector->project();
-
-		// CHECKME: should these be here?
-		if (m_bUseMinConstraint)
-			z->clampMin(m_fMinValue);
-		if (m_bUseMaxConstraint)
-			z->clampMax(m_fMaxValue);
-
-		// beta = 1/gamma;
-		beta = 1.0f / gamma;
-
-		// gamma = dot(z,z);
-		gamma = 0;
-		for (i = 0; i < z->getSize(); ++i) {
-			gamma += z->getData()[i] * z->getData()[i];
-		}
+			// CHECKME: should these be here?
+			if (m_bUseMinConstraint)
+				z->clampMin(m_fMinValue);
+			if (m_bUseMaxConstraint)
+				z->clampMax(m_fMaxValue);
 
-		// beta = gamma*beta;
-		beta *= gamma; 
+			// beta = 1/gamma;
+			beta = 1.0f / gamma;
 
-		// p = z + beta*p;
-		for (i = 0; i < z->getSize(); ++i) {
-			p->getData()[i] = z->getData()[i] + beta * p->getData()[i];
+			// gamma = dot(z,z);
+			gamma = (float32)reduceSquaredNorm(z->getData(), z->getSize());
+
+			// beta = gamma*beta;
+			beta *= gamma; 
+
+			// p = z + beta*p;
+			for (i = 0; i < z->getSize(); ++i) {
+				p->getData()[i] = z->getData()[i] + beta * p->getData()[i];
+			}
+			m_timings.addBytes(4 * fVolBytes);
 		}
-		
+
+		m_bResumeAtBP = false;
 		m_iIteration++;
 	}
 
+	ASTRA_DELETE(pForwardProjector);
+	ASTRA_DELETE(pBackProjector);
 }
 //----------------------------------------------------------------------------------------
 
@@ -0,0 +1,341 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#include "astra/CglsAlgorithm3D.h"
+
+#include <cmath>
+
+#include "astra/AstraObjectManager.h"
+#include "astra/Projector3D.h"
+#include "astra/Reduction.h"
+
+#include "astra/Logging.h"
+
+using namespace std;
+
+namespace astra {
+
+// type of the algorithm, needed to register with CAlgorithmFactory
+std::string CCglsAlgorithm3D::type = "CGLS3D";
+
+//----------------------------------------------------------------------------------------
+// Constructor
+CCglsAlgorithm3D::CCglsAlgorithm3D() 
+{
+	r = NULL;
+	w = NULL;
+	z = NULL;
+	p = NULL;
+	gamma = 0.0f;
+	m_iIteration = 0;
+}
+
+//----------------------------------------------------------------------------------------
+// Destructor
+CCglsAlgorithm3D::~CCglsAlgorithm3D() 
+{
+	clear();
+}
+
+//---------------------------------------------------------------------------------------
+// Clear - Public
+void CCglsAlgorithm3D::clear()
+{
+	CReconstructionAlgorithm3D::_clear();
+
+	ASTRA_DELETE(r);
+	ASTRA_DELETE(w);
+	ASTRA_DELETE(z);
+	ASTRA_DELETE(p);
+	m_projection.clear();
+
+	gamma = 0.0f;
+	m_iIteration = 0;
+}
+
+//---------------------------------------------------------------------------------------
+// Check
+bool CCglsAlgorithm3D::_check()
+{
+	// check base class
+	ASTRA_CONFIG_CHECK(CReconstructionAlgorithm3D::_check(), "CGLS3D", "Error in ReconstructionAlgorithm3D initialization");
+
+	CFloat32ProjectionData3DMemory* pSinoMem = dynamic_cast<CFloat32ProjectionData3DMemory*>(m_pSinogram);
+	CFloat32VolumeData3DMemory* pReconMem = dynamic_cast<CFloat32VolumeData3DMemory*>(m_pReconstruction);
+	ASTRA_CONFIG_CHECK(pSinoMem && pReconMem, "CGLS3D", "Data objects must be stored in memory.");
+	ASTRA_CONFIG_CHECK(pSinoMem->isPacked() && pReconMem->isPacked(), "CGLS3D", "Data objects with a row pitch are not supported.");
+	if (m_bUseReconstructionMask) {
+		CFloat32VolumeData3DMemory* pMask = dynamic_cast<CFloat32VolumeData3DMemory*>(m_pReconstructionMask);
+		ASTRA_CONFIG_CHECK(pMask && pMask->isPacked(), "CGLS3D", "Invalid Reconstruction Mask Object.");
+		ASTRA_CONFIG_CHECK(pMask->getGeometry()->isEqual(m_pReconstruction->getGeometry()), "CGLS3D", "Reconstruction Mask not compatible with the Reconstruction Data.");
+	}
+	if (m_bUseSinogramMask) {
+		CFloat32ProjectionData3DMemory* pMask = dynamic_cast<CFloat32ProjectionData3DMemory*>(m_pSinogramMask);
+		ASTRA_CONFIG_CHECK(pMask && pMask->isPacked(), "CGLS3D", "Invalid Sinogram Mask Object.");
+		ASTRA_CONFIG_CHECK(pMask->getGeometry()->isEqual(m_pSinogram->getGeometry()), "CGLS3D", "Sinogram Mask not compatible with the Projection Data.");
+	}
+	if (m_pProjector) {
+		ASTRA_CONFIG_CHECK(m_pSinogram->getGeometry()->isEqual(m_pProjector->getProjectionGeometry()), "CGLS3D", "Projection Data not compatible with the specified Projector.");
+		ASTRA_CONFIG_CHECK(m_pReconstruction->getGeometry()->isEqual(m_pProjector->getVolumeGeometry()), "CGLS3D", "Reconstruction Data not compatible with the specified Projector.");
+	}
+
+	ASTRA_CONFIG_CHECK(m_projection.isInitialized(), "CGLS3D", "Unsupported geometry.");
+	ASTRA_CONFIG_CHECK(r && r->isInitialized() && w && w->isInitialized(), "CGLS3D", "Invalid temporary projection data objects");
+	ASTRA_CONFIG_CHECK(z && z->isInitialized() && p && p->isInitialized(), "CGLS3D", "Invalid temporary volume data objects");
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------
+// Initialize - Config
+bool CCglsAlgorithm3D::initialize(const Config& _cfg)
+{
+	ASTRA_ASSERT(_cfg.self);
+	ConfigStackCheck<CAlgorithm> CC("CglsAlgorithm3D", this, _cfg);
+
+	// if already initialized, clear first
+	if (m_bIsInitialized) {
+		clear();
+	}
+
+	// initialization of parent class
+	if (!CReconstructionAlgorithm3D::initialize(_cfg)) {
+		return false;
+	}
+
+	// init data objects and projections
+	_init();
+
+	// success
+	m_bIsInitialized = _check();
+	return m_bIsInitialized;
+}
+
+//---------------------------------------------------------------------------------------
+// Initialize - C++
+bool CCglsAlgorithm3D::initialize(CProjector3D* _pProjector, 
+								  CFloat32ProjectionData3DMemory* _pSinogram, 
+								  CFloat32VolumeData3DMemory* _pReconstruction)
+{
+	// if already initialized, clear first
+	if (m_bIsInitialized) {
+		clear();
+	}
+
+	// initialization of parent class
+	if (!CReconstructionAlgorithm3D::initialize(_pProjector, _pSinogram, _pReconstruction)) {
+		return false;
+	}
+
+	// init data objects and projections
+	_init();
+
+	// success
+	m_bIsInitialized = _check();
+	return m_bIsInitialized;
+}
+
+//---------------------------------------------------------------------------------------
+// Initialize Data Objects - private
+void CCglsAlgorithm3D::_init()
+{
+	ASTRA_DELETE(r);
+	ASTRA_DELETE(w);
+	ASTRA_DELETE(z);
+	ASTRA_DELETE(p);
+
+	if (!m_projection.initialize(m_pSinogram->getGeometry(), m_pReconstruction->getGeometry(), m_pProjector))
+		return;
+
+	r = new CFloat32ProjectionData3DMemory(m_pSinogram->getGeometry());
+	w = new CFloat32ProjectionData3DMemory(m_pSinogram->getGeometry());
+	z = new CFloat32VolumeData3DMemory(m_pReconstruction->getGeometry());
+	p = new CFloat32VolumeData3DMemory(m_pReconstruction->getGeometry());
+
+	m_iIteration = 0;
+}
+
+//---------------------------------------------------------------------------------------
+// Information - All
+map<string,boost::any> CCglsAlgorithm3D::getInformation() 
+{
+	map<string, boost::any> res;
+	return mergeMap<string,boost::any>(CReconstructionAlgorithm3D::getInformation(), res);
+};
+
+//---------------------------------------------------------------------------------------
+// Information - Specific
+boost::any CCglsAlgorithm3D::getInformation(std::string _sIdentifier) 
+{
+	return CReconstructionAlgorithm3D::getInformation(_sIdentifier);
+};
+
+//----------------------------------------------------------------------------------------
+void CCglsAlgorithm3D::_maskSinogram(CFloat32ProjectionData3DMemory* _pData)
+{
+	if (!m_bUseSinogramMask)
+		return;
+	const float32* pfMask = dynamic_cast<CFloat32ProjectionData3DMemory*>(m_pSinogramMask)->getDataConst();
+	float32* pfData = _pData->getData();
+	for (int i = 0; i < _pData->getSize(); ++i)
+		pfData[i] *= pfMask[i];
+}
+
+//----------------------------------------------------------------------------------------
+void CCglsAlgorithm3D::_maskVolume(CFloat32VolumeData3DMemory* _pData)
+{
+	if (!m_bUseReconstructionMask)
+		return;
+	const float32* pfMask = dynamic_cast<CFloat32VolumeData3DMemory*>(m_pReconstructionMask)->getDataConst();
+	float32* pfData = _pData->getData();
+	for (int i = 0; i < _pData->getSize(); ++i)
+		pfData[i] *= pfMask[i];
+}
+
+//----------------------------------------------------------------------------------------
+// Iterate
+void CCglsAlgorithm3D::run(int _iNrIterations)
+{
+	// check initialized
+	ASTRA_ASSERT(m_bIsInitialized);
+
+	resetAbort();
+	m_timings.reset();
+
+	CFloat32ProjectionData3DMemory* pSinogram = dynamic_cast<CFloat32ProjectionData3DMemory*>(m_pSinogram);
+	CFloat32VolumeData3DMemory* pReconstruction = dynamic_cast<CFloat32VolumeData3DMemory*>(m_pReconstruction);
+	const int iVolSize = pReconstruction->getSize();
+	const int iSinoSize = pSinogram->getSize();
+	int i;
+
+	if (m_iIteration == 0) {
+		// r = b - A*x;
+		{
+			CPhaseTimer timer(m_timings, ALGPHASE_FP);
+			if (!m_projection.forwardProject(pReconstruction, r))
+				return;
+		}
+		{
+			CPhaseTimer timer(m_timings, ALGPHASE_VECTOROPS);
+			const float32* pfB = pSinogram->getDataConst();
+			float32* pfR = r->getData();
+			for (i = 0; i < iSinoSize; ++i)
+				pfR[i] = pfB[i] - pfR[i];
+			_maskSinogram(r);
+		}
+
+		// z = A'*r;
+		{
+			CPhaseTimer timer(m_timings, ALGPHASE_BP);
+			if (!m_projection.backProject(r, z))
+				return;
+		}
+
+		{
+			CPhaseTimer timer(m_timings, ALGPHASE_VECTOROPS);
+			_maskVolume(z);
+
+			// p = z;
+			p->copyData(z->getDataConst(), iVolSize);
+
+			// gamma = dot(z,z);
+			gamma = (float32)reduceSquaredNorm(z->getDataConst(), iVolSize);
+		}
+		m_iIteration++;
+	}
+
+	// start iterations
+	for (int iIteration = 0; iIteration < _iNrIterations && !m_bShouldAbort; ++iIteration) {
+		// stop at convergence; alpha would be undefined
+		if (gamma == 0.0f)
+			break;
+
+		// w = A*p;
+		{
+			CPhaseTimer timer(m_timings, ALGPHASE_FP);
+			if (!m_projection.forwardProject(p, w))
+				break;
+		}
+
+		{
+			CPhaseTimer timer(m_timings, ALGPHASE_VECTOROPS);
+			_maskSinogram(w);
+
+			// alpha = gamma/dot(w,w);
+			const float32 alpha = gamma / (float32)reduceSquaredNorm(w->getDataConst(), iSinoSize);
+
+			// x = x + alpha*p;
+			float32* pfX = pReconstruction->getData();
+			const float32* pfP = p->getDataConst();
+			for (i = 0; i < iVolSize; ++i)
+				pfX[i] += alpha * pfP[i];
+
+			// r = r - alpha*w;
+			float32* pfR = r->getData();
+			const float32* pfW = w->getDataConst();
+			for (i = 0; i < iSinoSize; ++i)
+				pfR[i] -= alpha * pfW[i];
+		}
+
+		// z = A'*r;
+		{
+			CPhaseTimer timer(m_timings, ALGPHASE_BP);
+			if (!m_projection.backProject(r, z))
+				break;
+		}
+
+		{
+			CPhaseTimer timer(m_timings, ALGPHASE_VECTOROPS);
+			_maskVolume(z);
+
+			// beta = gamma_new / gamma;
+			const float32 fGammaOld = gamma;
+			gamma = (float32)reduceSquaredNorm(z->getDataConst(), iVolSize);
+			const float32 beta = gamma / fGammaOld;
+
+			// p = z + beta*p;
+			float32* pfP = p->getData();
+			const float32* pfZ = z->getDataConst();
+			for (i = 0; i < iVolSize; ++i)
+				pfP[i] = pfZ[i] + beta * pfP[i];
+		}
+
+		m_iIteration++;
+	}
+}
+
+//----------------------------------------------------------------------------------------
+bool CCglsAlgorithm3D::getResidualNorm(float32& _fNorm)
+{
+	if (!m_bIsInitialized || m_iIteration == 0)
+		return false;
+
+	_fNorm = (float32)sqrt(reduceSquaredNorm(r->getDataConst(), r->getSize()));
+	return true;
+}
+
+} // namespace astra
@@ -42,10 +42,12 @@ along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
 #include "astra/Float32ProjectionData3DGPU.h"
 #include "astra/Float32VolumeData3DGPU.h"
 #include "astra/Logging.h"
+#include "astra/Tracing.h"
 
 #include "astra/cuda/2d/astra.h"
 #include "astra/cuda/3d/mem3d.h"
 
+#include <cstdio>
 #include <cstring>
 #include <sstream>
 #include <climits>
@@ -207,6 +209,15 @@ bool CFloat32ExistingGPUMemory::freeGPUMemory() {
 }
 
 
+// Distance between the rows of the data, in elements. Host data may have
+// padded rows; GPU data is handled by CFloat32ExistingGPUMemory.
+static unsigned int getRowPitch(CFloat32Data3D *d) {
+	CFloat32Data3DMemory *dMem = dynamic_cast<CFloat32Data3DMemory*>(d);
+	if (dMem)
+		return dMem->getRowPitch();
+	return d->getWidth();
+}
+
 CFloat32CustomGPUMemory * createGPUMemoryHandler(CFloat32Data3D *d) {
 	CFloat32Data3DMemory *dMem = dynamic_cast<CFloat32Data3DMemory*>(d);
 	CFloat32Data3DGPU *dGPU = dynamic_cast<CFloat32Data3DGPU*>(d);
@@ -1344,6 +1355,10 @@ static bool doJob(const CCompositeGeometryManager::TJobSet::const_iterator& iter
 	size_t outx, outy, outz;
 	output->getDims(outx, outy, outz);
 
+	CTraceScope trace("composite", "job");
+	trace.addDims("output", outx, outy, outz);
+	trace.addArg("jobs", (double)L.size());
+
 	if (L.begin()->eType == CCompositeGeometryManager::SJob::JOB_NOP) {
 		// just zero output?
 		if (zero) {
@@ -1353,10 +1368,7 @@ static bool doJob(const CCompositeGeometryManager::TJobSet::const_iterator& iter
 			if (hostMem) {
 				for (size_t z = 0; z < outz; ++z) {
 					for (size_t y = 0; y < outy; ++y) {
-						float* ptr = hostMem->getData();
-						ptr += (z + output->subX) * (size_t)output->pData->getHeight() * (size_t)output->pData->getWidth();
-						ptr += (y + output->subY) * (size_t)output->pData->getWidth();
-						ptr += output->subX;
+						float* ptr = hostMem->getRow(y + output->subY, z + output->subZ) + output->subX;
 						memset(ptr, 0, sizeof(float) * outx);
 					}
 				}
@@ -1374,7 +1386,7 @@ static bool doJob(const CCompositeGeometryManager::TJobSet::const_iterator& iter
 
 	astraCUDA3d::SSubDimensions3D dstdims;
 	dstdims.nx = output->pData->getWidth();
-	dstdims.pitch = dstdims.nx;
+	dstdims.pitch = getRowPitch(output->pData);
 	dstdims.ny = output->pData->getHeight();
 	dstdims.nz = output->pData->getDepth();
 	dstdims.subnx = outx;
@@ -1387,13 +1399,19 @@ static bool doJob(const CCompositeGeometryManager::TJobSet::const_iterator& iter
 
 	CFloat32CustomGPUMemory *dstMem = createGPUMemoryHandler(output->pData);
 
+	const double fOutputBytes = (double)outx * outy * outz * sizeof(float);
+	double fBytesIn = 0.0;
+
 	bool ok = dstMem->allocateGPUMemory(outx, outy, outz, zero ? astraCUDA3d::INIT_ZERO : astraCUDA3d::INIT_NO);
 	if (!ok) ASTRA_ERROR("Error allocating GPU memory");
 
 	if (!zero) {
 		// instead of zeroing output memory, copy from host
+		CTraceScope copyTrace("composite", "copy output to GPU");
+		copyTrace.addArg("bytes", fOutputBytes);
 		ok = dstMem->copyToGPUMemory(dstdims);
 		if (!ok) ASTRA_ERROR("Error copying output data to GPU");
+		fBytesIn += fOutputBytes;
 	}
 
 	for (CCompositeGeometryManager::TJobList::const_iterator i = L.begin(); i != L.end(); ++i) {
@@ -1420,7 +1438,7 @@ static bool doJob(const CCompositeGeometryManager::TJobSet::const_iterator& iter
 
 		astraCUDA3d::SSubDimensions3D srcdims;
 		srcdims.nx = j.pInput->pData->getWidth();
-		srcdims.pitch = srcdims.nx;
+		srcdims.pitch = getRowPitch(j.pInput->pData);
 		srcdims.ny = j.pInput->pData->getHeight();
 		srcdims.nz = j.pInput->pData->getDepth();
 		srcdims.subnx = inx;
@@ -1433,8 +1451,15 @@ static bool doJob(const CCompositeGeometryManager::TJobSet::const_iterator& iter
 		ok = srcMem->allocateGPUMemory(inx, iny, inz, astraCUDA3d::INIT_NO);
 		if (!ok) ASTRA_ERROR("Error allocating GPU memory");
 
-		ok = srcMem->copyToGPUMemory(srcdims);
-		if (!ok) ASTRA_ERROR("Error copying input data to GPU");
+		{
+			const double fInputBytes = (double)inx * iny * inz * sizeof(float);
+			CTraceScope copyTrace("composite", "copy input to GPU");
+			copyTrace.addDims("input", inx, iny, inz);
+			copyTrace.addArg("bytes", fInputBytes);
+			ok = srcMem->copyToGPUMemory(srcdims);
+			if (!ok) ASTRA_ERROR("Error copying input data to GPU");
+			fBytesIn += fInputBytes;
+		}
 
 		switch (j.eType) {
 		case CCompositeGeometryManager::SJob::JOB_FP:
@@ -1443,6 +1468,7 @@ static bool doJob(const CCompositeGeometryManager::TJobSet::const_iterator& iter
 			assert(dynamic_cast<CCompositeGeometryManager::CProjectionPart*>(j.pOutput.get()));
 
 			ASTRA_DEBUG("CCompositeGeometryManager::doJobs: doing FP");
+			CTraceScope kernelTrace("composite", "FP");
 
 			ok = astraCUDA3d::FP(((CCompositeGeometryManager::CProjectionPart*)j.pOutput.get())->pGeom, dstMem->hnd, ((CCompositeGeometryManager::CVolumePart*)j.pInput.get())->pGeom, srcMem->hnd, detectorSuperSampling, projKernel);
 			if (!ok) ASTRA_ERROR("Error performing sub-FP");
@@ -1455,6 +1481,7 @@ static bool doJob(const CCompositeGeometryManager::TJobSet::const_iterator& iter
 			assert(dynamic_cast<CCompositeGeometryManager::CProjectionPart*>(j.pInput.get()));
 
 			ASTRA_DEBUG("CCompositeGeometryManager::doJobs: doing BP");
+			CTraceScope kernelTrace("composite", "BP");
 
 			ok = astraCUDA3d::BP(((CCompositeGeometryManager::CProjectionPart*)j.pInput.get())->pGeom, srcMem->hnd, ((CCompositeGeometryManager::CVolumePart*)j.pOutput.get())->pGeom, dstMem->hnd, voxelSuperSampling, densityWeighting);
 			if (!ok) ASTRA_ERROR("Error performing sub-BP");
@@ -1471,6 +1498,7 @@ static bool doJob(const CCompositeGeometryManager::TJobSet::const_iterator& iter
 				ok = false;
 			} else {
 				ASTRA_DEBUG("CCompositeGeometryManager::doJobs: doing FDK");
+				CTraceScope kernelTrace("composite", "FDK");
 
 				ok = astraCUDA3d::FDK(((CCompositeGeometryManager::CProjectionPart*)j.pInput.get())->pGeom, srcMem->hnd, ((CCompositeGeometryManager::CVolumePart*)j.pOutput.get())->pGeom, dstMem->hnd, j.FDKSettings.bShortScan, j.FDKSettings.pfFilter);
 				if (!ok) ASTRA_ERROR("Error performing sub-FDK");
@@ -1488,8 +1516,15 @@ static bool doJob(const CCompositeGeometryManager::TJobSet::const_iterator& iter
 		delete srcMem;
 	}
 
-	ok = dstMem->copyFromGPUMemory(dstdims);
-	if (!ok) ASTRA_ERROR("Error copying output data from GPU");
+	{
+		CTraceScope copyTrace("composite", "copy output from GPU");
+		copyTrace.addArg("bytes", fOutputBytes);
+		ok = dstMem->copyFromGPUMemory(dstdims);
+		if (!ok) ASTRA_ERROR("Error copying output data from GPU");
+	}
+
+	trace.addArg("bytes_to_gpu", fBytesIn);
+	trace.addArg("bytes_from_gpu", fOutputBytes);
 	
 	ok = dstMem->freeGPUMemory();
 	if (!ok) ASTRA_ERROR("Error freeing GPU memory");
@@ -1555,41 +1590,45 @@ struct WorkThreadInfo {
 	unsigned int m_iGPU;
 };
 
-#ifndef USE_PTHREADS
-
-void runEntries_boost(WorkThreadInfo* info)
+// GPU jobs run on dedicated threads, one per GPU, and not on the CPU
+// worker pool: they block on the GPU for long stretches, and would take
+// the pool threads away from the CPU kernels.
+static void runEntries(WorkThreadInfo* info)
 {
+	char name[32];
+	snprintf(name, sizeof(name), "GPU %d", info->m_iGPU);
+	CTracer::setThreadName(name);
+	CTraceScope trace("composite", name);
+
 	ASTRA_DEBUG("Launching thread on GPU %d\n", info->m_iGPU);
 	CCompositeGeometryManager::TJobSet::const_iterator i;
 	while (info->m_queue->receive(i)) {
 		ASTRA_DEBUG("Running block on GPU %d\n", info->m_iGPU);
 		astraCUDA3d::setGPUIndex(info->m_iGPU);
+#ifdef USE_PTHREADS
+		pthread_testcancel();
+		doJob(i);
+		pthread_testcancel();
+#else
 		boost::this_thread::interruption_point();
 		doJob(i);
 		boost::this_thread::interruption_point();
+#endif
 	}
 	ASTRA_DEBUG("Finishing thread on GPU %d\n", info->m_iGPU);
 }
 
+#ifndef USE_PTHREADS
+
+void runEntries_boost(WorkThreadInfo* info)
+{
+	runEntries(info);
+}
 
 #else
 
 void* runEntries_pthreads(void* data) {
-	WorkThreadInfo* info = (WorkThreadInfo*)data;
-
-	ASTRA_DEBUG("Launching thread on GPU %d\n", info->m_iGPU);
-
-	CCompositeGeometryManager::TJobSet::const_iterator i;
-
-	while (info->m_queue->receive(i)) {
-		ASTRA_DEBUG("Running block on GPU %d\n", info->m_iGPU);
-		astraCUDA3d::setGPUIndex(info->m_iGPU);
-		pthread_testcancel();
-		doJob(i);
-		pthread_testcancel();
-	}
-	ASTRA_DEBUG("Finishing thread on GPU %d\n", info->m_iGPU);
-
+	runEntries((WorkThreadInfo*)data);
 	return 0;
 }
 
@@ -1642,6 +1681,9 @@ bool CCompositeGeometryManager::doJobs(TJobList &jobs)
 
 	ASTRA_DEBUG("CCompositeGeometryManager::doJobs");
 
+	CTraceScope trace("composite", "doJobs");
+	trace.addArg("jobs", (double)jobs.size());
+
 	// Sort job list into job set by output part
 	TJobSet jobset;
 
@@ -1673,9 +1715,16 @@ bool CCompositeGeometryManager::doJobs(TJobList &jobs)
 
 	// Split jobs to fit
 	TJobSet split;
-	splitJobs(jobset, maxSize, div, split);
+	{
+		CTraceScope splitTrace("composite", "splitJobs");
+		splitJobs(jobset, maxSize, div, split);
+	}
 	jobset.clear();
 
+	trace.addArg("parts", (double)split.size());
+	trace.addArg("gpus", (double)div);
+	trace.addArg("max_part_bytes", (double)maxSize * sizeof(float));
+
 	if (m_GPUIndices.size() <= 1) {
 
 		// Run jobs
@@ -0,0 +1,443 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#include "astra/CpuProjection3D.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "astra/BrickedVolume3D.h"
+#include "astra/HostMemory.h"
+#include "astra/MemoryBudget.h"
+#include "astra/Float32ProjectionData3DMemory.h"
+#include "astra/Float32VolumeData3DMemory.h"
+#include "astra/ParallelVecProjectionGeometry3D.h"
+#include "astra/VolumeGeometry3D.h"
+#include "astra/LinearKernel3D.h"
+#include "astra/LinearKernelProjector3D.h"
+#include "astra/SeparableFootprintProjector3D.h"
+#include "astra/SparseMatrix.h"
+#include "astra/WorkerPool.h"
+#include "astra/Logging.h"
+
+namespace astra {
+
+// number of slices that share one pass over the 2D weights
+static const int SLICE_BATCH = 8;
+
+//----------------------------------------------------------------------------------------
+CCpuProjection3D::CCpuProjection3D()
+{
+	m_bInitialized = false;
+	m_pProjGeom = 0;
+	m_pVolGeom = 0;
+	m_pSliceMatrix = 0;
+	m_pBricked = 0;
+	m_pFootprintProjector = 0;
+}
+
+//----------------------------------------------------------------------------------------
+CCpuProjection3D::~CCpuProjection3D()
+{
+	clear();
+}
+
+//----------------------------------------------------------------------------------------
+void CCpuProjection3D::clear()
+{
+	_freeScatterBuffers();
+	delete m_pProjGeom;
+	m_pProjGeom = 0;
+	delete m_pVolGeom;
+	m_pVolGeom = 0;
+	delete m_pSliceMatrix;
+	m_pSliceMatrix = 0;
+	delete m_pBricked;
+	m_pBricked = 0;
+	m_pFootprintProjector = 0;
+	m_bInitialized = false;
+}
+
+//----------------------------------------------------------------------------------------
+bool CCpuProjection3D::isSliceDecomposable(const CProjectionGeometry3D* _pProjGeom,
+                                           const CVolumeGeometry3D* _pVolGeom)
+{
+	SProjectionVectors3D vectors;
+	if (!vectors.set(_pProjGeom) || vectors.bCone)
+		return false;
+	if (vectors.iRows != _pVolGeom->getGridSliceCount())
+		return false;
+
+	// relative tolerance for values that went through float32 conversions
+	const double fEps = 1e-4;
+	const double fPixelZ = _pVolGeom->getPixelLengthZ();
+	const double fMinZ = _pVolGeom->getWindowMinZ();
+	for (int a = 0; a < vectors.iAngles; ++a) {
+		const SPar3DProjection& p = vectors.par[a];
+		const double fRay = std::sqrt(p.fRayX * p.fRayX + p.fRayY * p.fRayY + p.fRayZ * p.fRayZ);
+		const double fU = std::sqrt(p.fDetUX * p.fDetUX + p.fDetUY * p.fDetUY + p.fDetUZ * p.fDetUZ);
+		if (std::fabs(p.fRayZ) > fEps * fRay || std::fabs(p.fDetUZ) > fEps * fU)
+			return false;
+		// detector row i covers exactly slice i
+		if (std::fabs(p.fDetVX) > fEps * fPixelZ || std::fabs(p.fDetVY) > fEps * fPixelZ)
+			return false;
+		if (std::fabs(p.fDetVZ - fPixelZ) > fEps * fPixelZ || std::fabs(p.fDetSZ - fMinZ) > fEps * fPixelZ)
+			return false;
+	}
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+bool CCpuProjection3D::initialize(const CProjectionGeometry3D* _pProjGeom,
+                                  const CVolumeGeometry3D* _pVolGeom,
+                                  CProjector3D* _pProjector)
+{
+	clear();
+
+	SProjectionVectors3D vectors;
+	if (!vectors.set(_pProjGeom)) {
+		ASTRA_ERROR("CCpuProjection3D: unsupported projection geometry");
+		return false;
+	}
+
+	m_pProjGeom = _pProjGeom->clone();
+	m_pVolGeom = _pVolGeom->clone();
+
+	m_pFootprintProjector = dynamic_cast<CSeparableFootprintProjector3D*>(_pProjector);
+	if (m_pFootprintProjector) {
+		if (!m_pFootprintProjector->isInitialized() ||
+		    !m_pFootprintProjector->getProjectionGeometry()->isEqual(m_pProjGeom) ||
+		    !m_pFootprintProjector->getVolumeGeometry()->isEqual(m_pVolGeom)) {
+			ASTRA_ERROR("CCpuProjection3D: the projector doesn't match the geometries");
+			clear();
+			return false;
+		}
+	} else if (isSliceDecomposable(_pProjGeom, _pVolGeom)) {
+		// The weights of the first detector row against the first slice;
+		// every other row/slice pair is the same problem shifted in z.
+		CParallelVecProjectionGeometry3D sliceProj(vectors.iAngles, 1, vectors.iCols, &vectors.par[0]);
+		CVolumeGeometry3D sliceVol(_pVolGeom->getGridColCount(), _pVolGeom->getGridRowCount(), 1,
+		                           _pVolGeom->getWindowMinX(), _pVolGeom->getWindowMinY(), _pVolGeom->getWindowMinZ(),
+		                           _pVolGeom->getWindowMaxX(), _pVolGeom->getWindowMaxY(),
+		                           _pVolGeom->getWindowMinZ() + _pVolGeom->getPixelLengthZ());
+		CLinearKernelProjector3D projector(&sliceProj, &sliceVol);
+		m_pSliceMatrix = projector.getMatrix();
+		if (!m_pSliceMatrix) {
+			ASTRA_ERROR("CCpuProjection3D: failed to compute the slice weights");
+			clear();
+			return false;
+		}
+		ASTRA_DEBUG("CCpuProjection3D: using 2D slices, %lu weights",
+		            m_pSliceMatrix->m_plRowStarts[m_pSliceMatrix->m_iHeight]);
+	}
+
+	m_bInitialized = true;
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+bool CCpuProjection3D::_checkData(const CFloat32VolumeData3DMemory* _pVolume,
+                                  const CFloat32ProjectionData3DMemory* _pProjection) const
+{
+	if (!m_bInitialized || !_pVolume || !_pProjection)
+		return false;
+	if (!_pVolume->isPacked() || !_pProjection->isPacked()) {
+		ASTRA_ERROR("CCpuProjection3D: pitched data objects are not supported");
+		return false;
+	}
+	if (!_pVolume->getGeometry()->isEqual(m_pVolGeom) || !_pProjection->getGeometry()->isEqual(m_pProjGeom)) {
+		ASTRA_ERROR("CCpuProjection3D: data geometries don't match");
+		return false;
+	}
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+bool CCpuProjection3D::_allocateBricked()
+{
+	if (m_pBricked)
+		return true;
+	CBrickedVolume3D* pBricked = new CBrickedVolume3D();
+	if (!pBricked->initialize(m_pVolGeom->getGridColCount(), m_pVolGeom->getGridRowCount(), m_pVolGeom->getGridSliceCount())) {
+		delete pBricked;
+		return false;
+	}
+	m_pBricked = pBricked;
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+void CCpuProjection3D::_allocateScatterBuffers()
+{
+	if (!m_pfScatterBuffers.empty())
+		return;
+
+	// One volume per concurrent group of angles. The output volume is the
+	// first; the others are only allocated while they fit in the budget.
+	const size_t iBytes = (size_t)m_pVolGeom->getGridColCount() * m_pVolGeom->getGridRowCount() * m_pVolGeom->getGridSliceCount() * sizeof(float32);
+	const int iAngles = m_pProjGeom->getProjectionCount();
+	const int iThreads = CWorkerPool::getSingleton().getThreadCount();
+	m_pfScatterBuffers.push_back(0);
+	for (int i = 1; i < iThreads && i < iAngles; ++i) {
+		if (!CMemoryBudget::getSingleton().reserve(iBytes))
+			break;
+		float32* pfBuffer = (float32*)allocateHostMemory(iBytes, DATA_ALIGNMENT);
+		if (!pfBuffer) {
+			CMemoryBudget::getSingleton().release(iBytes);
+			break;
+		}
+		m_pfScatterBuffers.push_back(pfBuffer);
+	}
+}
+
+//----------------------------------------------------------------------------------------
+void CCpuProjection3D::_freeScatterBuffers()
+{
+	if (m_pfScatterBuffers.empty())
+		return;
+	const size_t iBytes = (size_t)m_pVolGeom->getGridColCount() * m_pVolGeom->getGridRowCount() * m_pVolGeom->getGridSliceCount() * sizeof(float32);
+	for (size_t i = 1; i < m_pfScatterBuffers.size(); ++i) {
+		freeHostMemory(m_pfScatterBuffers[i], iBytes);
+		CMemoryBudget::getSingleton().release(iBytes);
+	}
+	m_pfScatterBuffers.clear();
+}
+
+//----------------------------------------------------------------------------------------
+// Add a projection value times the weights along a ray to the volume; the
+// transpose of sampling the volume along the ray.
+struct SRayScatter {
+	float32* m_pfVolume;
+	int m_iCols, m_iRows;
+	float32 m_fValue;
+
+	void operator()(int _iX, int _iY, int _iZ, float32 _fWeight) {
+		m_pfVolume[((size_t)_iZ * m_iRows + _iY) * m_iCols + _iX] += _fWeight * m_fValue;
+	}
+};
+
+// Ray-driven backprojection. Work item g scatters angles g, g + n, g + 2n,
+// ... into buffer g of n, so no two threads write to the same volume.
+struct SRayBackProjectionFunctor {
+	const SVolumeGrid3D* m_pGrid;
+	const SProjectionVectors3D* m_pVectors;
+	const CFloat32ProjectionData3DMemory* m_pProjection;
+	float32* const* m_ppfBuffers;
+	int m_iBuffers;
+	size_t m_iVoxels;
+
+	void operator()(int _iFrom, int _iTo) const {
+		for (int g = _iFrom; g < _iTo; ++g) {
+			SRayScatter s;
+			s.m_pfVolume = m_ppfBuffers[g];
+			s.m_iCols = m_pGrid->iCols;
+			s.m_iRows = m_pGrid->iRows;
+			memset(s.m_pfVolume, 0, m_iVoxels * sizeof(float32));
+			for (int a = g; a < m_pVectors->iAngles; a += m_iBuffers) {
+				for (int v = 0; v < m_pVectors->iRows; ++v) {
+					const float32* pfIn = m_pProjection->getRowConst(a, v);
+					for (int u = 0; u < m_pVectors->iCols; ++u) {
+						if (pfIn[u] == 0.0f)
+							continue;
+						double fX, fY, fZ, fDX, fDY, fDZ;
+						m_pVectors->getRay(a, v, u, fX, fY, fZ, fDX, fDY, fDZ);
+						s.m_fValue = pfIn[u];
+						traceLinearRay3D(*m_pGrid, fX, fY, fZ, fDX, fDY, fDZ, s);
+					}
+				}
+			}
+		}
+	}
+};
+
+// Add the other buffers to the first, over a range of voxel rows.
+struct SBufferSumFunctor {
+	float32* const* m_ppfBuffers;
+	int m_iBuffers;
+	int m_iCols;
+
+	void operator()(int _iFrom, int _iTo) const {
+		const size_t iBegin = (size_t)_iFrom * m_iCols;
+		const size_t iEnd = (size_t)_iTo * m_iCols;
+		float32* pfOut = m_ppfBuffers[0];
+		for (int b = 1; b < m_iBuffers; ++b) {
+			const float32* pfIn = m_ppfBuffers[b];
+			for (size_t i = iBegin; i < iEnd; ++i)
+				pfOut[i] += pfIn[i];
+		}
+	}
+};
+
+//----------------------------------------------------------------------------------------
+bool CCpuProjection3D::_backProjectRays(const CFloat32ProjectionData3DMemory* _pProjection,
+                                        CFloat32VolumeData3DMemory* _pVolume)
+{
+	SVolumeGrid3D grid;
+	grid.set(m_pVolGeom);
+	SProjectionVectors3D vectors;
+	if (!vectors.set(m_pProjGeom)) {
+		ASTRA_ERROR("CCpuProjection3D: unsupported projection geometry");
+		return false;
+	}
+
+	_allocateScatterBuffers();
+	m_pfScatterBuffers[0] = _pVolume->getData();
+
+	SRayBackProjectionFunctor f;
+	f.m_pGrid = &grid;
+	f.m_pVectors = &vectors;
+	f.m_pProjection = _pProjection;
+	f.m_ppfBuffers = &m_pfScatterBuffers[0];
+	f.m_iBuffers = (int)m_pfScatterBuffers.size();
+	f.m_iVoxels = _pVolume->getSize();
+	CWorkerPool::getSingleton().parallelFor(0, f.m_iBuffers, f);
+
+	if (f.m_iBuffers > 1) {
+		SBufferSumFunctor sum;
+		sum.m_ppfBuffers = f.m_ppfBuffers;
+		sum.m_iBuffers = f.m_iBuffers;
+		sum.m_iCols = grid.iCols;
+		CWorkerPool::getSingleton().parallelFor(0, grid.iRows * grid.iSlices, sum, 16);
+	}
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+// Apply the slice matrix, or its transpose, to a range of slices. The
+// projection data of detector row z is one contiguous [angle][col] block,
+// as is volume slice z, so slice z is a plain 2D product.
+struct SSliceProjectionFunctor {
+	const CSparseMatrix* m_pMatrix;
+	const float32* m_pfIn;
+	float32* m_pfOut;
+	size_t m_iVolumeSlice;
+	size_t m_iProjectionSlice;
+	bool m_bTranspose;
+
+	void operator()(int _iFrom, int _iTo) const {
+		for (int z0 = _iFrom; z0 < _iTo; z0 += SLICE_BATCH) {
+			const int n = (_iTo - z0 < SLICE_BATCH) ? _iTo - z0 : SLICE_BATCH;
+			if (m_bTranspose)
+				_backProject(z0, n);
+			else
+				_forwardProject(z0, n);
+		}
+	}
+
+	void _forwardProject(int _iSlice, int _iCount) const {
+		const float32* pfVol = m_pfIn + _iSlice * m_iVolumeSlice;
+		float32* pfProj = m_pfOut + _iSlice * m_iProjectionSlice;
+		for (unsigned int i = 0; i < m_pMatrix->m_iHeight; ++i) {
+			float32 fSum[SLICE_BATCH] = { 0.0f };
+			for (unsigned long k = m_pMatrix->m_plRowStarts[i]; k < m_pMatrix->m_plRowStarts[i+1]; ++k) {
+				const float32 fWeight = m_pMatrix->m_pfValues[k];
+				const float32* pfIn = pfVol + m_pMatrix->m_piColIndices[k];
+				for (int z = 0; z < _iCount; ++z)
+					fSum[z] += fWeight * pfIn[z * m_iVolumeSlice];
+			}
+			for (int z = 0; z < _iCount; ++z)
+				pfProj[i + z * m_iProjectionSlice] = fSum[z];
+		}
+	}
+
+	void _backProject(int _iSlice, int _iCount) const {
+		const float32* pfProj = m_pfIn + _iSlice * m_iProjectionSlice;
+		float32* pfVol = m_pfOut + _iSlice * m_iVolumeSlice;
+		memset(pfVol, 0, _iCount * m_iVolumeSlice * sizeof(float32));
+		for (unsigned int i = 0; i < m_pMatrix->m_iHeight; ++i) {
+			float32 fValue[SLICE_BATCH];
+			bool bZero = true;
+			for (int z = 0; z < _iCount; ++z) {
+				fValue[z] = pfProj[i + z * m_iProjectionSlice];
+				bZero &= (fValue[z] == 0.0f);
+			}
+			if (bZero)
+				continue;
+			for (unsigned long k = m_pMatrix->m_plRowStarts[i]; k < m_pMatrix->m_plRowStarts[i+1]; ++k) {
+				const float32 fWeight = m_pMatrix->m_pfValues[k];
+				float32* pfOut = pfVol + m_pMatrix->m_piColIndices[k];
+				for (int z = 0; z < _iCount; ++z)
+					pfOut[z * m_iVolumeSlice] += fWeight * fValue[z];
+			}
+		}
+	}
+};
+
+//----------------------------------------------------------------------------------------
+bool CCpuProjection3D::forwardProject(const CFloat32VolumeData3DMemory* _pVolume,
+                                      CFloat32ProjectionData3DMemory* _pProjection)
+{
+	if (!_checkData(_pVolume, _pProjection))
+		return false;
+
+	if (m_pFootprintProjector)
+		return m_pFootprintProjector->forwardProject(_pVolume, _pProjection);
+
+	if (m_pSliceMatrix) {
+		SSliceProjectionFunctor f;
+		f.m_pMatrix = m_pSliceMatrix;
+		f.m_pfIn = _pVolume->getDataConst();
+		f.m_pfOut = _pProjection->getData();
+		f.m_iVolumeSlice = (size_t)_pVolume->getWidth() * _pVolume->getHeight();
+		f.m_iProjectionSlice = (size_t)_pProjection->getWidth() * _pProjection->getHeight();
+		f.m_bTranspose = false;
+		CWorkerPool::getSingleton().parallelFor(0, _pVolume->getDepth(), f, SLICE_BATCH);
+		return true;
+	}
+
+	if (!_allocateBricked())
+		return false;
+	return m_pBricked->copyFrom(_pVolume) && forwardProjectBricked(m_pBricked, m_pVolGeom, _pProjection);
+}
+
+//----------------------------------------------------------------------------------------
+bool CCpuProjection3D::backProject(const CFloat32ProjectionData3DMemory* _pProjection,
+                                   CFloat32VolumeData3DMemory* _pVolume)
+{
+	if (!_checkData(_pVolume, _pProjection))
+		return false;
+
+	if (m_pFootprintProjector)
+		return m_pFootprintProjector->backProject(_pProjection, _pVolume);
+
+	if (m_pSliceMatrix) {
+		SSliceProjectionFunctor f;
+		f.m_pMatrix = m_pSliceMatrix;
+		f.m_pfIn = _pProjection->getDataConst();
+		f.m_pfOut = _pVolume->getData();
+		f.m_iVolumeSlice = (size_t)_pVolume->getWidth() * _pVolume->getHeight();
+		f.m_iProjectionSlice = (size_t)_pProjection->getWidth() * _pProjection->getHeight();
+		f.m_bTranspose = true;
+		CWorkerPool::getSingleton().parallelFor(0, _pVolume->getDepth(), f, SLICE_BATCH);
+		return true;
+	}
+
+	return _backProjectRays(_pProjection, _pVolume);
+}
+
+} // end namespace astra
@@ -200,6 +200,10 @@ void CCudaBackProjectionAlgorithm3D::run(int _iNrIterations)
 		ASTRA_ASSERT(pSinoMemory);
 		CFloat32VolumeData3DMemory* pReconMemory = dynamic_cast<CFloat32VolumeData3DMemory*>(m_pReconstruction);
 		ASTRA_ASSERT(pReconMemory);
+		if (!pSinoMemory->isPacked() || !pReconMemory->isPacked()) {
+			ASTRA_ERROR("CudaBackProjectionAlgorithm3D: SIRT weighting does not support data with padded rows.");
+			return;
+		}
 		astraCudaBP_SIRTWeighted(pReconMemory->getData(),
 		                         pSinoMemory->getDataConst(),
 		                         &volgeom, projgeom,
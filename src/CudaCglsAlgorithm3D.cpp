@@ -233,27 +233,27 @@ void CCudaCglsAlgorithm3D::run(int _iNrIterations)
 	CFloat32ProjectionData3DMemory* pSinoMem = dynamic_cast<CFloat32ProjectionData3DMemory*>(m_pSinogram);
 	ASTRA_ASSERT(pSinoMem);
 
-	ok = m_pCgls->setSinogram(pSinoMem->getDataConst(), m_pSinogram->getGeometry()->getDetectorColCount());
+	ok = m_pCgls->setSinogram(pSinoMem->getDataConst(), pSinoMem->getRowPitch());
 
 	ASTRA_ASSERT(ok);
 
 	if (m_bUseReconstructionMask) {
 		CFloat32VolumeData3DMemory* pRMaskMem = dynamic_cast<CFloat32VolumeData3DMemory*>(m_pReconstructionMask);
 		ASTRA_ASSERT(pRMaskMem);
-		ok &= m_pCgls->setVolumeMask(pRMaskMem->getDataConst(), volgeom.getGridColCount());
+		ok &= m_pCgls->setVolumeMask(pRMaskMem->getDataConst(), pRMaskMem->getRowPitch());
 	}
 #if 0
 	if (m_bUseSinogramMask) {
 		CFloat32ProjectionData3DMemory* pSMaskMem = dynamic_cast<CFloat32ProjectionData3DMemory*>(m_pSinogramMask);
 		ASTRA_ASSERT(pSMaskMem);
-		ok &= m_pCgls->setSinogramMask(pSMaskMem->getDataConst(), m_pSinogramMask->getGeometry()->getDetectorColCount());
+		ok &= m_pCgls->setSinogramMask(pSMaskMem->getDataConst(), pSMaskMem->getRowPitch());
 	}
 #endif
 
 	CFloat32VolumeData3DMemory* pReconMem = dynamic_cast<CFloat32VolumeData3DMemory*>(m_pReconstruction);
 	ASTRA_ASSERT(pReconMem);
 	ok &= m_pCgls->setStartReconstruction(pReconMem->getDataConst(),
-	                                      volgeom.getGridColCount());
+	                                      pReconMem->getRowPitch());
 
 	ASTRA_ASSERT(ok);
 
@@ -264,11 +264,13 @@ void CCudaCglsAlgorithm3D::run(int _iNrIterations)
 		ok &= m_pCgls->setMaxConstraint(m_fMaxValue);
 #endif
 
-	ok &= m_pCgls->iterate(_iNrIterations);
+	// iterate() clears the abort flag, so honour a pending requestAbort()
+	if (!m_bAbortRequested)
+		ok &= m_pCgls->iterate(_iNrIterations);
 	ASTRA_ASSERT(ok);
 
 	ok &= m_pCgls->getReconstruction(pReconMem->getData(),
-	                                 volgeom.getGridColCount());
+	                                 pReconMem->getRowPitch());
 	ASTRA_ASSERT(ok);
 
 
@@ -136,6 +136,8 @@ bool CCudaDartMaskAlgorithm::_check()
 	// gpuindex >= 0 
 
 
+	ASTRA_CONFIG_CHECK(m_pSegmentation && m_pMask && m_pSegmentation->isPacked() && m_pMask->isPacked(), "CudaDartMask", "Data objects with a row pitch are not supported.");
+
 	// success
 	m_bIsInitialized = true;
 	return true;
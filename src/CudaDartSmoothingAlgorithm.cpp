@@ -128,6 +128,8 @@ void CCudaDartSmoothingAlgorithm::run(int _iNrIterations)
 // Check
 bool CCudaDartSmoothingAlgorithm::_check() 
 {
+	ASTRA_CONFIG_CHECK(m_pIn && m_pOut && m_pIn->isPacked() && m_pOut->isPacked(), "CudaDartSmoothing", "Data objects with a row pitch are not supported.");
+
 	// success
 	m_bIsInitialized = true;
 	return true;
@@ -130,6 +130,8 @@ bool CCudaDartSmoothingAlgorithm3D::_check()
 	// geometry of inData must match that of outData
 
 
+	ASTRA_CONFIG_CHECK(m_pIn && m_pOut && m_pIn->isPacked() && m_pOut->isPacked(), "CudaDartSmoothing", "Data objects with a row pitch are not supported.");
+
 	// success
 	m_bIsInitialized = true;
 	return true;
@@ -169,6 +169,11 @@ bool CCudaDataOperationAlgorithm::_check()
 {
 	// s*: 1 data + 1 scalar
 
+	for (unsigned int i = 0; i < m_pData.size(); ++i) {
+		ASTRA_CONFIG_CHECK(m_pData[i] && m_pData[i]->isPacked(), "CCudaDataOperationAlgorithm", "Data objects with a row pitch are not supported.");
+	}
+	ASTRA_CONFIG_CHECK(!m_pMask || m_pMask->isPacked(), "CCudaDataOperationAlgorithm", "Mask objects with a row pitch are not supported.");
+
 	// success
 	m_bIsInitialized = true;
 	return true;
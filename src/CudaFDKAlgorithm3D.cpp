@@ -153,6 +153,10 @@ bool CCudaFDKAlgorithm3D::initialize(const Config& _cfg)
 			ASTRA_ERROR("Incorrect FilterSinogramId");
 			return false;
 		}
+		if (!pFilterData->isPacked()) {
+			ASTRA_ERROR("FilterSinogramId refers to data with padded rows");
+			return false;
+		}
 		const CProjectionGeometry3D* projgeom = m_pSinogram->getGeometry();
 		const CProjectionGeometry2D* filtgeom = pFilterData->getGeometry();
 		int iPaddedDetCount = calcNextPowerOfTwo(2 * projgeom->getDetectorColCount());
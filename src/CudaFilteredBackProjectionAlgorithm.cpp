@@ -90,7 +90,8 @@ bool CCudaFilteredBackProjectionAlgorithm::initialize(const Config& _cfg)
 		int iFilterProjectionCount = pFilterData->getGeometry()->getProjectionAngleCount();
 
 		m_pfFilter = new float[m_iFilterWidth * iFilterProjectionCount];
-		memcpy(m_pfFilter, pFilterData->getDataConst(), sizeof(float) * m_iFilterWidth * iFilterProjectionCount);
+		for (int i = 0; i < iFilterProjectionCount; ++i)
+			memcpy(m_pfFilter + i * m_iFilterWidth, pFilterData->getData2DConst()[i], sizeof(float) * m_iFilterWidth);
 	}
 	else
 	{
@@ -293,10 +293,16 @@ void CCudaReconstructionAlgorithm2D::run(int _iNrIterations)
 	// check initialized
 	ASTRA_ASSERT(m_bIsInitialized);
 
+	m_timings.reset();
+
+	CTraceScope trace("algorithm", "CUDA2D");
+	trace.addArg("iterations", _iNrIterations);
+
 	bool ok = true;
 	const CVolumeGeometry2D& volgeom = *m_pReconstruction->getGeometry();
 
 	if (!m_bAlgoInit) {
+		CPhaseTimer timer(m_timings, ALGPHASE_SETUP);
 		initCUDAAlgorithm();
 		m_bAlgoInit = true;
 	}
@@ -304,10 +310,14 @@ void CCudaReconstructionAlgorithm2D::run(int _iNrIterations)
 	float fPixelSize = volgeom.getPixelLengthX();
 	float fSinogramScale = 1.0f/(fPixelSize*fPixelSize);
 
-	ok = m_pAlgo->copyDataToGPU(m_pSinogram->getDataConst(), m_pSinogram->getGeometry()->getDetectorCount(), fSinogramScale,
-	                            m_pReconstruction->getDataConst(), volgeom.getGridColCount(),
-	                            m_bUseReconstructionMask ? m_pReconstructionMask->getDataConst() : 0, volgeom.getGridColCount(),
-	                            m_bUseSinogramMask ? m_pSinogramMask->getDataConst() : 0, m_pSinogram->getGeometry()->getDetectorCount());
+	{
+		CPhaseTimer timer(m_timings, ALGPHASE_HOSTCOPY);
+		ok = m_pAlgo->copyDataToGPU(m_pSinogram->getDataConst(), m_pSinogram->getRowPitch(), fSinogramScale,
+		                            m_pReconstruction->getDataConst(), m_pReconstruction->getRowPitch(),
+		                            m_bUseReconstructionMask ? m_pReconstructionMask->getDataConst() : 0, m_bUseReconstructionMask ? m_pReconstructionMask->getRowPitch() : 0,
+		                            m_bUseSinogramMask ? m_pSinogramMask->getDataConst() : 0, m_bUseSinogramMask ? m_pSinogramMask->getRowPitch() : 0);
+		m_timings.addBytes((double)(m_pSinogram->getSize() + m_pReconstruction->getSize()) * sizeof(float32));
+	}
 
 	ASTRA_ASSERT(ok);
 
@@ -324,11 +334,20 @@ void CCudaReconstructionAlgorithm2D::run(int _iNrIterations)
 		}
 	}
 
-	ok &= m_pAlgo->iterate(_iNrIterations);
+	{
+		CTraceScope iterTrace("algorithm", "iterate");
+		// iterate() clears the abort flag, so honour a pending requestAbort()
+		if (!m_bAbortRequested)
+			ok &= m_pAlgo->iterate(_iNrIterations);
+	}
 	ASTRA_ASSERT(ok);
 
-	ok &= m_pAlgo->getReconstruction(m_pReconstruction->getData(),
-	                                 volgeom.getGridColCount());
+	{
+		CPhaseTimer timer(m_timings, ALGPHASE_HOSTCOPY);
+		ok &= m_pAlgo->getReconstruction(m_pReconstruction->getData(),
+		                                 m_pReconstruction->getRowPitch());
+		m_timings.addBytes((double)m_pReconstruction->getSize() * sizeof(float32));
+	}
 
 	ASTRA_ASSERT(ok);
 }
@@ -121,6 +121,8 @@ void CCudaRoiSelectAlgorithm::run(int _iNrIterations)
 bool CCudaRoiSelectAlgorithm::_check() 
 {
 
+	ASTRA_CONFIG_CHECK(m_pData && m_pData->isPacked(), "CudaRoiSelect", "Data objects with a row pitch are not supported.");
+
 	// success
 	m_bIsInitialized = true;
 	return true;
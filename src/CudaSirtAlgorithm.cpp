@@ -86,6 +86,8 @@ bool CCudaSirtAlgorithm::initialize(const Config& _cfg)
 		m_pMaxMask = dynamic_cast<CFloat32VolumeData2D*>(CData2DManager::getSingleton().get(id));
 	}
 	CC.markOptionParsed("MaxMaskId");
+	ASTRA_CONFIG_CHECK(!m_pMinMask || m_pMinMask->isPacked(), "CudaSirt", "MinMask has padded rows.");
+	ASTRA_CONFIG_CHECK(!m_pMaxMask || m_pMaxMask->isPacked(), "CudaSirt", "MaxMask has padded rows.");
 
 	m_fLambda = _cfg.self.getOptionNumerical("Relaxation", 1.0f);
 	CC.markOptionParsed("Relaxation");
@@ -238,25 +238,25 @@ void CCudaSirtAlgorithm3D::run(int _iNrIterations)
 	CFloat32ProjectionData3DMemory* pSinoMem = dynamic_cast<CFloat32ProjectionData3DMemory*>(m_pSinogram);
 	ASTRA_ASSERT(pSinoMem);
 
-	ok = m_pSirt->setSinogram(pSinoMem->getDataConst(), m_pSinogram->getGeometry()->getDetectorColCount());
+	ok = m_pSirt->setSinogram(pSinoMem->getDataConst(), pSinoMem->getRowPitch());
 
 	ASTRA_ASSERT(ok);
 
 	if (m_bUseReconstructionMask) {
 		CFloat32VolumeData3DMemory* pRMaskMem = dynamic_cast<CFloat32VolumeData3DMemory*>(m_pReconstructionMask);
 		ASTRA_ASSERT(pRMaskMem);
-		ok &= m_pSirt->setVolumeMask(pRMaskMem->getDataConst(), volgeom.getGridColCount());
+		ok &= m_pSirt->setVolumeMask(pRMaskMem->getDataConst(), pRMaskMem->getRowPitch());
 	}
 	if (m_bUseSinogramMask) {
 		CFloat32ProjectionData3DMemory* pSMaskMem = dynamic_cast<CFloat32ProjectionData3DMemory*>(m_pSinogramMask);
 		ASTRA_ASSERT(pSMaskMem);
-		ok &= m_pSirt->setSinogramMask(pSMaskMem->getDataConst(), m_pSinogramMask->getGeometry()->getDetectorColCount());
+		ok &= m_pSirt->setSinogramMask(pSMaskMem->getDataConst(), pSMaskMem->getRowPitch());
 	}
 
 	CFloat32VolumeData3DMemory* pReconMem = dynamic_cast<CFloat32VolumeData3DMemory*>(m_pReconstruction);
 	ASTRA_ASSERT(pReconMem);
 	ok &= m_pSirt->setStartReconstruction(pReconMem->getDataConst(),
-	                                      volgeom.getGridColCount());
+	                                      pReconMem->getRowPitch());
 
 	ASTRA_ASSERT(ok);
 
@@ -265,11 +265,13 @@ void CCudaSirtAlgorithm3D::run(int _iNrIterations)
 	if (m_bUseMaxConstraint)
 		ok &= m_pSirt->setMaxConstraint(m_fMaxValue);
 
-	ok &= m_pSirt->iterate(_iNrIterations);
+	// iterate() clears the abort flag, so honour a pending requestAbort()
+	if (!m_bAbortRequested)
+		ok &= m_pSirt->iterate(_iNrIterations);
 	ASTRA_ASSERT(ok);
 
 	ok &= m_pSirt->getReconstruction(pReconMem->getData(),
-	                                 volgeom.getGridColCount());
+	                                 pReconMem->getRowPitch());
 	ASTRA_ASSERT(ok);
 
 
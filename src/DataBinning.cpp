@@ -0,0 +1,412 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#include "astra/DataBinning.h"
+
+#include <vector>
+
+#include "astra/ParallelProjectionGeometry2D.h"
+#include "astra/ParallelVecProjectionGeometry2D.h"
+#include "astra/FanFlatProjectionGeometry2D.h"
+#include "astra/FanFlatVecProjectionGeometry2D.h"
+#include "astra/ParallelProjectionGeometry3D.h"
+#include "astra/ParallelVecProjectionGeometry3D.h"
+#include "astra/ConeProjectionGeometry3D.h"
+#include "astra/ConeVecProjectionGeometry3D.h"
+#include "astra/VolumeGeometry2D.h"
+#include "astra/VolumeGeometry3D.h"
+#include "astra/Float32ProjectionData2D.h"
+#include "astra/Float32VolumeData2D.h"
+#include "astra/Float32ProjectionData3DMemory.h"
+#include "astra/Float32VolumeData3DMemory.h"
+#include "astra/ScratchArena.h"
+#include "astra/WorkerPool.h"
+#include "astra/Logging.h"
+
+namespace astra {
+
+//----------------------------------------------------------------------------------------
+static bool checkFactor(int _iSize, int _iFactor)
+{
+	return _iFactor >= 1 && _iSize % _iFactor == 0;
+}
+
+//----------------------------------------------------------------------------------------
+// Mean angle of each group of _iFactor angles.
+static std::vector<float32> binAngles(const float32* _pfAngles, int _iCount, int _iFactor)
+{
+	std::vector<float32> angles(_iCount / _iFactor);
+	for (size_t i = 0; i < angles.size(); ++i) {
+		double fSum = 0.0;
+		for (int k = 0; k < _iFactor; ++k)
+			fSum += _pfAngles[i * _iFactor + k];
+		angles[i] = (float32)(fSum / _iFactor);
+	}
+	return angles;
+}
+
+//----------------------------------------------------------------------------------------
+// Mean of each group of _iFactor projection vectors. The vector structs
+// are plain arrays of coordinates of type S.
+template <typename T, typename S>
+static std::vector<T> binVectors(const T* _pVectors, int _iCount, int _iFactor)
+{
+	const int iCoords = sizeof(T) / sizeof(S);
+	std::vector<T> vectors(_iCount / _iFactor);
+	for (size_t i = 0; i < vectors.size(); ++i) {
+		S* pOut = reinterpret_cast<S*>(&vectors[i]);
+		for (int c = 0; c < iCoords; ++c) {
+			double fSum = 0.0;
+			for (int k = 0; k < _iFactor; ++k)
+				fSum += reinterpret_cast<const S*>(&_pVectors[i * _iFactor + k])[c];
+			pOut[c] = (S)(fSum / _iFactor);
+		}
+	}
+	return vectors;
+}
+
+//----------------------------------------------------------------------------------------
+CProjectionGeometry2D* binProjectionGeometry2D(const CProjectionGeometry2D* _pGeometry,
+                                               int _iAngleFactor, int _iDetectorFactor)
+{
+	int iAngles = _pGeometry->getProjectionAngleCount();
+	int iDets = _pGeometry->getDetectorCount();
+	if (!checkFactor(iAngles, _iAngleFactor) || !checkFactor(iDets, _iDetectorFactor))
+		return 0;
+	int iBinnedAngles = iAngles / _iAngleFactor;
+	int iBinnedDets = iDets / _iDetectorFactor;
+
+	if (dynamic_cast<const CParallelProjectionGeometry2D*>(_pGeometry)) {
+		std::vector<float32> angles = binAngles(_pGeometry->getProjectionAngles(), iAngles, _iAngleFactor);
+		return new CParallelProjectionGeometry2D(iBinnedAngles, iBinnedDets,
+		                                         _pGeometry->getDetectorWidth() * _iDetectorFactor, &angles[0]);
+	}
+
+	const CFanFlatProjectionGeometry2D* pFan = dynamic_cast<const CFanFlatProjectionGeometry2D*>(_pGeometry);
+	if (pFan) {
+		std::vector<float32> angles = binAngles(_pGeometry->getProjectionAngles(), iAngles, _iAngleFactor);
+		return new CFanFlatProjectionGeometry2D(iBinnedAngles, iBinnedDets,
+		                                        _pGeometry->getDetectorWidth() * _iDetectorFactor, &angles[0],
+		                                        pFan->getOriginSourceDistance(), pFan->getOriginDetectorDistance());
+	}
+
+	const CParallelVecProjectionGeometry2D* pParVec = dynamic_cast<const CParallelVecProjectionGeometry2D*>(_pGeometry);
+	if (pParVec) {
+		std::vector<SParProjection> vectors = binVectors<SParProjection, float>(pParVec->getProjectionVectors(), iAngles, _iAngleFactor);
+		for (size_t i = 0; i < vectors.size(); ++i) {
+			vectors[i].fDetUX *= _iDetectorFactor;
+			vectors[i].fDetUY *= _iDetectorFactor;
+		}
+		return new CParallelVecProjectionGeometry2D(iBinnedAngles, iBinnedDets, &vectors[0]);
+	}
+
+	const CFanFlatVecProjectionGeometry2D* pFanVec = dynamic_cast<const CFanFlatVecProjectionGeometry2D*>(_pGeometry);
+	if (pFanVec) {
+		std::vector<SFanProjection> vectors = binVectors<SFanProjection, float>(pFanVec->getProjectionVectors(), iAngles, _iAngleFactor);
+		for (size_t i = 0; i < vectors.size(); ++i) {
+			vectors[i].fDetUX *= _iDetectorFactor;
+			vectors[i].fDetUY *= _iDetectorFactor;
+		}
+		return new CFanFlatVecProjectionGeometry2D(iBinnedAngles, iBinnedDets, &vectors[0]);
+	}
+
+	return 0;
+}
+
+//----------------------------------------------------------------------------------------
+CVolumeGeometry2D* binVolumeGeometry2D(const CVolumeGeometry2D* _pGeometry,
+                                       int _iFactorX, int _iFactorY)
+{
+	if (!checkFactor(_pGeometry->getGridColCount(), _iFactorX) || !checkFactor(_pGeometry->getGridRowCount(), _iFactorY))
+		return 0;
+	return new CVolumeGeometry2D(_pGeometry->getGridColCount() / _iFactorX, _pGeometry->getGridRowCount() / _iFactorY,
+	                             _pGeometry->getWindowMinX(), _pGeometry->getWindowMinY(),
+	                             _pGeometry->getWindowMaxX(), _pGeometry->getWindowMaxY());
+}
+
+//----------------------------------------------------------------------------------------
+CProjectionGeometry3D* binProjectionGeometry3D(const CProjectionGeometry3D* _pGeometry,
+                                               int _iDetectorColFactor, int _iAngleFactor,
+                                               int _iDetectorRowFactor)
+{
+	int iAngles = _pGeometry->getProjectionCount();
+	int iRows = _pGeometry->getDetectorRowCount();
+	int iCols = _pGeometry->getDetectorColCount();
+	if (!checkFactor(iAngles, _iAngleFactor) || !checkFactor(iRows, _iDetectorRowFactor)
+	    || !checkFactor(iCols, _iDetectorColFactor))
+		return 0;
+	int iBinnedAngles = iAngles / _iAngleFactor;
+	int iBinnedRows = iRows / _iDetectorRowFactor;
+	int iBinnedCols = iCols / _iDetectorColFactor;
+
+	if (dynamic_cast<const CParallelProjectionGeometry3D*>(_pGeometry)) {
+		std::vector<float32> angles = binAngles(_pGeometry->getProjectionAngles(), iAngles, _iAngleFactor);
+		return new CParallelProjectionGeometry3D(iBinnedAngles, iBinnedRows, iBinnedCols,
+		                                         _pGeometry->getDetectorSpacingX() * _iDetectorColFactor,
+		                                         _pGeometry->getDetectorSpacingY() * _iDetectorRowFactor,
+		                                         &angles[0]);
+	}
+
+	const CConeProjectionGeometry3D* pCone = dynamic_cast<const CConeProjectionGeometry3D*>(_pGeometry);
+	if (pCone) {
+		std::vector<float32> angles = binAngles(_pGeometry->getProjectionAngles(), iAngles, _iAngleFactor);
+		return new CConeProjectionGeometry3D(iBinnedAngles, iBinnedRows, iBinnedCols,
+		                                     _pGeometry->getDetectorSpacingX() * _iDetectorColFactor,
+		                                     _pGeometry->getDetectorSpacingY() * _iDetectorRowFactor,
+		                                     &angles[0],
+		                                     pCone->getOriginSourceDistance(), pCone->getOriginDetectorDistance());
+	}
+
+	const CParallelVecProjectionGeometry3D* pParVec = dynamic_cast<const CParallelVecProjectionGeometry3D*>(_pGeometry);
+	if (pParVec) {
+		std::vector<SPar3DProjection> vectors = binVectors<SPar3DProjection, double>(pParVec->getProjectionVectors(), iAngles, _iAngleFactor);
+		for (size_t i = 0; i < vectors.size(); ++i) {
+			SPar3DProjection& v = vectors[i];
+			v.fDetUX *= _iDetectorColFactor; v.fDetUY *= _iDetectorColFactor; v.fDetUZ *= _iDetectorColFactor;
+			v.fDetVX *= _iDetectorRowFactor; v.fDetVY *= _iDetectorRowFactor; v.fDetVZ *= _iDetectorRowFactor;
+		}
+		return new CParallelVecProjectionGeometry3D(iBinnedAngles, iBinnedRows, iBinnedCols, &vectors[0]);
+	}
+
+	const CConeVecProjectionGeometry3D* pConeVec = dynamic_cast<const CConeVecProjectionGeometry3D*>(_pGeometry);
+	if (pConeVec) {
+		std::vector<SConeProjection> vectors = binVectors<SConeProjection, double>(pConeVec->getProjectionVectors(), iAngles, _iAngleFactor);
+		for (size_t i = 0; i < vectors.size(); ++i) {
+			SConeProjection& v = vectors[i];
+			v.fDetUX *= _iDetectorColFactor; v.fDetUY *= _iDetectorColFactor; v.fDetUZ *= _iDetectorColFactor;
+			v.fDetVX *= _iDetectorRowFactor; v.fDetVY *= _iDetectorRowFactor; v.fDetVZ *= _iDetectorRowFactor;
+		}
+		return new CConeVecProjectionGeometry3D(iBinnedAngles, iBinnedRows, iBinnedCols, &vectors[0]);
+	}
+
+	return 0;
+}
+
+//----------------------------------------------------------------------------------------
+CVolumeGeometry3D* binVolumeGeometry3D(const CVolumeGeometry3D* _pGeometry,
+                                       int _iFactorX, int _iFactorY, int _iFactorZ)
+{
+	if (!checkFactor(_pGeometry->getGridColCount(), _iFactorX) || !checkFactor(_pGeometry->getGridRowCount(), _iFactorY)
+	    || !checkFactor(_pGeometry->getGridSliceCount(), _iFactorZ))
+		return 0;
+	return new CVolumeGeometry3D(_pGeometry->getGridColCount() / _iFactorX, _pGeometry->getGridRowCount() / _iFactorY,
+	                             _pGeometry->getGridSliceCount() / _iFactorZ,
+	                             _pGeometry->getWindowMinX(), _pGeometry->getWindowMinY(), _pGeometry->getWindowMinZ(),
+	                             _pGeometry->getWindowMaxX(), _pGeometry->getWindowMaxY(), _pGeometry->getWindowMaxZ());
+}
+
+//----------------------------------------------------------------------------------------
+// Bin a range of output rows. An output row is the sum of _iFactorY * _iFactorZ
+// input rows, which is accumulated first, and then summed in groups of _iFactorX.
+struct SBinRowsFunctor {
+	const float32* m_pfIn;
+	float32* m_pfOut;
+	int m_iWidth, m_iHeight;
+	int m_iInPitch, m_iOutPitch;
+	int m_iFactorX, m_iFactorY, m_iFactorZ;
+	float32 m_fScale;
+	volatile bool* m_pbFailed;
+
+	void operator()(int _iFrom, int _iTo) const {
+		const int iOutWidth = m_iWidth / m_iFactorX;
+		const int iOutHeight = m_iHeight / m_iFactorY;
+		CScratchBuffer<float32> acc(m_iWidth);
+		if (!acc) {
+			*m_pbFailed = true;
+			return;
+		}
+
+		for (int iLine = _iFrom; iLine < _iTo; ++iLine) {
+			const int z = iLine / iOutHeight;
+			const int y = iLine % iOutHeight;
+			float32* pfAcc = acc;
+			for (int x = 0; x < m_iWidth; ++x)
+				pfAcc[x] = 0.0f;
+			for (int dz = 0; dz < m_iFactorZ; ++dz) {
+				for (int dy = 0; dy < m_iFactorY; ++dy) {
+					const float32* pfRow = m_pfIn + ((size_t)(z * m_iFactorZ + dz) * m_iHeight + y * m_iFactorY + dy) * m_iInPitch;
+					for (int x = 0; x < m_iWidth; ++x)
+						pfAcc[x] += pfRow[x];
+				}
+			}
+
+			float32* pfOut = m_pfOut + (size_t)iLine * m_iOutPitch;
+			if (m_iFactorX == 1) {
+				for (int x = 0; x < iOutWidth; ++x)
+					pfOut[x] = m_fScale * pfAcc[x];
+			} else {
+				for (int x = 0; x < iOutWidth; ++x) {
+					float32 fSum = 0.0f;
+					for (int k = 0; k < m_iFactorX; ++k)
+						fSum += pfAcc[x * m_iFactorX + k];
+					pfOut[x] = m_fScale * fSum;
+				}
+			}
+		}
+	}
+};
+
+//----------------------------------------------------------------------------------------
+bool binArray3D(const float32* _pfIn, int _iWidth, int _iHeight, int _iDepth,
+                int _iFactorX, int _iFactorY, int _iFactorZ,
+                float32 _fScale, float32* _pfOut, int _iInPitch, int _iOutPitch)
+{
+	ASTRA_ASSERT(_iWidth % _iFactorX == 0 && _iHeight % _iFactorY == 0 && _iDepth % _iFactorZ == 0);
+
+	SBinRowsFunctor f;
+	f.m_pfIn = _pfIn;
+	f.m_pfOut = _pfOut;
+	f.m_iWidth = _iWidth;
+	f.m_iHeight = _iHeight;
+	f.m_iInPitch = _iInPitch ? _iInPitch : _iWidth;
+	f.m_iOutPitch = _iOutPitch ? _iOutPitch : _iWidth / _iFactorX;
+	f.m_iFactorX = _iFactorX;
+	f.m_iFactorY = _iFactorY;
+	f.m_iFactorZ = _iFactorZ;
+	f.m_fScale = _fScale;
+	volatile bool bFailed = false;
+	f.m_pbFailed = &bFailed;
+
+	// rows of at least a few thousand values per task
+	int iLines = (_iHeight / _iFactorY) * (_iDepth / _iFactorZ);
+	int iGrain = 1 + 4096 / (_iWidth * _iFactorY * _iFactorZ);
+	CWorkerPool::getSingleton().parallelFor(0, iLines, f, iGrain);
+
+	if (bFailed) {
+		ASTRA_ERROR("binArray3D: unable to allocate the row buffers");
+		return false;
+	}
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+CFloat32ProjectionData2D* binProjectionData2D(const CFloat32ProjectionData2D* _pData,
+                                              int _iAngleFactor, int _iDetectorFactor)
+{
+	CProjectionGeometry2D* pGeometry = binProjectionGeometry2D(_pData->getGeometry(), _iAngleFactor, _iDetectorFactor);
+	if (!pGeometry) {
+		ASTRA_ERROR("binProjectionData2D: unsupported geometry or factors");
+		return 0;
+	}
+	CFloat32ProjectionData2D* pBinned = new CFloat32ProjectionData2D(pGeometry);
+	delete pGeometry;
+	if (!pBinned->isInitialized()) {
+		delete pBinned;
+		return 0;
+	}
+
+	if (!binArray3D(_pData->getDataConst(), _pData->getDetectorCount(), _pData->getAngleCount(), 1,
+	                _iDetectorFactor, _iAngleFactor, 1, 1.0f / _iAngleFactor, pBinned->getData(),
+	                _pData->getRowPitch(), pBinned->getRowPitch())) {
+		delete pBinned;
+		return 0;
+	}
+	pBinned->updateStatistics();
+	return pBinned;
+}
+
+//----------------------------------------------------------------------------------------
+CFloat32VolumeData2D* binVolumeData2D(const CFloat32VolumeData2D* _pData,
+                                      int _iFactorX, int _iFactorY)
+{
+	CVolumeGeometry2D* pGeometry = binVolumeGeometry2D(_pData->getGeometry(), _iFactorX, _iFactorY);
+	if (!pGeometry) {
+		ASTRA_ERROR("binVolumeData2D: unsupported factors");
+		return 0;
+	}
+	CFloat32VolumeData2D* pBinned = new CFloat32VolumeData2D(pGeometry);
+	delete pGeometry;
+	if (!pBinned->isInitialized()) {
+		delete pBinned;
+		return 0;
+	}
+
+	if (!binArray3D(_pData->getDataConst(), _pData->getWidth(), _pData->getHeight(), 1,
+	                _iFactorX, _iFactorY, 1, 1.0f / (_iFactorX * _iFactorY), pBinned->getData(),
+	                _pData->getRowPitch(), pBinned->getRowPitch())) {
+		delete pBinned;
+		return 0;
+	}
+	pBinned->updateStatistics();
+	return pBinned;
+}
+
+//----------------------------------------------------------------------------------------
+CFloat32ProjectionData3DMemory* binProjectionData3D(const CFloat32ProjectionData3DMemory* _pData,
+                                                    int _iDetectorColFactor, int _iAngleFactor,
+                                                    int _iDetectorRowFactor)
+{
+	CProjectionGeometry3D* pGeometry = binProjectionGeometry3D(_pData->getGeometry(), _iDetectorColFactor,
+	                                                           _iAngleFactor, _iDetectorRowFactor);
+	if (!pGeometry) {
+		ASTRA_ERROR("binProjectionData3D: unsupported geometry or factors");
+		return 0;
+	}
+	CFloat32ProjectionData3DMemory* pBinned = new CFloat32ProjectionData3DMemory(pGeometry);
+	delete pGeometry;
+	if (!pBinned->isInitialized()) {
+		delete pBinned;
+		return 0;
+	}
+
+	// stored as detector rows of angles of detector columns
+	if (!binArray3D(_pData->getDataConst(), _pData->getDetectorColCount(), _pData->getAngleCount(), _pData->getDetectorRowCount(),
+	                _iDetectorColFactor, _iAngleFactor, _iDetectorRowFactor,
+	                1.0f / (_iDetectorColFactor * _iAngleFactor * _iDetectorRowFactor), pBinned->getData(),
+	                _pData->getRowPitch(), pBinned->getRowPitch())) {
+		delete pBinned;
+		return 0;
+	}
+	return pBinned;
+}
+
+//----------------------------------------------------------------------------------------
+CFloat32VolumeData3DMemory* binVolumeData3D(const CFloat32VolumeData3DMemory* _pData,
+                                            int _iFactorX, int _iFactorY, int _iFactorZ)
+{
+	CVolumeGeometry3D* pGeometry = binVolumeGeometry3D(_pData->getGeometry(), _iFactorX, _iFactorY, _iFactorZ);
+	if (!pGeometry) {
+		ASTRA_ERROR("binVolumeData3D: unsupported factors");
+		return 0;
+	}
+	CFloat32VolumeData3DMemory* pBinned = new CFloat32VolumeData3DMemory(pGeometry);
+	delete pGeometry;
+	if (!pBinned->isInitialized()) {
+		delete pBinned;
+		return 0;
+	}
+
+	if (!binArray3D(_pData->getDataConst(), _pData->getColCount(), _pData->getRowCount(), _pData->getSliceCount(),
+	                _iFactorX, _iFactorY, _iFactorZ, 1.0f / (_iFactorX * _iFactorY * _iFactorZ), pBinned->getData(),
+	                _pData->getRowPitch(), pBinned->getRowPitch())) {
+		delete pBinned;
+		return 0;
+	}
+	return pBinned;
+}
+
+}
@@ -0,0 +1,481 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#include "astra/FanParallelRebinAlgorithm.h"
+
+#include <math.h>
+#include <algorithm>
+
+#include "astra/AstraObjectManager.h"
+#include "astra/Float32ProjectionData2D.h"
+#include "astra/ParallelProjectionGeometry2D.h"
+#include "astra/ParallelVecProjectionGeometry2D.h"
+#include "astra/FanFlatProjectionGeometry2D.h"
+#include "astra/FanFlatVecProjectionGeometry2D.h"
+#include "astra/WorkerPool.h"
+#include "astra/Logging.h"
+
+using namespace std;
+
+namespace astra {
+
+// type of the algorithm, needed to register with CAlgorithmFactory
+std::string CFanParallelRebinAlgorithm::type = "FanParallelRebin";
+
+static const double REBIN_PI = 3.14159265358979323846;
+
+//----------------------------------------------------------------------------------------
+// Source positions of a fan geometry, in vector form. Sets _pOwned if
+// the vectors had to be created.
+static const SFanProjection* getFanProjections(CProjectionGeometry2D* _pGeometry,
+                                               CFanFlatVecProjectionGeometry2D*& _pOwned)
+{
+	_pOwned = 0;
+	CFanFlatVecProjectionGeometry2D* pVec = dynamic_cast<CFanFlatVecProjectionGeometry2D*>(_pGeometry);
+	if (pVec)
+		return pVec->getProjectionVectors();
+	CFanFlatProjectionGeometry2D* pFan = dynamic_cast<CFanFlatProjectionGeometry2D*>(_pGeometry);
+	if (!pFan)
+		return 0;
+	_pOwned = pFan->toVectorGeometry();
+	return _pOwned->getProjectionVectors();
+}
+
+//----------------------------------------------------------------------------------------
+// Source angles relative to the first one, in the direction of rotation.
+// Returns false if the sources are not on a circle around the origin,
+// or not ordered by angle.
+static bool getSourceAngles(const SFanProjection* _pProjs, int _iAngleCount,
+                            std::vector<double>& _fPos, double& _fBeta0,
+                            double& _fDirection, double& _fRadius)
+{
+	if (_iAngleCount < 2)
+		return false;
+
+	std::vector<double> fBeta(_iAngleCount);
+	_fRadius = 0.0;
+	for (int i = 0; i < _iAngleCount; ++i) {
+		double b = atan2(_pProjs[i].fSrcX, -_pProjs[i].fSrcY);
+		if (i > 0) {
+			while (b - fBeta[i-1] > REBIN_PI)
+				b -= 2.0 * REBIN_PI;
+			while (b - fBeta[i-1] < -REBIN_PI)
+				b += 2.0 * REBIN_PI;
+		}
+		fBeta[i] = b;
+		_fRadius += sqrt((double)_pProjs[i].fSrcX * _pProjs[i].fSrcX + (double)_pProjs[i].fSrcY * _pProjs[i].fSrcY);
+	}
+	_fRadius /= _iAngleCount;
+
+	_fBeta0 = fBeta[0];
+	_fDirection = (fBeta[_iAngleCount-1] >= fBeta[0]) ? 1.0 : -1.0;
+	_fPos.resize(_iAngleCount);
+	for (int i = 0; i < _iAngleCount; ++i) {
+		double r = sqrt((double)_pProjs[i].fSrcX * _pProjs[i].fSrcX + (double)_pProjs[i].fSrcY * _pProjs[i].fSrcY);
+		if (fabs(r - _fRadius) > 1e-3 * _fRadius)
+			return false;
+		_fPos[i] = _fDirection * (fBeta[i] - _fBeta0);
+		if (i > 0 && _fPos[i] <= _fPos[i-1])
+			return false;
+	}
+	return _fPos[_iAngleCount-1] < 2.0 * REBIN_PI;
+}
+
+//----------------------------------------------------------------------------------------
+// Constructor
+CFanParallelRebinAlgorithm::CFanParallelRebinAlgorithm()
+{
+	_clear();
+}
+
+//----------------------------------------------------------------------------------------
+// Destructor
+CFanParallelRebinAlgorithm::~CFanParallelRebinAlgorithm()
+{
+
+}
+
+//---------------------------------------------------------------------------------------
+// Clear - Constructors
+void CFanParallelRebinAlgorithm::_clear()
+{
+	m_pFanSinogram = NULL;
+	m_pParallelSinogram = NULL;
+	m_table.clear();
+	m_bIsInitialized = false;
+}
+
+//---------------------------------------------------------------------------------------
+// Initialize - Config
+bool CFanParallelRebinAlgorithm::initialize(const Config& _cfg)
+{
+	ASTRA_ASSERT(_cfg.self);
+	ConfigStackCheck<CAlgorithm> CC("FanParallelRebinAlgorithm", this, _cfg);
+
+	// fan beam sinogram
+	XMLNode node = _cfg.self.getSingleNode("ProjectionDataId");
+	ASTRA_CONFIG_CHECK(node, "FanParallelRebin", "No ProjectionDataId tag specified.");
+	int id = node.getContentInt();
+	m_pFanSinogram = dynamic_cast<CFloat32ProjectionData2D*>(CData2DManager::getSingleton().get(id));
+	CC.markNodeParsed("ProjectionDataId");
+
+	// parallel beam sinogram
+	node = _cfg.self.getSingleNode("ParallelProjectionDataId");
+	ASTRA_CONFIG_CHECK(node, "FanParallelRebin", "No ParallelProjectionDataId tag specified.");
+	id = node.getContentInt();
+	m_pParallelSinogram = dynamic_cast<CFloat32ProjectionData2D*>(CData2DManager::getSingleton().get(id));
+	CC.markNodeParsed("ParallelProjectionDataId");
+
+	m_bIsInitialized = _check();
+	return m_bIsInitialized;
+}
+
+//---------------------------------------------------------------------------------------
+// Initialize - C++
+bool CFanParallelRebinAlgorithm::initialize(CFloat32ProjectionData2D* _pFanSinogram,
+                                            CFloat32ProjectionData2D* _pParallelSinogram)
+{
+	m_pFanSinogram = _pFanSinogram;
+	m_pParallelSinogram = _pParallelSinogram;
+
+	m_bIsInitialized = _check();
+	return m_bIsInitialized;
+}
+
+//----------------------------------------------------------------------------------------
+// Build the interpolation table entries of a range of parallel angles.
+struct SRebinTableFunctor {
+	CFanParallelRebinAlgorithm::SRebinEntry* m_pTable;
+	const SParProjection* m_pPar;
+	const SFanProjection* m_pFan;
+	const double* m_pfPos;
+	int m_iFanAngles;
+	int m_iFanDets;
+	int m_iParDets;
+	double m_fBeta0;
+	double m_fDirection;
+	double m_fRadius;
+	bool m_bFullScan;
+
+	// Find the fan sample of the ray from source _iProj at fan angle
+	// rotated by _fRotation from direction (_fDX, _fDY), and add it to
+	// the entry with weight _fWeight.
+	bool addSamples(CFanParallelRebinAlgorithm::SRebinEntry& _e, int _iSlot, int _iProj,
+	                double _fDX, double _fDY, double _fRotation, double _fWeight) const
+	{
+		const SFanProjection& p = m_pFan[_iProj];
+		double c = cos(_fRotation), s = sin(_fRotation);
+		double fDX = c * _fDX - s * _fDY;
+		double fDY = s * _fDX + c * _fDY;
+
+		// DetS + u DetU = Src + lambda d
+		double fCross = p.fDetUX * fDY - p.fDetUY * fDX;
+		if (fabs(fCross) < 1e-12)
+			return false;
+		double fSX = p.fSrcX - p.fDetSX, fSY = p.fSrcY - p.fDetSY;
+		double fU = (fSX * fDY - fSY * fDX) / fCross;
+		double fLambda = (fSX * p.fDetUY - fSY * p.fDetUX) / fCross;
+		if (fLambda <= 0.0)
+			return false;
+
+		// the fan sample includes the fan detector pixel size
+		_fWeight /= sqrt((double)p.fDetUX * p.fDetUX + (double)p.fDetUY * p.fDetUY);
+
+		double f = fU - 0.5;
+		int j = (int)floor(f);
+		double t = f - j;
+		if (j < -1 || j >= m_iFanDets)
+			return false;
+		if (j >= 0) {
+			_e.iOffset[_iSlot] = _iProj * m_iFanDets + j;
+			_e.fWeight[_iSlot] = (float32)(_fWeight * (1.0 - t));
+		}
+		if (j + 1 < m_iFanDets) {
+			_e.iOffset[_iSlot+1] = _iProj * m_iFanDets + j + 1;
+			_e.fWeight[_iSlot+1] = (float32)(_fWeight * t);
+		}
+		return true;
+	}
+
+	// Fill the entry for the ray along unit vector (_fDX, _fDY) from the
+	// point (_fSX, _fSY) on the source circle.
+	bool fillEntry(CFanParallelRebinAlgorithm::SRebinEntry& _e, double _fSX, double _fSY,
+	               double _fDX, double _fDY) const
+	{
+		double fBeta = atan2(_fSX, -_fSY);
+		double fPos = fmod(m_fDirection * (fBeta - m_fBeta0), 2.0 * REBIN_PI);
+		if (fPos < 0.0)
+			fPos += 2.0 * REBIN_PI;
+
+		// neighbouring projections i0 and i1 at positions fPos0 and fPos1
+		int i0 = (int)(std::upper_bound(m_pfPos, m_pfPos + m_iFanAngles, fPos) - m_pfPos) - 1;
+		int i1 = i0 + 1;
+		double fPos0 = m_pfPos[i0];
+		double fPos1;
+		if (i1 < m_iFanAngles) {
+			fPos1 = m_pfPos[i1];
+		} else if (m_bFullScan) {
+			i1 = 0;
+			fPos1 = 2.0 * REBIN_PI;
+		} else {
+			return false;
+		}
+		double t = (fPos - fPos0) / (fPos1 - fPos0);
+
+		for (int k = 0; k < 4; ++k) {
+			_e.iOffset[k] = 0;
+			_e.fWeight[k] = 0.0f;
+		}
+		// the rays of the neighbours keep the same fan angle
+		bool bOk = addSamples(_e, 0, i0, _fDX, _fDY, m_fDirection * (fPos0 - fPos), 1.0 - t);
+		bOk = addSamples(_e, 2, i1, _fDX, _fDY, m_fDirection * (fPos1 - fPos), t) && bOk;
+		return bOk;
+	}
+
+	void operator()(int _iFrom, int _iTo) const {
+		for (int iAngle = _iFrom; iAngle < _iTo; ++iAngle) {
+			const SParProjection& p = m_pPar[iAngle];
+			double fLength = sqrt((double)p.fRayX * p.fRayX + (double)p.fRayY * p.fRayY);
+			double fDX = p.fRayX / fLength, fDY = p.fRayY / fLength;
+			float32 fDetSize = (float32)sqrt((double)p.fDetUX * p.fDetUX + (double)p.fDetUY * p.fDetUY);
+			for (int iDet = 0; iDet < m_iParDets; ++iDet) {
+				CFanParallelRebinAlgorithm::SRebinEntry& e = m_pTable[(size_t)iAngle * m_iParDets + iDet];
+				for (int k = 0; k < 4; ++k) {
+					e.iOffset[k] = 0;
+					e.fWeight[k] = 0.0f;
+				}
+
+				// intersections Q + s d of the line with the source circle
+				double fQX = p.fDetSX + (iDet + 0.5) * p.fDetUX;
+				double fQY = p.fDetSY + (iDet + 0.5) * p.fDetUY;
+				double b = fQX * fDX + fQY * fDY;
+				double fDisc = b * b - (fQX * fQX + fQY * fQY - m_fRadius * m_fRadius);
+				if (fDisc <= 0.0)
+					continue;
+				double s0 = -b - sqrt(fDisc), s1 = -b + sqrt(fDisc);
+
+				// the line is measured from either end
+				if (!fillEntry(e, fQX + s0 * fDX, fQY + s0 * fDY, fDX, fDY)
+				    && !fillEntry(e, fQX + s1 * fDX, fQY + s1 * fDY, -fDX, -fDY)) {
+					for (int k = 0; k < 4; ++k) {
+						e.iOffset[k] = 0;
+						e.fWeight[k] = 0.0f;
+					}
+				}
+				for (int k = 0; k < 4; ++k)
+					e.fWeight[k] *= fDetSize;
+			}
+		}
+	}
+};
+
+//----------------------------------------------------------------------------------------
+// Check
+bool CFanParallelRebinAlgorithm::_check()
+{
+	ASTRA_CONFIG_CHECK(m_pFanSinogram, "FanParallelRebin", "Invalid ProjectionDataId.");
+	ASTRA_CONFIG_CHECK(m_pFanSinogram->isInitialized(), "FanParallelRebin", "Fan beam projection data not initialized.");
+	ASTRA_CONFIG_CHECK(m_pParallelSinogram, "FanParallelRebin", "Invalid ParallelProjectionDataId.");
+	ASTRA_CONFIG_CHECK(m_pParallelSinogram->isInitialized(), "FanParallelRebin", "Parallel beam projection data not initialized.");
+	ASTRA_CONFIG_CHECK(m_pFanSinogram->isPacked() && m_pParallelSinogram->isPacked(), "FanParallelRebin", "Data objects with a row pitch are not supported.");
+
+	CFanFlatVecProjectionGeometry2D* pOwnedFan = 0;
+	const SFanProjection* pFan = getFanProjections(m_pFanSinogram->getGeometry(), pOwnedFan);
+	ASTRA_CONFIG_CHECK(pFan, "FanParallelRebin", "ProjectionDataId must have a fanflat or fanflat_vec geometry.");
+
+	// the angular step is fPos[iFanAngles-1] / (iFanAngles - 1)
+	int iFanAngles = m_pFanSinogram->getAngleCount();
+	if (iFanAngles < 2) {
+		delete pOwnedFan;
+		ASTRA_CONFIG_CHECK(false, "FanParallelRebin", "ProjectionDataId must have at least two projection angles.");
+	}
+	std::vector<double> fPos;
+	double fBeta0, fDirection, fRadius;
+	bool bCircular = getSourceAngles(pFan, iFanAngles, fPos, fBeta0, fDirection, fRadius);
+	if (!bCircular) {
+		delete pOwnedFan;
+		ASTRA_CONFIG_CHECK(false, "FanParallelRebin", "The sources must lie on a circle around the origin, ordered by angle.");
+	}
+
+	CProjectionGeometry2D* pParGeometry = m_pParallelSinogram->getGeometry();
+	CParallelVecProjectionGeometry2D* pParVec = dynamic_cast<CParallelVecProjectionGeometry2D*>(pParGeometry);
+	CParallelVecProjectionGeometry2D* pOwnedPar = 0;
+	if (!pParVec) {
+		CParallelProjectionGeometry2D* pPar = dynamic_cast<CParallelProjectionGeometry2D*>(pParGeometry);
+		if (pPar)
+			pOwnedPar = pParVec = pPar->toVectorGeometry();
+	}
+	if (!pParVec) {
+		delete pOwnedFan;
+		ASTRA_CONFIG_CHECK(false, "FanParallelRebin", "ParallelProjectionDataId must have a parallel or parallel_vec geometry.");
+	}
+
+	int iParAngles = m_pParallelSinogram->getAngleCount();
+	int iParDets = m_pParallelSinogram->getDetectorCount();
+	m_table.resize((size_t)iParAngles * iParDets);
+
+	// The scan is full if it misses at most one angular step of a full circle.
+	double fRange = fPos[iFanAngles-1];
+	bool bFullScan = (fRange + fRange / (iFanAngles - 1) >= 2.0 * REBIN_PI * (1.0 - 1e-3));
+
+	SRebinTableFunctor f;
+	f.m_pTable = &m_table[0];
+	f.m_pPar = pParVec->getProjectionVectors();
+	f.m_pFan = pFan;
+	f.m_pfPos = &fPos[0];
+	f.m_iFanAngles = iFanAngles;
+	f.m_iFanDets = m_pFanSinogram->getDetectorCount();
+	f.m_iParDets = iParDets;
+	f.m_fBeta0 = fBeta0;
+	f.m_fDirection = fDirection;
+	f.m_fRadius = fRadius;
+	f.m_bFullScan = bFullScan;
+	CWorkerPool::getSingleton().parallelFor(0, iParAngles, f);
+
+	delete pOwnedFan;
+	delete pOwnedPar;
+
+	// success
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+size_t CFanParallelRebinAlgorithm::getMemoryEstimate() const
+{
+	if (!m_bIsInitialized)
+		return 0;
+	return m_table.size() * sizeof(SRebinEntry);
+}
+
+//----------------------------------------------------------------------------------------
+// Gather the parallel rays of a range of angles.
+struct SRebinFunctor {
+	const CFanParallelRebinAlgorithm::SRebinEntry* m_pTable;
+	const float32* m_pfFan;
+	float32* m_pfParallel;
+	int m_iParDets;
+
+	void operator()(int _iFrom, int _iTo) const {
+		size_t iEnd = (size_t)_iTo * m_iParDets;
+		for (size_t i = (size_t)_iFrom * m_iParDets; i < iEnd; ++i) {
+			const CFanParallelRebinAlgorithm::SRebinEntry& e = m_pTable[i];
+			m_pfParallel[i] = e.fWeight[0] * m_pfFan[e.iOffset[0]] + e.fWeight[1] * m_pfFan[e.iOffset[1]]
+			                + e.fWeight[2] * m_pfFan[e.iOffset[2]] + e.fWeight[3] * m_pfFan[e.iOffset[3]];
+		}
+	}
+};
+
+//----------------------------------------------------------------------------------------
+// Iterate
+void CFanParallelRebinAlgorithm::run(int _iNrIterations)
+{
+	ASTRA_ASSERT(m_bIsInitialized);
+
+	resetAbort();
+	m_timings.reset();
+
+	CPhaseTimer timer(m_timings, ALGPHASE_HOSTCOPY);
+
+	SRebinFunctor f;
+	f.m_pTable = &m_table[0];
+	f.m_pfFan = m_pFanSinogram->getDataConst();
+	f.m_pfParallel = m_pParallelSinogram->getData();
+	f.m_iParDets = m_pParallelSinogram->getDetectorCount();
+	CWorkerPool::getSingleton().parallelFor(0, m_pParallelSinogram->getAngleCount(), f);
+
+	m_timings.addBytes((double)m_pParallelSinogram->getSize() * (sizeof(float32) + sizeof(SRebinEntry)));
+	m_pParallelSinogram->updateStatistics();
+}
+
+//----------------------------------------------------------------------------------------
+CParallelProjectionGeometry2D* CFanParallelRebinAlgorithm::createParallelGeometry(CProjectionGeometry2D* _pFanGeometry)
+{
+	CFanFlatVecProjectionGeometry2D* pOwnedFan = 0;
+	const SFanProjection* pFan = getFanProjections(_pFanGeometry, pOwnedFan);
+	if (!pFan)
+		return 0;
+
+	int iFanAngles = _pFanGeometry->getProjectionAngleCount();
+	if (iFanAngles < 2) {
+		delete pOwnedFan;
+		ASTRA_ERROR("FanParallelRebin: the fan geometry must have at least two projection angles");
+		return 0;
+	}
+	std::vector<double> fPos;
+	double fBeta0, fDirection, fRadius;
+	if (!getSourceAngles(pFan, iFanAngles, fPos, fBeta0, fDirection, fRadius)) {
+		delete pOwnedFan;
+		return 0;
+	}
+
+	// detector pixel size scaled from the detector to the origin
+	const SFanProjection& p = pFan[0];
+	double fDetSize = sqrt((double)p.fDetUX * p.fDetUX + (double)p.fDetUY * p.fDetUY);
+	double fNX = -p.fDetUY / fDetSize, fNY = p.fDetUX / fDetSize;
+	double fSDD = fabs((p.fDetSX - p.fSrcX) * fNX + (p.fDetSY - p.fSrcY) * fNY);
+	double fSOD = fabs(p.fSrcX * fNX + p.fSrcY * fNY);
+	delete pOwnedFan;
+
+	double fStep = fPos[iFanAngles-1] / (iFanAngles - 1);
+	int iAngles = (int)(REBIN_PI / fStep + 0.5);
+	if (iAngles < 1)
+		iAngles = 1;
+	std::vector<float32> fAngles(iAngles);
+	for (int i = 0; i < iAngles; ++i)
+		fAngles[i] = (float32)(i * REBIN_PI / iAngles);
+
+	return new CParallelProjectionGeometry2D(iAngles, _pFanGeometry->getDetectorCount(),
+	                                         (float32)(fDetSize * fSOD / fSDD), &fAngles[0]);
+}
+
+//---------------------------------------------------------------------------------------
+// Information - All
+map<string,boost::any> CFanParallelRebinAlgorithm::getInformation()
+{
+	map<string, boost::any> result;
+	result["ProjectionDataId"] = getInformation("ProjectionDataId");
+	result["ParallelProjectionDataId"] = getInformation("ParallelProjectionDataId");
+	return mergeMap<string,boost::any>(CAlgorithm::getInformation(), result);
+}
+
+//---------------------------------------------------------------------------------------
+// Information - Specific
+boost::any CFanParallelRebinAlgorithm::getInformation(std::string _sIdentifier)
+{
+	if (_sIdentifier == "ProjectionDataId") {
+		int iIndex = CData2DManager::getSingleton().getIndex(m_pFanSinogram);
+		if (iIndex != 0) return iIndex;
+		return std::string("not in manager");
+	} else if (_sIdentifier == "ParallelProjectionDataId") {
+		int iIndex = CData2DManager::getSingleton().getIndex(m_pParallelSinogram);
+		if (iIndex != 0) return iIndex;
+		return std::string("not in manager");
+	}
+	return CAlgorithm::getInformation(_sIdentifier);
+}
+
+} // namespace astra
@@ -30,6 +30,7 @@ along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
 #include <iostream>
 #include <iomanip>
 #include <math.h>
+#include <vector>
 
 #include "astra/AstraObjectManager.h"
 #include "astra/ParallelBeamLineKernelProjector2D.h"
@@ -37,6 +38,12 @@ along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
 #include "astra/DataProjector.h"
 
 #include "astra/Logging.h"
+#include "astra/ScratchArena.h"
+#include "astra/NumaPlacement.h"
+#include "astra/PixelDrivenBackProjector2D.h"
+#include "astra/WorkerPool.h"
+#include "astra/FanFlatProjectionGeometry2D.h"
+#include "astra/FanFlatVecProjectionGeometry2D.h"
 
 using namespace std;
 
@@ -44,6 +51,24 @@ namespace astra {
 
 #include "astra/Projector2DImpl.inl"
 
+//----------------------------------------------------------------------------------------
+// We'll zero-pad to the smallest power of two at least 64 and
+// at least 2*iDetectorCount
+static int zeroPaddedDetectorCount(int iDetectorCount)
+{
+	int zpDetector = 64;
+	while (zpDetector < iDetectorCount*2)
+		zpDetector *= 2;
+	return zpDetector;
+}
+
+//----------------------------------------------------------------------------------------
+static bool isFanBeam(const CProjectionGeometry2D* _pGeometry)
+{
+	return dynamic_cast<const CFanFlatProjectionGeometry2D*>(_pGeometry)
+	    || dynamic_cast<const CFanFlatVecProjectionGeometry2D*>(_pGeometry);
+}
+
 // type of the algorithm, needed to register with CAlgorithmFactory
 std::string CFilteredBackProjectionAlgorithm::type = "FBP";
 const int FFT = 1;
@@ -70,6 +95,7 @@ void CFilteredBackProjectionAlgorithm::_clear()
 	m_pProjector = NULL;
 	m_pSinogram = NULL;
 	m_pReconstruction = NULL;
+	m_fWeightsPerProjection = -1.0;
 	m_bIsInitialized = false;
 }
 
@@ -80,6 +106,7 @@ void CFilteredBackProjectionAlgorithm::clear()
 	m_pProjector = NULL;
 	m_pSinogram = NULL;
 	m_pReconstruction = NULL;
+	m_fWeightsPerProjection = -1.0;
 	m_bIsInitialized = false;
 }
 
@@ -151,6 +178,12 @@ bool CFilteredBackProjectionAlgorithm::initialize(const Config& _cfg)
 		delete[] projectionAngles;
 	}
 
+	// optional: collect timings
+	m_timings.setEnabled(_cfg.self.getOptionBool("Timings", false));
+
+	// optional: pixel-driven backprojection
+	m_bPixelDriven = _cfg.self.getOptionBool("PixelDriven", false);
+
 	// TODO: check that the angles are linearly spaced between 0 and pi
 
 	// success
@@ -219,31 +252,142 @@ bool CFilteredBackProjectionAlgorithm::_check()
 }
 
 
+//----------------------------------------------------------------------------------------
+size_t CFilteredBackProjectionAlgorithm::getMemoryEstimate() const
+{
+	if (!m_bIsInitialized)
+		return 0;
+
+	size_t iAngleCount = m_pProjector->getProjectionGeometry()->getProjectionAngleCount();
+	size_t iDetectorCount = m_pProjector->getProjectionGeometry()->getDetectorCount();
+	size_t zpDetector = zeroPaddedDetectorCount((int)iDetectorCount);
+
+	// filtered sinogram, padded complex rows, filter and FFT twiddles
+	size_t iFloats = iAngleCount * iDetectorCount + 2 * iAngleCount * zpDetector
+	                 + zpDetector + zpDetector / 2;
+	size_t iInts = 2 + (size_t)sqrt((float)zpDetector) + 1;
+	return iFloats * sizeof(float32) + iInts * sizeof(int);
+}
+
 //----------------------------------------------------------------------------------------
 // Iterate
 void CFilteredBackProjectionAlgorithm::run(int _iNrIterations)
 {
 	ASTRA_ASSERT(m_bIsInitialized);
 
+	resetAbort();
+	m_timings.reset();
+
+	CTraceScope trace("algorithm", "FBP");
+
 	// Filter sinogram
-	CFloat32ProjectionData2D filteredSinogram(m_pSinogram->getGeometry(), m_pSinogram->getData());
-	performFiltering(&filteredSinogram);
+	double fStart = m_timings.isEnabled() ? CAlgorithmTimings::getClock() : 0.0;
+	CFloat32CustomMemory* pFilteredMem = CScratchArena::getSingleton().createCustomMemory(m_pSinogram->getSize());
+	if (!pFilteredMem) {
+		ASTRA_ERROR("FBP: unable to allocate the filtered sinogram");
+		return;
+	}
+	CFloat32ProjectionData2D filteredSinogram(m_pSinogram->getGeometry(), pFilteredMem);
+	copyRows(filteredSinogram.getData(), m_pSinogram->getDataConst(), m_pSinogram->getAngleCount(),
+	         m_pSinogram->getDetectorCount(), filteredSinogram.getRowPitch(), m_pSinogram->getRowPitch());
+	if (m_timings.isEnabled()) {
+		m_timings.addTime(ALGPHASE_HOSTCOPY, CAlgorithmTimings::getClock() - fStart);
+		m_timings.addBytes(2.0 * m_pSinogram->getSize() * sizeof(float32));
+	}
+	const bool bFanBeam = isFanBeam(m_pProjector->getProjectionGeometry());
+	{
+		CPhaseTimer timer(m_timings, ALGPHASE_FILTERING);
+		if (bFanBeam && !performFanBeamWeighting(&filteredSinogram))
+			return;
+		if (!performFiltering(&filteredSinogram))
+			return;
+	}
+	if (m_bShouldAbort)
+		return;
+	// the filtering is cheap compared to the backprojection
+	const float32 fFilterProgress = 0.1f;
+	reportProgress(fFilterProgress, ALGPHASE_FILTERING);
 
 	// Back project
-	m_pReconstruction->setData(0.0f);
-	projectData(m_pProjector,
-	            DefaultBPPolicy(m_pReconstruction, &filteredSinogram));
-
-	// Scale data
-	int iAngleCount = m_pProjector->getProjectionGeometry()->getProjectionAngleCount();
-	(*m_pReconstruction) *= (PI/2)/iAngleCount;
+	{
+		CPhaseTimer timer(m_timings, ALGPHASE_BP);
+		m_pReconstruction->setData(0.0f);
+		CAlgorithmCheckpoint checkpoint(this, ALGPHASE_BP, fFilterProgress, 1.0f);
+		// fan beams need the distance weighting of the pixel-driven backprojector
+		CPixelDrivenBackProjector2D* pPixelDrivenBP = 0;
+		if (bFanBeam)
+			pPixelDrivenBP = new CPixelDrivenBackProjector2D(m_pProjector->getProjectionGeometry(), m_pProjector->getVolumeGeometry(),
+			                                                 CPixelDrivenBackProjector2D::WEIGHT_FBP);
+		else if (m_bPixelDriven)
+			pPixelDrivenBP = new CPixelDrivenBackProjector2D(m_pProjector->getProjectionGeometry(), m_pProjector->getVolumeGeometry());
+		bool bDone;
+		if (pPixelDrivenBP && pPixelDrivenBP->isInitialized())
+			bDone = pPixelDrivenBP->backProject(&filteredSinogram, m_pReconstruction, 0, 0, &checkpoint);
+		else
+			bDone = projectData(m_pProjector, DefaultBPPolicy(m_pReconstruction, &filteredSinogram), checkpoint);
+		delete pPixelDrivenBP;
+		if (!bDone)
+			return;
+	}
+	addProjectionCounts();
+
+	// Scale data. The fan beam weighting already includes the angular step.
+	if (!bFanBeam) {
+		CPhaseTimer timer(m_timings, ALGPHASE_VECTOROPS);
+		int iAngleCount = m_pProjector->getProjectionGeometry()->getProjectionAngleCount();
+		(*m_pReconstruction) *= (PI/2)/iAngleCount;
+		m_timings.addBytes(2.0 * m_pReconstruction->getSize() * sizeof(float32));
+	}
 
 	m_pReconstruction->updateStatistics();
 }
 
 
 //----------------------------------------------------------------------------------------
-void CFilteredBackProjectionAlgorithm::performFiltering(CFloat32ProjectionData2D * _pFilteredSinogram)
+// Zero-pad, filter and copy back a range of sinogram rows. Every row
+// has its own part of the complex buffer.
+struct SFilterRowsFunctor {
+	float32* m_pfData;
+	float32* m_pfBuffer;
+	const float32* m_pfFilter;
+	int* m_piIp;
+	float32* m_pfW;
+	int m_iDetectorCount;
+	int m_iPaddedCount;
+
+	void operator()(int _iFrom, int _iTo) const {
+		const int zp = m_iPaddedCount;
+		for (int iAngle = _iFrom; iAngle < _iTo; ++iAngle) {
+			float32* pfRow = m_pfBuffer + (size_t)iAngle * 2 * zp;
+			float32* pfDataRow = m_pfData + (size_t)iAngle * m_iDetectorCount;
+
+			// Copy and zero-pad data
+			for (int iDetector = 0; iDetector < m_iDetectorCount; ++iDetector) {
+				pfRow[2*iDetector] = pfDataRow[iDetector];
+				pfRow[2*iDetector+1] = 0.0f;
+			}
+			for (int iDetector = m_iDetectorCount; iDetector < zp; ++iDetector) {
+				pfRow[2*iDetector] = 0.0f;
+				pfRow[2*iDetector+1] = 0.0f;
+			}
+
+			// in-place FFT, filter, in-place inverse FFT
+			cdft(2*zp, -1, pfRow, m_piIp, m_pfW);
+			for (int iDetector = 0; iDetector < zp; ++iDetector) {
+				pfRow[2*iDetector] *= m_pfFilter[iDetector];
+				pfRow[2*iDetector+1] *= m_pfFilter[iDetector];
+			}
+			cdft(2*zp, 1, pfRow, m_piIp, m_pfW);
+
+			// Copy data back
+			for (int iDetector = 0; iDetector < m_iDetectorCount; ++iDetector)
+				pfDataRow[iDetector] = pfRow[2*iDetector] / zp;
+		}
+	}
+};
+
+//----------------------------------------------------------------------------------------
+bool CFilteredBackProjectionAlgorithm::performFiltering(CFloat32ProjectionData2D * _pFilteredSinogram)
 {
 	ASTRA_ASSERT(_pFilteredSinogram != NULL);
 	ASTRA_ASSERT(_pFilteredSinogram->getAngleCount() == m_pSinogram->getAngleCount());
@@ -253,19 +397,24 @@ void CFilteredBackProjectionAlgorithm::performFiltering(CFloat32ProjectionData2D
 	int iAngleCount = m_pProjector->getProjectionGeometry()->getProjectionAngleCount();
 	int iDetectorCount = m_pProjector->getProjectionGeometry()->getDetectorCount();
 
+	return rampFilter(_pFilteredSinogram->getData(), iAngleCount, iDetectorCount);
+}
 
-	// We'll zero-pad to the smallest power of two at least 64 and
-	// at least 2*iDetectorCount
-	int zpDetector = 64;
-	int nextPow2 = 5;
-	while (zpDetector < iDetectorCount*2) {
-		zpDetector *= 2;
-		nextPow2++;
+//----------------------------------------------------------------------------------------
+bool CFilteredBackProjectionAlgorithm::rampFilter(float32* _pfData, int _iAngleCount, int _iDetectorCount)
+{
+	int zpDetector = zeroPaddedDetectorCount(_iDetectorCount);
+
+	// Create filter and FFT buffers
+	CScratchBuffer<float32> filter(zpDetector);
+	CScratchBuffer<float32> pf((size_t)2 * _iAngleCount * zpDetector);
+	CScratchBuffer<int> ip(int(2+sqrt((float)zpDetector)+1));
+	CScratchBuffer<float32> w(zpDetector/2);
+	if (!filter || !pf || !ip || !w) {
+		ASTRA_ERROR("FBP: unable to allocate the filtering buffers");
+		return false;
 	}
 
-	// Create filter
-	float32* filter = new float32[zpDetector];
-
 	for (int iDetector = 0; iDetector <= zpDetector/2; iDetector++)
 		filter[iDetector] = (2.0f * iDetector)/zpDetector;
 
@@ -273,58 +422,169 @@ void CFilteredBackProjectionAlgorithm::performFiltering(CFloat32ProjectionData2D
 		filter[iDetector] = (2.0f * (zpDetector - iDetector)) / zpDetector;
 
 
-	float32* pf = new float32[2 * iAngleCount * zpDetector];
-	int *ip = new int[int(2+sqrt((float)zpDetector)+1)];
 	ip[0]=0;
-	float32 *w = new float32[zpDetector/2];
-
-	// Copy and zero-pad data
-	for (int iAngle = 0; iAngle < iAngleCount; ++iAngle) {
-		float32* pfRow = pf + iAngle * 2 * zpDetector;
-		float32* pfDataRow = _pFilteredSinogram->getData() + iAngle * iDetectorCount;
-		for (int iDetector = 0; iDetector < iDetectorCount; ++iDetector) {
-			pfRow[2*iDetector] = pfDataRow[iDetector];
-			pfRow[2*iDetector+1] = 0.0f;
-		}
-		for (int iDetector = iDetectorCount; iDetector < zpDetector; ++iDetector) {
-			pfRow[2*iDetector] = 0.0f;
-			pfRow[2*iDetector+1] = 0.0f;
-		}
-	}
 
-	// in-place FFT
-	for (int iAngle = 0; iAngle < iAngleCount; ++iAngle) {
-		float32* pfRow = pf + iAngle * 2 * zpDetector;
-		cdft(2*zpDetector, -1, pfRow, ip, w);
+	SFilterRowsFunctor f;
+	f.m_pfData = _pfData;
+	f.m_pfBuffer = pf;
+	f.m_pfFilter = filter;
+	f.m_piIp = ip;
+	f.m_pfW = w;
+	f.m_iDetectorCount = _iDetectorCount;
+	f.m_iPaddedCount = zpDetector;
+
+	// The first row initializes the shared FFT tables, the others
+	// only read them and can be filtered concurrently.
+	f(0, 1);
+	CWorkerPool::getSingleton().parallelFor(1, _iAngleCount, f);
+
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+// Parker's short scan weight for source angle _fBeta from the start of
+// the scan and fan angle _fGamma, for a scan over PI + 2 * _fDelta.
+// A ray and its conjugate at (_fBeta + PI + 2 * _fGamma, -_fGamma) have
+// weights summing to one.
+static double parkerWeight(double _fBeta, double _fGamma, double _fDelta)
+{
+	const double fPi = 3.14159265358979323846;
+	if (_fBeta < 0.0 || _fBeta > fPi + 2.0 * _fDelta)
+		return 0.0;
+	if (_fBeta < 2.0 * (_fDelta - _fGamma)) {
+		double s = sin(fPi / 4.0 * _fBeta / (_fDelta - _fGamma));
+		return s * s;
 	}
+	if (_fBeta <= fPi - 2.0 * _fGamma)
+		return 1.0;
+	if (_fDelta + _fGamma <= 0.0)
+		return 0.0;
+	double s = sin(fPi / 4.0 * (fPi + 2.0 * _fDelta - _fBeta) / (_fDelta + _fGamma));
+	return s * s;
+}
+
+//----------------------------------------------------------------------------------------
+// Pre-weight a range of fan beam sinogram rows.
+struct SFanWeightingFunctor {
+	float32* m_pfData;
+	const SFanProjection* m_pProjections;
+	const double* m_pfBeta;
+	int m_iAngleCount;
+	int m_iDetectorCount;
+	bool m_bShortScan;
+	double m_fDelta;
+	double m_fDirection;
+
+	void operator()(int _iFrom, int _iTo) const {
+		const double fPi = 3.14159265358979323846;
+		for (int iAngle = _iFrom; iAngle < _iTo; ++iAngle) {
+			const SFanProjection& p = m_pProjections[iAngle];
+			float32* pfRow = m_pfData + (size_t)iAngle * m_iDetectorCount;
+
+			// unit detector normal, and the source distances to the detector
+			// and to the parallel line through the origin
+			double fDetSize = sqrt((double)p.fDetUX * p.fDetUX + (double)p.fDetUY * p.fDetUY);
+			double fNX = -p.fDetUY / fDetSize;
+			double fNY = p.fDetUX / fDetSize;
+			double fSDD = fabs((p.fDetSX - p.fSrcX) * fNX + (p.fDetSY - p.fSrcY) * fNY);
+			double fSOD = fabs(p.fSrcX * fNX + p.fSrcY * fNY);
+
+			// detector spacing when scaled to the origin
+			double fVirtualDetSize = fDetSize * fSOD / fSDD;
+
+			// angular step around this projection
+			double fStep;
+			if (m_iAngleCount == 1)
+				fStep = 2.0 * fPi;
+			else if (iAngle == 0)
+				fStep = fabs(m_pfBeta[1] - m_pfBeta[0]);
+			else if (iAngle == m_iAngleCount - 1)
+				fStep = fabs(m_pfBeta[iAngle] - m_pfBeta[iAngle-1]);
+			else
+				fStep = 0.5 * fabs(m_pfBeta[iAngle+1] - m_pfBeta[iAngle-1]);
+
+			// A full scan covers every ray twice. The filter is twice the
+			// Ram-Lak filter and has no detector spacing.
+			double fScale = fStep / (2.0 * fVirtualDetSize);
+			if (!m_bShortScan)
+				fScale *= 0.5;
+
+			double fBeta = m_fDirection * (m_pfBeta[iAngle] - m_pfBeta[0]);
+			double fCentral = atan2(-p.fSrcY, -p.fSrcX);
+
+			for (int iDetector = 0; iDetector < m_iDetectorCount; ++iDetector) {
+				double fDX = p.fDetSX + (iDetector + 0.5) * p.fDetUX - p.fSrcX;
+				double fDY = p.fDetSY + (iDetector + 0.5) * p.fDetUY - p.fSrcY;
+				double fLength = sqrt(fDX * fDX + fDY * fDY);
+				double fWeight = fScale * fabs(fDX * fNX + fDY * fNY) / fLength;
+
+				if (m_bShortScan) {
+					double fGamma = atan2(fDY, fDX) - fCentral;
+					if (fGamma > fPi)
+						fGamma -= 2.0 * fPi;
+					else if (fGamma <= -fPi)
+						fGamma += 2.0 * fPi;
+					fWeight *= parkerWeight(fBeta, m_fDirection * fGamma, m_fDelta);
+				}
 
-	// Filter
-	for (int iAngle = 0; iAngle < iAngleCount; ++iAngle) {
-		float32* pfRow = pf + iAngle * 2 * zpDetector;
-		for (int iDetector = 0; iDetector < zpDetector; ++iDetector) {
-			pfRow[2*iDetector] *= filter[iDetector];
-			pfRow[2*iDetector+1] *= filter[iDetector];
+				pfRow[iDetector] *= (float32)fWeight;
+			}
 		}
 	}
+};
 
-	// in-place inverse FFT
-	for (int iAngle = 0; iAngle < iAngleCount; ++iAngle) {
-		float32* pfRow = pf + iAngle * 2 * zpDetector;
-		cdft(2*zpDetector, 1, pfRow, ip, w);
-	}
+//----------------------------------------------------------------------------------------
+bool CFilteredBackProjectionAlgorithm::performFanBeamWeighting(CFloat32ProjectionData2D * _pFilteredSinogram)
+{
+	ASTRA_ASSERT(_pFilteredSinogram != NULL);
+	ASTRA_ASSERT(_pFilteredSinogram->getAngleCount() == m_pSinogram->getAngleCount());
 
-	// Copy data back
-	for (int iAngle = 0; iAngle < iAngleCount; ++iAngle) {
-		float32* pfRow = pf + iAngle * 2 * zpDetector;
-		float32* pfDataRow = _pFilteredSinogram->getData() + iAngle * iDetectorCount;
-		for (int iDetector = 0; iDetector < iDetectorCount; ++iDetector)
-			pfDataRow[iDetector] = pfRow[2*iDetector] / zpDetector;
+	const double fPi = 3.14159265358979323846;
+	CProjectionGeometry2D* pGeometry = m_pProjector->getProjectionGeometry();
+	CFanFlatVecProjectionGeometry2D* pVecGeometry = dynamic_cast<CFanFlatVecProjectionGeometry2D*>(pGeometry);
+	CFanFlatVecProjectionGeometry2D* pOwnedGeometry = 0;
+	if (!pVecGeometry) {
+		CFanFlatProjectionGeometry2D* pFanGeometry = dynamic_cast<CFanFlatProjectionGeometry2D*>(pGeometry);
+		ASTRA_ASSERT(pFanGeometry);
+		pOwnedGeometry = pFanGeometry->toVectorGeometry();
+		pVecGeometry = pOwnedGeometry;
+	}
+	const SFanProjection* pProjections = pVecGeometry->getProjectionVectors();
+	int iAngleCount = pVecGeometry->getProjectionAngleCount();
+
+	// source angles, unwrapped to be continuous
+	std::vector<double> fBeta(iAngleCount);
+	for (int i = 0; i < iAngleCount; ++i) {
+		double b = atan2(pProjections[i].fSrcX, -pProjections[i].fSrcY);
+		if (i > 0) {
+			while (b - fBeta[i-1] > fPi)
+				b -= 2.0 * fPi;
+			while (b - fBeta[i-1] < -fPi)
+				b += 2.0 * fPi;
+		}
+		fBeta[i] = b;
 	}
 
-	delete[] pf;
-	delete[] w;
-	delete[] ip;
-	delete[] filter;
+	// The scan is short if it misses more than one angular step of a full circle.
+	double fRange = fabs(fBeta[iAngleCount-1] - fBeta[0]);
+	double fStep = (iAngleCount > 1) ? fRange / (iAngleCount - 1) : 2.0 * fPi;
+	bool bShortScan = (fRange + fStep < 2.0 * fPi * (1.0 - 1e-3));
+	if (bShortScan && fRange < fPi)
+		ASTRA_WARN("FBP: the fan beam scan covers less than 180 degrees");
+
+	SFanWeightingFunctor f;
+	f.m_pfData = _pFilteredSinogram->getData();
+	f.m_pProjections = pProjections;
+	f.m_pfBeta = &fBeta[0];
+	f.m_iAngleCount = iAngleCount;
+	f.m_iDetectorCount = pVecGeometry->getDetectorCount();
+	f.m_bShortScan = bShortScan;
+	f.m_fDelta = 0.5 * (fRange - fPi);
+	f.m_fDirection = (fBeta[iAngleCount-1] >= fBeta[0]) ? 1.0 : -1.0;
+	CWorkerPool::getSingleton().parallelFor(0, iAngleCount, f);
+
+	delete pOwnedGeometry;
+	return true;
 }
 
 }
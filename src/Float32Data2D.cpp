@@ -26,6 +26,11 @@ along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include "astra/Float32Data2D.h"
+#include "astra/HostMemory.h"
+#include "astra/MemoryBudget.h"
+#include "astra/NumaPlacement.h"
+#include "astra/Reduction.h"
+#include "astra/Logging.h"
 #include <iostream>
 #include <cstring>
 #include <sstream>
@@ -112,7 +117,7 @@ CFloat32Data2D& CFloat32Data2D::operator=(const CFloat32Data2D& _dataIn)
 			ASTRA_ASSERT(m_iSize == (size_t)m_iWidth * m_iHeight);
 			ASTRA_ASSERT(m_pfData);
 
-			memcpy(m_pfData, _dataIn.m_pfData, m_iSize * sizeof(float32));
+			copyRows(m_pfData, _dataIn.m_pfData, m_iHeight, m_iWidth, m_iPitch, _dataIn.m_iPitch);
 		} else {
 			if (m_pCustomMemory) {
 				// Can't re-allocate custom data
@@ -121,10 +126,12 @@ CFloat32Data2D& CFloat32Data2D::operator=(const CFloat32Data2D& _dataIn)
 			}
 			// Re-allocate data
 			_unInit();
-			_initialize(_dataIn.getWidth(), _dataIn.getHeight(), _dataIn.getDataConst());
+			_initialize(_dataIn.getWidth(), _dataIn.getHeight());
+			copyRows(m_pfData, _dataIn.m_pfData, m_iHeight, m_iWidth, m_iPitch, _dataIn.m_iPitch);
 		}
 	} else {
-		_initialize(_dataIn.getWidth(), _dataIn.getHeight(), _dataIn.getDataConst());
+		_initialize(_dataIn.getWidth(), _dataIn.getHeight());
+		copyRows(m_pfData, _dataIn.m_pfData, m_iHeight, m_iWidth, m_iPitch, _dataIn.m_iPitch);
 	}
 
 	return (*this);
@@ -157,12 +164,15 @@ bool CFloat32Data2D::_initialize(int _iWidth, int _iHeight)
 	m_iWidth = _iWidth;
 	m_iHeight = _iHeight;
 	m_iSize = (size_t)m_iWidth * m_iHeight;
+	m_iPitch = m_iWidth;
 
-	// allocate memory for the data, but do not fill it
+	// allocate memory for the data, and place its pages without filling it
 	m_pfData = 0;
 	m_ppfData2D = 0;
 	m_pCustomMemory = 0;
-	_allocateData();
+	if (!_allocateData())
+		return false;
+	touchRows(m_pfData, m_iHeight, m_iWidth);
 
 	// set minmax to default values
 	m_fGlobalMin = 0.0;
@@ -192,18 +202,17 @@ bool CFloat32Data2D::_initialize(int _iWidth, int _iHeight, const float32 *_pfDa
 	m_iWidth = _iWidth;
 	m_iHeight = _iHeight;
 	m_iSize = (size_t)m_iWidth * m_iHeight;
+	m_iPitch = m_iWidth;
 
 	// allocate memory for the data 
 	m_pfData = 0;
 	m_ppfData2D = 0;
 	m_pCustomMemory = 0;
-	_allocateData();
+	if (!_allocateData())
+		return false;
 
 	// fill the data block with a copy of the input data
-	size_t i;
-	for (i = 0; i < m_iSize; ++i) {
-		m_pfData[i] = _pfData[i];
-	}
+	copyRows(m_pfData, _pfData, m_iHeight, m_iWidth);
 
 	// initialization complete
 	return true;
@@ -225,19 +234,17 @@ bool CFloat32Data2D::_initialize(int _iWidth, int _iHeight, float32 _fScalar)
 	m_iWidth = _iWidth;
 	m_iHeight = _iHeight;
 	m_iSize = (size_t)m_iWidth * m_iHeight;
+	m_iPitch = m_iWidth;
 
 	// allocate memory for the data 
 	m_pfData = 0;
 	m_ppfData2D = 0;
 	m_pCustomMemory = 0;
-	_allocateData();
+	if (!_allocateData())
+		return false;
 
 	// fill the data block with a copy of the input data
-	size_t i;
-	for (i = 0; i < m_iSize; ++i)
-	{
-		m_pfData[i] = _fScalar;
-	}
+	fillRows(m_pfData, m_iHeight, m_iWidth, _fScalar);
 
 	// initialization complete
 	return true;
@@ -261,6 +268,7 @@ bool CFloat32Data2D::_initialize(int _iWidth, int _iHeight, CFloat32CustomMemory
 	m_iWidth = _iWidth;
 	m_iHeight = _iHeight;
 	m_iSize = (size_t)m_iWidth * m_iHeight;
+	m_iPitch = m_iWidth;
 
 	// initialize the data pointers
 	m_pCustomMemory = _pCustomMemory;
@@ -280,7 +288,7 @@ bool CFloat32Data2D::_initialize(int _iWidth, int _iHeight, CFloat32CustomMemory
 
 //----------------------------------------------------------------------------------------
 // Allocate memory for m_pfData and m_ppfData2D arrays.
-void CFloat32Data2D::_allocateData()
+bool CFloat32Data2D::_allocateData()
 {
 	// basic checks
 	ASTRA_ASSERT(!m_bInitialized);
@@ -292,14 +300,21 @@ void CFloat32Data2D::_allocateData()
 
 	if (!m_pCustomMemory) {
 
+		const size_t iBytes = (size_t)m_iPitch * m_iHeight * sizeof(float32);
+		if (!CMemoryBudget::getSingleton().reserve(iBytes)) {
+			ASTRA_ERROR("Allocating %llu bytes would exceed the host memory limit", (unsigned long long)iBytes);
+			return false;
+		}
+
 		// allocate contiguous block
-#ifdef _MSC_VER
-		m_pfData = (float32*)_aligned_malloc(m_iSize * sizeof(float32), 16);
-#else
-		int ret = posix_memalign((void**)&m_pfData, 16, m_iSize * sizeof(float32));
-		ASTRA_ASSERT(ret == 0);
-#endif
+		m_pfData = (float32*)allocateHostMemory(iBytes, DATA_ALIGNMENT);
+		if (!m_pfData) {
+			CMemoryBudget::getSingleton().release(iBytes);
+			ASTRA_ERROR("Unable to allocate %llu bytes", (unsigned long long)iBytes);
+			return false;
+		}
 
+		bindPages(m_pfData, (size_t)m_iPitch * m_iHeight);
 	} else {
 		m_pfData = m_pCustomMemory->m_fPtr;
 	}
@@ -308,8 +323,10 @@ void CFloat32Data2D::_allocateData()
 	m_ppfData2D = new float32*[m_iHeight];
 	for (int iy = 0; iy < m_iHeight; iy++)
 	{
-		m_ppfData2D[iy] = &(m_pfData[iy * m_iWidth]);
+		m_ppfData2D[iy] = &(m_pfData[(size_t)iy * m_iPitch]);
 	}
+
+	return true;
 }
 
 //----------------------------------------------------------------------------------------
@@ -324,11 +341,9 @@ void CFloat32Data2D::_freeData()
 
 	if (!m_pCustomMemory) {
 		// free memory for data block
-#ifdef _MSC_VER
-		_aligned_free(m_pfData);
-#else
-		free(m_pfData);
-#endif
+		const size_t iBytes = (size_t)m_iPitch * m_iHeight * sizeof(float32);
+		freeHostMemory(m_pfData, iBytes);
+		CMemoryBudget::getSingleton().release(iBytes);
 	} else {
 		delete m_pCustomMemory;
 		m_pCustomMemory = 0;
@@ -343,6 +358,7 @@ void CFloat32Data2D::_clear()
 	m_iWidth = 0;
 	m_iHeight = 0;
 	m_iSize = 0;
+	m_iPitch = 0;
 
 	m_pfData = NULL;
 	m_ppfData2D = NULL;
@@ -381,10 +397,7 @@ void CFloat32Data2D::copyData(const float32* _pfData)
 	ASTRA_ASSERT(m_iSize > 0);
 
 	// copy data
-	size_t i;
-	for (i = 0; i < m_iSize; ++i) {
-		m_pfData[i] = _pfData[i];
-	}
+	copyRows(m_pfData, _pfData, m_iHeight, m_iWidth, m_iPitch);
 }	
 
 //----------------------------------------------------------------------------------------
@@ -398,10 +411,10 @@ void CFloat32Data2D::scale()
 	ASTRA_ASSERT(m_iSize > 0);
 
 	_computeGlobalMinMax();
-	for (size_t i = 0; i < m_iSize; i++) 
-	{
-		// do checks
-		m_pfData[i]= (m_pfData[i] - m_fGlobalMin) / (m_fGlobalMax - m_fGlobalMin) * 255; ;
+	for (int y = 0; y < m_iHeight; y++) {
+		float32* pfRow = m_ppfData2D[y];
+		for (int x = 0; x < m_iWidth; x++)
+			pfRow[x] = (pfRow[x] - m_fGlobalMin) / (m_fGlobalMax - m_fGlobalMin) * 255;
 	}
 
 
@@ -417,11 +430,7 @@ void CFloat32Data2D::setData(float32 _fScalar)
 	ASTRA_ASSERT(m_iSize > 0);
 
 	// copy data
-	size_t i;
-	for (i = 0; i < m_iSize; ++i)
-	{
-		m_pfData[i] = _fScalar;
-	}
+	fillRows(m_pfData, m_iHeight, m_iWidth, _fScalar, m_iPitch);
 }
 
 //----------------------------------------------------------------------------------------
@@ -434,10 +443,7 @@ void CFloat32Data2D::clearData()
 	ASTRA_ASSERT(m_iSize > 0);
 	
 	// set data
-	size_t i;
-	for (i = 0; i < m_iSize; ++i) {
-		m_pfData[i] = 0.0f;
-	}
+	fillRows(m_pfData, m_iHeight, m_iWidth, 0.0f, m_iPitch);
 }
 //----------------------------------------------------------------------------------------
 
@@ -466,22 +472,22 @@ void CFloat32Data2D::_computeGlobalMinMax()
 	// initial values
 	m_fGlobalMin = m_pfData[0];
 	m_fGlobalMax = m_pfData[0];
-	m_fGlobalMean = 0.0f;
 
 	// loop
-	for (size_t i = 0; i < m_iSize; i++) 
-	{
-		// do checks
-		float32 v = m_pfData[i];
-		if (v < m_fGlobalMin) {
-			m_fGlobalMin = v;
-		}
-		if (v > m_fGlobalMax) {
-			m_fGlobalMax = v;
+	for (int y = 0; y < m_iHeight; y++) {
+		const float32* pfRow = m_ppfData2D[y];
+		for (int x = 0; x < m_iWidth; x++) {
+			float32 v = pfRow[x];
+			if (v < m_fGlobalMin) {
+				m_fGlobalMin = v;
+			}
+			if (v > m_fGlobalMax) {
+				m_fGlobalMax = v;
+			}
 		}
-		m_fGlobalMean +=v;
 	}
-	m_fGlobalMean /= m_iSize;
+	// the padding between rows is zero, so it doesn't change the sum
+	m_fGlobalMean = (float32)(reduceSum(m_pfData, (size_t)m_iPitch * m_iHeight) / m_iSize);
 }
 //----------------------------------------------------------------------------------------
 
@@ -489,9 +495,12 @@ void CFloat32Data2D::_computeGlobalMinMax()
 CFloat32Data2D& CFloat32Data2D::clampMin(float32& _fMin)
 {
 	ASTRA_ASSERT(m_bInitialized);
-	for (size_t i = 0; i < m_iSize; i++) {
-		if (m_pfData[i] < _fMin)
-			m_pfData[i] = _fMin;
+	for (int y = 0; y < m_iHeight; y++) {
+		float32* pfRow = m_ppfData2D[y];
+		for (int x = 0; x < m_iWidth; x++) {
+			if (pfRow[x] < _fMin)
+				pfRow[x] = _fMin;
+		}
 	}
 	return (*this);
 }
@@ -499,9 +508,12 @@ CFloat32Data2D& CFloat32Data2D::clampMin(float32& _fMin)
 CFloat32Data2D& CFloat32Data2D::clampMax(float32& _fMax)
 {
 	ASTRA_ASSERT(m_bInitialized);
-	for (size_t i = 0; i < m_iSize; i++) {
-		if (m_pfData[i] > _fMax)
-			m_pfData[i] = _fMax;
+	for (int y = 0; y < m_iHeight; y++) {
+		float32* pfRow = m_ppfData2D[y];
+		for (int x = 0; x < m_iWidth; x++) {
+			if (pfRow[x] > _fMax)
+				pfRow[x] = _fMax;
+		}
 	}
 	return (*this);
 }
@@ -515,8 +527,12 @@ CFloat32Data2D& CFloat32Data2D::operator+=(const CFloat32Data2D& v)
 	ASTRA_ASSERT(m_bInitialized);
 	ASTRA_ASSERT(v.m_bInitialized);
 	ASTRA_ASSERT(getSize() == v.getSize());
-	for (size_t i = 0; i < m_iSize; i++) {
-		m_pfData[i] += v.m_pfData[i]; 
+	ASTRA_ASSERT(getWidth() == v.getWidth());
+	for (int y = 0; y < m_iHeight; y++) {
+		float32* pfRow = m_ppfData2D[y];
+		const float32* pfOther = v.m_ppfData2D[y];
+		for (int x = 0; x < m_iWidth; x++)
+			pfRow[x] += pfOther[x];
 	}
 	return (*this);
 }
@@ -526,8 +542,12 @@ CFloat32Data2D& CFloat32Data2D::operator-=(const CFloat32Data2D& v)
 	ASTRA_ASSERT(m_bInitialized);
 	ASTRA_ASSERT(v.m_bInitialized);
 	ASTRA_ASSERT(getSize() == v.getSize());
-	for (size_t i = 0; i < m_iSize; i++) {
-		m_pfData[i] -= v.m_pfData[i]; 
+	ASTRA_ASSERT(getWidth() == v.getWidth());
+	for (int y = 0; y < m_iHeight; y++) {
+		float32* pfRow = m_ppfData2D[y];
+		const float32* pfOther = v.m_ppfData2D[y];
+		for (int x = 0; x < m_iWidth; x++)
+			pfRow[x] -= pfOther[x];
 	}
 	return (*this);
 }
@@ -537,8 +557,12 @@ CFloat32Data2D& CFloat32Data2D::operator*=(const CFloat32Data2D& v)
 	ASTRA_ASSERT(m_bInitialized);
 	ASTRA_ASSERT(v.m_bInitialized);
 	ASTRA_ASSERT(getSize() == v.getSize());
-	for (size_t i = 0; i < m_iSize; i++) {
-		m_pfData[i] *= v.m_pfData[i]; 
+	ASTRA_ASSERT(getWidth() == v.getWidth());
+	for (int y = 0; y < m_iHeight; y++) {
+		float32* pfRow = m_ppfData2D[y];
+		const float32* pfOther = v.m_ppfData2D[y];
+		for (int x = 0; x < m_iWidth; x++)
+			pfRow[x] *= pfOther[x];
 	}
 	return (*this);
 }
@@ -546,8 +570,10 @@ CFloat32Data2D& CFloat32Data2D::operator*=(const CFloat32Data2D& v)
 CFloat32Data2D& CFloat32Data2D::operator*=(const float32& f)
 {
 	ASTRA_ASSERT(m_bInitialized);
-	for (size_t i = 0; i < m_iSize; i++) {
-		m_pfData[i] *= f; 
+	for (int y = 0; y < m_iHeight; y++) {
+		float32* pfRow = m_ppfData2D[y];
+		for (int x = 0; x < m_iWidth; x++)
+			pfRow[x] *= f;
 	}
 	return (*this);
 }
@@ -555,8 +581,10 @@ CFloat32Data2D& CFloat32Data2D::operator*=(const float32& f)
 CFloat32Data2D& CFloat32Data2D::operator/=(const float32& f)
 {
 	ASTRA_ASSERT(m_bInitialized);
-	for (size_t i = 0; i < m_iSize; i++) {
-		m_pfData[i] /= f; 
+	for (int y = 0; y < m_iHeight; y++) {
+		float32* pfRow = m_ppfData2D[y];
+		for (int x = 0; x < m_iWidth; x++)
+			pfRow[x] /= f;
 	}
 	return (*this);
 }
@@ -564,8 +592,10 @@ CFloat32Data2D& CFloat32Data2D::operator/=(const float32& f)
 CFloat32Data2D& CFloat32Data2D::operator+=(const float32& f)
 {
 	ASTRA_ASSERT(m_bInitialized);
-	for (size_t i = 0; i < m_iSize; i++) {
-		m_pfData[i] += f;
+	for (int y = 0; y < m_iHeight; y++) {
+		float32* pfRow = m_ppfData2D[y];
+		for (int x = 0; x < m_iWidth; x++)
+			pfRow[x] += f;
 	}
 	return (*this);
 }
@@ -573,13 +603,66 @@ CFloat32Data2D& CFloat32Data2D::operator+=(const float32& f)
 CFloat32Data2D& CFloat32Data2D::operator-=(const float32& f)
 {
 	ASTRA_ASSERT(m_bInitialized);
-	for (size_t i = 0; i < m_iSize; i++) {
-		m_pfData[i] -= f;
+	for (int y = 0; y < m_iHeight; y++) {
+		float32* pfRow = m_ppfData2D[y];
+		for (int x = 0; x < m_iWidth; x++)
+			pfRow[x] -= f;
 	}
 	return (*this);
 }
 
 
+//----------------------------------------------------------------------------------------
+// Store the rows _iPitch elements apart.
+bool CFloat32Data2D::setRowPitch(int _iPitch)
+{
+	ASTRA_ASSERT(m_bInitialized);
+
+	if (_iPitch == 0) {
+		const int iAlign = DATA_ALIGNMENT / sizeof(float32);
+		_iPitch = ((m_iWidth + iAlign - 1) / iAlign) * iAlign;
+	}
+	if (_iPitch < m_iWidth) {
+		ASTRA_ERROR("CFloat32Data2D::setRowPitch: the pitch %d is smaller than the width %d", _iPitch, m_iWidth);
+		return false;
+	}
+	if (_iPitch == m_iPitch)
+		return true;
+	if (m_pCustomMemory) {
+		ASTRA_ERROR("CFloat32Data2D::setRowPitch: custom memory can't be re-laid out");
+		return false;
+	}
+
+	const size_t iBytes = (size_t)_iPitch * m_iHeight * sizeof(float32);
+	if (!CMemoryBudget::getSingleton().reserve(iBytes)) {
+		ASTRA_ERROR("Allocating %llu bytes would exceed the host memory limit", (unsigned long long)iBytes);
+		return false;
+	}
+	float32* pfData = (float32*)allocateHostMemory(iBytes, DATA_ALIGNMENT);
+	if (!pfData) {
+		CMemoryBudget::getSingleton().release(iBytes);
+		ASTRA_ERROR("Unable to allocate %llu bytes", (unsigned long long)iBytes);
+		return false;
+	}
+	bindPages(pfData, (size_t)_iPitch * m_iHeight);
+
+	// zero the whole block including the padding, then copy the rows
+	fillRows(pfData, m_iHeight, _iPitch, 0.0f);
+	copyRows(pfData, m_pfData, m_iHeight, m_iWidth, _iPitch, m_iPitch);
+
+	const size_t iOldBytes = (size_t)m_iPitch * m_iHeight * sizeof(float32);
+	freeHostMemory(m_pfData, iOldBytes);
+	CMemoryBudget::getSingleton().release(iOldBytes);
+
+	m_pfData = pfData;
+	m_iPitch = _iPitch;
+	for (int iy = 0; iy < m_iHeight; iy++)
+		m_ppfData2D[iy] = &(m_pfData[(size_t)iy * m_iPitch]);
+
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
 std::string CFloat32Data2D::description() const
 {
 	std::stringstream res;
@@ -26,6 +26,10 @@ along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include "astra/Float32Data3DMemory.h"
+#include "astra/HostMemory.h"
+#include "astra/MemoryBudget.h"
+#include "astra/NumaPlacement.h"
+#include "astra/Logging.h"
 #include <iostream>
 #include <cstdlib>
 
@@ -68,11 +72,14 @@ bool CFloat32Data3DMemory::_initialize(int _iWidth, int _iHeight, int _iDepth)
 	m_iHeight = _iHeight;
 	m_iDepth = _iDepth;
 	m_iSize = (size_t)m_iWidth * m_iHeight * m_iDepth;
+	m_iPitch = m_iWidth;
 
-	// allocate memory for the data, but do not fill it
+	// allocate memory for the data, and place its pages without filling it
 	m_pfData = NULL;
 	m_pCustomMemory = 0;
-	_allocateData();
+	if (!_allocateData())
+		return false;
+	touchRows(m_pfData, (size_t)m_iHeight * m_iDepth, m_iWidth);
 
 	// initialization complete
 	return true;
@@ -98,18 +105,16 @@ bool CFloat32Data3DMemory::_initialize(int _iWidth, int _iHeight, int _iDepth, c
 	m_iHeight = _iHeight;
 	m_iDepth = _iDepth;
 	m_iSize = (size_t)m_iWidth * m_iHeight * m_iDepth;
+	m_iPitch = m_iWidth;
 
 	// allocate memory for the data, but do not fill it
 	m_pfData = NULL;
 	m_pCustomMemory = 0;
-	_allocateData();
+	if (!_allocateData())
+		return false;
 
 	// fill the data block with a copy of the input data
-	size_t i;
-	for (i = 0; i < m_iSize; ++i)
-	{
-		m_pfData[i] = _pfData[i];
-	}
+	copyRows(m_pfData, _pfData, (size_t)m_iHeight * m_iDepth, m_iWidth);
 
 	// initialization complete
 	return true;
@@ -133,18 +138,16 @@ bool CFloat32Data3DMemory::_initialize(int _iWidth, int _iHeight, int _iDepth, f
 	m_iHeight = _iHeight;
 	m_iDepth = _iDepth;
 	m_iSize = (size_t)m_iWidth * m_iHeight * m_iDepth;
+	m_iPitch = m_iWidth;
 
 	// allocate memory for the data, but do not fill it
 	m_pfData = NULL;
 	m_pCustomMemory = 0;
-	_allocateData();
+	if (!_allocateData())
+		return false;
 
 	// fill the data block with a copy of the input data
-	size_t i;
-	for (i = 0; i < m_iSize; ++i)
-	{
-		m_pfData[i] = _fScalar;
-	}
+	fillRows(m_pfData, (size_t)m_iHeight * m_iDepth, m_iWidth, _fScalar);
 
 	// initialization complete
 	return true;
@@ -168,6 +171,7 @@ bool CFloat32Data3DMemory::_initialize(int _iWidth, int _iHeight, int _iDepth, C
 	m_iHeight = _iHeight;
 	m_iDepth = _iDepth;
 	m_iSize = (size_t)m_iWidth * m_iHeight * m_iDepth;
+	m_iPitch = m_iWidth;
 
 	// allocate memory for the data, but do not fill it
 	m_pCustomMemory = _pCustomMemory;
@@ -182,7 +186,7 @@ bool CFloat32Data3DMemory::_initialize(int _iWidth, int _iHeight, int _iDepth, C
 
 //----------------------------------------------------------------------------------------
 // Allocate memory for m_pfData and m_ppfData2D arrays.
-void CFloat32Data3DMemory::_allocateData()
+bool CFloat32Data3DMemory::_allocateData()
 {
 	// basic checks
 	ASTRA_ASSERT(!m_bInitialized);
@@ -192,17 +196,26 @@ void CFloat32Data3DMemory::_allocateData()
 	ASTRA_ASSERT(m_pfData == NULL);
 
 	if (!m_pCustomMemory) {
+		const size_t iBytes = (size_t)m_iPitch * m_iHeight * m_iDepth * sizeof(float32);
+		if (!CMemoryBudget::getSingleton().reserve(iBytes)) {
+			ASTRA_ERROR("Allocating %llu bytes would exceed the host memory limit", (unsigned long long)iBytes);
+			return false;
+		}
+
 		// allocate contiguous block
-#ifdef _MSC_VER
-		m_pfData = (float32*)_aligned_malloc(m_iSize * sizeof(float32), 16);
-#else
-		int ret = posix_memalign((void**)&m_pfData, 16, m_iSize * sizeof(float32));
-		ASTRA_ASSERT(ret == 0);
-#endif
-		ASTRA_ASSERT(((size_t)m_pfData & 15) == 0);
+		m_pfData = (float32*)allocateHostMemory(iBytes, DATA_ALIGNMENT);
+		if (!m_pfData) {
+			CMemoryBudget::getSingleton().release(iBytes);
+			ASTRA_ERROR("Unable to allocate %llu bytes", (unsigned long long)iBytes);
+			return false;
+		}
+		ASTRA_ASSERT(((size_t)m_pfData & (DATA_ALIGNMENT - 1)) == 0);
+		bindPages(m_pfData, (size_t)m_iPitch * m_iHeight * m_iDepth);
 	} else {
 		m_pfData = m_pCustomMemory->m_fPtr;
 	}
+
+	return true;
 }
 
 //----------------------------------------------------------------------------------------
@@ -214,11 +227,9 @@ void CFloat32Data3DMemory::_freeData()
 
 	if (!m_pCustomMemory) {
 		// free memory for data block
-#ifdef _MSC_VER
-		_aligned_free(m_pfData);
-#else
-		free(m_pfData);
-#endif
+		const size_t iBytes = (size_t)m_iPitch * m_iHeight * m_iDepth * sizeof(float32);
+		freeHostMemory(m_pfData, iBytes);
+		CMemoryBudget::getSingleton().release(iBytes);
 	} else {
 		delete m_pCustomMemory;
 		m_pCustomMemory = 0;
@@ -233,6 +244,7 @@ void CFloat32Data3DMemory::_clear()
 	m_iHeight = 0;
 	m_iDepth = 0;
 	m_iSize = 0;
+	m_iPitch = 0;
 
 	m_pfData = NULL;
 	m_pCustomMemory = NULL;
@@ -261,11 +273,7 @@ void CFloat32Data3DMemory::copyData(const float32* _pfData, size_t _iSize)
 	ASTRA_ASSERT(m_iSize == _iSize);
 
 	// copy data
-	size_t i;
-	for (i = 0; i < m_iSize; ++i)
-	{
-		m_pfData[i] = _pfData[i];
-	}
+	copyRows(m_pfData, _pfData, (size_t)m_iHeight * m_iDepth, m_iWidth, m_iPitch);
 }
 
 //----------------------------------------------------------------------------------------
@@ -278,11 +286,7 @@ void CFloat32Data3DMemory::setData(float32 _fScalar)
 	ASTRA_ASSERT(m_iSize > 0);
 
 	// copy data
-	size_t i;
-	for (i = 0; i < m_iSize; ++i)
-	{
-		m_pfData[i] = _fScalar;
-	}
+	fillRows(m_pfData, (size_t)m_iHeight * m_iDepth, m_iWidth, _fScalar, m_iPitch);
 }
 
 //----------------------------------------------------------------------------------------
@@ -295,10 +299,7 @@ void CFloat32Data3DMemory::clearData()
 	ASTRA_ASSERT(m_iSize > 0);
 
 	// set data
-	size_t i;
-	for (i = 0; i < m_iSize; ++i) {
-		m_pfData[i] = 0.0f;
-	}
+	fillRows(m_pfData, (size_t)m_iHeight * m_iDepth, m_iWidth, 0.0f, m_iPitch);
 }
 
 //----------------------------------------------------------------------------------------
@@ -306,9 +307,13 @@ void CFloat32Data3DMemory::clearData()
 CFloat32Data3D& CFloat32Data3DMemory::clampMin(float32& _fMin)
 {
 	ASTRA_ASSERT(m_bInitialized);
-	for (size_t i = 0; i < m_iSize; i++) {
-		if (m_pfData[i] < _fMin)
-			m_pfData[i] = _fMin;
+	const size_t iRows = (size_t)m_iHeight * m_iDepth;
+	for (size_t r = 0; r < iRows; r++) {
+		float32* pfRow = m_pfData + r * m_iPitch;
+		for (int x = 0; x < m_iWidth; x++) {
+			if (pfRow[x] < _fMin)
+				pfRow[x] = _fMin;
+		}
 	}
 	return (*this);
 }
@@ -316,14 +321,64 @@ CFloat32Data3D& CFloat32Data3DMemory::clampMin(float32& _fMin)
 CFloat32Data3D& CFloat32Data3DMemory::clampMax(float32& _fMax)
 {
 	ASTRA_ASSERT(m_bInitialized);
-	for (size_t i = 0; i < m_iSize; i++) {
-		if (m_pfData[i] > _fMax)
-			m_pfData[i] = _fMax;
+	const size_t iRows = (size_t)m_iHeight * m_iDepth;
+	for (size_t r = 0; r < iRows; r++) {
+		float32* pfRow = m_pfData + r * m_iPitch;
+		for (int x = 0; x < m_iWidth; x++) {
+			if (pfRow[x] > _fMax)
+				pfRow[x] = _fMax;
+		}
 	}
 	return (*this);
 }
 
+//----------------------------------------------------------------------------------------
+// Store the rows _iPitch elements apart.
+bool CFloat32Data3DMemory::setRowPitch(int _iPitch)
+{
+	ASTRA_ASSERT(m_bInitialized);
 
+	if (_iPitch == 0) {
+		const int iAlign = DATA_ALIGNMENT / sizeof(float32);
+		_iPitch = ((m_iWidth + iAlign - 1) / iAlign) * iAlign;
+	}
+	if (_iPitch < m_iWidth) {
+		ASTRA_ERROR("CFloat32Data3DMemory::setRowPitch: the pitch %d is smaller than the width %d", _iPitch, m_iWidth);
+		return false;
+	}
+	if (_iPitch == m_iPitch)
+		return true;
+	if (m_pCustomMemory) {
+		ASTRA_ERROR("CFloat32Data3DMemory::setRowPitch: custom memory can't be re-laid out");
+		return false;
+	}
 
+	const size_t iRows = (size_t)m_iHeight * m_iDepth;
+	const size_t iBytes = (size_t)_iPitch * iRows * sizeof(float32);
+	if (!CMemoryBudget::getSingleton().reserve(iBytes)) {
+		ASTRA_ERROR("Allocating %llu bytes would exceed the host memory limit", (unsigned long long)iBytes);
+		return false;
+	}
+	float32* pfData = (float32*)allocateHostMemory(iBytes, DATA_ALIGNMENT);
+	if (!pfData) {
+		CMemoryBudget::getSingleton().release(iBytes);
+		ASTRA_ERROR("Unable to allocate %llu bytes", (unsigned long long)iBytes);
+		return false;
+	}
+	bindPages(pfData, (size_t)_iPitch * iRows);
+
+	// zero the whole block including the padding, then copy the rows
+	fillRows(pfData, iRows, _iPitch, 0.0f);
+	copyRows(pfData, m_pfData, iRows, m_iWidth, _iPitch, m_iPitch);
+
+	const size_t iOldBytes = (size_t)m_iPitch * iRows * sizeof(float32);
+	freeHostMemory(m_pfData, iOldBytes);
+	CMemoryBudget::getSingleton().release(iOldBytes);
+
+	m_pfData = pfData;
+	m_iPitch = _iPitch;
+
+	return true;
+}
 
 } // end namespace astra
@@ -26,6 +26,7 @@ along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include "astra/Float32ProjectionData3DMemory.h"
+#include "astra/NumaPlacement.h"
 #include "astra/ParallelProjectionGeometry3D.h"
 
 #include <cstring>
@@ -134,7 +135,8 @@ CFloat32ProjectionData3DMemory::~CFloat32ProjectionData3DMemory()
 
 CFloat32ProjectionData3DMemory& CFloat32ProjectionData3DMemory::operator=(const CFloat32ProjectionData3DMemory& _dataIn)
 {
-	memcpy(m_pfData, _dataIn.m_pfData, sizeof(float32) * _dataIn.m_pGeometry->getDetectorTotCount());
+	ASTRA_ASSERT(m_iWidth == _dataIn.m_iWidth && m_iHeight == _dataIn.m_iHeight && m_iDepth == _dataIn.m_iDepth);
+	copyRows(m_pfData, _dataIn.m_pfData, (size_t)m_iHeight * m_iDepth, m_iWidth, m_iPitch, _dataIn.m_iPitch);
 
 	return *this;
 }
@@ -100,6 +100,8 @@ bool CForwardProjectionAlgorithm::_check()
 	ASTRA_CONFIG_CHECK(m_pProjector->isInitialized(), "ForwardProjection", "Projector Object Not Initialized.");
 	ASTRA_CONFIG_CHECK(m_pSinogram->isInitialized(), "ForwardProjection", "Projection Data Object Not Initialized.");
 	ASTRA_CONFIG_CHECK(m_pVolume->isInitialized(), "ForwardProjection", "Volume Data Object Not Initialized.");
+	ASTRA_CONFIG_CHECK(m_pSinogram->isPacked(), "ForwardProjection", "Projection Data Object has padded rows.");
+	ASTRA_CONFIG_CHECK(m_pVolume->isPacked(), "ForwardProjection", "Volume Data Object has padded rows.");
 
 	// check compatibility between projector and data classes
 	ASTRA_CONFIG_CHECK(m_pSinogram->getGeometry()->isEqual(m_pProjector->getProjectionGeometry()), "ForwardProjection", "Projection Data not compatible with the specified Projector.");
@@ -260,12 +262,14 @@ void CForwardProjectionAlgorithm::run(int _iNrIterations)
 	// check initialized
 	ASTRA_ASSERT(m_bIsInitialized);
 
+	resetAbort();
+
 	m_pSinogram->setData(0.0f);
 
 //	if (m_bUseVoxelProjector) {
 //		m_pForwardProjector->projectAllVoxels();
 //	} else {
-		m_pForwardProjector->project();
+		m_pForwardProjector->projectParallel(CAlgorithmCheckpoint(this, ALGPHASE_FP, 0.0f, 1.0f));
 //	}
 
 }
@@ -0,0 +1,176 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#include "astra/ForwardProjectionAlgorithm3D.h"
+
+#include "astra/AstraObjectManager.h"
+#include "astra/Projector3D.h"
+
+#include "astra/Logging.h"
+
+using namespace std;
+
+namespace astra {
+
+// type of the algorithm, needed to register with CAlgorithmFactory
+std::string CForwardProjectionAlgorithm3D::type = "FP3D";
+
+//----------------------------------------------------------------------------------------
+// Constructor
+CForwardProjectionAlgorithm3D::CForwardProjectionAlgorithm3D() 
+{
+	m_bIsInitialized = false;
+	m_pProjector = 0;
+	m_pProjections = 0;
+	m_pVolume = 0;
+}
+
+//----------------------------------------------------------------------------------------
+// Destructor
+CForwardProjectionAlgorithm3D::~CForwardProjectionAlgorithm3D() 
+{
+
+}
+
+//---------------------------------------------------------------------------------------
+// Initialize - Config
+bool CForwardProjectionAlgorithm3D::initialize(const Config& _cfg)
+{
+	ASTRA_ASSERT(_cfg.self);
+	ConfigStackCheck<CAlgorithm> CC("ForwardProjectionAlgorithm3D", this, _cfg);	
+
+	XMLNode node;
+	int id;
+
+	// sinogram data
+	node = _cfg.self.getSingleNode("ProjectionDataId");
+	ASTRA_CONFIG_CHECK(node, "FP3D", "No ProjectionDataId tag specified.");
+	id = node.getContentInt();
+	m_pProjections = dynamic_cast<CFloat32ProjectionData3DMemory*>(CData3DManager::getSingleton().get(id));
+	CC.markNodeParsed("ProjectionDataId");
+
+	// volume data
+	node = _cfg.self.getSingleNode("VolumeDataId");
+	ASTRA_CONFIG_CHECK(node, "FP3D", "No VolumeDataId tag specified.");
+	id = node.getContentInt();
+	m_pVolume = dynamic_cast<CFloat32VolumeData3DMemory*>(CData3DManager::getSingleton().get(id));
+	CC.markNodeParsed("VolumeDataId");
+
+	// optional: projector
+	node = _cfg.self.getSingleNode("ProjectorId");
+	m_pProjector = 0;
+	if (node) {
+		id = node.getContentInt();
+		m_pProjector = CProjector3DManager::getSingleton().get(id);
+	}
+	CC.markNodeParsed("ProjectorId");
+
+	// success
+	m_bIsInitialized = check();
+	return m_bIsInitialized;
+}
+
+//----------------------------------------------------------------------------------------
+// Initialize - C++
+bool CForwardProjectionAlgorithm3D::initialize(CProjector3D* _pProjector, 
+                                               CFloat32ProjectionData3D* _pProjections, 
+                                               CFloat32VolumeData3D* _pVolume)
+{
+	m_pProjector = _pProjector;
+	m_pProjections = dynamic_cast<CFloat32ProjectionData3DMemory*>(_pProjections);
+	m_pVolume = dynamic_cast<CFloat32VolumeData3DMemory*>(_pVolume);
+
+	// success
+	m_bIsInitialized = check();
+	return m_bIsInitialized;
+}
+
+//----------------------------------------------------------------------------------------
+// Check
+bool CForwardProjectionAlgorithm3D::check() 
+{
+	// check pointers
+	ASTRA_CONFIG_CHECK(m_pProjections, "FP3D", "Invalid Projection Data Object.");
+	ASTRA_CONFIG_CHECK(m_pVolume, "FP3D", "Invalid Volume Data Object.");
+
+	// check initializations
+	ASTRA_CONFIG_CHECK(m_pProjections->isInitialized(), "FP3D", "Projection Data Object Not Initialized.");
+	ASTRA_CONFIG_CHECK(m_pVolume->isInitialized(), "FP3D", "Volume Data Object Not Initialized.");
+	ASTRA_CONFIG_CHECK(m_pProjections->isPacked() && m_pVolume->isPacked(), "FP3D", "Data objects with a row pitch are not supported.");
+
+	// check compatibility between projector and data classes
+	if (m_pProjector) {
+		ASTRA_CONFIG_CHECK(m_pProjections->getGeometry()->isEqual(m_pProjector->getProjectionGeometry()), "FP3D", "Projection Data not compatible with the specified Projector.");
+		ASTRA_CONFIG_CHECK(m_pVolume->getGeometry()->isEqual(m_pProjector->getVolumeGeometry()), "FP3D", "Volume Data not compatible with the specified Projector.");
+	}
+
+	ASTRA_CONFIG_CHECK(m_projection.initialize(m_pProjections->getGeometry(), m_pVolume->getGeometry(), m_pProjector), "FP3D", "Unsupported geometry.");
+
+	// success
+	m_bIsInitialized = true;
+	return true;
+}
+
+//---------------------------------------------------------------------------------------
+// Information - All
+map<string,boost::any> CForwardProjectionAlgorithm3D::getInformation()
+{
+	map<string,boost::any> res;
+	res["ProjectionDataId"] = getInformation("ProjectionDataId");
+	res["VolumeDataId"] = getInformation("VolumeDataId");
+	return mergeMap<string,boost::any>(CAlgorithm::getInformation(), res);
+}
+
+//---------------------------------------------------------------------------------------
+// Information - Specific
+boost::any CForwardProjectionAlgorithm3D::getInformation(std::string _sIdentifier)
+{
+	if (_sIdentifier == "ProjectionDataId") {
+		int iIndex = CData3DManager::getSingleton().getIndex(m_pProjections);
+		if (iIndex != 0) return iIndex;
+		return std::string("not in manager");
+	}
+	if (_sIdentifier == "VolumeDataId") {
+		int iIndex = CData3DManager::getSingleton().getIndex(m_pVolume);
+		if (iIndex != 0) return iIndex;
+		return std::string("not in manager");
+	}
+	return CAlgorithm::getInformation(_sIdentifier);
+}
+
+//----------------------------------------------------------------------------------------
+// Run
+void CForwardProjectionAlgorithm3D::run(int)
+{
+	// check initialized
+	ASTRA_ASSERT(m_bIsInitialized);
+
+	if (!m_projection.forwardProject(m_pVolume, m_pProjections))
+		ASTRA_ERROR("FP3D: forward projection failed");
+}
+
+} // namespace astra
@@ -0,0 +1,181 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+#include "astra/HostMemory.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <map>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#include "astra/Mutex.h"
+#include "astra/Logging.h"
+
+namespace astra {
+
+static const size_t HUGEPAGE_2M = (size_t)1 << 21;
+static const size_t HUGEPAGE_1G = (size_t)1 << 30;
+
+//----------------------------------------------------------------------------------------
+static EHugePagePolicy policyFromEnvironment()
+{
+	const char* pcPolicy = getenv("ASTRA_HUGEPAGES");
+	if (!pcPolicy || !*pcPolicy || !strcmp(pcPolicy, "none"))
+		return HUGEPAGES_NONE;
+	if (!strcmp(pcPolicy, "thp"))
+		return HUGEPAGES_TRANSPARENT;
+	if (!strcmp(pcPolicy, "2m"))
+		return HUGEPAGES_EXPLICIT_2M;
+	if (!strcmp(pcPolicy, "1g"))
+		return HUGEPAGES_EXPLICIT_1G;
+	ASTRA_WARN("Unknown ASTRA_HUGEPAGES \"%s\", using none", pcPolicy);
+	return HUGEPAGES_NONE;
+}
+
+static EHugePagePolicy s_ePolicy = policyFromEnvironment();
+
+void setHugePagePolicy(EHugePagePolicy _ePolicy)
+{
+	s_ePolicy = _ePolicy;
+}
+
+EHugePagePolicy getHugePagePolicy()
+{
+	return s_ePolicy;
+}
+
+//----------------------------------------------------------------------------------------
+// Blocks mapped from hugetlbfs, which are freed with munmap instead of free
+static CMutex& mappedMutex()
+{
+	static CMutex s_mutex;
+	return s_mutex;
+}
+
+static std::map<void*, size_t>& mappedBlocks()
+{
+	static std::map<void*, size_t> s_blocks;
+	return s_blocks;
+}
+
+//----------------------------------------------------------------------------------------
+static void* alignedAlloc(size_t _iBytes, size_t _iAlignment)
+{
+	void* p;
+#ifdef _MSC_VER
+	p = _aligned_malloc(_iBytes, _iAlignment);
+#else
+	if (posix_memalign(&p, _iAlignment, _iBytes) != 0)
+		p = NULL;
+#endif
+	return p;
+}
+
+//----------------------------------------------------------------------------------------
+#ifdef __linux__
+static void* mapHugePages(size_t _iBytes, size_t _iPageSize)
+{
+#ifdef MAP_HUGETLB
+	// the page size is encoded as log2 in the bits from MAP_HUGE_SHIFT
+	const int iHugeShift = 26;
+	int iLog = (_iPageSize == HUGEPAGE_1G) ? 30 : 21;
+	size_t iLength = (_iBytes + _iPageSize - 1) & ~(_iPageSize - 1);
+	void* p = mmap(NULL, iLength, PROT_READ | PROT_WRITE,
+	               MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (iLog << iHugeShift), -1, 0);
+	if (p == MAP_FAILED)
+		return NULL;
+
+	CMutexLock lock(mappedMutex());
+	mappedBlocks()[p] = iLength;
+	return p;
+#else
+	return NULL;
+#endif
+}
+#endif
+
+//----------------------------------------------------------------------------------------
+void* allocateHostMemory(size_t _iBytes, size_t _iAlignment)
+{
+	const EHugePagePolicy ePolicy = s_ePolicy;
+	if (ePolicy == HUGEPAGES_NONE || _iBytes < HUGEPAGE_MIN_BYTES)
+		return alignedAlloc(_iBytes, _iAlignment);
+
+#ifdef __linux__
+	if (ePolicy == HUGEPAGES_EXPLICIT_2M || ePolicy == HUGEPAGES_EXPLICIT_1G) {
+		void* p = mapHugePages(_iBytes, ePolicy == HUGEPAGES_EXPLICIT_1G ? HUGEPAGE_1G : HUGEPAGE_2M);
+		if (p)
+			return p;
+		ASTRA_DEBUG("allocateHostMemory: no explicit huge pages available, using transparent huge pages");
+	}
+
+	// Align to a huge page, and ask for huge pages before the first touch
+	void* p = alignedAlloc(_iBytes, _iAlignment > HUGEPAGE_2M ? _iAlignment : HUGEPAGE_2M);
+#ifdef MADV_HUGEPAGE
+	if (p && madvise(p, _iBytes, MADV_HUGEPAGE) != 0)
+		ASTRA_DEBUG("allocateHostMemory: madvise(MADV_HUGEPAGE) failed");
+#endif
+	return p;
+#else
+	return alignedAlloc(_iBytes, _iAlignment);
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+void freeHostMemory(void* _pData, size_t _iBytes)
+{
+	if (!_pData)
+		return;
+
+#ifdef __linux__
+	if (_iBytes >= HUGEPAGE_MIN_BYTES) {
+		size_t iLength = 0;
+		{
+			CMutexLock lock(mappedMutex());
+			std::map<void*, size_t>::iterator it = mappedBlocks().find(_pData);
+			if (it != mappedBlocks().end()) {
+				iLength = it->second;
+				mappedBlocks().erase(it);
+			}
+		}
+		if (iLength) {
+			munmap(_pData, iLength);
+			return;
+		}
+	}
+#endif
+
+#ifdef _MSC_VER
+	_aligned_free(_pData);
+#else
+	free(_pData);
+#endif
+}
+
+} // namespace astra
@@ -0,0 +1,118 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#include "astra/LinearKernel3D.h"
+
+#include "astra/VolumeGeometry3D.h"
+#include "astra/ParallelProjectionGeometry3D.h"
+#include "astra/ParallelVecProjectionGeometry3D.h"
+#include "astra/ConeProjectionGeometry3D.h"
+#include "astra/ConeVecProjectionGeometry3D.h"
+
+namespace astra {
+
+//----------------------------------------------------------------------------------------
+void SVolumeGrid3D::set(const CVolumeGeometry3D* _pGeom)
+{
+	iCols = _pGeom->getGridColCount();
+	iRows = _pGeom->getGridRowCount();
+	iSlices = _pGeom->getGridSliceCount();
+	fMinX = _pGeom->getWindowMinX();
+	fMinY = _pGeom->getWindowMinY();
+	fMinZ = _pGeom->getWindowMinZ();
+	fPixelX = _pGeom->getPixelLengthX();
+	fPixelY = _pGeom->getPixelLengthY();
+	fPixelZ = _pGeom->getPixelLengthZ();
+}
+
+//----------------------------------------------------------------------------------------
+bool SProjectionVectors3D::set(const CProjectionGeometry3D* _pGeom)
+{
+	const CParallelProjectionGeometry3D* pPar = dynamic_cast<const CParallelProjectionGeometry3D*>(_pGeom);
+	const CParallelVecProjectionGeometry3D* pParVec = dynamic_cast<const CParallelVecProjectionGeometry3D*>(_pGeom);
+	const CConeProjectionGeometry3D* pCone = dynamic_cast<const CConeProjectionGeometry3D*>(_pGeom);
+	const CConeVecProjectionGeometry3D* pConeVec = dynamic_cast<const CConeVecProjectionGeometry3D*>(_pGeom);
+
+	iAngles = _pGeom->getProjectionCount();
+	iRows = _pGeom->getDetectorRowCount();
+	iCols = _pGeom->getDetectorColCount();
+	par.clear();
+	cone.clear();
+
+	if (pPar) {
+		SPar3DProjection* p = genPar3DProjections(iAngles, iCols, iRows,
+		                                          pPar->getDetectorSpacingX(), pPar->getDetectorSpacingY(),
+		                                          pPar->getProjectionAngles());
+		par.assign(p, p + iAngles);
+		delete[] p;
+		bCone = false;
+	} else if (pParVec) {
+		par.assign(pParVec->getProjectionVectors(), pParVec->getProjectionVectors() + iAngles);
+		bCone = false;
+	} else if (pCone) {
+		SConeProjection* p = genConeProjections(iAngles, iCols, iRows,
+		                                        pCone->getOriginSourceDistance(), pCone->getOriginDetectorDistance(),
+		                                        pCone->getDetectorSpacingX(), pCone->getDetectorSpacingY(),
+		                                        pCone->getProjectionAngles());
+		cone.assign(p, p + iAngles);
+		delete[] p;
+		bCone = true;
+	} else if (pConeVec) {
+		cone.assign(pConeVec->getProjectionVectors(), pConeVec->getProjectionVectors() + iAngles);
+		bCone = true;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+void SProjectionVectors3D::getRay(int _iAngle, int _iRow, int _iCol, double& _fX, double& _fY, double& _fZ,
+                                  double& _fDX, double& _fDY, double& _fDZ) const
+{
+	const double fU = _iCol + 0.5;
+	const double fV = _iRow + 0.5;
+	if (bCone) {
+		const SConeProjection& p = cone[_iAngle];
+		_fX = p.fSrcX;
+		_fY = p.fSrcY;
+		_fZ = p.fSrcZ;
+		_fDX = p.fDetSX + fU * p.fDetUX + fV * p.fDetVX - p.fSrcX;
+		_fDY = p.fDetSY + fU * p.fDetUY + fV * p.fDetVY - p.fSrcY;
+		_fDZ = p.fDetSZ + fU * p.fDetUZ + fV * p.fDetVZ - p.fSrcZ;
+	} else {
+		const SPar3DProjection& p = par[_iAngle];
+		_fX = p.fDetSX + fU * p.fDetUX + fV * p.fDetVX;
+		_fY = p.fDetSY + fU * p.fDetUY + fV * p.fDetVY;
+		_fZ = p.fDetSZ + fU * p.fDetUZ + fV * p.fDetVZ;
+		_fDX = p.fRayX;
+		_fDY = p.fRayY;
+		_fDZ = p.fRayZ;
+	}
+}
+
+} // end namespace astra
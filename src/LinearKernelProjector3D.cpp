@@ -0,0 +1,190 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#include "astra/LinearKernelProjector3D.h"
+
+#include <algorithm>
+
+#include "astra/VolumeGeometry3D.h"
+#include "astra/ProjectionGeometry3D.h"
+
+using namespace std;
+using namespace astra;
+
+// type of the projector, needed to register with CProjectorFactory
+std::string CLinearKernelProjector3D::type = "linear3d";
+
+//----------------------------------------------------------------------------------------
+// default constructor
+CLinearKernelProjector3D::CLinearKernelProjector3D()
+{
+	_clear();
+}
+
+//----------------------------------------------------------------------------------------
+// constructor
+CLinearKernelProjector3D::CLinearKernelProjector3D(const CProjectionGeometry3D* _pProjectionGeometry,
+                                                   const CVolumeGeometry3D* _pVolumeGeometry)
+{
+	_clear();
+	initialize(_pProjectionGeometry, _pVolumeGeometry);
+}
+
+//----------------------------------------------------------------------------------------
+// destructor
+CLinearKernelProjector3D::~CLinearKernelProjector3D()
+{
+	clear();
+}
+
+//---------------------------------------------------------------------------------------
+// Clear - Constructors
+void CLinearKernelProjector3D::_clear()
+{
+	CProjector3D::_clear();
+	m_vectors.par.clear();
+	m_vectors.cone.clear();
+	m_bIsInitialized = false;
+}
+
+//---------------------------------------------------------------------------------------
+// Clear - Public
+void CLinearKernelProjector3D::clear()
+{
+	CProjector3D::clear();
+	m_vectors.par.clear();
+	m_vectors.cone.clear();
+	m_bIsInitialized = false;
+}
+
+//---------------------------------------------------------------------------------------
+// Check
+bool CLinearKernelProjector3D::_check()
+{
+	// check base class
+	ASTRA_CONFIG_CHECK(CProjector3D::_check(), "LinearKernelProjector3D", "Error in Projector3D initialization");
+	ASTRA_CONFIG_CHECK(m_vectors.set(m_pProjectionGeometry), "LinearKernelProjector3D", "Unsupported projection geometry");
+	m_grid.set(m_pVolumeGeometry);
+
+	// success
+	return true;
+}
+
+//---------------------------------------------------------------------------------------
+// Initialize, use a Config object
+bool CLinearKernelProjector3D::initialize(const Config& _cfg)
+{
+	ASTRA_ASSERT(_cfg.self);
+
+	// if already initialized, clear first
+	if (m_bIsInitialized) {
+		clear();
+	}
+
+	// initialization of parent class
+	if (!CProjector3D::initialize(_cfg)) {
+		return false;
+	}
+
+	// success
+	m_bIsInitialized = _check();
+	return m_bIsInitialized;
+}
+
+//---------------------------------------------------------------------------------------
+// Initialize
+bool CLinearKernelProjector3D::initialize(const CProjectionGeometry3D* _pProjectionGeometry,
+                                          const CVolumeGeometry3D* _pVolumeGeometry)
+{
+	// if already initialized, clear first
+	if (m_bIsInitialized) {
+		clear();
+	}
+
+	// hardcopy geometries
+	m_pProjectionGeometry = _pProjectionGeometry->clone();
+	m_pVolumeGeometry = _pVolumeGeometry->clone();
+
+	// success
+	m_bIsInitialized = _check();
+	return m_bIsInitialized;
+}
+
+//----------------------------------------------------------------------------------------
+// Get maximum amount of weights on a single ray
+int CLinearKernelProjector3D::getProjectionWeightsCount(int _iProjectionIndex)
+{
+	int maxDim = max(m_grid.iCols, max(m_grid.iRows, m_grid.iSlices));
+	return maxDim * 4;
+}
+
+//----------------------------------------------------------------------------------------
+// Store the nonzero weights of a ray, up to the size of the buffer.
+namespace {
+struct SStoreWeights3D {
+	SPixelWeight* m_pWeights;
+	int m_iMax;
+	int m_iCount;
+	int m_iCols, m_iRows;
+
+	void operator()(int _iX, int _iY, int _iZ, float32 _fWeight) {
+		if (_fWeight == 0.0f || m_iCount >= m_iMax)
+			return;
+		m_pWeights[m_iCount].m_iIndex = (_iZ * m_iRows + _iY) * m_iCols + _iX;
+		m_pWeights[m_iCount].m_fWeight = _fWeight;
+		++m_iCount;
+	}
+};
+}
+
+//----------------------------------------------------------------------------------------
+// Single Ray Weights
+void CLinearKernelProjector3D::computeSingleRayWeights(int _iProjectionIndex, int _iSliceIndex, int _iDetectorIndex,
+                                                       SPixelWeight* _pWeightedPixels, int _iMaxPixelCount,
+                                                       int& _iStoredPixelCount)
+{
+	ASTRA_ASSERT(m_bIsInitialized);
+
+	double fX, fY, fZ, fDX, fDY, fDZ;
+	m_vectors.getRay(_iProjectionIndex, _iSliceIndex, _iDetectorIndex, fX, fY, fZ, fDX, fDY, fDZ);
+
+	SStoreWeights3D s;
+	s.m_pWeights = _pWeightedPixels;
+	s.m_iMax = _iMaxPixelCount;
+	s.m_iCount = 0;
+	s.m_iCols = m_grid.iCols;
+	s.m_iRows = m_grid.iRows;
+	traceLinearRay3D(m_grid, fX, fY, fZ, fDX, fDY, fDZ, s);
+	_iStoredPixelCount = s.m_iCount;
+}
+
+//----------------------------------------------------------------------------------------
+// description
+std::string CLinearKernelProjector3D::description() const
+{
+	return "";
+}
@@ -29,11 +29,295 @@ along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
 #include <astra/clog.h>
 
 #include <astra/Logging.h>
+#include <astra/Mutex.h>
 
 #include <cstdio>
+#include <cstring>
+
+#ifdef USE_PTHREADS
+#include <pthread.h>
+#else
+#include <boost/thread.hpp>
+#endif
 
 using namespace astra;
 
+namespace {
+
+#ifdef _MSC_VER
+inline bool atomicCAS(volatile long* p, long oldval, long newval) { return InterlockedCompareExchange(p, newval, oldval) == oldval; }
+inline long atomicExchange(volatile long* p, long val) { return InterlockedExchange(p, val); }
+inline void atomicIncrement(volatile long* p) { InterlockedIncrement(p); }
+inline void memoryBarrier() { MemoryBarrier(); }
+#else
+inline bool atomicCAS(volatile long* p, long oldval, long newval) { return __sync_bool_compare_and_swap(p, oldval, newval); }
+inline long atomicExchange(volatile long* p, long val) { return __sync_lock_test_and_set(p, val); }
+inline void atomicIncrement(volatile long* p) { __sync_fetch_and_add(p, 1); }
+inline void memoryBarrier() { __sync_synchronize(); }
+#endif
+
+/**
+ * Bounded multi-producer queue of formatted log messages.
+ *
+ * Producers claim a slot with a single compare-and-swap and never wait;
+ * when the queue is full the message is dropped and counted. A background
+ * thread (or flush()) drains the queue and writes the messages to clog.
+ * The thread sleeps on a condition variable while the queue is empty, and
+ * producers only take the lock to wake it when it is sleeping.
+ */
+class CLogQueue {
+public:
+	CLogQueue();
+	~CLogQueue();
+
+	/** Queue a message. Returns false if it has to be written synchronously
+	 *  instead because it doesn't fit in a slot. */
+	bool push(log_level eLevel, const char *sfile, int sline, bool bScreen, bool bFile, const char *fmt, va_list ap);
+
+	/** Write all queued messages. */
+	void drain();
+
+	/** Write all queued messages and keep the writer locked out until
+	 *  unlock(), while the clog outputs are changed. Nothing may be logged
+	 *  in between. */
+	void drainAndLock();
+	void unlock() { m_mutex.unlock(); }
+
+	void threadLoop();
+
+private:
+	enum { QUEUE_SIZE = 1024, TEXT_SIZE = 512, FILE_SIZE = 128 };
+
+	struct SSlot {
+		volatile long iSequence;
+		log_level eLevel;
+		int iLine;
+		bool bScreen;
+		bool bFile;
+		char sFile[FILE_SIZE];
+		char sText[TEXT_SIZE];
+	};
+
+	void _start();
+	void _write();
+	bool _hasWork();
+	void _wake();
+
+	SSlot m_slots[QUEUE_SIZE];
+	volatile long m_iEnqueue;
+	long m_iDequeue;
+	volatile long m_iDropped;
+	volatile long m_iStarted;
+	volatile bool m_bStopping;
+	volatile long m_iSleeping;
+
+	// Protects m_iDequeue and the clog outputs
+	CMutex m_mutex;
+	// Protects the writer going to sleep
+	CMutex m_wakeMutex;
+	CCondition m_condWake;
+#ifdef USE_PTHREADS
+	pthread_t m_thread;
+#else
+	boost::thread* m_pThread;
+#endif
+};
+
+CLogQueue g_logQueue;
+
+#ifdef USE_PTHREADS
+void* runLogThread_pthreads(void* data)
+{
+	((CLogQueue*)data)->threadLoop();
+	return 0;
+}
+#else
+void runLogThread_boost(CLogQueue* queue)
+{
+	queue->threadLoop();
+}
+#endif
+
+CLogQueue::CLogQueue()
+{
+	for (long i = 0; i < QUEUE_SIZE; ++i)
+		m_slots[i].iSequence = i;
+	m_iEnqueue = 0;
+	m_iDequeue = 0;
+	m_iDropped = 0;
+	m_iStarted = 0;
+	m_bStopping = false;
+	m_iSleeping = 0;
+#ifndef USE_PTHREADS
+	m_pThread = 0;
+#endif
+}
+
+CLogQueue::~CLogQueue()
+{
+	if (m_iStarted) {
+		m_bStopping = true;
+		_wake();
+#ifdef USE_PTHREADS
+		pthread_join(m_thread, 0);
+#else
+		m_pThread->join();
+		delete m_pThread;
+#endif
+	}
+	// Anything logged from here on is written directly
+	CLogger::setAsync(false);
+}
+
+void CLogQueue::_start()
+{
+	if (m_iStarted || !atomicCAS(&m_iStarted, 0, 1))
+		return;
+#ifdef USE_PTHREADS
+	pthread_create(&m_thread, 0, runLogThread_pthreads, (void*)this);
+#else
+	m_pThread = new boost::thread(runLogThread_boost, this);
+#endif
+}
+
+bool CLogQueue::push(log_level eLevel, const char *sfile, int sline, bool bScreen, bool bFile, const char *fmt, va_list ap)
+{
+	// Format before claiming a slot, so a claimed slot is filled quickly
+	char text[TEXT_SIZE];
+	va_list ap2;
+	va_copy(ap2, ap);
+	int n = vsnprintf(text, TEXT_SIZE, fmt, ap2);
+	va_end(ap2);
+	if (n < 0 || n >= TEXT_SIZE)
+		return false;
+
+	_start();
+
+	long pos = m_iEnqueue;
+	SSlot* slot;
+	while (true) {
+		slot = &m_slots[pos & (QUEUE_SIZE - 1)];
+		long seq = slot->iSequence;
+		memoryBarrier();
+		long dif = (long)((unsigned long)seq - (unsigned long)pos);
+		if (dif == 0) {
+			if (atomicCAS(&m_iEnqueue, pos, pos + 1))
+				break;
+			pos = m_iEnqueue;
+		} else if (dif < 0) {
+			// Full
+			atomicIncrement(&m_iDropped);
+			return true;
+		} else {
+			pos = m_iEnqueue;
+		}
+	}
+
+	slot->eLevel = eLevel;
+	slot->iLine = sline;
+	slot->bScreen = bScreen;
+	slot->bFile = bFile;
+	strncpy(slot->sFile, sfile, FILE_SIZE - 1);
+	slot->sFile[FILE_SIZE - 1] = 0;
+	memcpy(slot->sText, text, n + 1);
+	memoryBarrier();
+	slot->iSequence = pos + 1;
+
+	// Wake the writer if it is waiting for messages. The barrier orders the
+	// publication above before the check, see threadLoop().
+	memoryBarrier();
+	if (m_iSleeping)
+		_wake();
+
+	return true;
+}
+
+void CLogQueue::_wake()
+{
+	CMutexLock lock(m_wakeMutex);
+	m_condWake.notifyAll();
+}
+
+bool CLogQueue::_hasWork()
+{
+	CMutexLock lock(m_mutex);
+	return m_slots[m_iDequeue & (QUEUE_SIZE - 1)].iSequence == m_iDequeue + 1;
+}
+
+// Write the queued messages. Must be called with m_mutex held.
+void CLogQueue::_write()
+{
+	while (true) {
+		SSlot* slot = &m_slots[m_iDequeue & (QUEUE_SIZE - 1)];
+		long seq = slot->iSequence;
+		memoryBarrier();
+		if (seq != m_iDequeue + 1)
+			break;
+
+		if (slot->bScreen)
+			clog_write(slot->sFile, slot->iLine, (clog_level)slot->eLevel, 0, slot->sText);
+		if (slot->bFile)
+			clog_write(slot->sFile, slot->iLine, (clog_level)slot->eLevel, 1, slot->sText);
+
+		memoryBarrier();
+		slot->iSequence = m_iDequeue + QUEUE_SIZE;
+		m_iDequeue++;
+	}
+}
+
+void CLogQueue::drain()
+{
+	m_mutex.lock();
+	_write();
+	long dropped = m_iDropped ? atomicExchange(&m_iDropped, 0) : 0;
+	m_mutex.unlock();
+
+	if (dropped)
+		CLogger::warn(__FILE__, __LINE__, "%ld log messages dropped because the log queue was full", dropped);
+}
+
+void CLogQueue::drainAndLock()
+{
+	// The dropped count is reported by the next drain()
+	m_mutex.lock();
+	_write();
+}
+
+void CLogQueue::threadLoop()
+{
+	while (!m_bStopping) {
+		drain();
+
+		// Announce that we're going to sleep before checking for messages
+		// again: a producer either publishes before the check, or sees
+		// m_iSleeping and notifies, which can't happen before the wait as
+		// we hold m_wakeMutex.
+		m_wakeMutex.lock();
+		m_iSleeping = 1;
+		memoryBarrier();
+		if (!m_bStopping && !_hasWork())
+			m_condWake.wait(m_wakeMutex);
+		m_iSleeping = 0;
+		m_wakeMutex.unlock();
+	}
+	drain();
+}
+
+/**
+ * Keeps the background writer from writing while the clog outputs are
+ * changed, after writing everything queued so far.
+ */
+class CLogWriterLock {
+public:
+	CLogWriterLock() { g_logQueue.drainAndLock(); }
+	~CLogWriterLock() { g_logQueue.unlock(); }
+private:
+	CLogWriterLock(const CLogWriterLock&);
+	CLogWriterLock& operator=(const CLogWriterLock&);
+};
+
+}
+
 void CLogger::enableScreen()
 {
 	m_bEnabledScreen = true;
@@ -68,70 +352,100 @@ void CLogger::disable()
 
 void CLogger::debug(const char *sfile, int sline, const char *fmt, ...)
 {
-	_assureIsInitialized();
-	va_list ap, apf;
-	if(m_bEnabledScreen){
-        va_start(ap, fmt);
-        clog_debug(sfile,sline,0,fmt,ap);
-        va_end(ap);
-    }
-	if(m_bEnabledFile && m_bFileProvided){
-        va_start(apf, fmt);
-        clog_debug(sfile,sline,1,fmt,apf);
-        va_end(apf);
-    }
+	va_list ap;
+	va_start(ap, fmt);
+	_log(LOG_DEBUG, sfile, sline, fmt, ap);
+	va_end(ap);
 }
 
 void CLogger::info(const char *sfile, int sline, const char *fmt, ...)
 {
-	_assureIsInitialized();
-	va_list ap, apf;
-	if(m_bEnabledScreen){
-        va_start(ap, fmt);
-        clog_info(sfile,sline,0,fmt,ap);
-        va_end(ap);
-    }
-	if(m_bEnabledFile && m_bFileProvided){
-        va_start(apf, fmt);
-        clog_info(sfile,sline,1,fmt,apf);
-        va_end(apf);
-    }
+	va_list ap;
+	va_start(ap, fmt);
+	_log(LOG_INFO, sfile, sline, fmt, ap);
+	va_end(ap);
 }
 
 void CLogger::warn(const char *sfile, int sline, const char *fmt, ...)
 {
-	_assureIsInitialized();
-	va_list ap, apf;
-	if(m_bEnabledScreen){
-        va_start(ap, fmt);
-        clog_warn(sfile,sline,0,fmt,ap);
-        va_end(ap);
-    }
-	if(m_bEnabledFile && m_bFileProvided){
-        va_start(apf, fmt);
-        clog_warn(sfile,sline,1,fmt,apf);
-        va_end(apf);
-    }
+	va_list ap;
+	va_start(ap, fmt);
+	_log(LOG_WARN, sfile, sline, fmt, ap);
+	va_end(ap);
 }
 
 void CLogger::error(const char *sfile, int sline, const char *fmt, ...)
+{
+	va_list ap;
+	va_start(ap, fmt);
+	_log(LOG_ERROR, sfile, sline, fmt, ap);
+	va_end(ap);
+}
+
+void CLogger::_log(log_level m_eLevel, const char *sfile, int sline, const char *fmt, va_list ap)
 {
 	_assureIsInitialized();
-	va_list ap, apf;
-	if(m_bEnabledScreen){
-        va_start(ap, fmt);
-        clog_error(sfile,sline,0,fmt,ap);
-        va_end(ap);
-    }
-	if(m_bEnabledFile && m_bFileProvided){
-        va_start(apf, fmt);
-        clog_error(sfile,sline,1,fmt,apf);
-        va_end(apf);
-    }
+
+	// Decide on the calling thread which outputs get the message, so
+	// messages below the output levels cost nothing more than this check.
+	bool bScreen = m_bEnabledScreen && m_eLevel >= m_eLevelScreen;
+	bool bFile = m_bEnabledFile && m_bFileProvided && m_eLevel >= m_eLevelFile;
+	if (!bScreen && !bFile)
+		return;
+
+	// Errors are written immediately, after anything still queued, so they
+	// aren't lost if the error is fatal
+	bool bAsync = m_bAsync && m_eLevel < LOG_ERROR;
+	if (m_bAsync && !bAsync)
+		flush();
+
+	// A screen callback has to be called from this thread
+	bool bSyncScreen = bScreen && (m_bCallbackScreen || !bAsync);
+	if (bSyncScreen) {
+		va_list ap2;
+		va_copy(ap2, ap);
+		_clog_log(sfile, sline, (clog_level)m_eLevel, 0, fmt, ap2);
+		va_end(ap2);
+		bScreen = false;
+	}
+
+	if (!bScreen && !bFile)
+		return;
+
+	if (!bAsync || !g_logQueue.push(m_eLevel, sfile, sline, bScreen, bFile, fmt, ap)) {
+		// Synchronous mode, or the message doesn't fit in a queue slot
+		va_list ap2;
+		if (bScreen) {
+			va_copy(ap2, ap);
+			_clog_log(sfile, sline, (clog_level)m_eLevel, 0, fmt, ap2);
+			va_end(ap2);
+		}
+		if (bFile) {
+			va_copy(ap2, ap);
+			_clog_log(sfile, sline, (clog_level)m_eLevel, 1, fmt, ap2);
+			va_end(ap2);
+		}
+	}
+}
+
+void CLogger::setAsync(bool async)
+{
+	if (!async)
+		flush();
+	m_bAsync = async;
+}
+
+void CLogger::flush()
+{
+	g_logQueue.drain();
 }
 
 void CLogger::_setLevel(int id, log_level m_eLevel)
 {
+	if (id == 0)
+		m_eLevelScreen = m_eLevel;
+	else
+		m_eLevelFile = m_eLevel;
 	switch(m_eLevel){
 		case LOG_DEBUG:
 			clog_set_level(id,CLOG_DEBUG);
@@ -151,16 +465,22 @@ void CLogger::_setLevel(int id, log_level m_eLevel)
 void CLogger::setOutputScreen(int fd, log_level m_eLevel)
 {
 	_assureIsInitialized();
-	if(fd==1||fd==2){
-		clog_set_fd(0, fd);
-	}else{
-		error(__FILE__,__LINE__,"Invalid file descriptor");
+	bool bValid = (fd==1||fd==2);
+	{
+		// Queued messages still go to the old output
+		CLogWriterLock lock;
+		if(bValid)
+			clog_set_fd(0, fd);
+		_setLevel(0,m_eLevel);
 	}
-	_setLevel(0,m_eLevel);
+	if(!bValid)
+		error(__FILE__,__LINE__,"Invalid file descriptor");
 }
 
 void CLogger::setOutputFile(const char *filename, log_level m_eLevel)
 {
+	// Queued messages still refer to the old file
+	CLogWriterLock lock;
 	if(m_bFileProvided){
 		clog_free(1);
 		m_bFileProvided=false;
@@ -176,7 +496,7 @@ void CLogger::_assureIsInitialized()
 	if(!m_bInitialized)
 	{
 		clog_init_fd(0, 2);
-		clog_set_level(0, CLOG_INFO);
+		_setLevel(0, LOG_INFO);
 		clog_set_fmt(0, "%l: %m\n");
 		m_bInitialized = true;
 	}
@@ -185,6 +505,7 @@ void CLogger::_assureIsInitialized()
 void CLogger::setFormatFile(const char *fmt)
 {
 	if(m_bFileProvided){
+		CLogWriterLock lock;
 		clog_set_fmt(1,fmt);
 	}else{
 		error(__FILE__,__LINE__,"No log file specified");
@@ -192,6 +513,7 @@ void CLogger::setFormatFile(const char *fmt)
 }
 void CLogger::setFormatScreen(const char *fmt)
 {
+	CLogWriterLock lock;
 	clog_set_fmt(0,fmt);
 }
 
@@ -202,10 +524,18 @@ CLogger::CLogger()
 
 bool CLogger::setCallbackScreen(void (*cb)(const char *msg, size_t len)){
 	_assureIsInitialized();
-	return clog_set_cb(0,cb)==0;
+	CLogWriterLock lock;
+	if (clog_set_cb(0,cb)!=0)
+		return false;
+	m_bCallbackScreen = (cb != 0);
+	return true;
 }
 
 bool CLogger::m_bEnabledScreen = true;
 bool CLogger::m_bEnabledFile = true;
 bool CLogger::m_bFileProvided = false;
 bool CLogger::m_bInitialized = false;
+bool CLogger::m_bAsync = true;
+bool CLogger::m_bCallbackScreen = false;
+log_level CLogger::m_eLevelScreen = LOG_INFO;
+log_level CLogger::m_eLevelFile = LOG_INFO;
@@ -0,0 +1,121 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#include "astra/MemoryBudget.h"
+
+#include <cstdlib>
+
+namespace astra {
+
+DEFINE_SINGLETON(CMemoryBudget)
+
+namespace {
+
+// Construct the budget when the library is loaded, since it is used from
+// worker threads and the lazy construction in Singleton is not thread-safe.
+struct SConstructBudget {
+	SConstructBudget() { CMemoryBudget::getSingleton(); }
+};
+
+SConstructBudget g_constructBudget;
+
+}
+
+//----------------------------------------------------------------------------------------
+CMemoryBudget::CMemoryBudget()
+{
+	m_iUsed = 0;
+	m_iPeak = 0;
+	m_iLimit = 0;
+
+	const char* pcLimit = getenv("ASTRA_MEMORY_LIMIT");
+	if (pcLimit && *pcLimit)
+		m_iLimit = (size_t)strtoull(pcLimit, 0, 10);
+}
+
+CMemoryBudget::~CMemoryBudget()
+{
+
+}
+
+//----------------------------------------------------------------------------------------
+bool CMemoryBudget::reserve(size_t _iBytes)
+{
+	CMutexLock lock(m_mutex);
+	if (m_iLimit > 0 && (_iBytes > m_iLimit || m_iUsed > m_iLimit - _iBytes))
+		return false;
+	m_iUsed += _iBytes;
+	if (m_iUsed > m_iPeak)
+		m_iPeak = m_iUsed;
+	return true;
+}
+
+void CMemoryBudget::release(size_t _iBytes)
+{
+	CMutexLock lock(m_mutex);
+	ASTRA_ASSERT(_iBytes <= m_iUsed);
+	m_iUsed -= _iBytes;
+}
+
+bool CMemoryBudget::fits(size_t _iBytes)
+{
+	CMutexLock lock(m_mutex);
+	return m_iLimit == 0 || (_iBytes <= m_iLimit && m_iUsed <= m_iLimit - _iBytes);
+}
+
+//----------------------------------------------------------------------------------------
+void CMemoryBudget::setLimit(size_t _iBytes)
+{
+	CMutexLock lock(m_mutex);
+	m_iLimit = _iBytes;
+}
+
+size_t CMemoryBudget::getLimit()
+{
+	CMutexLock lock(m_mutex);
+	return m_iLimit;
+}
+
+size_t CMemoryBudget::getUsed()
+{
+	CMutexLock lock(m_mutex);
+	return m_iUsed;
+}
+
+size_t CMemoryBudget::getPeak()
+{
+	CMutexLock lock(m_mutex);
+	return m_iPeak;
+}
+
+void CMemoryBudget::resetPeak()
+{
+	CMutexLock lock(m_mutex);
+	m_iPeak = m_iUsed;
+}
+
+} // end namespace
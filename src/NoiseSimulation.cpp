@@ -0,0 +1,287 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+#include "astra/NoiseSimulation.h"
+
+#include <cmath>
+
+#include "astra/Float32ProjectionData2D.h"
+#include "astra/Float32ProjectionData3DMemory.h"
+#include "astra/WorkerPool.h"
+#include "astra/Logging.h"
+
+namespace astra {
+
+// number of elements per task
+static const int NOISE_CHUNK_SIZE = 4096;
+
+//----------------------------------------------------------------------------------------
+// Philox4x32-10 counter-based generator (Salmon et al., SC'11). The
+// counter is (element index, stream, block), so every element has its own
+// sequence of random numbers that does not depend on the order in which
+// the elements are processed.
+class CElementRandom {
+public:
+	CElementRandom(uint64_t _iSeed, unsigned int _iStream, uint64_t _iElement)
+	{
+		m_iKey[0] = (uint32_t)_iSeed;
+		m_iKey[1] = (uint32_t)(_iSeed >> 32);
+		m_iCounter[0] = (uint32_t)_iElement;
+		m_iCounter[1] = (uint32_t)(_iElement >> 32);
+		m_iCounter[2] = _iStream;
+		m_iCounter[3] = 0;
+		m_iPos = 4;
+	}
+
+	uint32_t next()
+	{
+		if (m_iPos == 4) {
+			generate();
+			m_iCounter[3]++;
+			m_iPos = 0;
+		}
+		return m_iBlock[m_iPos++];
+	}
+
+	/** Uniform number in the open interval (0,1). */
+	double uniform()
+	{
+		return (next() + 0.5) * (1.0 / 4294967296.0);
+	}
+
+private:
+	void generate()
+	{
+		uint32_t c[4] = { m_iCounter[0], m_iCounter[1], m_iCounter[2], m_iCounter[3] };
+		uint32_t k0 = m_iKey[0], k1 = m_iKey[1];
+		for (int r = 0; r < 10; ++r) {
+			uint64_t p0 = (uint64_t)0xD2511F53u * c[0];
+			uint64_t p1 = (uint64_t)0xCD9E8D57u * c[2];
+			uint32_t n0 = (uint32_t)(p1 >> 32) ^ c[1] ^ k0;
+			uint32_t n2 = (uint32_t)(p0 >> 32) ^ c[3] ^ k1;
+			c[0] = n0;
+			c[1] = (uint32_t)p1;
+			c[2] = n2;
+			c[3] = (uint32_t)p0;
+			k0 += 0x9E3779B9u;
+			k1 += 0xBB67AE85u;
+		}
+		for (int i = 0; i < 4; ++i)
+			m_iBlock[i] = c[i];
+	}
+
+	uint32_t m_iKey[2];
+	uint32_t m_iCounter[4];
+	uint32_t m_iBlock[4];
+	int m_iPos;
+};
+
+//----------------------------------------------------------------------------------------
+// Poisson sample with mean _fLambda. Small means use Knuth's product of
+// uniforms, larger ones the PTRS transformed rejection method of Hormann
+// (1993), which needs about 1.2 pairs of uniforms per sample.
+static double samplePoisson(CElementRandom& _rng, double _fLambda)
+{
+	if (_fLambda <= 0.0)
+		return 0.0;
+
+	if (_fLambda < 10.0) {
+		const double fLimit = exp(-_fLambda);
+		double fProduct = _rng.uniform();
+		double k = 0.0;
+		while (fProduct > fLimit) {
+			fProduct *= _rng.uniform();
+			k += 1.0;
+		}
+		return k;
+	}
+
+	const double fSqrtLambda = sqrt(_fLambda);
+	const double fLogLambda = log(_fLambda);
+	const double b = 0.931 + 2.53 * fSqrtLambda;
+	const double a = -0.059 + 0.02483 * b;
+	const double fInvAlpha = 1.1239 + 1.1328 / (b - 3.4);
+	const double fVr = 0.9277 - 3.6224 / (b - 2.0);
+
+	for (;;) {
+		const double U = _rng.uniform() - 0.5;
+		const double V = _rng.uniform();
+		const double us = 0.5 - fabs(U);
+		const double k = floor((2.0 * a / us + b) * U + _fLambda + 0.43);
+		if (us >= 0.07 && V <= fVr)
+			return k;
+		if (k < 0.0 || (us < 0.013 && V > us))
+			continue;
+		if (log(V) + log(fInvAlpha) - log(a / (us * us) + b) <= -_fLambda + k * fLogLambda - lgamma(k + 1.0))
+			return k;
+	}
+}
+
+//----------------------------------------------------------------------------------------
+struct SPoissonNoiseFunctor {
+	float32* m_pfData;
+	size_t m_iSize;
+	double m_fI0;
+	double m_fScale;
+	uint64_t m_iSeed;
+	unsigned int m_iStream;
+
+	void operator()(int _iFrom, int _iTo) const {
+		size_t iEnd = (size_t)_iTo * NOISE_CHUNK_SIZE;
+		if (iEnd > m_iSize)
+			iEnd = m_iSize;
+		for (size_t i = (size_t)_iFrom * NOISE_CHUNK_SIZE; i < iEnd; ++i) {
+			CElementRandom rng(m_iSeed, m_iStream, i);
+			double fCount = samplePoisson(rng, m_fI0 * exp(-m_fScale * m_pfData[i]));
+			if (fCount < 1.0)
+				fCount = 1.0;
+			m_pfData[i] = (float32)(-log(fCount / m_fI0) / m_fScale);
+		}
+	}
+};
+
+//----------------------------------------------------------------------------------------
+// Box-Muller gives two normal samples per pair of uniforms, so elements
+// 2j and 2j+1 share the counter of element 2j.
+struct SGaussianNoiseFunctor {
+	float32* m_pfData;
+	size_t m_iSize;
+	double m_fSigma;
+	uint64_t m_iSeed;
+	unsigned int m_iStream;
+
+	void operator()(int _iFrom, int _iTo) const {
+		size_t iEnd = (size_t)_iTo * NOISE_CHUNK_SIZE;
+		if (iEnd > m_iSize)
+			iEnd = m_iSize;
+		for (size_t i = (size_t)_iFrom * NOISE_CHUNK_SIZE; i < iEnd; i += 2) {
+			CElementRandom rng(m_iSeed, m_iStream, i);
+			const double r = m_fSigma * sqrt(-2.0 * log(rng.uniform()));
+			const double t = 6.283185307179586 * rng.uniform();
+			m_pfData[i] += (float32)(r * cos(t));
+			if (i + 1 < iEnd)
+				m_pfData[i + 1] += (float32)(r * sin(t));
+		}
+	}
+};
+
+//----------------------------------------------------------------------------------------
+static int chunkCount(size_t _iSize)
+{
+	return (int)((_iSize + NOISE_CHUNK_SIZE - 1) / NOISE_CHUNK_SIZE);
+}
+
+//----------------------------------------------------------------------------------------
+bool addPoissonNoise(float32* _pfData, size_t _iSize, float32 _fI0, float32 _fScale,
+                     uint64_t _iSeed, unsigned int _iStream)
+{
+	if (!(_fI0 > 0.0f) || !(_fScale > 0.0f)) {
+		ASTRA_ERROR("addPoissonNoise: I0 and scale must be positive");
+		return false;
+	}
+
+	SPoissonNoiseFunctor f;
+	f.m_pfData = _pfData;
+	f.m_iSize = _iSize;
+	f.m_fI0 = _fI0;
+	f.m_fScale = _fScale;
+	f.m_iSeed = _iSeed;
+	f.m_iStream = _iStream;
+	CWorkerPool::getSingleton().parallelFor(0, chunkCount(_iSize), f);
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+bool addGaussianNoise(float32* _pfData, size_t _iSize, float32 _fSigma,
+                      uint64_t _iSeed, unsigned int _iStream)
+{
+	if (!(_fSigma >= 0.0f)) {
+		ASTRA_ERROR("addGaussianNoise: sigma must not be negative");
+		return false;
+	}
+
+	SGaussianNoiseFunctor f;
+	f.m_pfData = _pfData;
+	f.m_iSize = _iSize;
+	f.m_fSigma = _fSigma;
+	f.m_iSeed = _iSeed;
+	f.m_iStream = _iStream;
+	CWorkerPool::getSingleton().parallelFor(0, chunkCount(_iSize), f);
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+bool addPoissonNoise(CFloat32ProjectionData2D* _pData, float32 _fI0, float32 _fScale,
+                     uint64_t _iSeed, unsigned int _iStream)
+{
+	// the noise is generated per element index, so padding is not supported
+	if (!_pData->isPacked()) {
+		ASTRA_ERROR("addPoissonNoise: data objects with padded rows are not supported");
+		return false;
+	}
+	if (!addPoissonNoise(_pData->getData(), _pData->getSize(), _fI0, _fScale, _iSeed, _iStream))
+		return false;
+	_pData->updateStatistics();
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+bool addPoissonNoise(CFloat32ProjectionData3DMemory* _pData, float32 _fI0, float32 _fScale,
+                     uint64_t _iSeed, unsigned int _iStream)
+{
+	if (!_pData->isPacked()) {
+		ASTRA_ERROR("addPoissonNoise: data objects with padded rows are not supported");
+		return false;
+	}
+	return addPoissonNoise(_pData->getData(), _pData->getSize(), _fI0, _fScale, _iSeed, _iStream);
+}
+
+//----------------------------------------------------------------------------------------
+bool addGaussianNoise(CFloat32ProjectionData2D* _pData, float32 _fSigma,
+                      uint64_t _iSeed, unsigned int _iStream)
+{
+	if (!_pData->isPacked()) {
+		ASTRA_ERROR("addGaussianNoise: data objects with padded rows are not supported");
+		return false;
+	}
+	if (!addGaussianNoise(_pData->getData(), _pData->getSize(), _fSigma, _iSeed, _iStream))
+		return false;
+	_pData->updateStatistics();
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+bool addGaussianNoise(CFloat32ProjectionData3DMemory* _pData, float32 _fSigma,
+                      uint64_t _iSeed, unsigned int _iStream)
+{
+	if (!_pData->isPacked()) {
+		ASTRA_ERROR("addGaussianNoise: data objects with padded rows are not supported");
+		return false;
+	}
+	return addGaussianNoise(_pData->getData(), _pData->getSize(), _fSigma, _iSeed, _iStream);
+}
+
+} // namespace astra
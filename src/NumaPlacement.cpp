@@ -0,0 +1,219 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+#include "astra/NumaPlacement.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <vector>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+#include "astra/WorkerPool.h"
+#include "astra/Logging.h"
+
+namespace astra {
+
+//----------------------------------------------------------------------------------------
+static ENumaPolicy policyFromEnvironment()
+{
+	const char* pcPolicy = getenv("ASTRA_NUMA_POLICY");
+	if (!pcPolicy || !*pcPolicy || !strcmp(pcPolicy, "firsttouch"))
+		return NUMA_FIRST_TOUCH;
+	if (!strcmp(pcPolicy, "interleave"))
+		return NUMA_INTERLEAVE;
+	if (!strcmp(pcPolicy, "local"))
+		return NUMA_LOCAL;
+	ASTRA_WARN("Unknown ASTRA_NUMA_POLICY \"%s\", using firsttouch", pcPolicy);
+	return NUMA_FIRST_TOUCH;
+}
+
+static ENumaPolicy s_ePolicy = policyFromEnvironment();
+
+void setNumaPolicy(ENumaPolicy _ePolicy)
+{
+	s_ePolicy = _ePolicy;
+}
+
+ENumaPolicy getNumaPolicy()
+{
+	return s_ePolicy;
+}
+
+//----------------------------------------------------------------------------------------
+// The online nodes as a bit mask, from sysfs, for example "0-1" or "0,2-3".
+static std::vector<unsigned long> readOnlineNodes()
+{
+	std::vector<unsigned long> mask;
+#ifdef __linux__
+	FILE* f = fopen("/sys/devices/system/node/online", "r");
+	if (!f)
+		return mask;
+	char acLine[256];
+	if (fgets(acLine, sizeof(acLine), f)) {
+		const size_t iBits = 8 * sizeof(unsigned long);
+		char* pc = acLine;
+		while (*pc && *pc != '\n') {
+			long iFrom = strtol(pc, &pc, 10);
+			long iTo = iFrom;
+			if (*pc == '-')
+				iTo = strtol(pc + 1, &pc, 10);
+			for (long i = iFrom; i <= iTo && i >= 0; ++i) {
+				if (mask.size() <= (size_t)i / iBits)
+					mask.resize(i / iBits + 1, 0);
+				mask[i / iBits] |= 1UL << (i % iBits);
+			}
+			if (*pc == ',')
+				++pc;
+			else
+				break;
+		}
+	}
+	fclose(f);
+#endif
+	return mask;
+}
+
+static const std::vector<unsigned long>& getOnlineNodes()
+{
+	static std::vector<unsigned long> s_mask = readOnlineNodes();
+	return s_mask;
+}
+
+int getNumaNodeCount()
+{
+	const std::vector<unsigned long>& mask = getOnlineNodes();
+	int iCount = 0;
+	for (size_t i = 0; i < mask.size(); ++i)
+		for (unsigned long m = mask[i]; m; m &= m - 1)
+			++iCount;
+	return iCount > 0 ? iCount : 1;
+}
+
+//----------------------------------------------------------------------------------------
+void bindPages(float32* _pfData, size_t _iSize)
+{
+	if (s_ePolicy != NUMA_INTERLEAVE || _iSize * sizeof(float32) < NUMA_MIN_BYTES)
+		return;
+	if (getNumaNodeCount() < 2)
+		return;
+
+#if defined(__linux__) && defined(SYS_mbind)
+	// mbind works on whole pages, so bind the pages inside the block
+	const size_t iPage = (size_t)sysconf(_SC_PAGESIZE);
+	size_t iStart = ((size_t)_pfData + iPage - 1) & ~(iPage - 1);
+	size_t iEnd = ((size_t)(_pfData + _iSize)) & ~(iPage - 1);
+	if (iEnd <= iStart)
+		return;
+
+	const int iInterleave = 3; // MPOL_INTERLEAVE from <numaif.h>
+	const std::vector<unsigned long>& mask = getOnlineNodes();
+	if (syscall(SYS_mbind, iStart, iEnd - iStart, iInterleave, &mask[0],
+	            mask.size() * 8 * sizeof(unsigned long) + 1, 0) != 0)
+		ASTRA_DEBUG("bindPages: mbind failed, using the default placement");
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+struct SFillRowsFunctor {
+	float32* m_pfDst;
+	const float32* m_pfSrc;
+	size_t m_iRowSize;
+	size_t m_iDstPitch;
+	size_t m_iSrcPitch;
+	float32 m_fValue;
+
+	void operator()(int _iFrom, int _iTo) const {
+		// packed rows are processed as one block
+		size_t iRows = _iTo - _iFrom;
+		size_t iRowSize = m_iRowSize;
+		if (m_iDstPitch == m_iRowSize && (!m_pfSrc || m_iSrcPitch == m_iRowSize)) {
+			iRowSize *= iRows;
+			iRows = 1;
+		}
+		for (size_t r = 0; r < iRows; ++r) {
+			float32* pfDst = m_pfDst + (_iFrom + r) * m_iDstPitch;
+			if (m_pfSrc) {
+				memcpy(pfDst, m_pfSrc + (_iFrom + r) * m_iSrcPitch, iRowSize * sizeof(float32));
+			} else {
+				for (size_t i = 0; i < iRowSize; ++i)
+					pfDst[i] = m_fValue;
+			}
+		}
+	}
+};
+
+// Process the rows in the same contiguous ranges as parallelFor over the
+// rows, unless the block is small or the policy keeps everything local.
+static void processRows(const SFillRowsFunctor& _f, size_t _iRows)
+{
+	if (s_ePolicy == NUMA_LOCAL || _iRows * _f.m_iDstPitch * sizeof(float32) < NUMA_MIN_BYTES) {
+		_f(0, (int)_iRows);
+		return;
+	}
+	CWorkerPool::getSingleton().parallelFor(0, (int)_iRows, _f);
+}
+
+//----------------------------------------------------------------------------------------
+void touchRows(float32* _pfData, size_t _iRows, size_t _iRowSize)
+{
+	if (s_ePolicy != NUMA_FIRST_TOUCH)
+		return;
+	fillRows(_pfData, _iRows, _iRowSize, 0.0f);
+}
+
+//----------------------------------------------------------------------------------------
+void fillRows(float32* _pfData, size_t _iRows, size_t _iRowSize, float32 _fValue, size_t _iPitch)
+{
+	SFillRowsFunctor f;
+	f.m_pfDst = _pfData;
+	f.m_pfSrc = 0;
+	f.m_iRowSize = _iRowSize;
+	f.m_iDstPitch = _iPitch ? _iPitch : _iRowSize;
+	f.m_iSrcPitch = 0;
+	f.m_fValue = _fValue;
+	processRows(f, _iRows);
+}
+
+//----------------------------------------------------------------------------------------
+void copyRows(float32* _pfDst, const float32* _pfSrc, size_t _iRows, size_t _iRowSize,
+              size_t _iDstPitch, size_t _iSrcPitch)
+{
+	SFillRowsFunctor f;
+	f.m_pfDst = _pfDst;
+	f.m_pfSrc = _pfSrc;
+	f.m_iRowSize = _iRowSize;
+	f.m_iDstPitch = _iDstPitch ? _iDstPitch : _iRowSize;
+	f.m_iSrcPitch = _iSrcPitch ? _iSrcPitch : _iRowSize;
+	f.m_fValue = 0.0f;
+	processRows(f, _iRows);
+}
+
+} // namespace astra
@@ -176,7 +176,7 @@ bool CParallelBeamBlobKernelProjector2D::initialize(CParallelProjectionGeometry2
 	}
 
 	ASTRA_CONFIG_CHECK(_pProjectionGeometry, "BlobProjector", "Invalid ProjectionGeometry Object");
-	ASTRA_CONFIG_CHECK(m_pVolumeGeometry, "BlobProjector", "Invalid ProjectionGeometry Object");
+	ASTRA_CONFIG_CHECK(_pVolumeGeometry, "BlobProjector", "Invalid VolumeGeometry Object");
 	m_pProjectionGeometry = _pProjectionGeometry->clone();
 	m_pVolumeGeometry = _pVolumeGeometry->clone();
 	m_fBlobSize = _fBlobSize;
@@ -192,6 +192,14 @@ bool CParallelBeamBlobKernelProjector2D::initialize(CParallelProjectionGeometry2
 	return m_bIsInitialized;
 }
 
+//----------------------------------------------------------------------------------------
+size_t CParallelBeamBlobKernelProjector2D::getMemoryUsage() const
+{
+	if (!m_bIsInitialized)
+		return 0;
+	return CProjector2D::getMemoryUsage() + (size_t)m_iBlobSampleCount * sizeof(float32);
+}
+
 //----------------------------------------------------------------------------------------
 // Get maximum amount of weights on a single ray
 int CParallelBeamBlobKernelProjector2D::getProjectionWeightsCount(int _iProjectionIndex)
@@ -0,0 +1,375 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+
+#include "astra/PixelDrivenBackProjector2D.h"
+
+#include <cmath>
+#include <algorithm>
+
+#include "astra/ParallelProjectionGeometry2D.h"
+#include "astra/ParallelVecProjectionGeometry2D.h"
+#include "astra/FanFlatProjectionGeometry2D.h"
+#include "astra/FanFlatVecProjectionGeometry2D.h"
+#include "astra/VolumeGeometry2D.h"
+#include "astra/Float32ProjectionData2D.h"
+#include "astra/Float32VolumeData2D.h"
+#include "astra/ScratchArena.h"
+#include "astra/WorkerPool.h"
+#include "astra/Logging.h"
+
+namespace astra {
+
+// number of volume rows accumulated together for all angles
+static const int PIXELDRIVEN_BAND_ROWS = 8;
+
+//----------------------------------------------------------------------------------------
+CPixelDrivenBackProjector2D::CPixelDrivenBackProjector2D(CProjectionGeometry2D* _pProjectionGeometry,
+                                                         CVolumeGeometry2D* _pVolumeGeometry,
+                                                         EWeighting _eWeighting)
+{
+	m_bInitialized = false;
+	m_bFan = false;
+	m_eWeighting = _eWeighting;
+	m_iDetectorCount = _pProjectionGeometry->getDetectorCount();
+	m_iRowCount = _pVolumeGeometry->getGridRowCount();
+	m_iColCount = _pVolumeGeometry->getGridColCount();
+	m_fPixelLengthX = _pVolumeGeometry->getPixelLengthX();
+	m_fPixelLengthY = _pVolumeGeometry->getPixelLengthY();
+
+	if (!isSupported(_pProjectionGeometry))
+		return;
+
+	// centre of the upper left pixel
+	const double fX0 = _pVolumeGeometry->getWindowMinX() + 0.5 * m_fPixelLengthX;
+	const double fY0 = _pVolumeGeometry->getWindowMaxY() - 0.5 * m_fPixelLengthY;
+	const double fPixelArea = (double)m_fPixelLengthX * m_fPixelLengthY;
+	const double pw = m_fPixelLengthX;
+	const double ph = m_fPixelLengthY;
+
+	int iAngleCount = _pProjectionGeometry->getProjectionAngleCount();
+	m_angles.resize(iAngleCount);
+
+	CFanFlatVecProjectionGeometry2D* pFanVec = dynamic_cast<CFanFlatVecProjectionGeometry2D*>(_pProjectionGeometry);
+	CFanFlatProjectionGeometry2D* pFan = dynamic_cast<CFanFlatProjectionGeometry2D*>(_pProjectionGeometry);
+	m_bFan = pFanVec || pFan;
+
+	if (m_bFan) {
+		CFanFlatVecProjectionGeometry2D* pVec = pFan ? pFan->toVectorGeometry() : pFanVec;
+		const SFanProjection* pProjs = pVec->getProjectionVectors();
+
+		for (int i = 0; i < iAngleCount; ++i) {
+			const SFanProjection& p = pProjs[i];
+			SAngle& a = m_angles[i];
+
+			// The ray from the source S through the pixel, d = P - S, hits
+			// the detector at DetS + u * DetU with
+			//   u = cross(d, DetS - S) / cross(DetU, d)
+			double fDSX = p.fDetSX - p.fSrcX;
+			double fDSY = p.fDetSY - p.fSrcY;
+			double fDX0 = fX0 - p.fSrcX;
+			double fDY0 = fY0 - p.fSrcY;
+
+			double fNum0 = fDX0 * fDSY - fDY0 * fDSX;
+			double fNumCol = pw * fDSY;
+			double fNumRow = ph * fDSX;
+			double fDen0 = p.fDetUX * fDY0 - p.fDetUY * fDX0;
+			double fDenCol = -p.fDetUY * pw;
+			double fDenRow = -p.fDetUX * ph;
+
+			// measure from the centre of the first detector pixel
+			a.fNum0 = (float32)(fNum0 - 0.5 * fDen0);
+			a.fNumCol = (float32)(fNumCol - 0.5 * fDenCol);
+			a.fNumRow = (float32)(fNumRow - 0.5 * fDenRow);
+			a.fDen0 = (float32)fDen0;
+			a.fDenCol = (float32)fDenCol;
+			a.fDenRow = (float32)fDenRow;
+			a.fSrcDX0 = (float32)fDX0;
+			a.fSrcDY0 = (float32)fDY0;
+
+			// The line kernel weights are the detector size times the
+			// intersection length, which sum to the pixel area divided by
+			// the ray spacing at the pixel, |cross(DetU, d)|^2 / (|d| |cross(DetS - S, DetU)|).
+			double fDetSize = sqrt((double)p.fDetUX * p.fDetUX + (double)p.fDetUY * p.fDetUY);
+			a.fWeight = (float32)(fDetSize * fPixelArea * fabs(fDSX * p.fDetUY - fDSY * p.fDetUX));
+
+			// For FBP, den = cross(DetU, d) is |DetU| times the distance L
+			// from the source to the pixel perpendicular to the detector,
+			// and the weight is (R / L)^2 with R the same distance for the origin.
+			if (_eWeighting == WEIGHT_FBP) {
+				double fR = (double)p.fDetUX * -p.fSrcY - (double)p.fDetUY * -p.fSrcX;
+				a.fWeight = (float32)(fR * fR);
+			}
+		}
+
+		if (pFan)
+			delete pVec;
+	} else {
+		CParallelVecProjectionGeometry2D* pParVec = dynamic_cast<CParallelVecProjectionGeometry2D*>(_pProjectionGeometry);
+		CParallelProjectionGeometry2D* pPar = dynamic_cast<CParallelProjectionGeometry2D*>(_pProjectionGeometry);
+		CParallelVecProjectionGeometry2D* pVec = pPar ? pPar->toVectorGeometry() : pParVec;
+		const SParProjection* pProjs = pVec->getProjectionVectors();
+
+		for (int i = 0; i < iAngleCount; ++i) {
+			const SParProjection& p = pProjs[i];
+			SAngle& a = m_angles[i];
+
+			// The ray through the pixel P hits the detector at DetS + u * DetU with
+			//   u = cross(P - DetS, R) / cross(DetU, R)
+			double fCross = (double)p.fDetUX * p.fRayY - (double)p.fDetUY * p.fRayX;
+			if (fCross == 0.0) {
+				if (pPar)
+					delete pVec;
+				return;
+			}
+
+			a.fNum0 = (float32)(((fX0 - p.fDetSX) * p.fRayY - (fY0 - p.fDetSY) * p.fRayX) / fCross - 0.5);
+			a.fNumCol = (float32)(pw * p.fRayY / fCross);
+			a.fNumRow = (float32)(ph * p.fRayX / fCross);
+			a.fDen0 = 1.0f;
+			a.fDenCol = 0.0f;
+			a.fDenRow = 0.0f;
+			a.fSrcDX0 = 0.0f;
+			a.fSrcDY0 = 0.0f;
+
+			// pixel area over the ray spacing |cross(DetU, R)| / |R|, times the detector size
+			double fDetSize = sqrt((double)p.fDetUX * p.fDetUX + (double)p.fDetUY * p.fDetUY);
+			double fRayLength = sqrt((double)p.fRayX * p.fRayX + (double)p.fRayY * p.fRayY);
+			a.fWeight = (float32)(fDetSize * fPixelArea * fRayLength / fabs(fCross));
+			if (_eWeighting == WEIGHT_FBP)
+				a.fWeight = 1.0f;
+		}
+
+		if (pPar)
+			delete pVec;
+	}
+
+	m_bInitialized = true;
+}
+
+//----------------------------------------------------------------------------------------
+CPixelDrivenBackProjector2D::~CPixelDrivenBackProjector2D()
+{
+
+}
+
+//----------------------------------------------------------------------------------------
+bool CPixelDrivenBackProjector2D::isSupported(const CProjectionGeometry2D* _pProjectionGeometry)
+{
+	return dynamic_cast<const CParallelProjectionGeometry2D*>(_pProjectionGeometry)
+	    || dynamic_cast<const CParallelVecProjectionGeometry2D*>(_pProjectionGeometry)
+	    || dynamic_cast<const CFanFlatProjectionGeometry2D*>(_pProjectionGeometry)
+	    || dynamic_cast<const CFanFlatVecProjectionGeometry2D*>(_pProjectionGeometry);
+}
+
+//----------------------------------------------------------------------------------------
+// Gather one row for a parallel beam angle. The detector coordinate is
+// linear along the row, so the columns hitting the detector are computed
+// up front and the inner loop has no branches.
+static void accumulateParallelRow(float32* _pfAcc, const float32* _pfPadded, int _iDetCount,
+                                  float32 _fF0, float32 _fDF, int _iColCount, float32 _fWeight)
+{
+	// the padded row covers detector coordinates [-1, iDetCount)
+	const float32 fLo = -1.0f;
+	const float32 fHi = (float32)_iDetCount;
+
+	int iBegin = 0;
+	int iEnd = _iColCount;
+	if (_fDF > 0.0f) {
+		iBegin = std::max(iBegin, (int)ceil((fLo - _fF0) / _fDF));
+		iEnd = std::min(iEnd, (int)ceil((fHi - _fF0) / _fDF));
+	} else if (_fDF < 0.0f) {
+		iBegin = std::max(iBegin, (int)floor((fHi - _fF0) / _fDF) + 1);
+		iEnd = std::min(iEnd, (int)floor((fLo - _fF0) / _fDF) + 1);
+	} else if (_fF0 < fLo || _fF0 >= fHi) {
+		return;
+	}
+
+	// guard against rounding at the ends of the range
+	while (iBegin < iEnd && !(_fF0 + iBegin * _fDF >= fLo && _fF0 + iBegin * _fDF < fHi))
+		++iBegin;
+	while (iEnd > iBegin && !(_fF0 + (iEnd-1) * _fDF >= fLo && _fF0 + (iEnd-1) * _fDF < fHi))
+		--iEnd;
+
+	for (int iCol = iBegin; iCol < iEnd; ++iCol) {
+		float32 f = _fF0 + iCol * _fDF + 1.0f;
+		int i = (int)f;
+		float32 t = f - i;
+		_pfAcc[iCol] += _fWeight * (_pfPadded[i] + t * (_pfPadded[i+1] - _pfPadded[i]));
+	}
+}
+
+//----------------------------------------------------------------------------------------
+// Gather one row for a fan beam angle.
+static void accumulateFanRow(float32* _pfAcc, const float32* _pfPadded, int _iDetCount,
+                             const CPixelDrivenBackProjector2D::SAngle& _a, int _iRow,
+                             int _iColCount, float32 _fPixelLengthX, float32 _fPixelLengthY,
+                             bool _bDistance)
+{
+	const float32 fHi = (float32)_iDetCount;
+	const float32 fNum0 = _a.fNum0 + _iRow * _a.fNumRow;
+	const float32 fDen0 = _a.fDen0 + _iRow * _a.fDenRow;
+	const float32 fDY = _a.fSrcDY0 - _iRow * _fPixelLengthY;
+	const float32 fDY2 = fDY * fDY;
+
+	for (int iCol = 0; iCol < _iColCount; ++iCol) {
+		float32 fDen = fDen0 + iCol * _a.fDenCol;
+		if (fDen == 0.0f)
+			continue;
+		float32 fInvDen = 1.0f / fDen;
+		float32 f = (fNum0 + iCol * _a.fNumCol) * fInvDen;
+		if (!(f >= -1.0f && f < fHi))
+			continue;
+		f += 1.0f;
+		int i = (int)f;
+		float32 t = f - i;
+		float32 fWeight = _a.fWeight * fInvDen * fInvDen;
+		if (_bDistance) {
+			float32 fDX = _a.fSrcDX0 + iCol * _fPixelLengthX;
+			fWeight *= sqrt(fDX * fDX + fDY2);
+		}
+		_pfAcc[iCol] += fWeight * (_pfPadded[i] + t * (_pfPadded[i+1] - _pfPadded[i]));
+	}
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Functor backprojecting all angles into a range of volume rows
+ */
+struct SPixelDrivenBandFunctor {
+	const CPixelDrivenBackProjector2D* m_pBP;
+	const float32* m_pfPadded;
+	float32* m_pfVolume;
+	const float32* m_pfVolumeMask;
+	int m_iVolumePitch, m_iMaskPitch;
+	const CAlgorithmCheckpoint* m_pCheckpoint;
+	volatile bool* m_pbFailed;
+
+	void operator()(int _iFrom, int _iTo) const {
+		const int iCols = m_pBP->m_iColCount;
+		const int iDets = m_pBP->m_iDetectorCount;
+		const int iPadded = iDets + 2;
+		const int iAngles = (int)m_pBP->m_angles.size();
+
+		CScratchBuffer<float32> acc((size_t)PIXELDRIVEN_BAND_ROWS * iCols);
+		if (!acc) {
+			*m_pbFailed = true;
+			return;
+		}
+
+		for (int iBand = _iFrom; iBand < _iTo; iBand += PIXELDRIVEN_BAND_ROWS) {
+			if (m_pCheckpoint && m_pCheckpoint->shouldAbort())
+				return;
+			int iBandEnd = std::min(iBand + PIXELDRIVEN_BAND_ROWS, _iTo);
+			std::fill(acc.get(), acc.get() + (size_t)(iBandEnd - iBand) * iCols, 0.0f);
+
+			for (int iAngle = 0; iAngle < iAngles; ++iAngle) {
+				const CPixelDrivenBackProjector2D::SAngle& a = m_pBP->m_angles[iAngle];
+				const float32* pfRow = m_pfPadded + (size_t)iAngle * iPadded;
+				for (int iRow = iBand; iRow < iBandEnd; ++iRow) {
+					float32* pfAcc = acc + (size_t)(iRow - iBand) * iCols;
+					if (m_pBP->m_bFan)
+						accumulateFanRow(pfAcc, pfRow, iDets, a, iRow, iCols, m_pBP->m_fPixelLengthX, m_pBP->m_fPixelLengthY,
+						                 m_pBP->m_eWeighting == CPixelDrivenBackProjector2D::WEIGHT_LINE);
+					else
+						accumulateParallelRow(pfAcc, pfRow, iDets, a.fNum0 + iRow * a.fNumRow, a.fNumCol, iCols, a.fWeight);
+				}
+			}
+
+			for (int iRow = iBand; iRow < iBandEnd; ++iRow) {
+				const float32* pfAcc = acc + (size_t)(iRow - iBand) * iCols;
+				float32* pfVol = m_pfVolume + (size_t)iRow * m_iVolumePitch;
+				if (m_pfVolumeMask) {
+					const float32* pfMask = m_pfVolumeMask + (size_t)iRow * m_iMaskPitch;
+					for (int iCol = 0; iCol < iCols; ++iCol)
+						if (pfMask[iCol] != 0.0f)
+							pfVol[iCol] += pfAcc[iCol];
+				} else {
+					for (int iCol = 0; iCol < iCols; ++iCol)
+						pfVol[iCol] += pfAcc[iCol];
+				}
+			}
+		}
+	}
+};
+
+//----------------------------------------------------------------------------------------
+bool CPixelDrivenBackProjector2D::backProject(const CFloat32ProjectionData2D* _pSinogram,
+                                              CFloat32VolumeData2D* _pVolume,
+                                              const CFloat32ProjectionData2D* _pSinogramMask,
+                                              const CFloat32VolumeData2D* _pVolumeMask,
+                                              const CAlgorithmCheckpoint* _pCheckpoint) const
+{
+	ASTRA_ASSERT(m_bInitialized);
+	ASTRA_ASSERT(_pSinogram->getAngleCount() == (int)m_angles.size());
+	ASTRA_ASSERT(_pSinogram->getDetectorCount() == m_iDetectorCount);
+	ASTRA_ASSERT(_pVolume->getWidth() == m_iColCount && _pVolume->getHeight() == m_iRowCount);
+
+	// Copy the sinogram with a zero detector on both sides, so that the
+	// interpolation needs no bounds checks. Masked rays become zero.
+	const int iAngles = (int)m_angles.size();
+	const int iPadded = m_iDetectorCount + 2;
+	CScratchBuffer<float32> padded((size_t)iAngles * iPadded);
+	if (!padded)
+		return false;
+
+	for (int iAngle = 0; iAngle < iAngles; ++iAngle) {
+		float32* pfRow = padded + (size_t)iAngle * iPadded;
+		const float32* pfSino = _pSinogram->getData2DConst()[iAngle];
+		const float32* pfMask = _pSinogramMask ? _pSinogramMask->getData2DConst()[iAngle] : 0;
+		pfRow[0] = 0.0f;
+		pfRow[iPadded - 1] = 0.0f;
+		for (int iDet = 0; iDet < m_iDetectorCount; ++iDet)
+			pfRow[iDet + 1] = (pfMask && pfMask[iDet] == 0.0f) ? 0.0f : pfSino[iDet];
+	}
+
+	SPixelDrivenBandFunctor f;
+	f.m_pBP = this;
+	f.m_pfPadded = padded;
+	f.m_pfVolume = _pVolume->getData();
+	f.m_pfVolumeMask = _pVolumeMask ? _pVolumeMask->getDataConst() : 0;
+	f.m_iVolumePitch = _pVolume->getRowPitch();
+	f.m_iMaskPitch = _pVolumeMask ? _pVolumeMask->getRowPitch() : 0;
+	f.m_pCheckpoint = _pCheckpoint;
+	volatile bool bFailed = false;
+	f.m_pbFailed = &bFailed;
+	CWorkerPool::getSingleton().parallelFor(0, m_iRowCount, f, PIXELDRIVEN_BAND_ROWS);
+
+	if (bFailed) {
+		ASTRA_ERROR("CPixelDrivenBackProjector2D: unable to allocate the accumulation buffers");
+		return false;
+	}
+
+	if (_pCheckpoint) {
+		if (_pCheckpoint->shouldAbort())
+			return false;
+		_pCheckpoint->report(1, 1);
+	}
+	return true;
+}
+
+} // end namespace
@@ -173,6 +173,27 @@ void CProjector2D::computeProjectionRayWeights(int _iProjection, SPixelWeight* _
 
 }
 
+//----------------------------------------------------------------------------------------
+size_t CProjector2D::getMemoryUsage() const
+{
+	if (!m_bIsInitialized)
+		return 0;
+
+	size_t iAngleCount = m_pProjectionGeometry->getProjectionAngleCount();
+	size_t iBytes = iAngleCount * sizeof(float32);
+
+	if (dynamic_cast<CParallelVecProjectionGeometry2D*>(m_pProjectionGeometry))
+		iBytes += iAngleCount * sizeof(SParProjection);
+	else if (dynamic_cast<CFanFlatVecProjectionGeometry2D*>(m_pProjectionGeometry))
+		iBytes += iAngleCount * sizeof(SFanProjection);
+	else if (CSparseMatrixProjectionGeometry2D* pSparse = dynamic_cast<CSparseMatrixProjectionGeometry2D*>(m_pProjectionGeometry)) {
+		if (pSparse->getMatrix())
+			iBytes += pSparse->getMatrix()->getMemoryUsage();
+	}
+
+	return iBytes;
+}
+
 //----------------------------------------------------------------------------------------
 // explicit projection matrix
 CSparseMatrix* CProjector2D::getMatrix()
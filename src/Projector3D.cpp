@@ -27,11 +27,18 @@ along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
 
 #include "astra/Projector3D.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <stdint.h>
+
 #include "astra/VolumeGeometry3D.h"
 #include "astra/ParallelProjectionGeometry3D.h"
 #include "astra/ParallelVecProjectionGeometry3D.h"
 #include "astra/ConeProjectionGeometry3D.h"
 #include "astra/ConeVecProjectionGeometry3D.h"
+#include "astra/SparseMatrix.h"
+#include "astra/WorkerPool.h"
+#include "astra/Logging.h"
 
 
 namespace astra
@@ -141,7 +148,7 @@ void CProjector3D::computeProjectionRayWeights(int _iProjection, SPixelWeight* _
 	int iPixelBufferSize = getProjectionWeightsCount(_iProjection);
 	
 	int iDetector = 0;
-	for(iDetector = m_pProjectionGeometry->getDetectorTotCount()-1; iDetector >= 0; --iDetector) {
+	for(iDetector = m_pProjectionGeometry->getDetectorRowCount() * m_pProjectionGeometry->getDetectorColCount()-1; iDetector >= 0; --iDetector) {
 		int iSliceIndex = iDetector / m_pProjectionGeometry->getDetectorColCount(); 
 		int iDetectorColIndex = iDetector % m_pProjectionGeometry->getDetectorColCount(); 
 
@@ -154,5 +161,194 @@ void CProjector3D::computeProjectionRayWeights(int _iProjection, SPixelWeight* _
 	}
 }
 //----------------------------------------------------------------------------------------
+// Trace a range of matrix rows; ray i is detector pixel (col, angle, row) in
+// the [row][angle][col] order of the projection data. Without value buffers
+// only the number of weights per ray is stored.
+struct SRayWeights3DFunctor {
+	CProjector3D* m_pProjector;
+	int m_iAngles, m_iCols, m_iMaxWeights;
+	int m_iFirstRay;
+	unsigned long* m_plCounts;		///< per ray, from m_iFirstRay
+	const unsigned long* m_plStarts;	///< per ray, from m_iFirstRay, relative to the buffers
+	unsigned int* m_piColIndices;
+	float32* m_pfValues;
+
+	void operator()(int _iFrom, int _iTo) const {
+		std::vector<SPixelWeight> weights(m_iMaxWeights);
+		for (int i = _iFrom; i < _iTo; ++i) {
+			const int iCol = i % m_iCols;
+			const int iAngle = (i / m_iCols) % m_iAngles;
+			const int iRow = i / m_iCols / m_iAngles;
+			int iCount = 0;
+			m_pProjector->computeSingleRayWeights(iAngle, iRow, iCol, &weights[0], m_iMaxWeights, iCount);
+			const size_t iLocal = i - m_iFirstRay;
+			if (!m_pfValues) {
+				m_plCounts[iLocal] = iCount;
+				continue;
+			}
+			unsigned long lStart = m_plStarts[iLocal];
+			for (int j = 0; j < iCount; ++j) {
+				m_piColIndices[lStart + j] = weights[j].m_iIndex;
+				m_pfValues[lStart + j] = weights[j].m_fWeight;
+			}
+		}
+	}
+};
+
+//----------------------------------------------------------------------------------------
+// Largest number of weights on a single ray.
+static int maxRayWeights3D(CProjector3D* _pProjector)
+{
+	int iMaxWeights = 0;
+	for (int a = 0; a < _pProjector->getProjectionGeometry()->getProjectionCount(); ++a)
+		iMaxWeights = std::max(iMaxWeights, _pProjector->getProjectionWeightsCount(a));
+	return iMaxWeights;
+}
+
+//----------------------------------------------------------------------------------------
+// Count the weights of all rays, and turn the counts into row starts.
+static bool countRayWeights3D(CProjector3D* _pProjector, std::vector<unsigned long>& _starts)
+{
+	CProjectionGeometry3D* pGeom = _pProjector->getProjectionGeometry();
+	const int iAngles = pGeom->getProjectionCount();
+	const int iCols = pGeom->getDetectorColCount();
+	const int iRays = pGeom->getDetectorRowCount() * iAngles * iCols;
+
+	const int iMaxWeights = maxRayWeights3D(_pProjector);
+	if (iMaxWeights <= 0) {
+		ASTRA_ERROR("Projector3D: the %s projector doesn't compute ray weights", _pProjector->getType().c_str());
+		return false;
+	}
+
+	_starts.assign(iRays + 1, 0);
+	SRayWeights3DFunctor f;
+	f.m_pProjector = _pProjector;
+	f.m_iAngles = iAngles;
+	f.m_iCols = iCols;
+	f.m_iMaxWeights = iMaxWeights;
+	f.m_iFirstRay = 0;
+	f.m_plCounts = &_starts[1];
+	f.m_plStarts = 0;
+	f.m_piColIndices = 0;
+	f.m_pfValues = 0;
+	CWorkerPool::getSingleton().parallelFor(0, iRays, f, iCols);
+
+	for (int i = 0; i < iRays; ++i)
+		_starts[i + 1] += _starts[i];
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+// Fill the weights of rays [_iFrom, _iTo) into buffers that start at ray _iFrom.
+static void fillRayWeights3D(CProjector3D* _pProjector, const std::vector<unsigned long>& _starts,
+                             int _iFrom, int _iTo, unsigned int* _piColIndices, float32* _pfValues)
+{
+	std::vector<unsigned long> localStarts(_iTo - _iFrom);
+	for (int i = _iFrom; i < _iTo; ++i)
+		localStarts[i - _iFrom] = _starts[i] - _starts[_iFrom];
+
+	SRayWeights3DFunctor f;
+	f.m_pProjector = _pProjector;
+	f.m_iAngles = _pProjector->getProjectionGeometry()->getProjectionCount();
+	f.m_iCols = _pProjector->getProjectionGeometry()->getDetectorColCount();
+	f.m_iMaxWeights = maxRayWeights3D(_pProjector);
+	f.m_iFirstRay = _iFrom;
+	f.m_plCounts = 0;
+	f.m_plStarts = &localStarts[0];
+	f.m_piColIndices = _piColIndices;
+	f.m_pfValues = _pfValues;
+	CWorkerPool::getSingleton().parallelFor(_iFrom, _iTo, f, f.m_iCols);
+}
+
+//----------------------------------------------------------------------------------------
+// explicit projection matrix
+CSparseMatrix* CProjector3D::getMatrix()
+{
+	ASTRA_ASSERT(m_bIsInitialized);
+
+	std::vector<unsigned long> starts;
+	if (!countRayWeights3D(this, starts))
+		return 0;
+	const unsigned int iRays = starts.size() - 1;
+
+	CSparseMatrix* pMatrix = new CSparseMatrix(iRays, m_pVolumeGeometry->getGridTotCount(), starts[iRays]);
+	if (!pMatrix->isInitialized()) {
+		delete pMatrix;
+		return 0;
+	}
+	std::copy(starts.begin(), starts.end(), pMatrix->m_plRowStarts);
+
+	fillRayWeights3D(this, starts, 0, iRays, pMatrix->m_piColIndices, pMatrix->m_pfValues);
+	return pMatrix;
+}
+
+//----------------------------------------------------------------------------------------
+// explicit projection matrix, streamed to disk
+bool CProjector3D::writeMatrix(const std::string& _sFilename, int _iSlabRows)
+{
+	ASTRA_ASSERT(m_bIsInitialized);
+
+	std::vector<unsigned long> starts;
+	if (!countRayWeights3D(this, starts))
+		return false;
+
+	const int iDetRows = m_pProjectionGeometry->getDetectorRowCount();
+	const int iRaysPerRow = m_pProjectionGeometry->getProjectionCount() * m_pProjectionGeometry->getDetectorColCount();
+	const uint32_t iRays = starts.size() - 1;
+
+	// the first detector row of each block, and the end
+	std::vector<int> slabs;
+	const unsigned long lBlockSize = 16 << 20;
+	for (int r = 0; r < iDetRows; ) {
+		slabs.push_back(r);
+		int iEnd = r + 1;
+		if (_iSlabRows > 0) {
+			iEnd = std::min(iDetRows, r + _iSlabRows);
+		} else {
+			while (iEnd < iDetRows && starts[(size_t)(iEnd + 1) * iRaysPerRow] - starts[(size_t)r * iRaysPerRow] <= lBlockSize)
+				++iEnd;
+		}
+		r = iEnd;
+	}
+	slabs.push_back(iDetRows);
+
+	FILE* f = fopen(_sFilename.c_str(), "wb");
+	if (!f) {
+		ASTRA_ERROR("Projector3D::writeMatrix: can't open %s", _sFilename.c_str());
+		return false;
+	}
+
+	const uint32_t header[4] = { 1, iRays, (uint32_t)m_pVolumeGeometry->getGridTotCount(), (uint32_t)(slabs.size() - 1) };
+	const uint64_t lSize = starts[iRays];
+	bool bOk = fwrite("ASTRASPM", 1, 8, f) == 8;
+	bOk = bOk && fwrite(header, sizeof(uint32_t), 4, f) == 4;
+	bOk = bOk && fwrite(&lSize, sizeof(uint64_t), 1, f) == 1;
+	if (bOk) {
+		std::vector<uint64_t> rowStarts(starts.begin(), starts.end());
+		bOk = fwrite(&rowStarts[0], sizeof(uint64_t), rowStarts.size(), f) == rowStarts.size();
+	}
+
+	std::vector<unsigned int> colIndices;
+	std::vector<float32> values;
+	for (size_t s = 0; bOk && s + 1 < slabs.size(); ++s) {
+		const int iFrom = slabs[s] * iRaysPerRow;
+		const int iTo = slabs[s + 1] * iRaysPerRow;
+		const size_t iCount = starts[iTo] - starts[iFrom];
+		colIndices.resize(std::max<size_t>(iCount, 1));
+		values.resize(std::max<size_t>(iCount, 1));
+		fillRayWeights3D(this, starts, iFrom, iTo, &colIndices[0], &values[0]);
+
+		const uint32_t block[2] = { (uint32_t)iFrom, (uint32_t)(iTo - iFrom) };
+		bOk = fwrite(block, sizeof(uint32_t), 2, f) == 2;
+		bOk = bOk && fwrite(&colIndices[0], sizeof(unsigned int), iCount, f) == iCount;
+		bOk = bOk && fwrite(&values[0], sizeof(float32), iCount, f) == iCount;
+	}
+
+	if (fclose(f) != 0)
+		bOk = false;
+	if (!bOk)
+		ASTRA_ERROR("Projector3D::writeMatrix: error writing %s", _sFilename.c_str());
+	return bOk;
+}
 
 } // end namespace
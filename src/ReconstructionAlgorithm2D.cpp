@@ -28,11 +28,17 @@ along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
 #include "astra/ReconstructionAlgorithm2D.h"
 
 #include "astra/AstraObjectManager.h"
+#include "astra/DataProjector.h"
+#include "astra/DataProjectorPolicies.h"
+#include "astra/PixelDrivenBackProjector2D.h"
+#include "astra/Logging.h"
 
 using namespace std;
 
 namespace astra {
 
+#include "astra/Projector2DImpl.inl"
+
 //----------------------------------------------------------------------------------------
 // Constructor
 CReconstructionAlgorithm2D::CReconstructionAlgorithm2D() 
@@ -62,6 +68,8 @@ void CReconstructionAlgorithm2D::_clear()
 	m_pReconstructionMask = NULL;
 	m_bUseSinogramMask = false;
 	m_pSinogramMask = NULL;
+	m_bPixelDriven = false;
+	m_fWeightsPerProjection = -1.0;
 	m_bIsInitialized = false;
 }
 
@@ -114,6 +122,7 @@ bool CReconstructionAlgorithm2D::initialize(const Config& _cfg)
 		id = _cfg.self.getOptionInt("ReconstructionMaskId");
 		m_pReconstructionMask = dynamic_cast<CFloat32VolumeData2D*>(CData2DManager::getSingleton().get(id));
 		ASTRA_CONFIG_CHECK(m_pReconstructionMask, "Reconstruction2D", "Invalid ReconstructionMaskId.");
+		ASTRA_CONFIG_CHECK(m_pReconstructionMask->isPacked(), "Reconstruction2D", "Reconstruction Mask has padded rows.");
 	}
 	CC.markOptionParsed("ReconstructionMaskId");
 
@@ -123,6 +132,7 @@ bool CReconstructionAlgorithm2D::initialize(const Config& _cfg)
 		id = _cfg.self.getOptionInt("SinogramMaskId");
 		m_pSinogramMask = dynamic_cast<CFloat32ProjectionData2D*>(CData2DManager::getSingleton().get(id));
 		ASTRA_CONFIG_CHECK(m_pSinogramMask, "Reconstruction2D", "Invalid SinogramMaskId.");
+		ASTRA_CONFIG_CHECK(m_pSinogramMask->isPacked(), "Reconstruction2D", "Sinogram Mask has padded rows.");
 	}
 	CC.markOptionParsed("SinogramMaskId");
 
@@ -154,6 +164,11 @@ bool CReconstructionAlgorithm2D::initialize(const Config& _cfg)
 		}
 	}
 
+	m_timings.setEnabled(_cfg.self.getOptionBool("Timings", false));
+	CC.markOptionParsed("Timings");
+
+	m_fWeightsPerProjection = -1.0;
+
 	// return success
 	return _check();
 }
@@ -167,6 +182,7 @@ bool CReconstructionAlgorithm2D::initialize(CProjector2D* _pProjector,
 	m_pProjector = _pProjector;
 	m_pSinogram = _pSinogram;
 	m_pReconstruction = _pReconstruction;
+	m_fWeightsPerProjection = -1.0;
 
 	// return success
 	return _check();
@@ -187,11 +203,17 @@ void CReconstructionAlgorithm2D::setConstraints(bool _bUseMin, float32 _fMinValu
 void CReconstructionAlgorithm2D::setReconstructionMask(CFloat32VolumeData2D* _pMask, bool _bEnable)
 {
 	// TODO: check geometry matches volume
+	// the mask policies index the mask linearly
+	if (_pMask && !_pMask->isPacked()) {
+		ASTRA_ERROR("Reconstruction2D: reconstruction mask has padded rows");
+		_pMask = NULL;
+	}
 	m_bUseReconstructionMask = _bEnable;
 	m_pReconstructionMask = _pMask;
 	if (m_pReconstructionMask == NULL) {
 		m_bUseReconstructionMask = false;
 	}
+	m_fWeightsPerProjection = -1.0;
 }
 
 //----------------------------------------------------------------------------------------
@@ -199,12 +221,45 @@ void CReconstructionAlgorithm2D::setReconstructionMask(CFloat32VolumeData2D* _pM
 void CReconstructionAlgorithm2D::setSinogramMask(CFloat32ProjectionData2D* _pMask, bool _bEnable)
 {
 	// TODO: check geometry matches sinogram
+	if (_pMask && !_pMask->isPacked()) {
+		ASTRA_ERROR("Reconstruction2D: sinogram mask has padded rows");
+		_pMask = NULL;
+	}
 	m_bUseSinogramMask = _bEnable;
 	m_pSinogramMask = _pMask;
 	if (m_pSinogramMask == NULL) {
 		m_bUseSinogramMask = false;
 	}
-}//----------------------------------------------------------------------------------------
+	m_fWeightsPerProjection = -1.0;
+}
+
+//----------------------------------------------------------------------------------------
+// Timing counters for a single projection
+void CReconstructionAlgorithm2D::addProjectionCounts()
+{
+	if (!m_timings.isEnabled() || !m_pProjector)
+		return;
+
+	if (m_fWeightsPerProjection < 0.0) {
+		CPhaseTimer timer(m_timings, ALGPHASE_SETUP);
+		size_t iCount = 0;
+		CDataProjectorInterface* pCounter = dispatchDataProjector(
+			m_pProjector,
+			SinogramMaskPolicy(m_pSinogramMask),
+			ReconstructionMaskPolicy(m_pReconstructionMask),
+			CountWeightsPolicy(&iCount),
+			m_bUseSinogramMask, m_bUseReconstructionMask, true
+		);
+		pCounter->project();
+		ASTRA_DELETE(pCounter);
+		m_fWeightsPerProjection = (double)iCount;
+	}
+
+	m_timings.addRays((double)m_pSinogram->getSize());
+	m_timings.addWeights(m_fWeightsPerProjection);
+}
+
+//----------------------------------------------------------------------------------------
 // Check
 bool CReconstructionAlgorithm2D::_check() 
 {
@@ -219,6 +274,8 @@ bool CReconstructionAlgorithm2D::_check()
 		ASTRA_CONFIG_CHECK(m_pProjector->isInitialized(), "Reconstruction2D", "Projector Object Not Initialized.");
 	ASTRA_CONFIG_CHECK(m_pSinogram->isInitialized(), "Reconstruction2D", "Projection Data Object Not Initialized.");
 	ASTRA_CONFIG_CHECK(m_pReconstruction->isInitialized(), "Reconstruction2D", "Reconstruction Data Object Not Initialized.");
+	ASTRA_CONFIG_CHECK(m_pSinogram->isPacked(), "Reconstruction2D", "Projection Data Object has padded rows.");
+	ASTRA_CONFIG_CHECK(m_pReconstruction->isPacked(), "Reconstruction2D", "Reconstruction Data Object has padded rows.");
 
 	// check compatibility between projector and data classes
 	if (requiresProjector()) {
@@ -226,6 +283,9 @@ bool CReconstructionAlgorithm2D::_check()
 		ASTRA_CONFIG_CHECK(m_pReconstruction->getGeometry()->isEqual(m_pProjector->getVolumeGeometry()), "Reconstruction2D", "Reconstruction Data not compatible with the specified Projector.");
 	}
 
+	if (m_bPixelDriven)
+		ASTRA_CONFIG_CHECK(m_pProjector && CPixelDrivenBackProjector2D::isSupported(m_pProjector->getProjectionGeometry()), "Reconstruction2D", "PixelDriven requires a parallel or fan beam geometry.");
+
 	// success
 	return true;
 }
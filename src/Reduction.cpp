@@ -0,0 +1,158 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+#include "astra/Reduction.h"
+
+#include <vector>
+
+#include "astra/WorkerPool.h"
+
+namespace astra {
+
+// Elements per leaf of the pairwise tree, summed in four lanes
+static const size_t REDUCTION_LEAF_SIZE = 128;
+
+// Elements per parallel block. Fixed, so that the tree does not depend
+// on the thread count.
+static const size_t REDUCTION_BLOCK_SIZE = 16384;
+
+//----------------------------------------------------------------------------------------
+struct SSumOp {
+	const float32* m_pfA;
+	double operator()(size_t i) const { return m_pfA[i]; }
+};
+
+struct SDotOp {
+	const float32* m_pfA;
+	const float32* m_pfB;
+	double operator()(size_t i) const { return (double)m_pfA[i] * m_pfB[i]; }
+};
+
+struct SSquareOp {
+	const float32* m_pfA;
+	double operator()(size_t i) const { return (double)m_pfA[i] * m_pfA[i]; }
+};
+
+//----------------------------------------------------------------------------------------
+template <typename Op>
+static double pairwiseSum(const Op& _op, size_t _iBegin, size_t _iEnd)
+{
+	const size_t n = _iEnd - _iBegin;
+	if (n <= REDUCTION_LEAF_SIZE) {
+		double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+		size_t i = _iBegin;
+		for (; i + 4 <= _iEnd; i += 4) {
+			s0 += _op(i);
+			s1 += _op(i + 1);
+			s2 += _op(i + 2);
+			s3 += _op(i + 3);
+		}
+		for (; i < _iEnd; ++i)
+			s0 += _op(i);
+		return (s0 + s1) + (s2 + s3);
+	}
+	const size_t iMid = _iBegin + n / 2;
+	return pairwiseSum(_op, _iBegin, iMid) + pairwiseSum(_op, iMid, _iEnd);
+}
+
+//----------------------------------------------------------------------------------------
+template <typename Op>
+struct SBlockSumFunctor {
+	const Op* m_pOp;
+	size_t m_iSize;
+	double* m_pfBlockSums;
+
+	void operator()(int _iFrom, int _iTo) const {
+		for (int b = _iFrom; b < _iTo; ++b) {
+			size_t iBegin = (size_t)b * REDUCTION_BLOCK_SIZE;
+			size_t iEnd = iBegin + REDUCTION_BLOCK_SIZE;
+			if (iEnd > m_iSize)
+				iEnd = m_iSize;
+			m_pfBlockSums[b] = pairwiseSum(*m_pOp, iBegin, iEnd);
+		}
+	}
+};
+
+//----------------------------------------------------------------------------------------
+// Combine the block sums pairwise, level by level.
+static double combineBlocks(std::vector<double>& _sums)
+{
+	size_t n = _sums.size();
+	while (n > 1) {
+		size_t iHalf = (n + 1) / 2;
+		for (size_t i = 0; i < n / 2; ++i)
+			_sums[i] = _sums[2 * i] + _sums[2 * i + 1];
+		if (n % 2)
+			_sums[iHalf - 1] = _sums[n - 1];
+		n = iHalf;
+	}
+	return n ? _sums[0] : 0.0;
+}
+
+//----------------------------------------------------------------------------------------
+template <typename Op>
+static double reduce(const Op& _op, size_t _iSize)
+{
+	if (_iSize <= REDUCTION_BLOCK_SIZE)
+		return _iSize ? pairwiseSum(_op, 0, _iSize) : 0.0;
+
+	std::vector<double> sums((_iSize + REDUCTION_BLOCK_SIZE - 1) / REDUCTION_BLOCK_SIZE);
+
+	SBlockSumFunctor<Op> f;
+	f.m_pOp = &_op;
+	f.m_iSize = _iSize;
+	f.m_pfBlockSums = &sums[0];
+	CWorkerPool::getSingleton().parallelFor(0, (int)sums.size(), f);
+
+	return combineBlocks(sums);
+}
+
+//----------------------------------------------------------------------------------------
+float64 reduceSum(const float32* _pfData, size_t _iSize)
+{
+	SSumOp op;
+	op.m_pfA = _pfData;
+	return reduce(op, _iSize);
+}
+
+//----------------------------------------------------------------------------------------
+float64 reduceDot(const float32* _pfA, const float32* _pfB, size_t _iSize)
+{
+	SDotOp op;
+	op.m_pfA = _pfA;
+	op.m_pfB = _pfB;
+	return reduce(op, _iSize);
+}
+
+//----------------------------------------------------------------------------------------
+float64 reduceSquaredNorm(const float32* _pfData, size_t _iSize)
+{
+	SSquareOp op;
+	op.m_pfA = _pfData;
+	return reduce(op, _iSize);
+}
+
+} // namespace astra
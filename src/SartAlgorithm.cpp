@@ -252,6 +252,11 @@ bool CSartAlgorithm::_check()
 		ASTRA_CONFIG_CHECK(0 <= m_piProjectionOrder[i] && m_piProjectionOrder[i] < m_pProjector->getProjectionGeometry()->getProjectionAngleCount(), "SART", "Projection Order out of range.");
 	}
 
+	// check temporaries, which fail to allocate when over the memory budget
+	ASTRA_CONFIG_CHECK(m_pTotalRayLength && m_pTotalRayLength->isInitialized(), "SART", "Invalid TotalRayLength Object");
+	ASTRA_CONFIG_CHECK(m_pTotalPixelWeight && m_pTotalPixelWeight->isInitialized(), "SART", "Invalid TotalPixelWeight Object");
+	ASTRA_CONFIG_CHECK(m_pDiffSinogram && m_pDiffSinogram->isInitialized(), "SART", "Invalid DiffSinogram Object");
+
 	return true;
 }
 
@@ -281,6 +286,17 @@ boost::any CSartAlgorithm::getInformation(std::string _sIdentifier)
 	return CAlgorithm::getInformation(_sIdentifier);
 };
 
+//----------------------------------------------------------------------------------------
+size_t CSartAlgorithm::getMemoryEstimate() const
+{
+	if (!m_bIsInitialized)
+		return 0;
+
+	size_t iProjSize = (size_t)m_pProjector->getProjectionGeometry()->getProjectionAngleCount() * m_pProjector->getProjectionGeometry()->getDetectorCount();
+	size_t iVolSize = (size_t)m_pProjector->getVolumeGeometry()->getGridTotCount();
+	return (2 * iProjSize + iVolSize) * sizeof(float32) + (size_t)m_iProjectionCount * sizeof(int);
+}
+
 //----------------------------------------------------------------------------------------
 // Iterate
 void CSartAlgorithm::run(int _iNrIterations)
@@ -288,7 +304,7 @@ void CSartAlgorithm::run(int _iNrIterations)
 	// check initialized
 	ASTRA_ASSERT(m_bIsInitialized);
 
-	m_bShouldAbort = false;
+	resetAbort();
 
 	// data projectors
 	CDataProjectorInterface* pFirstForwardProjector;
@@ -333,9 +349,15 @@ void CSartAlgorithm::run(int _iNrIterations)
 
 
 
+	// every iteration handles a single projection, so report progress in blocks
+	const int iReportInterval = std::max(_iNrIterations / 64, 1);
+
 	// iteration loop
 	for (int iIteration = 0; iIteration < _iNrIterations && !m_bShouldAbort; ++iIteration) {
 
+		if (m_pProgress && iIteration % iReportInterval == 0)
+			reportProgress((float32)iIteration / _iNrIterations, ALGPHASE_FP);
+
 		int iProjection = m_piProjectionOrder[m_iIterationCount % m_iProjectionCount];
 	
 		// forward projection and difference calculation
@@ -0,0 +1,219 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#include "astra/ScratchArena.h"
+#include "astra/HostMemory.h"
+#include "astra/MemoryBudget.h"
+#include "astra/Float32ProjectionData2D.h"
+#include "astra/Float32VolumeData2D.h"
+
+#include <cstdlib>
+
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+namespace astra {
+
+DEFINE_SINGLETON(CScratchArena)
+
+namespace {
+
+// Construct the arena when the library is loaded, since it is used from
+// worker threads and the lazy construction in Singleton is not thread-safe.
+struct SConstructArena {
+	SConstructArena() { CScratchArena::getSingleton(); }
+};
+
+SConstructArena g_constructArena;
+
+}
+
+//----------------------------------------------------------------------------------------
+// Custom memory handle returning its buffer to the arena
+class CScratchCustomMemory : public CFloat32CustomMemory {
+public:
+	CScratchCustomMemory(float32* _pfData, size_t _iClassBytes) : m_iClassBytes(_iClassBytes) { m_fPtr = _pfData; }
+	virtual ~CScratchCustomMemory() { CScratchArena::getSingleton().release(m_fPtr, m_iClassBytes); }
+private:
+	size_t m_iClassBytes;
+};
+
+//----------------------------------------------------------------------------------------
+static void* alignedAlloc(size_t _iBytes)
+{
+	if (!CMemoryBudget::getSingleton().reserve(_iBytes))
+		return 0;
+	void* p = allocateHostMemory(_iBytes, CScratchArena::ALIGNMENT);
+	if (!p)
+		CMemoryBudget::getSingleton().release(_iBytes);
+	return p;
+}
+
+static void alignedFree(void* _pBuffer, size_t _iBytes)
+{
+	freeHostMemory(_pBuffer, _iBytes);
+	CMemoryBudget::getSingleton().release(_iBytes);
+}
+
+//----------------------------------------------------------------------------------------
+CScratchArena::CScratchArena()
+{
+	m_iCachedBytes = 0;
+	m_iCacheLimit = (size_t)256 << 20;
+}
+
+CScratchArena::~CScratchArena()
+{
+	_freeAll();
+}
+
+//----------------------------------------------------------------------------------------
+size_t CScratchArena::getClassSize(size_t _iBytes)
+{
+	// Size classes are 4 KiB and up, in steps of 2^k and 3*2^(k-1), so at
+	// most a third of a buffer is unused.
+	size_t iClass = 4096;
+	while (iClass < _iBytes) {
+		size_t iMid = iClass + iClass / 2;
+		if (iMid >= _iBytes)
+			return iMid;
+		iClass *= 2;
+	}
+	return iClass;
+}
+
+//----------------------------------------------------------------------------------------
+void* CScratchArena::allocate(size_t _iBytes, size_t& _iClassBytes)
+{
+	_iClassBytes = getClassSize(_iBytes);
+
+	{
+		CMutexLock lock(m_mutex);
+		std::map<size_t, std::vector<void*> >::iterator it = m_freeLists.find(_iClassBytes);
+		if (it != m_freeLists.end() && !it->second.empty()) {
+			void* p = it->second.back();
+			it->second.pop_back();
+			m_iCachedBytes -= _iClassBytes;
+			return p;
+		}
+	}
+
+	void* p = alignedAlloc(_iClassBytes);
+	if (!p) {
+		// free the cached buffers, and try again
+		trim();
+		p = alignedAlloc(_iClassBytes);
+	}
+	return p;
+}
+
+//----------------------------------------------------------------------------------------
+void CScratchArena::release(void* _pBuffer, size_t _iClassBytes)
+{
+	if (!_pBuffer)
+		return;
+
+	{
+		CMutexLock lock(m_mutex);
+		if (m_iCachedBytes + _iClassBytes <= m_iCacheLimit) {
+			m_freeLists[_iClassBytes].push_back(_pBuffer);
+			m_iCachedBytes += _iClassBytes;
+			return;
+		}
+	}
+
+	alignedFree(_pBuffer, _iClassBytes);
+}
+
+//----------------------------------------------------------------------------------------
+CFloat32CustomMemory* CScratchArena::createCustomMemory(size_t _iCount)
+{
+	size_t iClassBytes;
+	float32* pfData = (float32*)allocate(_iCount * sizeof(float32), iClassBytes);
+	if (!pfData)
+		return 0;
+	return new CScratchCustomMemory(pfData, iClassBytes);
+}
+
+//----------------------------------------------------------------------------------------
+CFloat32ProjectionData2D* CScratchArena::createProjectionData2D(CProjectionGeometry2D* _pGeometry)
+{
+	CFloat32CustomMemory* pMem = createCustomMemory((size_t)_pGeometry->getProjectionAngleCount() * _pGeometry->getDetectorCount());
+	if (!pMem)
+		return new CFloat32ProjectionData2D();
+	return new CFloat32ProjectionData2D(_pGeometry, pMem);
+}
+
+CFloat32VolumeData2D* CScratchArena::createVolumeData2D(CVolumeGeometry2D* _pGeometry)
+{
+	CFloat32CustomMemory* pMem = createCustomMemory((size_t)_pGeometry->getGridTotCount());
+	if (!pMem)
+		return new CFloat32VolumeData2D();
+	return new CFloat32VolumeData2D(_pGeometry, pMem);
+}
+
+//----------------------------------------------------------------------------------------
+void CScratchArena::_freeAll()
+{
+	std::map<size_t, std::vector<void*> >::iterator it;
+	for (it = m_freeLists.begin(); it != m_freeLists.end(); ++it) {
+		for (size_t i = 0; i < it->second.size(); ++i)
+			alignedFree(it->second[i], it->first);
+	}
+	m_freeLists.clear();
+	m_iCachedBytes = 0;
+}
+
+void CScratchArena::trim()
+{
+	CMutexLock lock(m_mutex);
+	_freeAll();
+}
+
+//----------------------------------------------------------------------------------------
+void CScratchArena::setCacheLimit(size_t _iBytes)
+{
+	CMutexLock lock(m_mutex);
+	m_iCacheLimit = _iBytes;
+	if (m_iCachedBytes > m_iCacheLimit)
+		_freeAll();
+}
+
+size_t CScratchArena::getCacheLimit()
+{
+	CMutexLock lock(m_mutex);
+	return m_iCacheLimit;
+}
+
+size_t CScratchArena::getCachedBytes()
+{
+	CMutexLock lock(m_mutex);
+	return m_iCachedBytes;
+}
+
+} // end namespace
@@ -0,0 +1,535 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#include "astra/SeparableFootprintProjector3D.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "astra/VolumeGeometry3D.h"
+#include "astra/ProjectionGeometry3D.h"
+#include "astra/Float32ProjectionData3DMemory.h"
+#include "astra/Float32VolumeData3DMemory.h"
+#include "astra/WorkerPool.h"
+#include "astra/Logging.h"
+
+using namespace std;
+using namespace astra;
+
+// type of the projector, needed to register with CProjectorFactory
+std::string CSeparableFootprintProjector3D::type = "sf3d";
+
+namespace {
+
+//----------------------------------------------------------------------------------------
+// Integral from -inf to _fX of the trapezoid that rises from 0 at _fT[0] to 1
+// at _fT[1], stays 1 until _fT[2], and falls to 0 at _fT[3].
+inline double trapezoidIntegral(const double* _fT, double _fX)
+{
+	if (_fX <= _fT[0])
+		return 0.0;
+	double f = 0.0;
+	double e = std::min(_fX, _fT[1]);
+	if (_fT[1] > _fT[0])
+		f += (e - _fT[0]) * (e - _fT[0]) / (2.0 * (_fT[1] - _fT[0]));
+	if (_fX <= _fT[1])
+		return f;
+	f += std::min(_fX, _fT[2]) - _fT[1];
+	if (_fX <= _fT[2])
+		return f;
+	e = std::min(_fX, _fT[3]);
+	if (_fT[3] > _fT[2])
+		f += (e - _fT[2]) - (e - _fT[2]) * (e - _fT[2]) / (2.0 * (_fT[3] - _fT[2]));
+	return f;
+}
+
+inline void sort4(double* _fT)
+{
+	if (_fT[0] > _fT[1]) std::swap(_fT[0], _fT[1]);
+	if (_fT[2] > _fT[3]) std::swap(_fT[2], _fT[3]);
+	if (_fT[0] > _fT[2]) std::swap(_fT[0], _fT[2]);
+	if (_fT[1] > _fT[3]) std::swap(_fT[1], _fT[3]);
+	if (_fT[1] > _fT[2]) std::swap(_fT[1], _fT[2]);
+}
+
+//----------------------------------------------------------------------------------------
+// The footprints of the voxels of one column (x, y) in one projection.
+// Detector coordinates are in pixels, with pixel i covering [i, i+1).
+struct SColumnFootprint {
+	const SVolumeGrid3D* m_pGrid;
+	int m_iDetCols, m_iDetRows;
+	bool m_bTrapezoidAxial;
+
+	// transaxial: weights of detector columns [m_iU0, m_iU1)
+	int m_iU0, m_iU1;
+	std::vector<float32> m_fU;
+
+	// magnification at the column centre and its extremes over the corners,
+	// length of the central ray in the xy plane, and the in-plane chord
+	double m_fT, m_fTMin, m_fTMax;
+	double m_fR, m_fChord;
+
+	// axial, per voxel: the trapezoid in v, and the ray length scale
+	std::vector<double> m_fV;
+	std::vector<float32> m_fAmplitude;
+
+	void init(const SVolumeGrid3D* _pGrid, int _iDetCols, int _iDetRows, bool _bTrapezoidAxial) {
+		m_pGrid = _pGrid;
+		m_iDetCols = _iDetCols;
+		m_iDetRows = _iDetRows;
+		m_bTrapezoidAxial = _bTrapezoidAxial;
+		m_fU.resize(_iDetCols);
+		m_fV.resize(4 * _pGrid->iSlices);
+		m_fAmplitude.resize(_pGrid->iSlices);
+	}
+
+	// The transaxial footprint; false if it misses the detector.
+	bool computeTransaxial(const SConeProjection& _p, int _iX, int _iY) {
+		const SVolumeGrid3D& g = *m_pGrid;
+		// horizontal normal of the (vertical) detector plane
+		const double fNX = -_p.fDetUY, fNY = _p.fDetUX;
+		const double fUU = _p.fDetUX * _p.fDetUX + _p.fDetUY * _p.fDetUY;
+		const double fND = fNX * (_p.fDetSX - _p.fSrcX) + fNY * (_p.fDetSY - _p.fSrcY);
+		const double fCX = g.fMinX + (_iX + 0.5) * g.fPixelX;
+		const double fCY = g.fMinY + (_iY + 0.5) * g.fPixelY;
+
+		double fU[4];
+		m_fTMin = m_fTMax = 0.0;
+		for (int c = 0; c < 4; ++c) {
+			const double fDX = fCX + ((c & 1) ? 0.5 : -0.5) * g.fPixelX - _p.fSrcX;
+			const double fDY = fCY + ((c & 2) ? 0.5 : -0.5) * g.fPixelY - _p.fSrcY;
+			const double fDen = fNX * fDX + fNY * fDY;
+			// corners at or behind the source don't project
+			if (fDen * fND <= 0.0)
+				return false;
+			const double fT = fND / fDen;
+			fU[c] = ((_p.fSrcX + fT * fDX - _p.fDetSX) * _p.fDetUX + (_p.fSrcY + fT * fDY - _p.fDetSY) * _p.fDetUY) / fUU;
+			if (c == 0 || fT < m_fTMin) m_fTMin = fT;
+			if (c == 0 || fT > m_fTMax) m_fTMax = fT;
+		}
+		sort4(fU);
+
+		m_iU0 = std::max(0, (int)std::floor(fU[0]));
+		m_iU1 = std::min(m_iDetCols, (int)std::ceil(fU[3]));
+		if (m_iU0 >= m_iU1)
+			return false;
+		double fPrev = trapezoidIntegral(fU, m_iU0);
+		for (int i = m_iU0; i < m_iU1; ++i) {
+			const double fNext = trapezoidIntegral(fU, i + 1);
+			m_fU[i - m_iU0] = (float32)(fNext - fPrev);
+			fPrev = fNext;
+		}
+
+		// central ray
+		const double fDX = fCX - _p.fSrcX, fDY = fCY - _p.fSrcY;
+		m_fT = fND / (fNX * fDX + fNY * fDY);
+		m_fR = std::sqrt(fDX * fDX + fDY * fDY);
+		const double fAX = std::fabs(fDX) / m_fR, fAY = std::fabs(fDY) / m_fR;
+		m_fChord = std::min(fAX > 0.0 ? g.fPixelX / fAX : g.fPixelY / fAY,
+		                    fAY > 0.0 ? g.fPixelY / fAY : g.fPixelX / fAX);
+		return true;
+	}
+
+	// The axial footprints of all voxels in the column. Everything here is
+	// linear in z, so the loops are straight line code over the slices.
+	void computeAxial(const SConeProjection& _p) {
+		const SVolumeGrid3D& g = *m_pGrid;
+		const int iSlices = g.iSlices;
+		const double fInvVZ = 1.0 / _p.fDetVZ;
+		const double fOffset = (_p.fSrcZ - _p.fDetSZ) * fInvVZ;
+		const double fR2 = m_fR * m_fR;
+		double* fV = &m_fV[0];
+		float32* fAmplitude = &m_fAmplitude[0];
+
+		for (int k = 0; k < iSlices; ++k) {
+			const double fZC = g.fMinZ + (k + 0.5) * g.fPixelZ - _p.fSrcZ;
+			fAmplitude[k] = (float32)(m_fChord * std::sqrt(fR2 + fZC * fZC) / m_fR);
+		}
+
+		if (!m_bTrapezoidAxial) {
+			// rectangle between the projections of the bottom and top face
+			const double fScale = m_fT * fInvVZ;
+			for (int k = 0; k < iSlices; ++k) {
+				const double fZ0 = g.fMinZ + k * g.fPixelZ - _p.fSrcZ;
+				double fA = fOffset + fZ0 * fScale;
+				double fB = fA + g.fPixelZ * fScale;
+				if (fA > fB)
+					std::swap(fA, fB);
+				fV[4*k] = fV[4*k+1] = fA;
+				fV[4*k+2] = fV[4*k+3] = fB;
+			}
+		} else {
+			// trapezoid from both faces at the nearest and farthest corner
+			const double fScaleMin = m_fTMin * fInvVZ;
+			const double fScaleMax = m_fTMax * fInvVZ;
+			for (int k = 0; k < iSlices; ++k) {
+				const double fZ0 = g.fMinZ + k * g.fPixelZ - _p.fSrcZ;
+				const double fZ1 = fZ0 + g.fPixelZ;
+				fV[4*k] = fOffset + fZ0 * fScaleMin;
+				fV[4*k+1] = fOffset + fZ0 * fScaleMax;
+				fV[4*k+2] = fOffset + fZ1 * fScaleMin;
+				fV[4*k+3] = fOffset + fZ1 * fScaleMax;
+				sort4(fV + 4*k);
+			}
+		}
+	}
+
+	// Detector rows [_iV0, _iV1) covered by voxel _iZ.
+	void rows(int _iZ, int& _iV0, int& _iV1) const {
+		_iV0 = std::max(0, (int)std::floor(m_fV[4*_iZ]));
+		_iV1 = std::min(m_iDetRows, (int)std::ceil(m_fV[4*_iZ+3]));
+	}
+
+	// Axial weight of voxel _iZ on detector row _iV.
+	float32 axialWeight(int _iZ, int _iV) const {
+		const double* fT = &m_fV[4*_iZ];
+		return (float32)(trapezoidIntegral(fT, _iV + 1) - trapezoidIntegral(fT, _iV));
+	}
+};
+
+//----------------------------------------------------------------------------------------
+// Forward projection of a range of projections; each writes its own rows.
+struct SSFForwardFunctor {
+	const SVolumeGrid3D* m_pGrid;
+	const SProjectionVectors3D* m_pVectors;
+	bool m_bTrapezoidAxial;
+	const CFloat32VolumeData3DMemory* m_pVolume;
+	CFloat32ProjectionData3DMemory* m_pProjection;
+
+	void operator()(int _iFrom, int _iTo) const {
+		const SVolumeGrid3D& g = *m_pGrid;
+		SColumnFootprint fp;
+		fp.init(m_pGrid, m_pVectors->iCols, m_pVectors->iRows, m_bTrapezoidAxial);
+		for (int a = _iFrom; a < _iTo; ++a) {
+			const SConeProjection& p = m_pVectors->cone[a];
+			for (int v = 0; v < m_pVectors->iRows; ++v)
+				memset(m_pProjection->getRow(a, v), 0, m_pVectors->iCols * sizeof(float32));
+
+			for (int y = 0; y < g.iRows; ++y) {
+				for (int x = 0; x < g.iCols; ++x) {
+					if (!fp.computeTransaxial(p, x, y))
+						continue;
+					fp.computeAxial(p);
+					const int iWidth = fp.m_iU1 - fp.m_iU0;
+					for (int z = 0; z < g.iSlices; ++z) {
+						const float32 fValue = m_pVolume->getRowConst(y, z)[x];
+						if (fValue == 0.0f)
+							continue;
+						const float32 fScaled = fValue * fp.m_fAmplitude[z];
+						int v0, v1;
+						fp.rows(z, v0, v1);
+						for (int v = v0; v < v1; ++v) {
+							const float32 fW = fScaled * fp.axialWeight(z, v);
+							float32* pfOut = m_pProjection->getRow(a, v) + fp.m_iU0;
+							for (int i = 0; i < iWidth; ++i)
+								pfOut[i] += fW * fp.m_fU[i];
+						}
+					}
+				}
+			}
+		}
+	}
+};
+
+//----------------------------------------------------------------------------------------
+// Backprojection into a range of volume rows y; each writes its own columns.
+struct SSFBackFunctor {
+	const SVolumeGrid3D* m_pGrid;
+	const SProjectionVectors3D* m_pVectors;
+	bool m_bTrapezoidAxial;
+	const CFloat32ProjectionData3DMemory* m_pProjection;
+	CFloat32VolumeData3DMemory* m_pVolume;
+
+	void operator()(int _iFrom, int _iTo) const {
+		const SVolumeGrid3D& g = *m_pGrid;
+		SColumnFootprint fp;
+		fp.init(m_pGrid, m_pVectors->iCols, m_pVectors->iRows, m_bTrapezoidAxial);
+		std::vector<float32> fColumn(g.iSlices);
+		for (int y = _iFrom; y < _iTo; ++y) {
+			for (int x = 0; x < g.iCols; ++x) {
+				std::fill(fColumn.begin(), fColumn.end(), 0.0f);
+				for (int a = 0; a < m_pVectors->iAngles; ++a) {
+					const SConeProjection& p = m_pVectors->cone[a];
+					if (!fp.computeTransaxial(p, x, y))
+						continue;
+					fp.computeAxial(p);
+					const int iWidth = fp.m_iU1 - fp.m_iU0;
+					for (int z = 0; z < g.iSlices; ++z) {
+						int v0, v1;
+						fp.rows(z, v0, v1);
+						float32 fSum = 0.0f;
+						for (int v = v0; v < v1; ++v) {
+							const float32* pfIn = m_pProjection->getRowConst(a, v) + fp.m_iU0;
+							float32 fRow = 0.0f;
+							for (int i = 0; i < iWidth; ++i)
+								fRow += pfIn[i] * fp.m_fU[i];
+							fSum += fRow * fp.axialWeight(z, v);
+						}
+						fColumn[z] += fSum * fp.m_fAmplitude[z];
+					}
+				}
+				for (int z = 0; z < g.iSlices; ++z)
+					m_pVolume->getRow(y, z)[x] = fColumn[z];
+			}
+		}
+	}
+};
+
+}
+
+//----------------------------------------------------------------------------------------
+// default constructor
+CSeparableFootprintProjector3D::CSeparableFootprintProjector3D()
+{
+	_clear();
+}
+
+//----------------------------------------------------------------------------------------
+// constructor
+CSeparableFootprintProjector3D::CSeparableFootprintProjector3D(const CProjectionGeometry3D* _pProjectionGeometry,
+                                                               const CVolumeGeometry3D* _pVolumeGeometry,
+                                                               bool _bTrapezoidAxial)
+{
+	_clear();
+	initialize(_pProjectionGeometry, _pVolumeGeometry, _bTrapezoidAxial);
+}
+
+//----------------------------------------------------------------------------------------
+// destructor
+CSeparableFootprintProjector3D::~CSeparableFootprintProjector3D()
+{
+	clear();
+}
+
+//---------------------------------------------------------------------------------------
+// Clear - Constructors
+void CSeparableFootprintProjector3D::_clear()
+{
+	CProjector3D::_clear();
+	m_vectors.par.clear();
+	m_vectors.cone.clear();
+	m_bTrapezoidAxial = false;
+	m_bIsInitialized = false;
+}
+
+//---------------------------------------------------------------------------------------
+// Clear - Public
+void CSeparableFootprintProjector3D::clear()
+{
+	CProjector3D::clear();
+	m_vectors.par.clear();
+	m_vectors.cone.clear();
+	m_bTrapezoidAxial = false;
+	m_bIsInitialized = false;
+}
+
+//---------------------------------------------------------------------------------------
+// Check
+bool CSeparableFootprintProjector3D::_check()
+{
+	// check base class
+	ASTRA_CONFIG_CHECK(CProjector3D::_check(), "SeparableFootprintProjector3D", "Error in Projector3D initialization");
+	ASTRA_CONFIG_CHECK(m_vectors.set(m_pProjectionGeometry) && m_vectors.bCone, "SeparableFootprintProjector3D", "Only cone and cone_vec geometries are supported");
+	m_grid.set(m_pVolumeGeometry);
+
+	// the footprints separate when u is horizontal and v is vertical
+	const double fEps = 1e-4;
+	for (int a = 0; a < m_vectors.iAngles; ++a) {
+		const SConeProjection& p = m_vectors.cone[a];
+		const double fU = std::sqrt(p.fDetUX * p.fDetUX + p.fDetUY * p.fDetUY + p.fDetUZ * p.fDetUZ);
+		const double fV = std::sqrt(p.fDetVX * p.fDetVX + p.fDetVY * p.fDetVY + p.fDetVZ * p.fDetVZ);
+		ASTRA_CONFIG_CHECK(std::fabs(p.fDetUZ) <= fEps * fU && std::fabs(p.fDetVX) <= fEps * fV && std::fabs(p.fDetVY) <= fEps * fV,
+		                   "SeparableFootprintProjector3D", "The detector must have horizontal rows and vertical columns");
+	}
+
+	// success
+	return true;
+}
+
+//---------------------------------------------------------------------------------------
+// Initialize, use a Config object
+bool CSeparableFootprintProjector3D::initialize(const Config& _cfg)
+{
+	ASTRA_ASSERT(_cfg.self);
+	ConfigStackCheck<CProjector3D> CC("SeparableFootprintProjector3D", this, _cfg);
+
+	// if already initialized, clear first
+	if (m_bIsInitialized) {
+		clear();
+	}
+
+	// initialization of parent class
+	if (!CProjector3D::initialize(_cfg)) {
+		return false;
+	}
+
+	std::string sFootprint = _cfg.self.getOption("Footprint", "TR");
+	ASTRA_CONFIG_CHECK(sFootprint == "TR" || sFootprint == "TT", "SeparableFootprintProjector3D", "Footprint must be TR or TT");
+	m_bTrapezoidAxial = (sFootprint == "TT");
+	CC.markOptionParsed("Footprint");
+
+	// success
+	m_bIsInitialized = _check();
+	return m_bIsInitialized;
+}
+
+//---------------------------------------------------------------------------------------
+// Initialize
+bool CSeparableFootprintProjector3D::initialize(const CProjectionGeometry3D* _pProjectionGeometry,
+                                                const CVolumeGeometry3D* _pVolumeGeometry,
+                                                bool _bTrapezoidAxial)
+{
+	// if already initialized, clear first
+	if (m_bIsInitialized) {
+		clear();
+	}
+
+	// hardcopy geometries
+	m_pProjectionGeometry = _pProjectionGeometry->clone();
+	m_pVolumeGeometry = _pVolumeGeometry->clone();
+	m_bTrapezoidAxial = _bTrapezoidAxial;
+
+	// success
+	m_bIsInitialized = _check();
+	return m_bIsInitialized;
+}
+
+//----------------------------------------------------------------------------------------
+bool CSeparableFootprintProjector3D::forwardProject(const CFloat32VolumeData3DMemory* _pVolume,
+                                                    CFloat32ProjectionData3DMemory* _pProjection) const
+{
+	ASTRA_ASSERT(m_bIsInitialized);
+	if (!_pVolume->getGeometry()->isEqual(m_pVolumeGeometry) || !_pProjection->getGeometry()->isEqual(m_pProjectionGeometry)) {
+		ASTRA_ERROR("SeparableFootprintProjector3D: data geometries don't match the projector");
+		return false;
+	}
+
+	SSFForwardFunctor f;
+	f.m_pGrid = &m_grid;
+	f.m_pVectors = &m_vectors;
+	f.m_bTrapezoidAxial = m_bTrapezoidAxial;
+	f.m_pVolume = _pVolume;
+	f.m_pProjection = _pProjection;
+	CWorkerPool::getSingleton().parallelFor(0, m_vectors.iAngles, f);
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+bool CSeparableFootprintProjector3D::backProject(const CFloat32ProjectionData3DMemory* _pProjection,
+                                                 CFloat32VolumeData3DMemory* _pVolume) const
+{
+	ASTRA_ASSERT(m_bIsInitialized);
+	if (!_pVolume->getGeometry()->isEqual(m_pVolumeGeometry) || !_pProjection->getGeometry()->isEqual(m_pProjectionGeometry)) {
+		ASTRA_ERROR("SeparableFootprintProjector3D: data geometries don't match the projector");
+		return false;
+	}
+
+	SSFBackFunctor f;
+	f.m_pGrid = &m_grid;
+	f.m_pVectors = &m_vectors;
+	f.m_bTrapezoidAxial = m_bTrapezoidAxial;
+	f.m_pProjection = _pProjection;
+	f.m_pVolume = _pVolume;
+	CWorkerPool::getSingleton().parallelFor(0, m_grid.iRows, f);
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+// Get maximum amount of weights on a single ray: the largest number of
+// voxel columns whose footprint touches one detector column, times the
+// largest number of voxels in a column that touch one detector row.
+int CSeparableFootprintProjector3D::getProjectionWeightsCount(int _iProjectionIndex)
+{
+	ASTRA_ASSERT(m_bIsInitialized);
+	const SConeProjection& p = m_vectors.cone[_iProjectionIndex];
+	SColumnFootprint fp;
+	fp.init(&m_grid, m_vectors.iCols, m_vectors.iRows, m_bTrapezoidAxial);
+
+	std::vector<int> columns(m_vectors.iCols, 0);
+	int iMaxAxial = 0;
+	const int iLast = m_grid.iSlices - 1;
+	for (int y = 0; y < m_grid.iRows; ++y) {
+		for (int x = 0; x < m_grid.iCols; ++x) {
+			if (!fp.computeTransaxial(p, x, y))
+				continue;
+			for (int i = fp.m_iU0; i < fp.m_iU1; ++i)
+				columns[i]++;
+			fp.computeAxial(p);
+			// footprints are widest at the ends of the column
+			const double fStep = std::fabs(fp.m_fTMin * m_grid.fPixelZ / p.fDetVZ);
+			const double fWidth = std::max(fp.m_fV[3] - fp.m_fV[0], fp.m_fV[4*iLast+3] - fp.m_fV[4*iLast]);
+			iMaxAxial = std::max(iMaxAxial, (int)std::ceil((1.0 + fWidth) / fStep) + 1);
+		}
+	}
+	const int iMaxColumns = *std::max_element(columns.begin(), columns.end());
+	return iMaxColumns * std::min(iMaxAxial, m_grid.iSlices);
+}
+
+//----------------------------------------------------------------------------------------
+// Single Ray Weights
+void CSeparableFootprintProjector3D::computeSingleRayWeights(int _iProjectionIndex, int _iSliceIndex, int _iDetectorIndex,
+                                                             SPixelWeight* _pWeightedPixels, int _iMaxPixelCount,
+                                                             int& _iStoredPixelCount)
+{
+	ASTRA_ASSERT(m_bIsInitialized);
+	const SConeProjection& p = m_vectors.cone[_iProjectionIndex];
+	SColumnFootprint fp;
+	fp.init(&m_grid, m_vectors.iCols, m_vectors.iRows, m_bTrapezoidAxial);
+
+	_iStoredPixelCount = 0;
+	for (int y = 0; y < m_grid.iRows; ++y) {
+		for (int x = 0; x < m_grid.iCols; ++x) {
+			if (!fp.computeTransaxial(p, x, y) || _iDetectorIndex < fp.m_iU0 || _iDetectorIndex >= fp.m_iU1)
+				continue;
+			const float32 fU = fp.m_fU[_iDetectorIndex - fp.m_iU0];
+			if (fU == 0.0f)
+				continue;
+			fp.computeAxial(p);
+			for (int z = 0; z < m_grid.iSlices; ++z) {
+				int v0, v1;
+				fp.rows(z, v0, v1);
+				if (_iSliceIndex < v0 || _iSliceIndex >= v1)
+					continue;
+				const float32 fWeight = fp.m_fAmplitude[z] * fU * fp.axialWeight(z, _iSliceIndex);
+				if (fWeight == 0.0f || _iStoredPixelCount >= _iMaxPixelCount)
+					continue;
+				_pWeightedPixels[_iStoredPixelCount].m_iIndex = (z * m_grid.iRows + y) * m_grid.iCols + x;
+				_pWeightedPixels[_iStoredPixelCount].m_fWeight = fWeight;
+				++_iStoredPixelCount;
+			}
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------
+// description
+std::string CSeparableFootprintProjector3D::description() const
+{
+	return "";
+}
@@ -29,6 +29,8 @@ along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
 
 #include "astra/AstraObjectManager.h"
 #include "astra/DataProjectorPolicies.h"
+#include "astra/ScratchArena.h"
+#include "astra/PixelDrivenBackProjector2D.h"
 
 using namespace std;
 
@@ -108,6 +110,7 @@ bool CSirtAlgorithm::_check()
 	ASTRA_CONFIG_CHECK(m_pTotalPixelWeight->isInitialized(), "SIRT", "Invalid TotalPixelWeight Object");
 	ASTRA_CONFIG_CHECK(m_pDiffSinogram, "SIRT", "Invalid DiffSinogram Object");
 	ASTRA_CONFIG_CHECK(m_pDiffSinogram->isInitialized(), "SIRT", "Invalid DiffSinogram Object");
+	ASTRA_CONFIG_CHECK(m_pTmpVolume && m_pTmpVolume->isInitialized(), "SIRT", "Invalid TmpVolume Object");
 
 	return true;
 }
@@ -132,6 +135,9 @@ bool CSirtAlgorithm::initialize(const Config& _cfg)
 	m_fLambda = _cfg.self.getOptionNumerical("Relaxation", 1.0f);
 	CC.markOptionParsed("Relaxation");
 
+	m_bPixelDriven = _cfg.self.getOptionBool("PixelDriven", false);
+	CC.markOptionParsed("PixelDriven");
+
 	// init data objects and data projectors
 	_init();
 
@@ -170,11 +176,16 @@ bool CSirtAlgorithm::initialize(CProjector2D* _pProjector,
 // Initialize Data Projectors - private
 void CSirtAlgorithm::_init()
 {
-	// create data objects
-	m_pTotalRayLength = new CFloat32ProjectionData2D(m_pProjector->getProjectionGeometry());
-	m_pTotalPixelWeight = new CFloat32VolumeData2D(m_pProjector->getVolumeGeometry());
-	m_pDiffSinogram = new CFloat32ProjectionData2D(m_pProjector->getProjectionGeometry());
-	m_pTmpVolume = new CFloat32VolumeData2D(m_pProjector->getVolumeGeometry());
+	// create data objects, with memory borrowed from the scratch arena
+	CScratchArena& arena = CScratchArena::getSingleton();
+	m_pTotalRayLength = arena.createProjectionData2D(m_pProjector->getProjectionGeometry());
+	m_pTotalPixelWeight = arena.createVolumeData2D(m_pProjector->getVolumeGeometry());
+	m_pDiffSinogram = arena.createProjectionData2D(m_pProjector->getProjectionGeometry());
+	m_pTmpVolume = arena.createVolumeData2D(m_pProjector->getVolumeGeometry());
+
+	// recycled buffers hold stale data, and masked rays are never written
+	if (m_pDiffSinogram->isInitialized())
+		m_pDiffSinogram->setData(0.0f);
 }
 
 //---------------------------------------------------------------------------------------
@@ -192,6 +203,17 @@ boost::any CSirtAlgorithm::getInformation(std::string _sIdentifier)
 	return CAlgorithm::getInformation(_sIdentifier);
 };
 
+//----------------------------------------------------------------------------------------
+size_t CSirtAlgorithm::getMemoryEstimate() const
+{
+	if (!m_bIsInitialized)
+		return 0;
+
+	size_t iProjSize = (size_t)m_pProjector->getProjectionGeometry()->getProjectionAngleCount() * m_pProjector->getProjectionGeometry()->getDetectorCount();
+	size_t iVolSize = (size_t)m_pProjector->getVolumeGeometry()->getGridTotCount();
+	return (2 * iProjSize + 2 * iVolSize) * sizeof(float32);
+}
+
 //----------------------------------------------------------------------------------------
 // Iterate
 void CSirtAlgorithm::run(int _iNrIterations)
@@ -199,117 +221,158 @@ void CSirtAlgorithm::run(int _iNrIterations)
 	// check initialized
 	ASTRA_ASSERT(m_bIsInitialized);
 
-	m_bShouldAbort = false;
+	resetAbort();
+	m_timings.reset();
+
+	CTraceScope trace("algorithm", "SIRT");
+	trace.addArg("iterations", _iNrIterations);
 
 	int iIteration = 0;
 
+	// sizes, for counting bytes moved by vector operations
+	const double fVolBytes = (double)m_pReconstruction->getSize() * sizeof(float32);
+	const double fSinoBytes = (double)m_pSinogram->getSize() * sizeof(float32);
+
 	// data projectors
 	CDataProjectorInterface* pForwardProjector;
 	CDataProjectorInterface* pBackProjector;
 	CDataProjectorInterface* pFirstForwardProjector;
+	CPixelDrivenBackProjector2D* pPixelDrivenBP = 0;
 
-	m_pTotalRayLength->setData(0.0f);
-	m_pTotalPixelWeight->setData(0.0f);
+	{
+		CPhaseTimer timer(m_timings, ALGPHASE_SETUP);
 
-	// forward projection data projector
-	pForwardProjector = dispatchDataProjector(
-		m_pProjector, 
-			SinogramMaskPolicy(m_pSinogramMask),														// sinogram mask
-			ReconstructionMaskPolicy(m_pReconstructionMask),											// reconstruction mask
-			DiffFPPolicy(m_pReconstruction, m_pDiffSinogram, m_pSinogram),								// forward projection with difference calculation
-			m_bUseSinogramMask, m_bUseReconstructionMask, true											// options on/off
-		); 
+		m_pTotalRayLength->setData(0.0f);
+		m_pTotalPixelWeight->setData(0.0f);
 
-	// backprojection data projector
-	pBackProjector = dispatchDataProjector(
-			m_pProjector, 
-			SinogramMaskPolicy(m_pSinogramMask),														// sinogram mask
-			ReconstructionMaskPolicy(m_pReconstructionMask),											// reconstruction mask
-			DefaultBPPolicy(m_pTmpVolume, m_pDiffSinogram), // backprojection
-			m_bUseSinogramMask, m_bUseReconstructionMask, true // options on/off
-		); 
-
-	// first time forward projection data projector,
-	// also computes total pixel weight and total ray length
-	pFirstForwardProjector = dispatchDataProjector(
+		// forward projection data projector
+		pForwardProjector = dispatchDataProjector(
 			m_pProjector, 
-			SinogramMaskPolicy(m_pSinogramMask),														// sinogram mask
-			ReconstructionMaskPolicy(m_pReconstructionMask),											// reconstruction mask
-			Combine3Policy<DiffFPPolicy, TotalPixelWeightPolicy, TotalRayLengthPolicy>(					// 3 basic operations
+				SinogramMaskPolicy(m_pSinogramMask),														// sinogram mask
+				ReconstructionMaskPolicy(m_pReconstructionMask),											// reconstruction mask
 				DiffFPPolicy(m_pReconstruction, m_pDiffSinogram, m_pSinogram),								// forward projection with difference calculation
-				TotalPixelWeightPolicy(m_pTotalPixelWeight),												// calculate the total pixel weights
-				TotalRayLengthPolicy(m_pTotalRayLength)),													// calculate the total ray lengths
-			m_bUseSinogramMask, m_bUseReconstructionMask, true											 // options on/off
-		);
-
-
-
-	// forward projection, difference calculation and raylength/pixelweight computation
-	pFirstForwardProjector->project();
-
-	float32* pfT = m_pTotalPixelWeight->getData();
-	for (int i = 0; i < m_pTotalPixelWeight->getSize(); ++i) {
-		float32 x = pfT[i];
-		if (x < -eps || x > eps)
-			x = 1.0f / x;
-		else
-			x = 0.0f;
-		pfT[i] = m_fLambda * x;
-	}
-	pfT = m_pTotalRayLength->getData();
-	for (int i = 0; i < m_pTotalRayLength->getSize(); ++i) {
-		float32 x = pfT[i];
-		if (x < -eps || x > eps)
-			x = 1.0f / x;
-		else
-			x = 0.0f;
-		pfT[i] = x;
+				m_bUseSinogramMask, m_bUseReconstructionMask, true											// options on/off
+			); 
+
+		// backprojection data projector
+		pBackProjector = dispatchDataProjector(
+				m_pProjector, 
+				SinogramMaskPolicy(m_pSinogramMask),														// sinogram mask
+				ReconstructionMaskPolicy(m_pReconstructionMask),											// reconstruction mask
+				DefaultBPPolicy(m_pTmpVolume, m_pDiffSinogram), // backprojection
+				m_bUseSinogramMask, m_bUseReconstructionMask, true // options on/off
+			); 
+
+		if (m_bPixelDriven) {
+			pPixelDrivenBP = new CPixelDrivenBackProjector2D(m_pProjector->getProjectionGeometry(), m_pProjector->getVolumeGeometry());
+			if (!pPixelDrivenBP->isInitialized())
+				ASTRA_DELETE(pPixelDrivenBP);
+		}
+
+		// first time forward projection data projector,
+		// also computes total pixel weight and total ray length
+		pFirstForwardProjector = dispatchDataProjector(
+				m_pProjector, 
+				SinogramMaskPolicy(m_pSinogramMask),														// sinogram mask
+				ReconstructionMaskPolicy(m_pReconstructionMask),											// reconstruction mask
+				Combine3Policy<DiffFPPolicy, TotalPixelWeightPolicy, TotalRayLengthPolicy>(					// 3 basic operations
+					DiffFPPolicy(m_pReconstruction, m_pDiffSinogram, m_pSinogram),								// forward projection with difference calculation
+					TotalPixelWeightPolicy(m_pTotalPixelWeight),												// calculate the total pixel weights
+					TotalRayLengthPolicy(m_pTotalRayLength)),													// calculate the total ray lengths
+				m_bUseSinogramMask, m_bUseReconstructionMask, true											 // options on/off
+			);
 	}
 
-	// divide by line weights
-	(*m_pDiffSinogram) *= (*m_pTotalRayLength);
-
-	// backprojection
-	m_pTmpVolume->setData(0.0f);
-	pBackProjector->project();
-
-	// divide by pixel weights
-	(*m_pTmpVolume) *= (*m_pTotalPixelWeight);
-	(*m_pReconstruction) += (*m_pTmpVolume);
-
-	if (m_bUseMinConstraint)
-		m_pReconstruction->clampMin(m_fMinValue);
-	if (m_bUseMaxConstraint)
-		m_pReconstruction->clampMax(m_fMaxValue);
 
-	// update iteration count
-	m_iIterationCount++;
-	iIteration++;
+	// progress: every iteration is a forward and a backprojection
+	const float32 fStep = 0.5f / std::max(_iNrIterations, 1);
 
+	// iteration loop. The first iteration also computes the ray and pixel
+	// weights, and always runs.
+	for (; (iIteration == 0 || iIteration < _iNrIterations) && !m_bShouldAbort; ++iIteration) {
+		const float32 fProgress = 2 * iIteration * fStep;
 
-	
-
-	// iteration loop
-	for (; iIteration < _iNrIterations && !m_bShouldAbort; ++iIteration) {
 		// forward projection and difference calculation
-		pForwardProjector->project();
-
-		// divide by line weights
-		(*m_pDiffSinogram) *= (*m_pTotalRayLength);
-
+		if (iIteration == 0) {
+			CPhaseTimer timer(m_timings, ALGPHASE_WEIGHTS);
+
+			// also computes the raylength/pixelweight
+			if (!pFirstForwardProjector->project(CAlgorithmCheckpoint(this, ALGPHASE_WEIGHTS, fProgress, fProgress + fStep)))
+				break;
+
+			// the pixel weights must come from the backprojector that is
+			// used in the iterations
+			if (pPixelDrivenBP) {
+				CFloat32ProjectionData2D ones(m_pSinogram->getGeometry(), 1.0f);
+				m_pTotalPixelWeight->setData(0.0f);
+				if (!pPixelDrivenBP->backProject(&ones, m_pTotalPixelWeight,
+				                                 m_bUseSinogramMask ? m_pSinogramMask : 0,
+				                                 m_bUseReconstructionMask ? m_pReconstructionMask : 0))
+					break;
+			}
+
+			float32* pfT = m_pTotalPixelWeight->getData();
+			for (int i = 0; i < m_pTotalPixelWeight->getSize(); ++i) {
+				float32 x = pfT[i];
+				if (x < -eps || x > eps)
+					x = 1.0f / x;
+				else
+					x = 0.0f;
+				pfT[i] = m_fLambda * x;
+			}
+			pfT = m_pTotalRayLength->getData();
+			for (int i = 0; i < m_pTotalRayLength->getSize(); ++i) {
+				float32 x = pfT[i];
+				if (x < -eps || x > eps)
+					x = 1.0f / x;
+				else
+					x = 0.0f;
+				pfT[i] = x;
+			}
+			m_timings.addBytes(2 * fVolBytes + 2 * fSinoBytes);
+		} else {
+			CPhaseTimer timer(m_timings, ALGPHASE_FP);
+			if (!pForwardProjector->projectParallel(CAlgorithmCheckpoint(this, ALGPHASE_FP, fProgress, fProgress + fStep)))
+				break;
+		}
+		addProjectionCounts();
+
+		{
+			CPhaseTimer timer(m_timings, ALGPHASE_VECTOROPS);
+			// divide by line weights
+			(*m_pDiffSinogram) *= (*m_pTotalRayLength);
+			m_timings.addBytes(3 * fSinoBytes);
+		}
 
 		// backprojection
-		m_pTmpVolume->setData(0.0f);
-		pBackProjector->project();
-
-		// multiply with relaxation factor divided by pixel weights
-		(*m_pTmpVolume) *= (*m_pTotalPixelWeight);
-		(*m_pReconstruction) += (*m_pTmpVolume);
-
-		if (m_bUseMinConstraint)
-			m_pReconstruction->clampMin(m_fMinValue);
-		if (m_bUseMaxConstraint)
-			m_pReconstruction->clampMax(m_fMaxValue);
+		{
+			CPhaseTimer timer(m_timings, ALGPHASE_BP);
+			m_pTmpVolume->setData(0.0f);
+			CAlgorithmCheckpoint checkpoint(this, ALGPHASE_BP, fProgress + fStep, fProgress + 2 * fStep);
+			if (pPixelDrivenBP) {
+				if (!pPixelDrivenBP->backProject(m_pDiffSinogram, m_pTmpVolume,
+				                                 m_bUseSinogramMask ? m_pSinogramMask : 0,
+				                                 m_bUseReconstructionMask ? m_pReconstructionMask : 0,
+				                                 &checkpoint))
+					break;
+			} else if (!pBackProjector->project(checkpoint))
+				break;
+		}
+		addProjectionCounts();
+
+		{
+			CPhaseTimer timer(m_timings, ALGPHASE_VECTOROPS);
+
+			// multiply with relaxation factor divided by pixel weights
+			(*m_pTmpVolume) *= (*m_pTotalPixelWeight);
+			(*m_pReconstruction) += (*m_pTmpVolume);
+
+			if (m_bUseMinConstraint)
+				m_pReconstruction->clampMin(m_fMinValue);
+			if (m_bUseMaxConstraint)
+				m_pReconstruction->clampMax(m_fMaxValue);
+			m_timings.addBytes(6 * fVolBytes);
+		}
 
 		// update iteration count
 		m_iIterationCount++;
@@ -319,6 +382,7 @@ void CSirtAlgorithm::run(int _iNrIterations)
 	ASTRA_DELETE(pForwardProjector);
 	ASTRA_DELETE(pBackProjector);
 	ASTRA_DELETE(pFirstForwardProjector);
+	ASTRA_DELETE(pPixelDrivenBP);
 }
 //----------------------------------------------------------------------------------------
 
@@ -0,0 +1,352 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#include "astra/SirtAlgorithm3D.h"
+
+#include <cmath>
+
+#include "astra/AstraObjectManager.h"
+#include "astra/Projector3D.h"
+#include "astra/Reduction.h"
+
+#include "astra/Logging.h"
+
+using namespace std;
+
+namespace astra {
+
+// type of the algorithm, needed to register with CAlgorithmFactory
+std::string CSirtAlgorithm3D::type = "SIRT3D";
+
+//----------------------------------------------------------------------------------------
+// Constructor
+CSirtAlgorithm3D::CSirtAlgorithm3D() 
+{
+	m_pTotalRayLength = NULL;
+	m_pTotalPixelWeight = NULL;
+	m_pDiffSinogram = NULL;
+	m_pTmpVolume = NULL;
+	m_bWeightsComputed = false;
+	m_iIterationCount = 0;
+	m_fLambda = 1.0f;
+	m_fResidualNorm = -1.0f;
+}
+
+//----------------------------------------------------------------------------------------
+// Destructor
+CSirtAlgorithm3D::~CSirtAlgorithm3D() 
+{
+	clear();
+}
+
+//---------------------------------------------------------------------------------------
+// Clear - Public
+void CSirtAlgorithm3D::clear()
+{
+	CReconstructionAlgorithm3D::_clear();
+
+	ASTRA_DELETE(m_pTotalRayLength);
+	ASTRA_DELETE(m_pTotalPixelWeight);
+	ASTRA_DELETE(m_pDiffSinogram);
+	ASTRA_DELETE(m_pTmpVolume);
+	m_projection.clear();
+
+	m_bWeightsComputed = false;
+	m_iIterationCount = 0;
+	m_fLambda = 1.0f;
+	m_fResidualNorm = -1.0f;
+}
+
+//---------------------------------------------------------------------------------------
+// Check
+bool CSirtAlgorithm3D::_check()
+{
+	// check base class
+	ASTRA_CONFIG_CHECK(CReconstructionAlgorithm3D::_check(), "SIRT3D", "Error in ReconstructionAlgorithm3D initialization");
+
+	CFloat32ProjectionData3DMemory* pSinoMem = dynamic_cast<CFloat32ProjectionData3DMemory*>(m_pSinogram);
+	CFloat32VolumeData3DMemory* pReconMem = dynamic_cast<CFloat32VolumeData3DMemory*>(m_pReconstruction);
+	ASTRA_CONFIG_CHECK(pSinoMem && pReconMem, "SIRT3D", "Data objects must be stored in memory.");
+	ASTRA_CONFIG_CHECK(pSinoMem->isPacked() && pReconMem->isPacked(), "SIRT3D", "Data objects with a row pitch are not supported.");
+	if (m_bUseReconstructionMask) {
+		CFloat32VolumeData3DMemory* pMask = dynamic_cast<CFloat32VolumeData3DMemory*>(m_pReconstructionMask);
+		ASTRA_CONFIG_CHECK(pMask && pMask->isPacked(), "SIRT3D", "Invalid Reconstruction Mask Object.");
+		ASTRA_CONFIG_CHECK(pMask->getGeometry()->isEqual(m_pReconstruction->getGeometry()), "SIRT3D", "Reconstruction Mask not compatible with the Reconstruction Data.");
+	}
+	if (m_bUseSinogramMask) {
+		CFloat32ProjectionData3DMemory* pMask = dynamic_cast<CFloat32ProjectionData3DMemory*>(m_pSinogramMask);
+		ASTRA_CONFIG_CHECK(pMask && pMask->isPacked(), "SIRT3D", "Invalid Sinogram Mask Object.");
+		ASTRA_CONFIG_CHECK(pMask->getGeometry()->isEqual(m_pSinogram->getGeometry()), "SIRT3D", "Sinogram Mask not compatible with the Projection Data.");
+	}
+	if (m_pProjector) {
+		ASTRA_CONFIG_CHECK(m_pSinogram->getGeometry()->isEqual(m_pProjector->getProjectionGeometry()), "SIRT3D", "Projection Data not compatible with the specified Projector.");
+		ASTRA_CONFIG_CHECK(m_pReconstruction->getGeometry()->isEqual(m_pProjector->getVolumeGeometry()), "SIRT3D", "Reconstruction Data not compatible with the specified Projector.");
+	}
+
+	ASTRA_CONFIG_CHECK(m_projection.isInitialized(), "SIRT3D", "Unsupported geometry.");
+	ASTRA_CONFIG_CHECK(m_pTotalRayLength && m_pTotalRayLength->isInitialized(), "SIRT3D", "Invalid TotalRayLength Object");
+	ASTRA_CONFIG_CHECK(m_pTotalPixelWeight && m_pTotalPixelWeight->isInitialized(), "SIRT3D", "Invalid TotalPixelWeight Object");
+	ASTRA_CONFIG_CHECK(m_pDiffSinogram && m_pDiffSinogram->isInitialized(), "SIRT3D", "Invalid DiffSinogram Object");
+	ASTRA_CONFIG_CHECK(m_pTmpVolume && m_pTmpVolume->isInitialized(), "SIRT3D", "Invalid TmpVolume Object");
+
+	return true;
+}
+
+//---------------------------------------------------------------------------------------
+// Initialize - Config
+bool CSirtAlgorithm3D::initialize(const Config& _cfg)
+{
+	ASTRA_ASSERT(_cfg.self);
+	ConfigStackCheck<CAlgorithm> CC("SirtAlgorithm3D", this, _cfg);
+
+	// if already initialized, clear first
+	if (m_bIsInitialized) {
+		clear();
+	}
+
+	// initialization of parent class
+	if (!CReconstructionAlgorithm3D::initialize(_cfg)) {
+		return false;
+	}
+
+	m_fLambda = _cfg.self.getOptionNumerical("Relaxation", 1.0f);
+	CC.markOptionParsed("Relaxation");
+
+	// init data objects and projections
+	_init();
+
+	// success
+	m_bIsInitialized = _check();
+	return m_bIsInitialized;
+}
+
+//---------------------------------------------------------------------------------------
+// Initialize - C++
+bool CSirtAlgorithm3D::initialize(CProjector3D* _pProjector, 
+								  CFloat32ProjectionData3DMemory* _pSinogram, 
+								  CFloat32VolumeData3DMemory* _pReconstruction)
+{
+	// if already initialized, clear first
+	if (m_bIsInitialized) {
+		clear();
+	}
+
+	// initialization of parent class
+	if (!CReconstructionAlgorithm3D::initialize(_pProjector, _pSinogram, _pReconstruction)) {
+		return false;
+	}
+
+	m_fLambda = 1.0f;
+
+	// init data objects and projections
+	_init();
+
+	// success
+	m_bIsInitialized = _check();
+	return m_bIsInitialized;
+}
+
+//---------------------------------------------------------------------------------------
+// Initialize Data Objects - private
+void CSirtAlgorithm3D::_init()
+{
+	ASTRA_DELETE(m_pTotalRayLength);
+	ASTRA_DELETE(m_pTotalPixelWeight);
+	ASTRA_DELETE(m_pDiffSinogram);
+	ASTRA_DELETE(m_pTmpVolume);
+
+	if (!m_projection.initialize(m_pSinogram->getGeometry(), m_pReconstruction->getGeometry(), m_pProjector))
+		return;
+
+	m_pTotalRayLength = new CFloat32ProjectionData3DMemory(m_pSinogram->getGeometry());
+	m_pTotalPixelWeight = new CFloat32VolumeData3DMemory(m_pReconstruction->getGeometry());
+	m_pDiffSinogram = new CFloat32ProjectionData3DMemory(m_pSinogram->getGeometry());
+	m_pTmpVolume = new CFloat32VolumeData3DMemory(m_pReconstruction->getGeometry());
+
+	m_bWeightsComputed = false;
+}
+
+//---------------------------------------------------------------------------------------
+// Information - All
+map<string,boost::any> CSirtAlgorithm3D::getInformation() 
+{
+	map<string, boost::any> res;
+	return mergeMap<string,boost::any>(CReconstructionAlgorithm3D::getInformation(), res);
+};
+
+//---------------------------------------------------------------------------------------
+// Information - Specific
+boost::any CSirtAlgorithm3D::getInformation(std::string _sIdentifier) 
+{
+	return CReconstructionAlgorithm3D::getInformation(_sIdentifier);
+};
+
+//----------------------------------------------------------------------------------------
+// Inverse total ray lengths, A*1, and inverse total pixel weights, A'*1,
+// restricted to the masks
+bool CSirtAlgorithm3D::_computeWeights()
+{
+	const float32* pfVolMask = m_bUseReconstructionMask ? dynamic_cast<CFloat32VolumeData3DMemory*>(m_pReconstructionMask)->getDataConst() : 0;
+	const float32* pfSinoMask = m_bUseSinogramMask ? dynamic_cast<CFloat32ProjectionData3DMemory*>(m_pSinogramMask)->getDataConst() : 0;
+	const int iVolSize = m_pTmpVolume->getSize();
+	const int iSinoSize = m_pDiffSinogram->getSize();
+
+	if (pfVolMask)
+		m_pTmpVolume->copyData(pfVolMask, iVolSize);
+	else
+		m_pTmpVolume->setData(1.0f);
+	if (!m_projection.forwardProject(m_pTmpVolume, m_pTotalRayLength))
+		return false;
+
+	if (pfSinoMask)
+		m_pDiffSinogram->copyData(pfSinoMask, iSinoSize);
+	else
+		m_pDiffSinogram->setData(1.0f);
+	if (!m_projection.backProject(m_pDiffSinogram, m_pTotalPixelWeight))
+		return false;
+
+	float32* pfT = m_pTotalRayLength->getData();
+	for (int i = 0; i < iSinoSize; ++i) {
+		float32 x = pfT[i];
+		if (x < -eps || x > eps)
+			x = 1.0f / x;
+		else
+			x = 0.0f;
+		pfT[i] = pfSinoMask ? x * pfSinoMask[i] : x;
+	}
+	pfT = m_pTotalPixelWeight->getData();
+	for (int i = 0; i < iVolSize; ++i) {
+		float32 x = pfT[i];
+		if (x < -eps || x > eps)
+			x = 1.0f / x;
+		else
+			x = 0.0f;
+		pfT[i] = m_fLambda * (pfVolMask ? x * pfVolMask[i] : x);
+	}
+
+	m_bWeightsComputed = true;
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+// Iterate
+void CSirtAlgorithm3D::run(int _iNrIterations)
+{
+	// check initialized
+	ASTRA_ASSERT(m_bIsInitialized);
+
+	resetAbort();
+	m_timings.reset();
+
+	CFloat32ProjectionData3DMemory* pSinogram = dynamic_cast<CFloat32ProjectionData3DMemory*>(m_pSinogram);
+	CFloat32VolumeData3DMemory* pReconstruction = dynamic_cast<CFloat32VolumeData3DMemory*>(m_pReconstruction);
+	const float32* pfVolMask = m_bUseReconstructionMask ? dynamic_cast<CFloat32VolumeData3DMemory*>(m_pReconstructionMask)->getDataConst() : 0;
+	const float32* pfSinoMask = m_bUseSinogramMask ? dynamic_cast<CFloat32ProjectionData3DMemory*>(m_pSinogramMask)->getDataConst() : 0;
+	const int iVolSize = pReconstruction->getSize();
+	const int iSinoSize = pSinogram->getSize();
+
+	if (!m_bWeightsComputed) {
+		CPhaseTimer timer(m_timings, ALGPHASE_WEIGHTS);
+		if (!_computeWeights()) {
+			ASTRA_ERROR("SIRT3D: failed to compute the weights");
+			return;
+		}
+	}
+
+	for (int iIteration = 0; iIteration < _iNrIterations && !m_bShouldAbort; ++iIteration) {
+
+		// forward projection of the voxels inside the mask
+		{
+			CPhaseTimer timer(m_timings, ALGPHASE_FP);
+			const CFloat32VolumeData3DMemory* pInput = pReconstruction;
+			if (pfVolMask) {
+				const float32* pfX = pReconstruction->getDataConst();
+				float32* pfTmp = m_pTmpVolume->getData();
+				for (int i = 0; i < iVolSize; ++i)
+					pfTmp[i] = pfX[i] * pfVolMask[i];
+				pInput = m_pTmpVolume;
+			}
+			if (!m_projection.forwardProject(pInput, m_pDiffSinogram))
+				break;
+		}
+
+		// difference, weighted by the inverse ray lengths
+		{
+			CPhaseTimer timer(m_timings, ALGPHASE_VECTOROPS);
+			const float32* pfB = pSinogram->getDataConst();
+			const float32* pfR = m_pTotalRayLength->getDataConst();
+			float32* pfDiff = m_pDiffSinogram->getData();
+			for (int i = 0; i < iSinoSize; ++i) {
+				float32 x = pfB[i] - pfDiff[i];
+				if (pfSinoMask)
+					x *= pfSinoMask[i];
+				pfDiff[i] = x;
+			}
+			m_fResidualNorm = (float32)sqrt(reduceSquaredNorm(pfDiff, iSinoSize));
+			for (int i = 0; i < iSinoSize; ++i)
+				pfDiff[i] *= pfR[i];
+		}
+
+		// backprojection
+		{
+			CPhaseTimer timer(m_timings, ALGPHASE_BP);
+			if (!m_projection.backProject(m_pDiffSinogram, m_pTmpVolume))
+				break;
+		}
+
+		{
+			CPhaseTimer timer(m_timings, ALGPHASE_VECTOROPS);
+
+			// multiply with relaxation factor divided by pixel weights
+			const float32* pfC = m_pTotalPixelWeight->getDataConst();
+			const float32* pfTmp = m_pTmpVolume->getDataConst();
+			float32* pfX = pReconstruction->getData();
+			for (int i = 0; i < iVolSize; ++i)
+				pfX[i] += pfTmp[i] * pfC[i];
+
+			if (m_bUseMinConstraint)
+				pReconstruction->clampMin(m_fMinValue);
+			if (m_bUseMaxConstraint)
+				pReconstruction->clampMax(m_fMaxValue);
+		}
+
+		// update iteration count
+		m_iIterationCount++;
+	}
+}
+
+//----------------------------------------------------------------------------------------
+bool CSirtAlgorithm3D::getResidualNorm(float32& _fNorm)
+{
+	if (!m_bIsInitialized || m_fResidualNorm < 0.0f)
+		return false;
+
+	_fNorm = m_fResidualNorm;
+	return true;
+}
+
+} // namespace astra
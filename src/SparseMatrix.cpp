@@ -29,6 +29,8 @@ along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
 
 #include "astra/Globals.h"
 #include "astra/SparseMatrix.h"
+#include "astra/HostMemory.h"
+#include "astra/Logging.h"
 
 namespace astra
 {
@@ -38,6 +40,9 @@ namespace astra
 
 CSparseMatrix::CSparseMatrix()
 {
+	m_pfValues = 0;
+	m_piColIndices = 0;
+	m_plRowStarts = 0;
 	m_bInitialized = false;
 }
 
@@ -46,6 +51,10 @@ CSparseMatrix::CSparseMatrix()
 CSparseMatrix::CSparseMatrix(unsigned int _iHeight, unsigned int _iWidth,
                              unsigned long _lSize)
 {
+	m_pfValues = 0;
+	m_piColIndices = 0;
+	m_plRowStarts = 0;
+	m_bInitialized = false;
 	initialize(_iHeight, _iWidth, _lSize);
 }
 
@@ -54,9 +63,20 @@ CSparseMatrix::CSparseMatrix(unsigned int _iHeight, unsigned int _iWidth,
 // destructor
 CSparseMatrix::~CSparseMatrix()
 {
-	delete[] m_pfValues;
-	delete[] m_piColIndices;
-	delete[] m_plRowStarts;
+	_freeData();
+}
+
+//----------------------------------------------------------------------------------------
+// free the arrays
+void CSparseMatrix::_freeData()
+{
+	freeHostMemory(m_pfValues, (size_t)m_lSize * sizeof(float32));
+	freeHostMemory(m_piColIndices, (size_t)m_lSize * sizeof(unsigned int));
+	freeHostMemory(m_plRowStarts, ((size_t)m_iHeight + 1) * sizeof(unsigned long));
+	m_pfValues = 0;
+	m_piColIndices = 0;
+	m_plRowStarts = 0;
+	m_bInitialized = false;
 }
 
 //----------------------------------------------------------------------------------------
@@ -64,15 +84,24 @@ CSparseMatrix::~CSparseMatrix()
 bool CSparseMatrix::initialize(unsigned int _iHeight, unsigned int _iWidth,
                                unsigned long _lSize)
 {
+	if (m_bInitialized)
+		_freeData();
+
 	m_iHeight = _iHeight;
 	m_iWidth = _iWidth;
 	m_lSize = _lSize;
 
-	m_pfValues = new float32[_lSize];
-	m_piColIndices = new unsigned int[_lSize];
-	m_plRowStarts = new unsigned long[_iHeight+1];
+	// the large arrays may be backed by huge pages, see HostMemory.h
+	m_pfValues = (float32*)allocateHostMemory((size_t)_lSize * sizeof(float32));
+	m_piColIndices = (unsigned int*)allocateHostMemory((size_t)_lSize * sizeof(unsigned int));
+	m_plRowStarts = (unsigned long*)allocateHostMemory(((size_t)_iHeight + 1) * sizeof(unsigned long));
 	m_bInitialized = true;
 
+	if (!m_pfValues || !m_piColIndices || !m_plRowStarts) {
+		ASTRA_ERROR("CSparseMatrix: unable to allocate a %ux%u matrix with %lu entries", _iHeight, _iWidth, _lSize);
+		_freeData();
+	}
+
 	return m_bInitialized;
 }
 
@@ -84,6 +113,14 @@ std::string CSparseMatrix::description() const
 	return res.str();
 }
 
+size_t CSparseMatrix::getMemoryUsage() const
+{
+	if (!m_bInitialized)
+		return 0;
+	return (size_t)m_lSize * (sizeof(float32) + sizeof(unsigned int))
+	       + ((size_t)m_iHeight + 1) * sizeof(unsigned long);
+}
+
 
 
 
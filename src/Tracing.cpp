@@ -0,0 +1,306 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#include "astra/Tracing.h"
+#include "astra/AlgorithmTimings.h"
+#include "astra/Logging.h"
+#include "astra/Mutex.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <vector>
+
+
+namespace astra {
+
+volatile bool CTracer::s_bEnabled = false;
+
+namespace {
+
+struct STraceEvent {
+	char cPhase;
+	int iThread;
+	double fTimestamp;
+	const char* sCategory;
+	std::string sName;
+	std::string sArgs;
+};
+
+// Protects everything below
+CMutex g_traceMutex;
+std::string g_sTraceFile;
+double g_fTraceStart = 0.0;
+std::vector<STraceEvent> g_traceEvents;
+std::map<int, std::string> g_threadNames;
+int g_iNextThread = 1;
+
+// Trace id of this thread, or 0 if not assigned yet
+ASTRA_THREAD_LOCAL int g_iTraceThread = 0;
+
+// Must be called with the mutex held
+int getTraceThread()
+{
+	if (g_iTraceThread == 0)
+		g_iTraceThread = g_iNextThread++;
+	return g_iTraceThread;
+}
+
+void appendEscaped(std::string& _s, const std::string& _sValue)
+{
+	for (size_t i = 0; i < _sValue.size(); ++i) {
+		char c = _sValue[i];
+		if (c == '"' || c == '\\') {
+			_s += '\\';
+			_s += c;
+		} else if ((unsigned char)c < 0x20) {
+			char buf[8];
+			snprintf(buf, sizeof(buf), "\\u%04x", (int)c);
+			_s += buf;
+		} else {
+			_s += c;
+		}
+	}
+}
+
+void addEvent(char _cPhase, const char* _sCategory, const std::string& _sName, const std::string& _sArgs)
+{
+	double fNow = CAlgorithmTimings::getClock();
+
+	g_traceMutex.lock();
+	if (CTracer::isEnabled()) {
+		g_traceEvents.push_back(STraceEvent());
+		STraceEvent& e = g_traceEvents.back();
+		e.cPhase = _cPhase;
+		e.iThread = getTraceThread();
+		e.fTimestamp = fNow;
+		e.sCategory = _sCategory;
+		e.sName = _sName;
+		e.sArgs = _sArgs;
+	}
+	g_traceMutex.unlock();
+}
+
+// Must be called with the mutex held
+bool writeTrace()
+{
+	if (g_sTraceFile.empty())
+		return false;
+
+	FILE* f = fopen(g_sTraceFile.c_str(), "w");
+	if (!f) {
+		ASTRA_ERROR("CTracer: unable to open %s", g_sTraceFile.c_str());
+		return false;
+	}
+
+	std::string s;
+	fprintf(f, "{\"traceEvents\":[\n");
+	bool bFirst = true;
+	for (std::map<int, std::string>::const_iterator i = g_threadNames.begin(); i != g_threadNames.end(); ++i) {
+		s = "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":";
+		char buf[32];
+		snprintf(buf, sizeof(buf), "%d", i->first);
+		s += buf;
+		s += ",\"args\":{\"name\":\"";
+		appendEscaped(s, i->second);
+		s += "\"}}";
+		fprintf(f, "%s%s", bFirst ? "" : ",\n", s.c_str());
+		bFirst = false;
+	}
+	for (size_t i = 0; i < g_traceEvents.size(); ++i) {
+		const STraceEvent& e = g_traceEvents[i];
+		s = "{\"name\":\"";
+		appendEscaped(s, e.sName);
+		s += "\",\"cat\":\"";
+		s += e.sCategory;
+		char buf[96];
+		snprintf(buf, sizeof(buf), "\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%d", e.cPhase, (e.fTimestamp - g_fTraceStart) * 1e6, e.iThread);
+		s += buf;
+		if (!e.sArgs.empty()) {
+			s += ",\"args\":{";
+			s += e.sArgs;
+			s += "}";
+		}
+		s += "}";
+		fprintf(f, "%s%s", bFirst ? "" : ",\n", s.c_str());
+		bFirst = false;
+	}
+	fprintf(f, "\n],\"displayTimeUnit\":\"ms\"}\n");
+
+	bool ok = (fclose(f) == 0);
+	if (!ok)
+		ASTRA_ERROR("CTracer: error writing %s", g_sTraceFile.c_str());
+	return ok;
+}
+
+// Starts tracing if ASTRA_TRACE is set, and writes the trace on unload
+class CTraceEnvironment {
+public:
+	CTraceEnvironment() {
+		const char* env = getenv("ASTRA_TRACE");
+		if (env && *env)
+			CTracer::start(env);
+	}
+	~CTraceEnvironment() {
+		if (CTracer::isEnabled())
+			CTracer::stop();
+	}
+};
+
+CTraceEnvironment g_traceEnvironment;
+
+}
+
+//----------------------------------------------------------------------------------------
+void CTracer::start(const std::string& _sFilename)
+{
+	g_traceMutex.lock();
+	g_sTraceFile = _sFilename;
+	g_traceEvents.clear();
+	g_fTraceStart = CAlgorithmTimings::getClock();
+	s_bEnabled = true;
+	g_traceMutex.unlock();
+}
+
+//----------------------------------------------------------------------------------------
+bool CTracer::stop()
+{
+	g_traceMutex.lock();
+	if (!s_bEnabled) {
+		g_traceMutex.unlock();
+		return false;
+	}
+	s_bEnabled = false;
+	bool ok = writeTrace();
+	g_traceEvents.clear();
+	g_traceMutex.unlock();
+	return ok;
+}
+
+//----------------------------------------------------------------------------------------
+bool CTracer::flush()
+{
+	g_traceMutex.lock();
+	bool ok = s_bEnabled && writeTrace();
+	g_traceMutex.unlock();
+	return ok;
+}
+
+//----------------------------------------------------------------------------------------
+void CTracer::setThreadName(const std::string& _sName)
+{
+	g_traceMutex.lock();
+	g_threadNames[getTraceThread()] = _sName;
+	g_traceMutex.unlock();
+}
+
+//----------------------------------------------------------------------------------------
+void CTracer::begin(const char* _sCategory, const std::string& _sName)
+{
+	if (!s_bEnabled)
+		return;
+	addEvent('B', _sCategory, _sName, std::string());
+}
+
+//----------------------------------------------------------------------------------------
+void CTracer::end(const char* _sCategory, const std::string& _sName, const std::string& _sArgs)
+{
+	if (!s_bEnabled)
+		return;
+	addEvent('E', _sCategory, _sName, _sArgs);
+}
+
+
+//----------------------------------------------------------------------------------------
+// Trace scopes
+CTraceScope::CTraceScope(const char* _sCategory, const char* _sName)
+{
+	m_bActive = CTracer::isEnabled();
+	if (!m_bActive)
+		return;
+	m_sCategory = _sCategory;
+	m_sName = _sName;
+	CTracer::begin(m_sCategory, m_sName);
+}
+
+CTraceScope::CTraceScope(const char* _sCategory, const std::string& _sName)
+{
+	m_bActive = CTracer::isEnabled();
+	if (!m_bActive)
+		return;
+	m_sCategory = _sCategory;
+	m_sName = _sName;
+	CTracer::begin(m_sCategory, m_sName);
+}
+
+CTraceScope::~CTraceScope()
+{
+	if (m_bActive)
+		CTracer::end(m_sCategory, m_sName, m_sArgs);
+}
+
+void CTraceScope::addArg(const char* _sKey, double _fValue)
+{
+	if (!m_bActive)
+		return;
+	// JSON has no nan or inf; x - x is only 0 for finite x
+	char buf[64];
+	if (_fValue - _fValue == 0.0)
+		snprintf(buf, sizeof(buf), "%.17g", _fValue);
+	else
+		snprintf(buf, sizeof(buf), "null");
+	if (!m_sArgs.empty())
+		m_sArgs += ',';
+	m_sArgs += '"';
+	appendEscaped(m_sArgs, _sKey);
+	m_sArgs += "\":";
+	m_sArgs += buf;
+}
+
+void CTraceScope::addArg(const char* _sKey, const std::string& _sValue)
+{
+	if (!m_bActive)
+		return;
+	if (!m_sArgs.empty())
+		m_sArgs += ',';
+	m_sArgs += '"';
+	appendEscaped(m_sArgs, _sKey);
+	m_sArgs += "\":\"";
+	appendEscaped(m_sArgs, _sValue);
+	m_sArgs += '"';
+}
+
+void CTraceScope::addDims(const char* _sKey, size_t _iX, size_t _iY, size_t _iZ)
+{
+	if (!m_bActive)
+		return;
+	char buf[96];
+	snprintf(buf, sizeof(buf), "%lu x %lu x %lu", (unsigned long)_iX, (unsigned long)_iY, (unsigned long)_iZ);
+	addArg(_sKey, std::string(buf));
+}
+
+}
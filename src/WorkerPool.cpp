@@ -0,0 +1,444 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+#include "astra/WorkerPool.h"
+#include "astra/Logging.h"
+#include "astra/Mutex.h"
+#include "astra/Tracing.h"
+
+#include <deque>
+#include <cstdio>
+#include <cstdlib>
+
+#ifdef USE_PTHREADS
+#include <pthread.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
+#else
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#endif
+
+namespace astra {
+
+DEFINE_SINGLETON(CWorkerPool)
+
+SWorkerPoolParams CWorkerPool::s_params;
+
+// Index of the pool worker running on this thread, or -1
+static ASTRA_THREAD_LOCAL int g_iWorkerIndex = -1;
+
+struct SWorkerQueue {
+	CMutex mutex;
+	std::deque<CWorkerTask*> tasks;
+};
+
+struct SWorkerThreadInfo {
+	CWorkerPool* m_pPool;
+	int m_iIndex;
+};
+
+struct SWorkerPoolState {
+	// Protects everything below, except the contents of the queues
+	CMutex mutex;
+	// Signalled when tasks are queued, or on shutdown
+	CCondition condWork;
+	// Signalled when a task group finishes, or tasks are queued while
+	// threads are waiting on a group
+	CCondition condDone;
+
+	volatile bool bRunning;
+	bool bStopping;
+	volatile int iQueued;
+	int iSleepingWaiters;
+	unsigned int iNextQueue;
+
+	std::vector<SWorkerQueue*> queues;
+	std::vector<SWorkerThreadInfo> infos;
+#ifdef USE_PTHREADS
+	std::vector<pthread_t> threads;
+#else
+	std::vector<boost::thread*> threads;
+#endif
+};
+
+
+#ifdef USE_PTHREADS
+static void* runWorker_pthreads(void* data)
+{
+	SWorkerThreadInfo* info = (SWorkerThreadInfo*)data;
+	info->m_pPool->workerLoop(info->m_iIndex);
+	return 0;
+}
+#else
+static void runWorker_boost(SWorkerThreadInfo* info)
+{
+	info->m_pPool->workerLoop(info->m_iIndex);
+}
+#endif
+
+static int getDefaultThreadCount()
+{
+	const char* env = getenv("ASTRA_NUM_THREADS");
+	if (env) {
+		int n = atoi(env);
+		if (n > 0)
+			return n;
+	}
+#ifdef USE_PTHREADS
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+#else
+	long n = boost::thread::hardware_concurrency();
+#endif
+	if (n < 1)
+		n = 1;
+	return (int)n;
+}
+
+
+//----------------------------------------------------------------------------------------
+// Task groups
+CTaskGroup::CTaskGroup() : m_iPending(0)
+{
+
+}
+
+CTaskGroup::~CTaskGroup()
+{
+	wait();
+}
+
+void CTaskGroup::wait()
+{
+	if (m_iPending == 0)
+		return;
+	CWorkerPool::getSingleton()._wait(this);
+}
+
+
+//----------------------------------------------------------------------------------------
+// Constructor
+CWorkerPool::CWorkerPool()
+{
+	m_pState = new SWorkerPoolState;
+	m_pState->bRunning = false;
+	m_pState->bStopping = false;
+	m_pState->iQueued = 0;
+	m_pState->iSleepingWaiters = 0;
+	m_pState->iNextQueue = 0;
+}
+
+//----------------------------------------------------------------------------------------
+// Destructor
+CWorkerPool::~CWorkerPool()
+{
+	shutdown();
+	delete m_pState;
+}
+
+//----------------------------------------------------------------------------------------
+// Start the workers. Must be called with the state mutex held.
+void CWorkerPool::_start()
+{
+	if (m_pState->bRunning)
+		return;
+
+	int iThreadCount = s_params.iThreadCount;
+	if (iThreadCount <= 0)
+		iThreadCount = getDefaultThreadCount();
+
+	ASTRA_DEBUG("CWorkerPool: starting %d worker threads", iThreadCount);
+
+	m_pState->bStopping = false;
+	m_pState->queues.resize(iThreadCount);
+	m_pState->infos.resize(iThreadCount);
+	m_pState->threads.resize(iThreadCount);
+	for (int i = 0; i < iThreadCount; ++i) {
+		m_pState->queues[i] = new SWorkerQueue;
+		m_pState->infos[i].m_pPool = this;
+		m_pState->infos[i].m_iIndex = i;
+	}
+
+	for (int i = 0; i < iThreadCount; ++i) {
+#ifdef USE_PTHREADS
+		pthread_create(&m_pState->threads[i], 0, runWorker_pthreads, (void*)&m_pState->infos[i]);
+#ifdef __linux__
+		if (!s_params.affinity.empty()) {
+			cpu_set_t cpuset;
+			CPU_ZERO(&cpuset);
+			CPU_SET(s_params.affinity[i % s_params.affinity.size()], &cpuset);
+			if (pthread_setaffinity_np(m_pState->threads[i], sizeof(cpu_set_t), &cpuset) != 0)
+				ASTRA_WARN("CWorkerPool: unable to set affinity of worker %d", i);
+		}
+#endif
+#else
+		m_pState->threads[i] = new boost::thread(runWorker_boost, &m_pState->infos[i]);
+#endif
+	}
+
+	m_pState->bRunning = true;
+}
+
+//----------------------------------------------------------------------------------------
+// Stop the workers
+void CWorkerPool::shutdown()
+{
+	m_pState->mutex.lock();
+	if (!m_pState->bRunning) {
+		m_pState->mutex.unlock();
+		return;
+	}
+	m_pState->bStopping = true;
+	m_pState->condWork.notifyAll();
+	m_pState->mutex.unlock();
+
+	// Workers drain all queued tasks before exiting
+	for (unsigned int i = 0; i < m_pState->threads.size(); ++i) {
+#ifdef USE_PTHREADS
+		pthread_join(m_pState->threads[i], 0);
+#else
+		m_pState->threads[i]->join();
+		delete m_pState->threads[i];
+#endif
+	}
+
+	m_pState->mutex.lock();
+	for (unsigned int i = 0; i < m_pState->queues.size(); ++i)
+		delete m_pState->queues[i];
+	m_pState->queues.clear();
+	m_pState->infos.clear();
+	m_pState->threads.clear();
+	m_pState->bRunning = false;
+	m_pState->bStopping = false;
+	m_pState->mutex.unlock();
+}
+
+//----------------------------------------------------------------------------------------
+int CWorkerPool::getThreadCount()
+{
+	m_pState->mutex.lock();
+	_start();
+	int n = m_pState->threads.size();
+	m_pState->mutex.unlock();
+	return n;
+}
+
+//----------------------------------------------------------------------------------------
+bool CWorkerPool::isWorkerThread()
+{
+	return g_iWorkerIndex >= 0;
+}
+
+//----------------------------------------------------------------------------------------
+int CWorkerPool::_chunkCount(int _iSize, int _iGrain)
+{
+	if (_iGrain < 1)
+		_iGrain = 1;
+	int iChunks = (_iSize + _iGrain - 1) / _iGrain;
+	// A few chunks per thread, to allow stealing to even out the load
+	int iMax = 4 * getThreadCount();
+	if (iChunks > iMax)
+		iChunks = iMax;
+	return iChunks;
+}
+
+//----------------------------------------------------------------------------------------
+// Submit
+void CWorkerPool::submit(CWorkerTask* _pTask, CTaskGroup* _pGroup, bool _bAutoDelete)
+{
+	ASTRA_ASSERT(_pTask);
+
+	_pTask->m_pGroup = _pGroup;
+	_pTask->m_bAutoDelete = _bAutoDelete;
+
+	m_pState->mutex.lock();
+	_start();
+	if (_pGroup)
+		_pGroup->m_iPending++;
+
+	// Tasks submitted by a worker go to its own queue, others are
+	// distributed round-robin.
+	unsigned int iQueue;
+	if (g_iWorkerIndex >= 0 && (unsigned int)g_iWorkerIndex < m_pState->queues.size())
+		iQueue = g_iWorkerIndex;
+	else
+		iQueue = (m_pState->iNextQueue++) % m_pState->queues.size();
+
+	SWorkerQueue* q = m_pState->queues[iQueue];
+	q->mutex.lock();
+	q->tasks.push_back(_pTask);
+	q->mutex.unlock();
+
+	m_pState->iQueued++;
+	m_pState->condWork.notifyAll();
+	if (m_pState->iSleepingWaiters > 0)
+		m_pState->condDone.notifyAll();
+	m_pState->mutex.unlock();
+}
+
+//----------------------------------------------------------------------------------------
+// Take a single task from the queues and run it. Workers take from the back
+// of their own queue, and steal from the front of the others.
+bool CWorkerPool::runOneTask()
+{
+	// The state mutex keeps shutdown() from deleting the queues while we
+	// look at them, and keeps iQueued in step with the queues.
+	m_pState->mutex.lock();
+	if (m_pState->iQueued == 0 || !m_pState->bRunning) {
+		m_pState->mutex.unlock();
+		return false;
+	}
+
+	CWorkerTask* pTask = 0;
+	unsigned int n = m_pState->queues.size();
+	unsigned int iStart = (g_iWorkerIndex >= 0) ? g_iWorkerIndex : 0;
+	for (unsigned int k = 0; k < n && !pTask; ++k) {
+		SWorkerQueue* q = m_pState->queues[(iStart + k) % n];
+		q->mutex.lock();
+		if (!q->tasks.empty()) {
+			if (k == 0 && g_iWorkerIndex >= 0) {
+				pTask = q->tasks.back();
+				q->tasks.pop_back();
+			} else {
+				pTask = q->tasks.front();
+				q->tasks.pop_front();
+			}
+		}
+		q->mutex.unlock();
+	}
+
+	if (pTask)
+		m_pState->iQueued--;
+	m_pState->mutex.unlock();
+
+	if (!pTask)
+		return false;
+
+	{
+		CTraceScope trace("pool", "task");
+		pTask->run();
+	}
+	_finish(pTask);
+
+	return true;
+}
+
+//----------------------------------------------------------------------------------------
+void CWorkerPool::_finish(CWorkerTask* _pTask)
+{
+	CTaskGroup* pGroup = _pTask->m_pGroup;
+	if (_pTask->m_bAutoDelete)
+		delete _pTask;
+
+	if (pGroup) {
+		m_pState->mutex.lock();
+		pGroup->m_iPending--;
+		if (pGroup->m_iPending == 0)
+			m_pState->condDone.notifyAll();
+		m_pState->mutex.unlock();
+	}
+}
+
+//----------------------------------------------------------------------------------------
+// Wait for a group, executing queued tasks in the meantime
+void CWorkerPool::_wait(CTaskGroup* _pGroup)
+{
+	while (true) {
+		m_pState->mutex.lock();
+		if (_pGroup->m_iPending == 0) {
+			m_pState->mutex.unlock();
+			return;
+		}
+		if (m_pState->iQueued == 0) {
+			// Everything left is already running elsewhere
+			m_pState->iSleepingWaiters++;
+			m_pState->condDone.wait(m_pState->mutex);
+			m_pState->iSleepingWaiters--;
+		}
+		m_pState->mutex.unlock();
+
+		runOneTask();
+	}
+}
+
+//----------------------------------------------------------------------------------------
+void CWorkerPool::workerLoop(int _iIndex)
+{
+	g_iWorkerIndex = _iIndex;
+
+	char name[32];
+	snprintf(name, sizeof(name), "worker %d", _iIndex);
+	CTracer::setThreadName(name);
+
+	while (true) {
+		if (runOneTask())
+			continue;
+
+		m_pState->mutex.lock();
+		while (m_pState->iQueued == 0 && !m_pState->bStopping)
+			m_pState->condWork.wait(m_pState->mutex);
+		bool bExit = m_pState->bStopping && m_pState->iQueued == 0;
+		m_pState->mutex.unlock();
+
+		if (bExit)
+			break;
+	}
+
+	g_iWorkerIndex = -1;
+}
+
+//----------------------------------------------------------------------------------------
+//static
+void CWorkerPool::setGlobalParams(const SWorkerPoolParams& _params)
+{
+	// _start reads s_params with the state mutex held
+	CWorkerPool& pool = getSingleton();
+	pool.m_pState->mutex.lock();
+	bool bChanged = _params.iThreadCount != s_params.iThreadCount || _params.affinity != s_params.affinity;
+	s_params = _params;
+	pool.m_pState->mutex.unlock();
+
+	ASTRA_DEBUG("CWorkerPool: setting thread count %d", _params.iThreadCount);
+
+	if (bChanged)
+		pool.shutdown();
+}
+
+//----------------------------------------------------------------------------------------
+//static
+SWorkerPoolParams CWorkerPool::getGlobalParams()
+{
+	CWorkerPool& pool = getSingleton();
+	pool.m_pState->mutex.lock();
+	SWorkerPoolParams params = s_params;
+	pool.m_pState->mutex.unlock();
+	return params;
+}
+
+} // end namespace
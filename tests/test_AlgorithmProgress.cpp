@@ -0,0 +1,170 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+
+#include <vector>
+
+#include "astra/SirtAlgorithm.h"
+#include "astra/CglsAlgorithm.h"
+#include "astra/AsyncAlgorithm.h"
+#include "astra/ParallelBeamLineKernelProjector2D.h"
+#include "astra/ParallelProjectionGeometry2D.h"
+#include "astra/VolumeGeometry2D.h"
+#include "astra/Float32VolumeData2D.h"
+#include "astra/Float32ProjectionData2D.h"
+
+namespace {
+
+class CRecordProgress : public astra::CAlgorithmProgress {
+public:
+	CRecordProgress() : m_pAbort(0), m_fAbortAt(2.0f) { }
+	virtual void progress(astra::float32 _fProgress, astra::EAlgorithmPhase _ePhase) {
+		m_progress.push_back(_fProgress);
+		m_phases.push_back(_ePhase);
+		if (m_pAbort && _fProgress >= m_fAbortAt)
+			m_pAbort->signalAbort();
+	}
+	std::vector<astra::float32> m_progress;
+	std::vector<astra::EAlgorithmPhase> m_phases;
+	astra::CAlgorithm* m_pAbort;
+	astra::float32 m_fAbortAt;
+};
+
+// Aborts once, at the first report of a backprojection past _fAbortAfter
+class CAbortInBP : public astra::CAlgorithmProgress {
+public:
+	CAbortInBP(astra::CAlgorithm* _pAlg, astra::float32 _fAbortAfter)
+		: m_pAbort(_pAlg), m_fAbortAfter(_fAbortAfter) { }
+	virtual void progress(astra::float32 _fProgress, astra::EAlgorithmPhase _ePhase) {
+		if (m_pAbort && _ePhase == astra::ALGPHASE_BP && _fProgress > m_fAbortAfter) {
+			m_pAbort->signalAbort();
+			m_pAbort = 0;
+		}
+	}
+	astra::CAlgorithm* m_pAbort;
+	astra::float32 m_fAbortAfter;
+};
+
+struct TestSirt {
+	TestSirt() : vg(32, 32) {
+		for (int i = 0; i < 100; ++i)
+			angles[i] = i * 3.14159265f / 100;
+		pg.initialize(100, 48, 1.0f, angles);
+		proj.initialize(&pg, &vg);
+		sino = new astra::CFloat32ProjectionData2D(&pg, 1.0f);
+		rec = new astra::CFloat32VolumeData2D(&vg, 0.0f);
+		sirt.initialize(&proj, sino, rec);
+	}
+	~TestSirt() {
+		sirt.clear();
+		delete sino;
+		delete rec;
+	}
+
+	astra::float32 angles[100];
+	astra::CVolumeGeometry2D vg;
+	astra::CParallelProjectionGeometry2D pg;
+	astra::CParallelBeamLineKernelProjector2D proj;
+	astra::CFloat32ProjectionData2D* sino;
+	astra::CFloat32VolumeData2D* rec;
+	astra::CSirtAlgorithm sirt;
+};
+
+}
+
+BOOST_FIXTURE_TEST_CASE( testAlgorithmProgress_Sirt, TestSirt )
+{
+	CRecordProgress progress;
+	sirt.setProgressCallback(&progress);
+	sirt.run(4);
+
+	BOOST_REQUIRE(!progress.m_progress.empty());
+	for (size_t i = 1; i < progress.m_progress.size(); ++i)
+		BOOST_CHECK(progress.m_progress[i] >= progress.m_progress[i-1]);
+	BOOST_CHECK_CLOSE(progress.m_progress.back(), 1.0f, 1e-3);
+	BOOST_CHECK_EQUAL(progress.m_phases.front(), astra::ALGPHASE_WEIGHTS);
+	BOOST_CHECK_EQUAL(progress.m_phases.back(), astra::ALGPHASE_BP);
+}
+
+BOOST_FIXTURE_TEST_CASE( testAlgorithmProgress_Abort, TestSirt )
+{
+	CRecordProgress progress;
+	progress.m_pAbort = &sirt;
+	progress.m_fAbortAt = 0.05f;
+	sirt.setProgressCallback(&progress);
+	sirt.run(10);
+
+	// aborted at the end of the first forward projection
+	BOOST_REQUIRE(!progress.m_progress.empty());
+	BOOST_CHECK(progress.m_progress.back() < 0.1f);
+	BOOST_CHECK(sirt.shouldAbort());
+}
+
+BOOST_FIXTURE_TEST_CASE( testAlgorithmProgress_Async, TestSirt )
+{
+	CRecordProgress progress;
+	astra::CAsyncAlgorithm async(&sirt);
+	async.setProgressCallback(&progress);
+	async.run(2);
+	while (!async.isDone()) { }
+
+	BOOST_CHECK_CLOSE(async.getProgress(), 1.0f, 1e-3);
+	BOOST_CHECK(!progress.m_progress.empty());
+}
+
+BOOST_FIXTURE_TEST_CASE( testAlgorithmProgress_CglsAbortInBP, TestSirt )
+{
+	for (int i = 0; i < sino->getSize(); ++i)
+		sino->getData()[i] = (astra::float32)((i * 7) % 11);
+
+	astra::CFloat32VolumeData2D ref(&vg, 0.0f);
+	astra::CCglsAlgorithm cgls;
+	cgls.initialize(&proj, sino, &ref);
+	cgls.run(4);
+
+	// abort during the backprojection of the second iteration, after x
+	// and r were updated, and finish the remaining iterations in a second run
+	astra::CCglsAlgorithm aborted;
+	aborted.initialize(&proj, sino, rec);
+	CAbortInBP abort(&aborted, 0.3f);
+	aborted.setProgressCallback(&abort);
+	aborted.run(4);
+	BOOST_REQUIRE(aborted.shouldAbort());
+	aborted.run(3);
+
+	for (int i = 0; i < rec->getSize(); ++i)
+		BOOST_REQUIRE_SMALL(rec->getData()[i] - ref.getData()[i], 1e-4f);
+
+	astra::float32 fRef, fResumed;
+	BOOST_REQUIRE(cgls.getResidualNorm(fRef));
+	BOOST_REQUIRE(aborted.getResidualNorm(fResumed));
+	BOOST_CHECK_CLOSE(fResumed, fRef, 1e-2);
+}
@@ -0,0 +1,239 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+
+#include <vector>
+
+#include "astra/AlgorithmScheduler.h"
+#include "astra/WorkerPool.h"
+
+namespace {
+
+astra::CMutex g_mutex;
+std::vector<int> g_order;
+int g_iRunning = 0;
+int g_iMaxRunning = 0;
+
+class CTestAlgorithm : public astra::CAlgorithm {
+public:
+	CTestAlgorithm(int _iId, bool _bBlock = false) : m_iId(_iId), m_bBlock(_bBlock), m_bRelease(false), m_bRunning(false),
+	                                               m_bHoldStart(false), m_bSawAbort(false) {
+		m_bIsInitialized = true;
+	}
+	virtual bool initialize(const astra::Config&) { return true; }
+	virtual void run(int) {
+		m_bRunning = true;
+		// optionally wait before clearing the abort flag
+		while (m_bHoldStart) { }
+		// like the real algorithms
+		resetAbort();
+		m_bSawAbort = m_bShouldAbort;
+		{
+			astra::CMutexLock lock(g_mutex);
+			g_order.push_back(m_iId);
+			if (++g_iRunning > g_iMaxRunning)
+				g_iMaxRunning = g_iRunning;
+		}
+		// spin until released or aborted
+		while (m_bBlock && !m_bRelease && !m_bShouldAbort) { }
+		{
+			astra::CMutexLock lock(g_mutex);
+			--g_iRunning;
+		}
+	}
+	void release() { m_bRelease = true; }
+	bool aborted() const { return m_bShouldAbort; }
+	void waitRunning() const { while (!m_bRunning) { } }
+
+	int m_iId;
+	bool m_bBlock;
+	volatile bool m_bRelease;
+	volatile bool m_bRunning;
+	volatile bool m_bHoldStart;
+	bool m_bSawAbort;
+};
+
+// Occupies a pool worker until released
+class CBlockingTask : public astra::CWorkerTask {
+public:
+	CBlockingTask(volatile bool* _pRelease) : m_pRelease(_pRelease) { }
+	virtual void run() {
+		{
+			astra::CMutexLock lock(g_mutex);
+			++g_iRunning;
+		}
+		while (!*m_pRelease) { }
+	}
+	volatile bool* m_pRelease;
+};
+
+int runningCount()
+{
+	astra::CMutexLock lock(g_mutex);
+	return g_iRunning;
+}
+
+struct TestScheduler {
+	TestScheduler() {
+		g_order.clear();
+		g_iRunning = 0;
+		g_iMaxRunning = 0;
+	}
+	~TestScheduler() {
+		astra::CAlgorithmScheduler::getSingleton().setParams(astra::SAlgorithmSchedulerParams());
+	}
+};
+
+}
+
+BOOST_FIXTURE_TEST_CASE( testAlgorithmScheduler_Priority, TestScheduler )
+{
+	astra::CAlgorithmScheduler& s = astra::CAlgorithmScheduler::getSingleton();
+	astra::SAlgorithmSchedulerParams params;
+	params.iMaxRunning = 1;
+	s.setParams(params);
+
+	CTestAlgorithm blocker(0, true), low(1), high(2), high2(3);
+	astra::CAlgorithmScheduler::TJob j0 = s.submit(&blocker);
+	astra::CAlgorithmScheduler::TJob j1 = s.submit(&low, 0, 0);
+	astra::CAlgorithmScheduler::TJob j2 = s.submit(&high, 0, 5);
+	astra::CAlgorithmScheduler::TJob j3 = s.submit(&high2, 0, 5);
+
+	BOOST_CHECK_EQUAL(j0->getState(), astra::CAlgorithmJob::JOB_RUNNING);
+	BOOST_CHECK_EQUAL(s.getPendingCount(), 3);
+
+	blocker.release();
+	s.waitAll();
+
+	BOOST_CHECK(j1->isDone() && j2->isDone() && j3->isDone());
+	BOOST_REQUIRE_EQUAL(g_order.size(), 4U);
+	BOOST_CHECK_EQUAL(g_order[1], 2);
+	BOOST_CHECK_EQUAL(g_order[2], 3);
+	BOOST_CHECK_EQUAL(g_order[3], 1);
+	BOOST_CHECK_EQUAL(g_iMaxRunning, 1);
+}
+
+BOOST_FIXTURE_TEST_CASE( testAlgorithmScheduler_Cancel, TestScheduler )
+{
+	astra::CAlgorithmScheduler& s = astra::CAlgorithmScheduler::getSingleton();
+	astra::SAlgorithmSchedulerParams params;
+	params.iMaxRunning = 1;
+	s.setParams(params);
+
+	CTestAlgorithm blocker(0, true), other(1);
+	astra::CAlgorithmScheduler::TJob j0 = s.submit(&blocker);
+	astra::CAlgorithmScheduler::TJob j1 = s.submit(&other);
+
+	j1->cancel();
+	BOOST_CHECK_EQUAL(j1->getState(), astra::CAlgorithmJob::JOB_CANCELLED);
+
+	blocker.waitRunning();
+	j0->cancel();
+	j0->wait();
+	BOOST_CHECK(blocker.aborted());
+	BOOST_CHECK_EQUAL(j0->getState(), astra::CAlgorithmJob::JOB_CANCELLED);
+	BOOST_CHECK_EQUAL(g_order.size(), 1U);
+}
+
+BOOST_FIXTURE_TEST_CASE( testAlgorithmScheduler_MemoryBudget, TestScheduler )
+{
+	astra::CAlgorithmScheduler& s = astra::CAlgorithmScheduler::getSingleton();
+	astra::SAlgorithmSchedulerParams params;
+	params.iMemoryBudget = 100;
+	s.setParams(params);
+
+	CTestAlgorithm a(0, true), b(1), c(2);
+	astra::CAlgorithmScheduler::TJob ja = s.submit(&a, 0, 0, 60);
+	astra::CAlgorithmScheduler::TJob jb = s.submit(&b, 0, 0, 60);
+	// larger than the budget on its own: runs when nothing else does
+	astra::CAlgorithmScheduler::TJob jc = s.submit(&c, 0, 0, 200);
+
+	BOOST_CHECK_EQUAL(jb->getState(), astra::CAlgorithmJob::JOB_PENDING);
+
+	a.release();
+	s.waitAll();
+
+	BOOST_CHECK_EQUAL(jc->getState(), astra::CAlgorithmJob::JOB_DONE);
+	BOOST_CHECK_EQUAL(g_order.size(), 3U);
+	BOOST_CHECK_EQUAL(g_iMaxRunning, 1);
+}
+
+BOOST_FIXTURE_TEST_CASE( testAlgorithmScheduler_CancelQueued, TestScheduler )
+{
+	astra::CAlgorithmScheduler& s = astra::CAlgorithmScheduler::getSingleton();
+	astra::CWorkerPool& pool = astra::CWorkerPool::getSingleton();
+
+	// keep all workers busy, so the job is dispatched but waits in the pool
+	volatile bool bRelease = false;
+	int iThreads = pool.getThreadCount();
+	std::vector<CBlockingTask*> blockers;
+	astra::CTaskGroup group;
+	for (int i = 0; i < iThreads; ++i) {
+		blockers.push_back(new CBlockingTask(&bRelease));
+		pool.submit(blockers.back(), &group);
+	}
+	while (runningCount() < iThreads) { }
+
+	CTestAlgorithm alg(0);
+	astra::CAlgorithmScheduler::TJob j = s.submit(&alg);
+	BOOST_CHECK_EQUAL(j->getState(), astra::CAlgorithmJob::JOB_RUNNING);
+
+	j->cancel();
+	bRelease = true;
+	j->wait();
+	group.wait();
+	for (size_t i = 0; i < blockers.size(); ++i)
+		delete blockers[i];
+
+	BOOST_CHECK_EQUAL(j->getState(), astra::CAlgorithmJob::JOB_CANCELLED);
+	BOOST_CHECK(g_order.empty());
+}
+
+BOOST_FIXTURE_TEST_CASE( testAlgorithmScheduler_CancelAtStart, TestScheduler )
+{
+	astra::CAlgorithmScheduler& s = astra::CAlgorithmScheduler::getSingleton();
+
+	// cancel after the job started, but before run() clears the abort flag
+	CTestAlgorithm alg(0);
+	alg.m_bHoldStart = true;
+	astra::CAlgorithmScheduler::TJob j = s.submit(&alg);
+	alg.waitRunning();
+	j->cancel();
+	alg.m_bHoldStart = false;
+	j->wait();
+
+	BOOST_CHECK(alg.m_bSawAbort);
+	BOOST_CHECK_EQUAL(j->getState(), astra::CAlgorithmJob::JOB_CANCELLED);
+
+	// the request ends with the job
+	alg.run(0);
+	BOOST_CHECK(!alg.m_bSawAbort);
+}
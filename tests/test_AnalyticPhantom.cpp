@@ -0,0 +1,164 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+
+#include <cmath>
+
+#include "astra/AnalyticPhantom.h"
+#include "astra/ForwardProjectionAlgorithm.h"
+#include "astra/FanFlatBeamLineKernelProjector2D.h"
+#include "astra/ParallelBeamLineKernelProjector2D.h"
+#include "astra/ParallelProjectionGeometry2D.h"
+#include "astra/FanFlatProjectionGeometry2D.h"
+#include "astra/ConeProjectionGeometry3D.h"
+#include "astra/VolumeGeometry2D.h"
+#include "astra/VolumeGeometry3D.h"
+#include "astra/Float32VolumeData2D.h"
+#include "astra/Float32ProjectionData2D.h"
+#include "astra/Float32VolumeData3DMemory.h"
+#include "astra/Float32ProjectionData3DMemory.h"
+#include "astra/MemoryBudget.h"
+
+static double relativeError(const astra::float32* _pfA, const astra::float32* _pfB, int _iSize)
+{
+	double fDiff = 0.0, fNorm = 0.0;
+	for (int i = 0; i < _iSize; ++i) {
+		fDiff += ((double)_pfA[i] - _pfB[i]) * ((double)_pfA[i] - _pfB[i]);
+		fNorm += (double)_pfB[i] * _pfB[i];
+	}
+	return sqrt(fDiff / fNorm);
+}
+
+BOOST_AUTO_TEST_CASE( testAnalyticPhantom_Rasterize2D )
+{
+	astra::CEllipsePhantom2D phantom = astra::CEllipsePhantom2D::createSheppLogan(60.0);
+	BOOST_CHECK_EQUAL(phantom.getEllipses().size(), 10u);
+
+	astra::CVolumeGeometry2D vg(128, 128);
+	astra::CFloat32VolumeData2D vol(&vg, 0.0f);
+	BOOST_REQUIRE(phantom.rasterize(&vol, 4));
+
+	// the total equals the integral of the phantom
+	double fSum = 0.0, fExact = 0.0;
+	for (int i = 0; i < vol.getSize(); ++i)
+		fSum += vol.getData()[i];
+	for (size_t i = 0; i < phantom.getEllipses().size(); ++i) {
+		const astra::SEllipse& e = phantom.getEllipses()[i];
+		fExact += e.fValue * M_PI * e.fSemiAxisX * e.fSemiAxisY;
+	}
+	BOOST_CHECK_CLOSE(fSum, fExact, 0.5);
+
+	// row 0 is at the top: the small ellipses near y = -0.6 R are at the bottom
+	BOOST_CHECK_CLOSE(vol.getData2D()[64][64], phantom.getValue(0.5, -0.5), 1e-3);
+	BOOST_CHECK_CLOSE(vol.getData2D()[100][64], phantom.getValue(0.5, -36.5), 1e-3);
+	BOOST_CHECK_CLOSE(phantom.getValue(0.0, -36.36), 0.3, 1e-3);
+}
+
+BOOST_AUTO_TEST_CASE( testAnalyticPhantom_BufferFailure )
+{
+	astra::CEllipsePhantom2D phantom = astra::CEllipsePhantom2D::createSheppLogan(1.0);
+	astra::CVolumeGeometry2D vg(300000, 1);
+	astra::CFloat32VolumeData2D vol(&vg, 0.0f);
+
+	// no room for the row accumulator
+	astra::CMemoryBudget& budget = astra::CMemoryBudget::getSingleton();
+	size_t iLimit = budget.getLimit();
+	budget.setLimit(budget.getUsed() + (1 << 20));
+	BOOST_CHECK(!phantom.rasterize(&vol, 1));
+	budget.setLimit(iLimit);
+}
+
+BOOST_AUTO_TEST_CASE( testAnalyticPhantom_Project2D )
+{
+	astra::CEllipsePhantom2D phantom = astra::CEllipsePhantom2D::createSheppLogan(60.0);
+	astra::CVolumeGeometry2D vg(128, 128);
+	astra::CFloat32VolumeData2D vol(&vg, 0.0f);
+	phantom.rasterize(&vol, 4);
+
+	astra::float32 angles[60];
+	for (int i = 0; i < 60; ++i)
+		angles[i] = i * 3.14159265f / 60;
+
+	// parallel beam, compared to the line projector on the rasterized phantom
+	astra::CParallelProjectionGeometry2D pg(60, 192, 1.0f, angles);
+	astra::CFloat32ProjectionData2D exact(&pg, 0.0f);
+	BOOST_REQUIRE(phantom.project(&exact));
+
+	astra::CParallelBeamLineKernelProjector2D proj(&pg, &vg);
+	astra::CFloat32ProjectionData2D sino(&pg, 0.0f);
+	astra::CForwardProjectionAlgorithm fp(&proj, &vol, &sino);
+	fp.run();
+	BOOST_CHECK_SMALL(relativeError(sino.getData(), exact.getData(), sino.getSize()), 0.03);
+
+	// fan beam
+	astra::CFanFlatProjectionGeometry2D fg(60, 256, 1.5f, angles, 300.0f, 150.0f);
+	astra::CFloat32ProjectionData2D exactFan(&fg, 0.0f);
+	BOOST_REQUIRE(phantom.project(&exactFan));
+
+	astra::CFanFlatBeamLineKernelProjector2D fanProj(&fg, &vg);
+	astra::CFloat32ProjectionData2D fanSino(&fg, 0.0f);
+	astra::CForwardProjectionAlgorithm fp2(&fanProj, &vol, &fanSino);
+	fp2.run();
+	BOOST_CHECK_SMALL(relativeError(fanSino.getData(), exactFan.getData(), fanSino.getSize()), 0.03);
+}
+
+BOOST_AUTO_TEST_CASE( testAnalyticPhantom_Sphere3D )
+{
+	astra::CEllipsoidPhantom3D phantom;
+	astra::SEllipsoid e = { 1.0, 0.0, 6.0, 0.0, 8.0, 8.0, 8.0, 0.0 };
+	phantom.addEllipsoid(e);
+
+	astra::CVolumeGeometry3D vg(32, 32, 32);
+	astra::CFloat32VolumeData3DMemory vol(&vg, 0.0f);
+	BOOST_REQUIRE(phantom.rasterize(&vol, 2));
+
+	double fSum = 0.0;
+	for (int i = 0; i < vol.getSize(); ++i)
+		fSum += vol.getData()[i];
+	BOOST_CHECK_CLOSE(fSum, 4.0 / 3.0 * M_PI * 512.0, 1.0);
+	// y = 6 is row 21.5
+	BOOST_CHECK_EQUAL(vol.getData()[(16 * 32 + 21) * 32 + 16], 1.0f);
+	BOOST_CHECK_EQUAL(vol.getData()[(16 * 32 + 8) * 32 + 16], 0.0f);
+
+	astra::float32 angles[2] = { 0.0f, 1.5707963f };
+	astra::CConeProjectionGeometry3D pg(2, 16, 16, 2.0f, 2.0f, angles, 100.0f, 100.0f);
+	astra::CFloat32ProjectionData3DMemory proj(&pg, 0.0f);
+	BOOST_REQUIRE(phantom.project(&proj));
+	// a ray along x, at distance 6 from the centre
+	double fCentre = phantom.getLineIntegral(100.0, 0.0, 0.0, -1.0, 0.0, 0.0);
+	BOOST_CHECK_CLOSE(fCentre, 2.0 * sqrt(64.0 - 36.0), 1e-6);
+	// at angle 0 the central rays pass through the sphere centre
+	double fMax = 0.0;
+	for (int u = 0; u < 16; ++u)
+		for (int v = 0; v < 16; ++v)
+			fMax = std::max(fMax, (double)proj.getData()[(v * 2 + 0) * 16 + u]);
+	BOOST_CHECK(fMax > 14.0 && fMax <= 16.0);
+}
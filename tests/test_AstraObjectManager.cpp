@@ -29,7 +29,10 @@ along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
 #include <boost/test/unit_test.hpp>
 #include <boost/test/auto_unit_test.hpp>
 
+#include <vector>
+
 #include "astra/AstraObjectManager.h"
+#include "astra/WorkerPool.h"
 
 struct TestT {
 	TestT(int _x) : x(_x) { }
@@ -51,6 +54,31 @@ DEFINE_SINGLETON(CTestManager);
 
 }
 
+namespace {
+
+// Each index in the range stores, looks up and removes its own objects
+struct StoreRemoveRange {
+	std::vector<int>* m_pErrors;
+	void operator()(int _iFrom, int _iTo) const {
+		astra::CTestManager &man = astra::CTestManager::getSingleton();
+		for (int i = _iFrom; i < _iTo; ++i) {
+			for (int j = 0; j < 100; ++j) {
+				TestT* p = new TestT(i);
+				int idx = man.store(p);
+				if (man.get(idx) != p || man.getIndex(p) != idx)
+					(*m_pErrors)[i]++;
+				if (astra::CAstraIndexManager::getSingleton().get(idx) != &man)
+					(*m_pErrors)[i]++;
+				man.remove(idx);
+				if (man.hasIndex(idx))
+					(*m_pErrors)[i]++;
+			}
+		}
+	}
+};
+
+}
+
 BOOST_AUTO_TEST_CASE( testAstraObjectManager )
 {
 	astra::CTestManager &man = astra::CTestManager::getSingleton();
@@ -91,3 +119,21 @@ BOOST_AUTO_TEST_CASE( testAstraObjectManager )
 	BOOST_CHECK(!man.hasIndex(i4));
 	BOOST_CHECK(!man.getIndex(pi4));
 }
+
+BOOST_AUTO_TEST_CASE( testAstraObjectManager_Concurrent )
+{
+	astra::CTestManager &man = astra::CTestManager::getSingleton();
+
+	std::vector<int> errors(64, 0);
+	StoreRemoveRange f;
+	f.m_pErrors = &errors;
+	astra::CWorkerPool::getSingleton().parallelFor(0, 64, f);
+
+	for (int i = 0; i < 64; ++i)
+		BOOST_CHECK_EQUAL(errors[i], 0);
+
+	int i1 = man.store(new TestT(1));
+	int i2 = man.store(new TestT(2));
+	BOOST_CHECK_EQUAL(i2, i1 + 1);
+	man.clear();
+}
@@ -0,0 +1,133 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+
+#include <cmath>
+
+#include "astra/BrickedVolume3D.h"
+#include "astra/VolumeGeometry3D.h"
+#include "astra/ParallelProjectionGeometry3D.h"
+#include "astra/ConeProjectionGeometry3D.h"
+#include "astra/Float32VolumeData3DMemory.h"
+#include "astra/Float32ProjectionData3DMemory.h"
+
+BOOST_AUTO_TEST_CASE( testBrickedVolume3D_Conversion )
+{
+	astra::CVolumeGeometry3D geom(19, 13, 10);
+	astra::CFloat32VolumeData3DMemory vol(&geom, 0.0f);
+	BOOST_REQUIRE(vol.setRowPitch());
+	for (int z = 0; z < 10; ++z)
+		for (int y = 0; y < 13; ++y)
+			for (int x = 0; x < 19; ++x)
+				vol.getRow(y, z)[x] = (float)(x + 100 * y + 10000 * z);
+
+	astra::CBrickedVolume3D bricked(19, 13, 10);
+	BOOST_REQUIRE(bricked.isInitialized());
+	BOOST_CHECK_EQUAL(bricked.getBrickCount(), 3 * 2 * 2);
+	BOOST_REQUIRE(bricked.copyFrom(&vol));
+	BOOST_CHECK_EQUAL(bricked.getValue(18, 12, 9), 18.0f + 1200.0f + 90000.0f);
+	BOOST_CHECK_EQUAL(bricked.getValue(9, 3, 8), 9.0f + 300.0f + 80000.0f);
+	// padding voxels beyond the volume stay zero
+	BOOST_CHECK_EQUAL(bricked.getBrick(bricked.getBrickCount() - 1)[astra::CBrickedVolume3D::BRICK_VOXELS - 1], 0.0f);
+
+	astra::CFloat32VolumeData3DMemory out(&geom, -1.0f);
+	BOOST_REQUIRE(bricked.copyTo(&out));
+	for (int z = 0; z < 10; ++z)
+		for (int y = 0; y < 13; ++y)
+			for (int x = 0; x < 19; ++x)
+				BOOST_REQUIRE_EQUAL(out.getRow(y, z)[x], vol.getRow(y, z)[x]);
+
+	astra::CBrickedVolume3D wrong(19, 13, 9);
+	BOOST_CHECK(!wrong.copyFrom(&vol));
+}
+
+BOOST_AUTO_TEST_CASE( testBrickedVolume3D_ForwardProjection )
+{
+	astra::CVolumeGeometry3D geom(16, 16, 16);
+	astra::CBrickedVolume3D vol(16, 16, 16);
+	for (int z = 0; z < 16; ++z)
+		for (int y = 0; y < 16; ++y)
+			for (int x = 0; x < 16; ++x)
+				vol.setValue(x, y, z, 1.0f);
+
+	const float angles[2] = { 0.0f, 0.3f };
+	astra::CParallelProjectionGeometry3D par(2, 16, 16, 1.0f, 1.0f, angles);
+	astra::CFloat32ProjectionData3DMemory proj(&par, 0.0f);
+	BOOST_REQUIRE(astra::forwardProjectBricked(&vol, &geom, &proj));
+	// rays along y through the volume; the tilted ray crosses 16 y-planes
+	BOOST_CHECK_CLOSE(proj.getRow(0, 8)[8], 16.0f, 1e-4);
+	BOOST_CHECK_CLOSE(proj.getRow(1, 8)[8], 16.0f / cos(0.3f), 1e-3);
+	BOOST_CHECK_EQUAL(proj.getRow(0, 8)[0], 1.0f * 16);
+
+	astra::CConeProjectionGeometry3D cone(1, 16, 16, 2.0f, 2.0f, angles, 100.0f, 100.0f);
+	astra::CFloat32ProjectionData3DMemory coneProj(&cone, 0.0f);
+	BOOST_REQUIRE(astra::forwardProjectBricked(&vol, &geom, &coneProj));
+	// the ray through pixel (8, 8) hits the detector at (1, 1) and leaves
+	// the source at (0, -100, 0)
+	const double fLength = sqrt(1.0 + 200.0 * 200.0 + 1.0) / 200.0 * 16.0;
+	BOOST_CHECK_CLOSE(coneProj.getRow(0, 8)[8], fLength, 1e-3);
+}
+
+BOOST_AUTO_TEST_CASE( testBrickedVolume3D_Backprojection )
+{
+	astra::CVolumeGeometry3D geom(20, 12, 10);
+	const float angles[2] = { 0.0f, 1.2f };
+	astra::CParallelProjectionGeometry3D par(2, 12, 24, 1.0f, 1.0f, angles);
+	astra::CConeProjectionGeometry3D cone(2, 14, 32, 1.5f, 1.5f, angles, 40.0f, 20.0f);
+	astra::CProjectionGeometry3D* geoms[2] = { &par, &cone };
+
+	for (int g = 0; g < 2; ++g) {
+		// the backprojection of the projection of a single voxel peaks at it
+		astra::CBrickedVolume3D vol(20, 12, 10);
+		vol.setValue(13, 4, 6, 1.0f);
+		astra::CFloat32ProjectionData3DMemory proj(geoms[g], 0.0f);
+		BOOST_REQUIRE(astra::forwardProjectBricked(&vol, &geom, &proj));
+		BOOST_REQUIRE(astra::backprojectBricked(&proj, &geom, &vol));
+
+		int iBest = -1;
+		float fBest = -1.0f;
+		for (int z = 0; z < 10; ++z)
+			for (int y = 0; y < 12; ++y)
+				for (int x = 0; x < 20; ++x)
+					if (vol.getValue(x, y, z) > fBest) {
+						fBest = vol.getValue(x, y, z);
+						iBest = (z * 12 + y) * 20 + x;
+					}
+		BOOST_CHECK_EQUAL(iBest, (6 * 12 + 4) * 20 + 13);
+	}
+
+	// a constant projection backprojects to the number of angles inside
+	// the detector's field of view
+	astra::CFloat32ProjectionData3DMemory ones(&par, 1.0f);
+	astra::CBrickedVolume3D bp(20, 12, 10);
+	BOOST_REQUIRE(astra::backprojectBricked(&ones, &geom, &bp));
+	BOOST_CHECK_CLOSE(bp.getValue(10, 6, 5), 2.0f, 1e-4);
+}
@@ -0,0 +1,100 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+
+#include <cmath>
+
+#include "astra/CenterOfRotationAlgorithm.h"
+#include "astra/ForwardProjectionAlgorithm.h"
+#include "astra/ParallelBeamLineKernelProjector2D.h"
+#include "astra/ParallelProjectionGeometry2D.h"
+#include "astra/FanFlatProjectionGeometry2D.h"
+#include "astra/VolumeGeometry2D.h"
+#include "astra/Float32VolumeData2D.h"
+#include "astra/Float32ProjectionData2D.h"
+
+BOOST_AUTO_TEST_CASE( testCenterOfRotationAlgorithm_Offset )
+{
+	const int N = 128;
+	const float fShift = 5.5f;
+	astra::float32 angles[90];
+	for (int i = 0; i < 90; ++i)
+		angles[i] = i * 3.14159265f / 90;
+	astra::CVolumeGeometry2D vg(N, N);
+	astra::CParallelProjectionGeometry2D pg(90, N, 1.0f, angles);
+	astra::CParallelBeamLineKernelProjector2D proj(&pg, &vg);
+
+	astra::CFloat32VolumeData2D phantom(&vg, 0.0f);
+	for (int y = 0; y < N; ++y) {
+		for (int x = 0; x < N; ++x) {
+			float X = (x - 0.5f * N) / N, Y = (y - 0.5f * N) / N;
+			if (X * X / 0.16f + Y * Y / 0.25f < 1.0f)
+				phantom.getData2D()[y][x] = 1.0f;
+			if ((X - 0.1f) * (X - 0.1f) + Y * Y < 0.01f)
+				phantom.getData2D()[y][x] = 0.5f;
+		}
+	}
+	astra::CFloat32ProjectionData2D sino(&pg, 0.0f);
+	astra::CForwardProjectionAlgorithm fp(&proj, &phantom, &sino);
+	fp.run();
+
+	// the same projections, seen by a detector shifted by fShift pixels
+	astra::CFloat32ProjectionData2D shifted(&pg, 0.0f);
+	for (int a = 0; a < 90; ++a) {
+		for (int j = 0; j + 6 < N; ++j) {
+			float v0 = sino.getData2D()[a][j + 5];
+			float v1 = sino.getData2D()[a][j + 6];
+			shifted.getData2D()[a][j] = v0 + (fShift - 5.0f) * (v1 - v0);
+		}
+	}
+
+	astra::CCenterOfRotationAlgorithm cor;
+	BOOST_REQUIRE(cor.initialize(&shifted));
+	cor.run();
+	BOOST_CHECK_SMALL(cor.getOffset() - fShift, 1.0f);
+	BOOST_CHECK(cor.getCandidateCount() > 0);
+}
+
+BOOST_AUTO_TEST_CASE( testCenterOfRotationAlgorithm_Invalid )
+{
+	astra::float32 angles[10];
+	for (int i = 0; i < 10; ++i)
+		angles[i] = i * 3.14159265f / 10;
+	astra::CParallelProjectionGeometry2D pg(10, 64, 1.0f, angles);
+	astra::CFanFlatProjectionGeometry2D fg(10, 64, 1.0f, angles, 100.0f, 100.0f);
+	astra::CFloat32ProjectionData2D sino(&pg, 0.0f);
+	astra::CFloat32ProjectionData2D fanSino(&fg, 0.0f);
+
+	astra::CCenterOfRotationAlgorithm cor;
+	BOOST_CHECK(!cor.initialize(&fanSino));
+	BOOST_CHECK(!cor.initialize(&sino, 0.0f, 0.25f, 3));
+	BOOST_CHECK(cor.initialize(&sino, 10.0f, 0.5f, 2));
+}
@@ -0,0 +1,173 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+
+#include "astra/CpuProjection3D.h"
+#include "astra/BrickedVolume3D.h"
+#include "astra/SirtAlgorithm3D.h"
+#include "astra/CglsAlgorithm3D.h"
+#include "astra/VolumeGeometry3D.h"
+#include "astra/ParallelProjectionGeometry3D.h"
+#include "astra/ConeProjectionGeometry3D.h"
+#include "astra/Float32ProjectionData3DMemory.h"
+#include "astra/Float32VolumeData3DMemory.h"
+
+struct TestCpuProjection3D {
+	TestCpuProjection3D()
+		: geom(12, 10, 9),
+		  par(4, 9, 16, 1.0f, 1.0f, angles),
+		  cone(4, 9, 20, 1.5f, 1.5f, angles, 30.0f, 20.0f),
+		  vol(&geom, 0.0f)
+	{
+		float* pfVol = vol.getData();
+		for (int i = 0; i < 12 * 10 * 9; ++i)
+			pfVol[i] = (float)((i * 7) % 11);
+	}
+
+	static const float angles[4];
+	astra::CVolumeGeometry3D geom;
+	astra::CParallelProjectionGeometry3D par;
+	astra::CConeProjectionGeometry3D cone;
+	astra::CFloat32VolumeData3DMemory vol;
+};
+
+const float TestCpuProjection3D::angles[4] = { 0.0f, 0.7f, 1.6f, 2.5f };
+
+BOOST_FIXTURE_TEST_CASE( testCpuProjection3D_Detect, TestCpuProjection3D )
+{
+	BOOST_CHECK(astra::CCpuProjection3D::isSliceDecomposable(&par, &geom));
+	BOOST_CHECK(!astra::CCpuProjection3D::isSliceDecomposable(&cone, &geom));
+
+	// rows no longer line up with the slices
+	astra::CVolumeGeometry3D shifted(12, 10, 9, -6.0f, -5.0f, -4.0f, 6.0f, 5.0f, 5.0f);
+	BOOST_CHECK(!astra::CCpuProjection3D::isSliceDecomposable(&par, &shifted));
+	astra::CParallelProjectionGeometry3D finer(4, 9, 16, 1.0f, 0.5f, angles);
+	BOOST_CHECK(!astra::CCpuProjection3D::isSliceDecomposable(&finer, &geom));
+}
+
+BOOST_FIXTURE_TEST_CASE( testCpuProjection3D_Slices, TestCpuProjection3D )
+{
+	astra::CCpuProjection3D projection;
+	BOOST_REQUIRE(projection.initialize(&par, &geom));
+	BOOST_REQUIRE(projection.isSliceDecomposed());
+
+	// same weights as the general path
+	astra::CBrickedVolume3D bricked(12, 10, 9);
+	BOOST_REQUIRE(bricked.copyFrom(&vol));
+	astra::CFloat32ProjectionData3DMemory ref(&par, 0.0f);
+	BOOST_REQUIRE(astra::forwardProjectBricked(&bricked, &geom, &ref));
+
+	astra::CFloat32ProjectionData3DMemory proj(&par, 0.0f);
+	BOOST_REQUIRE(projection.forwardProject(&vol, &proj));
+	for (int i = 0; i < proj.getSize(); ++i)
+		BOOST_REQUIRE_SMALL(proj.getDataConst()[i] - ref.getDataConst()[i], 1e-3f);
+
+	// the backprojection is the transpose: <A x, y> = <x, A' y>
+	astra::CFloat32ProjectionData3DMemory y(&par, 0.0f);
+	for (int i = 0; i < y.getSize(); ++i)
+		y.getData()[i] = (float)((i * 5) % 7) - 3.0f;
+	astra::CFloat32VolumeData3DMemory bp(&geom, 1.0f);
+	BOOST_REQUIRE(projection.backProject(&y, &bp));
+	double fLeft = 0.0, fRight = 0.0;
+	for (int i = 0; i < proj.getSize(); ++i)
+		fLeft += (double)proj.getDataConst()[i] * y.getDataConst()[i];
+	for (int i = 0; i < vol.getSize(); ++i)
+		fRight += (double)vol.getDataConst()[i] * bp.getDataConst()[i];
+	BOOST_CHECK_CLOSE(fLeft, fRight, 1e-3);
+
+	// cone beam falls back to the bricked kernels
+	astra::CCpuProjection3D general;
+	BOOST_REQUIRE(general.initialize(&cone, &geom));
+	BOOST_CHECK(!general.isSliceDecomposed());
+	astra::CFloat32ProjectionData3DMemory coneProj(&cone, 0.0f);
+	BOOST_CHECK(general.forwardProject(&vol, &coneProj));
+}
+
+BOOST_FIXTURE_TEST_CASE( testCpuProjection3D_Algorithms, TestCpuProjection3D )
+{
+	astra::CCpuProjection3D projection;
+	BOOST_REQUIRE(projection.initialize(&par, &geom));
+	astra::CFloat32ProjectionData3DMemory sino(&par, 0.0f);
+	BOOST_REQUIRE(projection.forwardProject(&vol, &sino));
+
+	astra::CFloat32VolumeData3DMemory rec(&geom, 0.0f);
+	astra::CSirtAlgorithm3D sirt;
+	BOOST_REQUIRE(sirt.initialize(0, &sino, &rec));
+	astra::float32 fFirst, fLast;
+	sirt.run(1);
+	BOOST_REQUIRE(sirt.getResidualNorm(fFirst));
+	sirt.run(20);
+	BOOST_REQUIRE(sirt.getResidualNorm(fLast));
+	BOOST_CHECK_LT(fLast, 0.5f * fFirst);
+
+	rec.setData(0.0f);
+	astra::CCglsAlgorithm3D cgls;
+	BOOST_REQUIRE(cgls.initialize(0, &sino, &rec));
+	cgls.run(1);
+	BOOST_REQUIRE(cgls.getResidualNorm(fFirst));
+	cgls.run(20);
+	BOOST_REQUIRE(cgls.getResidualNorm(fLast));
+	BOOST_CHECK_LT(fLast, 0.1f * fFirst);
+}
+
+BOOST_FIXTURE_TEST_CASE( testCpuProjection3D_ConeAdjoint, TestCpuProjection3D )
+{
+	astra::CCpuProjection3D projection;
+	BOOST_REQUIRE(projection.initialize(&cone, &geom));
+	BOOST_REQUIRE(!projection.isSliceDecomposed());
+
+	astra::CFloat32ProjectionData3DMemory proj(&cone, 0.0f);
+	BOOST_REQUIRE(projection.forwardProject(&vol, &proj));
+
+	// the general backprojection is the transpose as well: <A x, y> = <x, A' y>
+	astra::CFloat32ProjectionData3DMemory y(&cone, 0.0f);
+	for (int i = 0; i < y.getSize(); ++i)
+		y.getData()[i] = (float)((i * 5) % 7) + 1.0f;
+	astra::CFloat32VolumeData3DMemory bp(&geom, 1.0f);
+	BOOST_REQUIRE(projection.backProject(&y, &bp));
+	double fLeft = 0.0, fRight = 0.0;
+	for (int i = 0; i < proj.getSize(); ++i)
+		fLeft += (double)proj.getDataConst()[i] * y.getDataConst()[i];
+	for (int i = 0; i < vol.getSize(); ++i)
+		fRight += (double)vol.getDataConst()[i] * bp.getDataConst()[i];
+	BOOST_CHECK_CLOSE(fLeft, fRight, 1e-3);
+
+	// so CGLS converges on cone beam data
+	astra::CFloat32VolumeData3DMemory rec(&geom, 0.0f);
+	astra::CCglsAlgorithm3D cgls;
+	BOOST_REQUIRE(cgls.initialize(0, &proj, &rec));
+	astra::float32 fFirst, fLast;
+	cgls.run(1);
+	BOOST_REQUIRE(cgls.getResidualNorm(fFirst));
+	cgls.run(20);
+	BOOST_REQUIRE(cgls.getResidualNorm(fLast));
+	BOOST_CHECK_LT(fLast, 0.1f * fFirst);
+}
@@ -0,0 +1,160 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+
+#include <cmath>
+
+#include "astra/DataBinning.h"
+#include "astra/ForwardProjectionAlgorithm.h"
+#include "astra/ParallelBeamLineKernelProjector2D.h"
+#include "astra/ParallelProjectionGeometry2D.h"
+#include "astra/ConeVecProjectionGeometry3D.h"
+#include "astra/VolumeGeometry2D.h"
+#include "astra/VolumeGeometry3D.h"
+#include "astra/Float32VolumeData2D.h"
+#include "astra/Float32ProjectionData2D.h"
+#include "astra/Float32ProjectionData3DMemory.h"
+#include "astra/Float32VolumeData3DMemory.h"
+#include "astra/MemoryBudget.h"
+
+BOOST_AUTO_TEST_CASE( testDataBinning_Volume2D )
+{
+	astra::CVolumeGeometry2D vg(4, 6);
+	astra::CFloat32VolumeData2D vol(&vg, 0.0f);
+	for (int i = 0; i < 24; ++i)
+		vol.getData()[i] = (float)i;
+
+	astra::CFloat32VolumeData2D* pBinned = astra::binVolumeData2D(&vol, 2, 3);
+	BOOST_REQUIRE(pBinned);
+	BOOST_CHECK_EQUAL(pBinned->getWidth(), 2);
+	BOOST_CHECK_EQUAL(pBinned->getHeight(), 2);
+	BOOST_CHECK_EQUAL(pBinned->getGeometry()->getWindowMinX(), vg.getWindowMinX());
+	BOOST_CHECK_EQUAL(pBinned->getGeometry()->getPixelLengthX(), 2.0f);
+	// mean of rows 0-2, columns 2-3
+	BOOST_CHECK_CLOSE(pBinned->getData2D()[0][1], (2 + 3 + 6 + 7 + 10 + 11) / 6.0f, 1e-4);
+	delete pBinned;
+
+	BOOST_CHECK(!astra::binVolumeData2D(&vol, 3, 1));
+}
+
+BOOST_AUTO_TEST_CASE( testDataBinning_BufferFailure )
+{
+	astra::CVolumeGeometry2D vg(600000, 2);
+	astra::CFloat32VolumeData2D vol(&vg, 1.0f);
+
+	// leave room for the binned volume, but not for the row buffer
+	astra::CMemoryBudget& budget = astra::CMemoryBudget::getSingleton();
+	size_t iLimit = budget.getLimit();
+	budget.setLimit(budget.getUsed() + (2 << 20));
+	astra::CFloat32VolumeData2D* pBinned = astra::binVolumeData2D(&vol, 2, 2);
+	budget.setLimit(iLimit);
+	BOOST_CHECK(!pBinned);
+	delete pBinned;
+}
+
+BOOST_AUTO_TEST_CASE( testDataBinning_Sinogram2D )
+{
+	astra::float32 angles[90];
+	for (int i = 0; i < 90; ++i)
+		angles[i] = i * 3.14159265f / 90;
+	astra::CVolumeGeometry2D vg(64, 64);
+	astra::CParallelProjectionGeometry2D pg(90, 96, 1.0f, angles);
+	astra::CParallelBeamLineKernelProjector2D proj(&pg, &vg);
+
+	astra::CFloat32VolumeData2D disk(&vg, 0.0f);
+	for (int y = 0; y < 64; ++y)
+		for (int x = 0; x < 64; ++x)
+			if ((x - 31.5f) * (x - 31.5f) + (y - 29.5f) * (y - 29.5f) < 20 * 20)
+				disk.getData2D()[y][x] = 1.0f;
+	astra::CFloat32ProjectionData2D sino(&pg, 0.0f);
+	astra::CForwardProjectionAlgorithm fp(&proj, &disk, &sino);
+	fp.run();
+
+	astra::CFloat32ProjectionData2D* pBinned = astra::binProjectionData2D(&sino, 1, 2);
+	BOOST_REQUIRE(pBinned);
+	BOOST_CHECK_EQUAL(pBinned->getDetectorCount(), 48);
+	BOOST_CHECK_EQUAL(pBinned->getGeometry()->getDetectorWidth(), 2.0f);
+
+	// compare to a projection with the binned geometry
+	astra::CParallelBeamLineKernelProjector2D binnedProj(dynamic_cast<astra::CParallelProjectionGeometry2D*>(pBinned->getGeometry()), &vg);
+	astra::CFloat32ProjectionData2D direct(pBinned->getGeometry(), 0.0f);
+	astra::CForwardProjectionAlgorithm fp2(&binnedProj, &disk, &direct);
+	fp2.run();
+
+	double fDiff = 0.0, fNorm = 0.0;
+	for (int i = 0; i < direct.getSize(); ++i) {
+		double d = pBinned->getData()[i] - direct.getData()[i];
+		fDiff += d * d;
+		fNorm += (double)direct.getData()[i] * direct.getData()[i];
+	}
+	BOOST_CHECK_SMALL(sqrt(fDiff / fNorm), 0.02);
+	delete pBinned;
+}
+
+BOOST_AUTO_TEST_CASE( testDataBinning_Cone3D )
+{
+	astra::SConeProjection vectors[4];
+	for (int i = 0; i < 4; ++i) {
+		astra::SConeProjection& v = vectors[i];
+		v.fSrcX = 0.0; v.fSrcY = -100.0; v.fSrcZ = i;
+		v.fDetSX = -8.0; v.fDetSY = 50.0; v.fDetSZ = -4.0;
+		v.fDetUX = 1.0; v.fDetUY = 0.0; v.fDetUZ = 0.0;
+		v.fDetVX = 0.0; v.fDetVY = 0.0; v.fDetVZ = 1.0;
+	}
+	astra::CConeVecProjectionGeometry3D pg(4, 8, 16, vectors);
+	astra::CFloat32ProjectionData3DMemory proj(&pg, 1.0f);
+
+	astra::CFloat32ProjectionData3DMemory* pBinned = astra::binProjectionData3D(&proj, 4, 2, 2);
+	BOOST_REQUIRE(pBinned);
+	BOOST_CHECK_EQUAL(pBinned->getDetectorColCount(), 4);
+	BOOST_CHECK_EQUAL(pBinned->getAngleCount(), 2);
+	BOOST_CHECK_EQUAL(pBinned->getDetectorRowCount(), 4);
+	// 3D projections are averaged
+	BOOST_CHECK_CLOSE(pBinned->getData()[0], 1.0f, 1e-4);
+
+	const astra::CConeVecProjectionGeometry3D* pGeom = dynamic_cast<const astra::CConeVecProjectionGeometry3D*>(pBinned->getGeometry());
+	BOOST_REQUIRE(pGeom);
+	const astra::SConeProjection& v = pGeom->getProjectionVectors()[1];
+	BOOST_CHECK_CLOSE(v.fSrcZ, 2.5, 1e-4);
+	BOOST_CHECK_CLOSE(v.fDetUX, 4.0, 1e-4);
+	BOOST_CHECK_CLOSE(v.fDetVZ, 2.0, 1e-4);
+	delete pBinned;
+
+	astra::CVolumeGeometry3D vg(8, 8, 8);
+	astra::CFloat32VolumeData3DMemory vol(&vg, 0.0f);
+	for (int i = 0; i < 512; ++i)
+		vol.getData()[i] = (float)(i % 2);
+	astra::CFloat32VolumeData3DMemory* pBinnedVol = astra::binVolumeData3D(&vol, 2, 2, 2);
+	BOOST_REQUIRE(pBinnedVol);
+	BOOST_CHECK_EQUAL(pBinnedVol->getSize(), 64);
+	BOOST_CHECK_CLOSE(pBinnedVol->getData()[5], 0.5f, 1e-4);
+	delete pBinnedVol;
+}
@@ -0,0 +1,158 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+
+#include "astra/HostMemory.h"
+#include "astra/VolumeGeometry2D.h"
+#include "astra/VolumeGeometry3D.h"
+#include "astra/Float32VolumeData2D.h"
+#include "astra/Float32VolumeData3DMemory.h"
+#include "astra/SirtAlgorithm.h"
+#include "astra/DataBinning.h"
+
+BOOST_AUTO_TEST_CASE( testDataLayout_RowPitch2D )
+{
+	astra::CVolumeGeometry2D geom(37, 5);
+	astra::CFloat32VolumeData2D data(&geom);
+	BOOST_REQUIRE(data.isInitialized());
+	BOOST_CHECK_EQUAL((size_t)data.getData() % astra::DATA_ALIGNMENT, 0u);
+	BOOST_CHECK(data.isPacked());
+	BOOST_CHECK_EQUAL(data.getRowPitch(), 37);
+
+	for (int y = 0; y < 5; ++y)
+		for (int x = 0; x < 37; ++x)
+			data.getData2D()[y][x] = (float)(y * 37 + x);
+
+	BOOST_REQUIRE(data.setRowPitch());
+	BOOST_CHECK(!data.isPacked());
+	BOOST_CHECK_EQUAL(data.getRowPitch(), 48);
+	BOOST_CHECK(!data.setRowPitch(36));
+
+	astra::float32** ppf = data.getData2D();
+	for (int y = 0; y < 5; ++y) {
+		BOOST_CHECK_EQUAL(ppf[y], data.getData() + y * 48);
+		BOOST_CHECK_EQUAL((size_t)ppf[y] % astra::DATA_ALIGNMENT, 0u);
+		for (int x = 0; x < 37; ++x)
+			BOOST_CHECK_EQUAL(ppf[y][x], (float)(y * 37 + x));
+		BOOST_CHECK_EQUAL(ppf[y][40], 0.0f);
+	}
+
+	// element-wise operations and statistics only see the real elements
+	data += 1.0f;
+	data.updateStatistics();
+	BOOST_CHECK_EQUAL(data.getGlobalMin(), 1.0f);
+	BOOST_CHECK_EQUAL(data.getGlobalMax(), 185.0f);
+	BOOST_CHECK_CLOSE(data.getGlobalMean(), 93.0f, 1e-4);
+
+	// copies between objects with different pitches
+	astra::CFloat32VolumeData2D packed(&geom, 2.0f);
+	data = packed;
+	BOOST_CHECK_EQUAL(data.getRowPitch(), 48);
+	BOOST_CHECK_EQUAL(data.getData2D()[4][36], 2.0f);
+	BOOST_CHECK_EQUAL(data.getData2D()[4][37], 0.0f);
+}
+
+BOOST_AUTO_TEST_CASE( testDataLayout_CopyPadded2D )
+{
+	astra::CVolumeGeometry2D geom(5, 3);
+	astra::CFloat32VolumeData2D data(&geom);
+	for (int y = 0; y < 3; ++y)
+		for (int x = 0; x < 5; ++x)
+			data.getData2D()[y][x] = (float)(y * 5 + x);
+	BOOST_REQUIRE(data.setRowPitch());
+
+	// copies read the source with its own pitch
+	astra::CFloat32VolumeData2D copy(data);
+	BOOST_CHECK(copy.isPacked());
+
+	astra::CVolumeGeometry2D other(2, 2);
+	astra::CFloat32VolumeData2D assigned(&other);
+	assigned = data;
+
+	for (int y = 0; y < 3; ++y)
+		for (int x = 0; x < 5; ++x) {
+			BOOST_CHECK_EQUAL(copy.getData2D()[y][x], (float)(y * 5 + x));
+			BOOST_CHECK_EQUAL(assigned.getData2D()[y][x], (float)(y * 5 + x));
+		}
+}
+
+BOOST_AUTO_TEST_CASE( testDataLayout_RowPitch3D )
+{
+	astra::CVolumeGeometry3D geom(20, 3, 2);
+	astra::CFloat32VolumeData3DMemory data(&geom, 1.5f);
+	BOOST_REQUIRE(data.isInitialized());
+	BOOST_CHECK_EQUAL((size_t)data.getData() % astra::DATA_ALIGNMENT, 0u);
+
+	BOOST_REQUIRE(data.setRowPitch(32));
+	BOOST_CHECK_EQUAL(data.getRowPitch(), 32);
+	BOOST_CHECK_EQUAL(data.getRow(2, 1), data.getData() + (1 * 3 + 2) * 32);
+	BOOST_CHECK_EQUAL(data.getRow(2, 1)[19], 1.5f);
+	BOOST_CHECK_EQUAL(data.getRow(2, 1)[20], 0.0f);
+
+	astra::float32 fMax = 1.0f;
+	data.clampMax(fMax);
+	data.setData(3.0f);
+	BOOST_CHECK_EQUAL(data.getRowConst(0, 0)[0], 3.0f);
+	BOOST_CHECK_EQUAL(data.getRowConst(0, 0)[31], 0.0f);
+	BOOST_CHECK_EQUAL(data.getMemoryUsage(), 32u * 3 * 2 * sizeof(astra::float32));
+}
+
+BOOST_AUTO_TEST_CASE( testDataLayout_PaddedMask2D )
+{
+	astra::CVolumeGeometry2D geom(37, 5);
+	astra::CFloat32VolumeData2D packed(&geom, 1.0f);
+	astra::CFloat32VolumeData2D padded(&geom, 1.0f);
+	BOOST_REQUIRE(padded.setRowPitch());
+
+	// the mask policies index masks linearly, so padded masks are refused
+	astra::CSirtAlgorithm sirt;
+	sirt.setReconstructionMask(&packed);
+	BOOST_CHECK_EQUAL(sirt.getReconstructionMask(), &packed);
+	sirt.setReconstructionMask(&padded);
+	BOOST_CHECK(sirt.getReconstructionMask() == NULL);
+}
+
+BOOST_AUTO_TEST_CASE( testDataLayout_BinPadded2D )
+{
+	astra::CVolumeGeometry2D geom(6, 4);
+	astra::CFloat32VolumeData2D data(&geom);
+	for (int y = 0; y < 4; ++y)
+		for (int x = 0; x < 6; ++x)
+			data.getData2D()[y][x] = (float)(y * 6 + x);
+	BOOST_REQUIRE(data.setRowPitch());
+
+	astra::CFloat32VolumeData2D* pBinned = astra::binVolumeData2D(&data, 2, 2);
+	BOOST_REQUIRE(pBinned);
+	for (int y = 0; y < 2; ++y)
+		for (int x = 0; x < 3; ++x)
+			BOOST_CHECK_CLOSE(pBinned->getData2D()[y][x], (float)(12 * y + 2 * x + 3.5f), 1e-4);
+	delete pBinned;
+}
@@ -0,0 +1,93 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+
+#include <cmath>
+#include <vector>
+
+#include "astra/FilteredBackProjectionAlgorithm.h"
+#include "astra/ForwardProjectionAlgorithm.h"
+#include "astra/FanFlatBeamLineKernelProjector2D.h"
+#include "astra/FanFlatProjectionGeometry2D.h"
+#include "astra/VolumeGeometry2D.h"
+#include "astra/Float32VolumeData2D.h"
+#include "astra/Float32ProjectionData2D.h"
+
+namespace {
+
+// Reconstruct the fan beam projection of a disk over the given angular
+// range and return the relative error
+double reconstructDisk(int _iAngleCount, double _fRange, bool _bEndpoint)
+{
+	std::vector<astra::float32> angles(_iAngleCount);
+	for (int i = 0; i < _iAngleCount; ++i)
+		angles[i] = (astra::float32)(i * _fRange / (_bEndpoint ? _iAngleCount - 1 : _iAngleCount));
+	astra::CVolumeGeometry2D vg(64, 64);
+	astra::CFanFlatProjectionGeometry2D pg(_iAngleCount, 128, 1.0f, &angles[0], 150.0f, 100.0f);
+	astra::CFanFlatBeamLineKernelProjector2D proj(&pg, &vg);
+
+	astra::CFloat32VolumeData2D disk(&vg, 0.0f);
+	for (int y = 0; y < disk.getHeight(); ++y)
+		for (int x = 0; x < disk.getWidth(); ++x)
+			if ((x - 35.5f) * (x - 35.5f) + (y - 29.5f) * (y - 29.5f) < 20 * 20)
+				disk.getData2D()[y][x] = 1.0f;
+
+	astra::CFloat32ProjectionData2D sino(&pg, 0.0f);
+	astra::CForwardProjectionAlgorithm fp(&proj, &disk, &sino);
+	fp.run();
+
+	astra::CFloat32VolumeData2D rec(&vg, 0.0f);
+	astra::CFilteredBackProjectionAlgorithm fbp;
+	BOOST_REQUIRE(fbp.initialize(&proj, &rec, &sino));
+	fbp.run();
+
+	double fDiff = 0.0, fNorm = 0.0;
+	for (int i = 0; i < rec.getSize(); ++i) {
+		double d = rec.getData()[i] - disk.getData()[i];
+		fDiff += d * d;
+		fNorm += (double)disk.getData()[i] * disk.getData()[i];
+	}
+	return sqrt(fDiff / fNorm);
+}
+
+}
+
+BOOST_AUTO_TEST_CASE( testFanBeamFBP_FullScan )
+{
+	BOOST_CHECK_SMALL(reconstructDisk(180, 2 * 3.14159265358979, false), 0.15);
+}
+
+BOOST_AUTO_TEST_CASE( testFanBeamFBP_ShortScan )
+{
+	// half fan angle of the detector is atan(64 / 250)
+	double fRange = 3.14159265358979 + 2 * atan(64.0 / 250.0) + 0.05;
+	BOOST_CHECK_SMALL(reconstructDisk(120, fRange, true), 0.15);
+}
@@ -0,0 +1,108 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+
+#include <cmath>
+
+#include "astra/FanParallelRebinAlgorithm.h"
+#include "astra/ForwardProjectionAlgorithm.h"
+#include "astra/ParallelBeamLineKernelProjector2D.h"
+#include "astra/FanFlatBeamLineKernelProjector2D.h"
+#include "astra/ParallelProjectionGeometry2D.h"
+#include "astra/FanFlatProjectionGeometry2D.h"
+#include "astra/VolumeGeometry2D.h"
+#include "astra/Float32VolumeData2D.h"
+#include "astra/Float32ProjectionData2D.h"
+
+BOOST_AUTO_TEST_CASE( testFanParallelRebinAlgorithm_FullScan )
+{
+	astra::float32 angles[360];
+	for (int i = 0; i < 360; ++i)
+		angles[i] = i * 2 * 3.14159265f / 360;
+	astra::CVolumeGeometry2D vg(64, 64);
+	astra::CFanFlatProjectionGeometry2D fanGeom(360, 128, 1.0f, angles, 150.0f, 100.0f);
+	astra::CFanFlatBeamLineKernelProjector2D fanProj(&fanGeom, &vg);
+
+	astra::CParallelProjectionGeometry2D* pParGeom = astra::CFanParallelRebinAlgorithm::createParallelGeometry(&fanGeom);
+	BOOST_REQUIRE(pParGeom);
+	BOOST_CHECK_EQUAL(pParGeom->getProjectionAngleCount(), 180);
+	BOOST_CHECK_CLOSE(pParGeom->getDetectorWidth(), 150.0f / 250.0f, 1e-3);
+	astra::CParallelBeamLineKernelProjector2D parProj(pParGeom, &vg);
+
+	astra::CFloat32VolumeData2D disk(&vg, 0.0f);
+	for (int y = 0; y < disk.getHeight(); ++y)
+		for (int x = 0; x < disk.getWidth(); ++x)
+			if ((x - 35.5f) * (x - 35.5f) + (y - 29.5f) * (y - 29.5f) < 20 * 20)
+				disk.getData2D()[y][x] = 1.0f;
+
+	astra::CFloat32ProjectionData2D fanSino(&fanGeom, 0.0f);
+	astra::CForwardProjectionAlgorithm fp(&fanProj, &disk, &fanSino);
+	fp.run();
+	astra::CFloat32ProjectionData2D parSino(pParGeom, 0.0f);
+	astra::CForwardProjectionAlgorithm fp2(&parProj, &disk, &parSino);
+	fp2.run();
+
+	astra::CFloat32ProjectionData2D rebinned(pParGeom, 0.0f);
+	astra::CFanParallelRebinAlgorithm rebin;
+	BOOST_REQUIRE(rebin.initialize(&fanSino, &rebinned));
+	rebin.run();
+
+	double fDiff = 0.0, fNorm = 0.0;
+	for (int i = 0; i < parSino.getSize(); ++i) {
+		double d = rebinned.getData()[i] - parSino.getData()[i];
+		fDiff += d * d;
+		fNorm += (double)parSino.getData()[i] * parSino.getData()[i];
+	}
+	BOOST_CHECK_SMALL(sqrt(fDiff / fNorm), 0.02);
+
+	delete pParGeom;
+}
+
+BOOST_AUTO_TEST_CASE( testFanParallelRebinAlgorithm_Invalid )
+{
+	astra::float32 angles[10];
+	for (int i = 0; i < 10; ++i)
+		angles[i] = i * 3.14159265f / 10;
+	astra::CParallelProjectionGeometry2D parGeom(10, 32, 1.0f, angles);
+	astra::CFloat32ProjectionData2D a(&parGeom, 0.0f);
+	astra::CFloat32ProjectionData2D b(&parGeom, 0.0f);
+
+	// the input must be fan beam data
+	astra::CFanParallelRebinAlgorithm rebin;
+	BOOST_CHECK(!rebin.initialize(&a, &b));
+	BOOST_CHECK(!astra::CFanParallelRebinAlgorithm::createParallelGeometry(&parGeom));
+
+	// one fan angle has no angular step
+	astra::CFanFlatProjectionGeometry2D fanGeom(1, 32, 1.0f, angles, 150.0f, 100.0f);
+	astra::CFloat32ProjectionData2D fan(&fanGeom, 0.0f);
+	BOOST_CHECK(!rebin.initialize(&fan, &b));
+	BOOST_CHECK(!astra::CFanParallelRebinAlgorithm::createParallelGeometry(&fanGeom));
+}
@@ -0,0 +1,68 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+
+#include "astra/HostMemory.h"
+#include "astra/SparseMatrix.h"
+#include "astra/VolumeGeometry3D.h"
+#include "astra/Float32VolumeData3DMemory.h"
+
+BOOST_AUTO_TEST_CASE( testHostMemory_Policies )
+{
+	astra::EHugePagePolicy saved = astra::getHugePagePolicy();
+
+	// explicit pages are usually not reserved, which must fall back cleanly
+	const astra::EHugePagePolicy policies[4] = { astra::HUGEPAGES_NONE, astra::HUGEPAGES_TRANSPARENT,
+	                                             astra::HUGEPAGES_EXPLICIT_2M, astra::HUGEPAGES_EXPLICIT_1G };
+	const size_t iBytes = astra::HUGEPAGE_MIN_BYTES + 12345;
+	for (int p = 0; p < 4; ++p) {
+		astra::setHugePagePolicy(policies[p]);
+
+		char* pc = (char*)astra::allocateHostMemory(iBytes, 64);
+		BOOST_REQUIRE(pc);
+		BOOST_CHECK_EQUAL((size_t)pc % 64, 0u);
+		pc[0] = 1;
+		pc[iBytes - 1] = 2;
+		astra::freeHostMemory(pc, iBytes);
+
+		astra::CVolumeGeometry3D vg(256, 128, 80);
+		astra::CFloat32VolumeData3DMemory vol(&vg, 1.0f);
+		BOOST_REQUIRE(vol.isInitialized());
+		BOOST_CHECK_EQUAL(vol.getData()[vol.getSize() - 1], 1.0f);
+
+		astra::CSparseMatrix matrix(1000, 1000, 4 << 20);
+		BOOST_REQUIRE(matrix.isInitialized());
+		matrix.m_pfValues[(4 << 20) - 1] = 1.0f;
+		matrix.m_plRowStarts[1000] = 0;
+	}
+
+	astra::setHugePagePolicy(saved);
+}
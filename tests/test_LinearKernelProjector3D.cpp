@@ -0,0 +1,115 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+
+#include <cstdio>
+#include <vector>
+#include <stdint.h>
+
+#include "astra/LinearKernelProjector3D.h"
+#include "astra/BrickedVolume3D.h"
+#include "astra/SparseMatrix.h"
+#include "astra/VolumeGeometry3D.h"
+#include "astra/ParallelProjectionGeometry3D.h"
+#include "astra/ConeProjectionGeometry3D.h"
+#include "astra/Float32ProjectionData3DMemory.h"
+
+BOOST_AUTO_TEST_CASE( testLinearKernelProjector3D_Matrix )
+{
+	astra::CVolumeGeometry3D geom(12, 10, 9);
+	const float angles[3] = { 0.0f, 0.7f, 2.0f };
+	astra::CParallelProjectionGeometry3D par(3, 9, 16, 1.0f, 1.0f, angles);
+	astra::CConeProjectionGeometry3D cone(3, 12, 20, 1.5f, 1.5f, angles, 30.0f, 20.0f);
+	astra::CProjectionGeometry3D* geoms[2] = { &par, &cone };
+
+	astra::CBrickedVolume3D vol(12, 10, 9);
+	for (int z = 0; z < 9; ++z)
+		for (int y = 0; y < 10; ++y)
+			for (int x = 0; x < 12; ++x)
+				vol.setValue(x, y, z, (float)((x * 7 + y * 3 + z * 5) % 11));
+
+	for (int g = 0; g < 2; ++g) {
+		astra::CLinearKernelProjector3D projector(geoms[g], &geom);
+		BOOST_REQUIRE(projector.isInitialized());
+
+		astra::CSparseMatrix* pMatrix = projector.getMatrix();
+		BOOST_REQUIRE(pMatrix);
+		const unsigned int iRays = geoms[g]->getDetectorRowCount() * 3 * geoms[g]->getDetectorColCount();
+		BOOST_REQUIRE_EQUAL(pMatrix->m_iHeight, iRays);
+		BOOST_REQUIRE_EQUAL(pMatrix->m_iWidth, 12u * 10 * 9);
+		BOOST_CHECK_EQUAL(pMatrix->m_plRowStarts[iRays], pMatrix->m_lSize);
+
+		// the matrix applies the same kernel as the bricked forward projection
+		astra::CFloat32ProjectionData3DMemory proj(geoms[g], 0.0f);
+		BOOST_REQUIRE(astra::forwardProjectBricked(&vol, &geom, &proj));
+		const float* pfProj = proj.getDataConst();
+		for (unsigned int r = 0; r < iRays; ++r) {
+			double fSum = 0.0;
+			for (unsigned long j = pMatrix->m_plRowStarts[r]; j < pMatrix->m_plRowStarts[r + 1]; ++j) {
+				unsigned int c = pMatrix->m_piColIndices[j];
+				fSum += pMatrix->m_pfValues[j] * vol.getValue(c % 12, (c / 12) % 10, c / 120);
+			}
+			BOOST_REQUIRE_SMALL(fSum - pfProj[r], 1e-3);
+		}
+
+		// streamed in blocks of three detector rows
+		const char* sFile = "test_LinearKernelProjector3D.bin";
+		BOOST_REQUIRE(projector.writeMatrix(sFile, 3));
+		FILE* f = fopen(sFile, "rb");
+		BOOST_REQUIRE(f);
+		char magic[8];
+		uint32_t header[4];
+		uint64_t lSize;
+		BOOST_REQUIRE(fread(magic, 1, 8, f) == 8 && fread(header, 4, 4, f) == 4 && fread(&lSize, 8, 1, f) == 1);
+		BOOST_CHECK_EQUAL(header[1], iRays);
+		BOOST_CHECK_EQUAL(header[3], (uint32_t)((geoms[g]->getDetectorRowCount() + 2) / 3));
+		BOOST_CHECK_EQUAL(lSize, (uint64_t)pMatrix->m_lSize);
+		std::vector<uint64_t> starts(iRays + 1);
+		BOOST_REQUIRE(fread(&starts[0], 8, iRays + 1, f) == iRays + 1);
+		BOOST_CHECK_EQUAL(starts[iRays / 2], (uint64_t)pMatrix->m_plRowStarts[iRays / 2]);
+		for (uint32_t b = 0; b < header[3]; ++b) {
+			uint32_t block[2];
+			BOOST_REQUIRE(fread(block, 4, 2, f) == 2);
+			size_t iCount = starts[block[0] + block[1]] - starts[block[0]];
+			std::vector<uint32_t> cols(iCount + 1);
+			std::vector<float> values(iCount + 1);
+			BOOST_REQUIRE(fread(&cols[0], 4, iCount, f) == iCount && fread(&values[0], 4, iCount, f) == iCount);
+			if (iCount > 0) {
+				BOOST_CHECK_EQUAL(cols[iCount - 1], pMatrix->m_piColIndices[starts[block[0]] + iCount - 1]);
+				BOOST_CHECK_EQUAL(values[0], pMatrix->m_pfValues[starts[block[0]]]);
+			}
+		}
+		fclose(f);
+		remove(sFile);
+
+		delete pMatrix;
+	}
+}
@@ -0,0 +1,139 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <string>
+
+#include "astra/Logging.h"
+#include "astra/WorkerPool.h"
+
+namespace {
+
+struct LogRange {
+	void operator()(int _iFrom, int _iTo) const {
+		for (int i = _iFrom; i < _iTo; ++i)
+			ASTRA_INFO("message %d", i);
+	}
+};
+
+int countLines(const char* _sFilename)
+{
+	std::ifstream f(_sFilename);
+	std::string s;
+	int n = 0;
+	while (std::getline(f, s))
+		n++;
+	return n;
+}
+
+int countLinesStartingWith(const char* _sFilename, char _c)
+{
+	std::ifstream f(_sFilename);
+	std::string s;
+	int n = 0;
+	while (std::getline(f, s))
+		if (!s.empty() && s[0] == _c)
+			n++;
+	return n;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE( testLogging_Queue )
+{
+	const char* sFile = "test_Logging.log";
+
+	astra::CLogger::disableScreen();
+	astra::CLogger::setOutputFile(sFile, astra::LOG_INFO);
+	astra::CLogger::enableFile();
+
+	// Fewer messages than the queue size, so none are dropped
+	astra::CWorkerPool::getSingleton().parallelFor(0, 500, LogRange());
+	astra::CLogger::flush();
+	BOOST_CHECK_EQUAL(countLines(sFile), 500);
+
+	// Errors are written immediately
+	ASTRA_ERROR("error");
+	BOOST_CHECK_EQUAL(countLines(sFile), 501);
+
+	astra::CLogger::setAsync(false);
+	ASTRA_INFO("synchronous");
+	BOOST_CHECK_EQUAL(countLines(sFile), 502);
+	astra::CLogger::setAsync(true);
+
+	astra::CLogger::disableFile();
+	astra::CLogger::enableScreen();
+	remove(sFile);
+}
+
+BOOST_AUTO_TEST_CASE( testLogging_Reconfigure )
+{
+	const char* sFile = "test_Logging.log";
+
+	astra::CLogger::disableScreen();
+	astra::CLogger::setOutputFile(sFile, astra::LOG_INFO);
+	astra::CLogger::enableFile();
+
+	// Messages queued before a format change keep the old format
+	astra::CLogger::setFormatFile("A %m\n");
+	for (int i = 0; i < 10; ++i)
+		ASTRA_INFO("message %d", i);
+	astra::CLogger::setFormatFile("B %m\n");
+	ASTRA_INFO("message");
+	astra::CLogger::flush();
+	BOOST_CHECK_EQUAL(countLinesStartingWith(sFile, 'A'), 10);
+	BOOST_CHECK_EQUAL(countLinesStartingWith(sFile, 'B'), 1);
+
+	// The writer wakes up for new messages without a flush
+	ASTRA_INFO("message");
+	time_t start = time(0);
+	while (countLines(sFile) < 12 && time(0) - start < 10) { }
+	BOOST_CHECK_EQUAL(countLines(sFile), 12);
+
+	astra::CLogger::disableFile();
+	astra::CLogger::enableScreen();
+	remove(sFile);
+}
+
+BOOST_AUTO_TEST_CASE( testLogging_DebugCompiledOut )
+{
+	int i = 0;
+	ASTRA_DEBUG("%d", ++i);
+#ifdef ASTRA_DEBUG_LOG
+	BOOST_CHECK_EQUAL(i, 1);
+#else
+	BOOST_CHECK_EQUAL(i, 0);
+#endif
+}
@@ -0,0 +1,122 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+
+#include "astra/MemoryBudget.h"
+#include "astra/ScratchArena.h"
+#include "astra/SirtAlgorithm.h"
+#include "astra/ParallelBeamLineKernelProjector2D.h"
+#include "astra/ParallelProjectionGeometry2D.h"
+#include "astra/VolumeGeometry2D.h"
+#include "astra/Float32VolumeData2D.h"
+#include "astra/Float32ProjectionData2D.h"
+
+BOOST_AUTO_TEST_CASE( testMemoryBudget_Limit )
+{
+	astra::CMemoryBudget& budget = astra::CMemoryBudget::getSingleton();
+	size_t iLimit = budget.getLimit();
+	size_t iUsed = budget.getUsed();
+	budget.resetPeak();
+
+	budget.setLimit(iUsed + 1000);
+	BOOST_CHECK(budget.fits(1000));
+	BOOST_CHECK(!budget.fits(1001));
+	BOOST_CHECK(budget.reserve(600));
+	BOOST_CHECK(!budget.reserve(600));
+	BOOST_CHECK_EQUAL(budget.getUsed(), iUsed + 600);
+	budget.release(600);
+	BOOST_CHECK_EQUAL(budget.getUsed(), iUsed);
+	BOOST_CHECK_EQUAL(budget.getPeak(), iUsed + 600);
+
+	budget.setLimit(iLimit);
+}
+
+BOOST_AUTO_TEST_CASE( testMemoryBudget_Data )
+{
+	astra::CMemoryBudget& budget = astra::CMemoryBudget::getSingleton();
+	size_t iLimit = budget.getLimit();
+	size_t iUsed = budget.getUsed();
+	astra::CVolumeGeometry2D geom(64, 64);
+
+	// over the limit, the data object fails cleanly
+	budget.setLimit(iUsed + 1000);
+	{
+		astra::CFloat32VolumeData2D data(&geom, 0.0f);
+		BOOST_CHECK(!data.isInitialized());
+		BOOST_CHECK_EQUAL(data.getMemoryUsage(), 0U);
+		BOOST_CHECK_EQUAL(budget.getUsed(), iUsed);
+	}
+
+	budget.setLimit(0);
+	{
+		astra::CFloat32VolumeData2D data(&geom, 0.0f);
+		BOOST_REQUIRE(data.isInitialized());
+		BOOST_CHECK(data.getMemoryUsage() >= 64*64*sizeof(astra::float32));
+		BOOST_CHECK_EQUAL(budget.getUsed(), iUsed + 64*64*sizeof(astra::float32));
+	}
+	BOOST_CHECK_EQUAL(budget.getUsed(), iUsed);
+
+	budget.setLimit(iLimit);
+}
+
+BOOST_AUTO_TEST_CASE( testMemoryBudget_SirtEstimate )
+{
+	astra::CMemoryBudget& budget = astra::CMemoryBudget::getSingleton();
+	size_t iLimit = budget.getLimit();
+
+	astra::float32 angles[100];
+	for (int i = 0; i < 100; ++i)
+		angles[i] = i * 3.14159265f / 100;
+	astra::CVolumeGeometry2D vg(32, 32);
+	astra::CParallelProjectionGeometry2D pg(100, 48, 1.0f, angles);
+	astra::CParallelBeamLineKernelProjector2D proj(&pg, &vg);
+	astra::CFloat32ProjectionData2D sino(&pg, 1.0f);
+	astra::CFloat32VolumeData2D rec(&vg, 0.0f);
+	BOOST_CHECK(proj.getMemoryUsage() >= 100 * sizeof(astra::float32));
+
+	{
+		astra::CSirtAlgorithm sirt;
+		BOOST_CHECK_EQUAL(sirt.getMemoryEstimate(), 0U);
+		BOOST_REQUIRE(sirt.initialize(&proj, &sino, &rec));
+		BOOST_CHECK_EQUAL(sirt.getMemoryEstimate(), (2*100*48 + 2*32*32) * sizeof(astra::float32));
+	}
+
+	// without room for its temporaries, SIRT fails to initialize
+	astra::CScratchArena::getSingleton().trim();
+	budget.setLimit(budget.getUsed() + 1000);
+	{
+		astra::CSirtAlgorithm sirt;
+		BOOST_CHECK(!sirt.initialize(&proj, &sino, &rec));
+	}
+
+	budget.setLimit(iLimit);
+	astra::CScratchArena::getSingleton().trim();
+}
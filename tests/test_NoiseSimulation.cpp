@@ -0,0 +1,110 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+
+#include <cmath>
+#include <vector>
+
+#include "astra/NoiseSimulation.h"
+#include "astra/WorkerPool.h"
+
+static void moments(const std::vector<double>& _v, double& _fMean, double& _fVar)
+{
+	double s = 0.0, s2 = 0.0;
+	for (size_t i = 0; i < _v.size(); ++i) {
+		s += _v[i];
+		s2 += _v[i] * _v[i];
+	}
+	_fMean = s / _v.size();
+	_fVar = s2 / _v.size() - _fMean * _fMean;
+}
+
+BOOST_AUTO_TEST_CASE( testNoiseSimulation_Gaussian )
+{
+	std::vector<float> data(100001, 1.0f);
+	BOOST_REQUIRE(astra::addGaussianNoise(&data[0], data.size(), 2.0f, 1234));
+
+	std::vector<double> v(data.begin(), data.end());
+	double fMean, fVar;
+	moments(v, fMean, fVar);
+	BOOST_CHECK_SMALL(fMean - 1.0, 0.03);
+	BOOST_CHECK_CLOSE(sqrt(fVar), 2.0, 2.0);
+
+	BOOST_CHECK(!astra::addGaussianNoise(&data[0], data.size(), -1.0f, 1234));
+}
+
+BOOST_AUTO_TEST_CASE( testNoiseSimulation_Poisson )
+{
+	// large counts: p = 1, I0 = 1000
+	std::vector<float> data(100000, 1.0f);
+	BOOST_REQUIRE(astra::addPoissonNoise(&data[0], data.size(), 1000.0f, 1.0f, 99));
+	std::vector<double> counts(data.size());
+	for (size_t i = 0; i < data.size(); ++i)
+		counts[i] = 1000.0 * exp(-(double)data[i]);
+	double fMean, fVar;
+	moments(counts, fMean, fVar);
+	BOOST_CHECK_CLOSE(fMean, 1000.0 * exp(-1.0), 0.5);
+	BOOST_CHECK_CLOSE(fVar, 1000.0 * exp(-1.0), 3.0);
+
+	// small counts: p = 0.5 with scale 2, I0 = 4
+	std::vector<float> low(100000, 0.5f);
+	BOOST_REQUIRE(astra::addPoissonNoise(&low[0], low.size(), 4.0f, 2.0f, 99));
+	for (size_t i = 0; i < low.size(); ++i)
+		counts[i] = 4.0 * exp(-2.0 * low[i]);
+	moments(counts, fMean, fVar);
+	// zero counts are counted as one
+	double fExpected = 4.0 * exp(-1.0) + exp(-4.0 * exp(-1.0));
+	BOOST_CHECK_CLOSE(fMean, fExpected, 2.0);
+
+	BOOST_CHECK(!astra::addPoissonNoise(&data[0], data.size(), 0.0f, 1.0f, 99));
+}
+
+BOOST_AUTO_TEST_CASE( testNoiseSimulation_Reproducible )
+{
+	astra::SWorkerPoolParams saved = astra::CWorkerPool::getGlobalParams();
+
+	std::vector<float> a(50000, 2.0f), b(50000, 2.0f), c(50000, 2.0f);
+
+	astra::SWorkerPoolParams params;
+	params.iThreadCount = 1;
+	astra::CWorkerPool::setGlobalParams(params);
+	astra::addPoissonNoise(&a[0], a.size(), 500.0f, 1.0f, 7, 3);
+
+	params.iThreadCount = 3;
+	astra::CWorkerPool::setGlobalParams(params);
+	astra::addPoissonNoise(&b[0], b.size(), 500.0f, 1.0f, 7, 3);
+	astra::addPoissonNoise(&c[0], c.size(), 500.0f, 1.0f, 7, 4);
+
+	astra::CWorkerPool::setGlobalParams(saved);
+
+	BOOST_CHECK(a == b);
+	BOOST_CHECK(a != c);
+}
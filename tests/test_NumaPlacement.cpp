@@ -0,0 +1,77 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+
+#include <algorithm>
+#include <vector>
+
+#include "astra/NumaPlacement.h"
+#include "astra/VolumeGeometry2D.h"
+#include "astra/VolumeGeometry3D.h"
+#include "astra/Float32VolumeData2D.h"
+#include "astra/Float32VolumeData3DMemory.h"
+
+BOOST_AUTO_TEST_CASE( testNumaPlacement_Policies )
+{
+	astra::ENumaPolicy saved = astra::getNumaPolicy();
+	BOOST_CHECK(astra::getNumaNodeCount() >= 1);
+
+	// large enough for the parallel paths
+	astra::CVolumeGeometry3D vg(128, 128, 80);
+	std::vector<float> src(128 * 128 * 80);
+	for (size_t i = 0; i < src.size(); ++i)
+		src[i] = (float)(i % 1013);
+
+	const astra::ENumaPolicy policies[3] = { astra::NUMA_FIRST_TOUCH, astra::NUMA_INTERLEAVE, astra::NUMA_LOCAL };
+	for (int p = 0; p < 3; ++p) {
+		astra::setNumaPolicy(policies[p]);
+		BOOST_CHECK_EQUAL(astra::getNumaPolicy(), policies[p]);
+
+		astra::CFloat32VolumeData3DMemory copy(&vg, &src[0]);
+		BOOST_CHECK(std::equal(src.begin(), src.end(), copy.getData()));
+
+		astra::CFloat32VolumeData3DMemory filled(&vg, 2.5f);
+		BOOST_CHECK_EQUAL(filled.getData()[0], 2.5f);
+		BOOST_CHECK_EQUAL(filled.getData()[src.size() - 1], 2.5f);
+		filled.copyData(&src[0], src.size());
+		BOOST_CHECK(std::equal(src.begin(), src.end(), filled.getData()));
+		filled.clearData();
+		BOOST_CHECK_EQUAL(filled.getData()[src.size() / 2], 0.0f);
+
+		astra::CVolumeGeometry2D vg2(1024, 1280);
+		astra::CFloat32VolumeData2D vol(&vg2, &src[0]);
+		BOOST_CHECK(std::equal(src.begin(), src.begin() + vol.getSize(), vol.getData()));
+		vol.setData(-1.0f);
+		BOOST_CHECK_EQUAL(vol.getData()[vol.getSize() - 1], -1.0f);
+	}
+
+	astra::setNumaPolicy(saved);
+}
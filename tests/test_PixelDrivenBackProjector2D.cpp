@@ -0,0 +1,191 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+
+#include <cmath>
+
+#include "astra/PixelDrivenBackProjector2D.h"
+#include "astra/BackProjectionAlgorithm.h"
+#include "astra/ForwardProjectionAlgorithm.h"
+#include "astra/SirtAlgorithm.h"
+#include "astra/ParallelBeamLineKernelProjector2D.h"
+#include "astra/FanFlatBeamLineKernelProjector2D.h"
+#include "astra/ParallelProjectionGeometry2D.h"
+#include "astra/FanFlatProjectionGeometry2D.h"
+#include "astra/VolumeGeometry2D.h"
+#include "astra/Float32VolumeData2D.h"
+#include "astra/Float32ProjectionData2D.h"
+#include "astra/MemoryBudget.h"
+
+namespace {
+
+// Backproject the projection of a disk, ray-driven and pixel-driven,
+// and return the relative difference
+double compareBP(astra::CProjector2D* _pProjector)
+{
+	astra::CVolumeGeometry2D* pVolGeom = _pProjector->getVolumeGeometry();
+	astra::CProjectionGeometry2D* pProjGeom = _pProjector->getProjectionGeometry();
+
+	astra::CFloat32VolumeData2D disk(pVolGeom, 0.0f);
+	for (int y = 0; y < disk.getHeight(); ++y)
+		for (int x = 0; x < disk.getWidth(); ++x)
+			if ((x - 31.5f) * (x - 31.5f) + (y - 31.5f) * (y - 31.5f) < 20 * 20)
+				disk.getData2D()[y][x] = 1.0f;
+
+	astra::CFloat32ProjectionData2D sino(pProjGeom, 0.0f);
+	astra::CForwardProjectionAlgorithm fp(_pProjector, &disk, &sino);
+	fp.run();
+
+	astra::CFloat32VolumeData2D ray(pVolGeom, 0.0f);
+	astra::CFloat32VolumeData2D pixel(pVolGeom, 0.0f);
+	astra::CBackProjectionAlgorithm bp;
+	BOOST_REQUIRE(bp.initialize(_pProjector, &sino, &ray));
+	bp.run();
+	BOOST_REQUIRE(bp.initialize(_pProjector, &sino, &pixel));
+	bp.setPixelDriven(true);
+	bp.run();
+
+	double fDiff = 0.0, fNorm = 0.0;
+	for (int i = 0; i < ray.getSize(); ++i) {
+		double d = ray.getData()[i] - pixel.getData()[i];
+		fDiff += d * d;
+		fNorm += (double)ray.getData()[i] * ray.getData()[i];
+	}
+	BOOST_REQUIRE(fNorm > 0.0);
+	return sqrt(fDiff / fNorm);
+}
+
+// SIRT with access to its pixel weights
+class CTestSirt : public astra::CSirtAlgorithm {
+public:
+	const astra::CFloat32VolumeData2D* getPixelWeights() const { return m_pTotalPixelWeight; }
+};
+
+}
+
+BOOST_AUTO_TEST_CASE( testPixelDrivenBackProjector2D_Parallel )
+{
+	astra::float32 angles[90];
+	for (int i = 0; i < 90; ++i)
+		angles[i] = i * 3.14159265f / 90;
+	astra::CVolumeGeometry2D vg(64, 64);
+	astra::CParallelProjectionGeometry2D pg(90, 96, 1.0f, angles);
+	astra::CParallelBeamLineKernelProjector2D proj(&pg, &vg);
+
+	BOOST_CHECK(astra::CPixelDrivenBackProjector2D::isSupported(&pg));
+	BOOST_CHECK_SMALL(compareBP(&proj), 0.05);
+}
+
+BOOST_AUTO_TEST_CASE( testPixelDrivenBackProjector2D_Fan )
+{
+	astra::float32 angles[120];
+	for (int i = 0; i < 120; ++i)
+		angles[i] = i * 2 * 3.14159265f / 120;
+	astra::CVolumeGeometry2D vg(64, 64);
+	astra::CFanFlatProjectionGeometry2D pg(120, 128, 1.5f, angles, 200.0f, 100.0f);
+	astra::CFanFlatBeamLineKernelProjector2D proj(&pg, &vg);
+
+	BOOST_CHECK(astra::CPixelDrivenBackProjector2D::isSupported(&pg));
+	BOOST_CHECK_SMALL(compareBP(&proj), 0.05);
+}
+
+BOOST_AUTO_TEST_CASE( testPixelDrivenBackProjector2D_Mask )
+{
+	astra::float32 angles[30];
+	for (int i = 0; i < 30; ++i)
+		angles[i] = i * 3.14159265f / 30;
+	astra::CVolumeGeometry2D vg(32, 32);
+	astra::CParallelProjectionGeometry2D pg(30, 48, 1.0f, angles);
+
+	astra::CFloat32ProjectionData2D sino(&pg, 1.0f);
+	astra::CFloat32VolumeData2D full(&vg, 0.0f);
+	astra::CFloat32VolumeData2D masked(&vg, 0.0f);
+	astra::CFloat32VolumeData2D mask(&vg, 1.0f);
+	for (int y = 0; y < 32; ++y)
+		for (int x = 0; x < 16; ++x)
+			mask.getData2D()[y][x] = 0.0f;
+
+	astra::CPixelDrivenBackProjector2D bp(&pg, &vg);
+	BOOST_REQUIRE(bp.isInitialized());
+	BOOST_CHECK(bp.backProject(&sino, &full));
+	BOOST_CHECK(bp.backProject(&sino, &masked, 0, &mask));
+
+	for (int y = 0; y < 32; ++y) {
+		BOOST_CHECK_EQUAL(masked.getData2D()[y][3], 0.0f);
+		BOOST_CHECK_EQUAL(masked.getData2D()[y][20], full.getData2D()[y][20]);
+	}
+	// every pixel is seen by all 30 angles with weight 1
+	BOOST_CHECK_CLOSE(full.getData2D()[16][16], 30.0f, 0.01);
+}
+
+BOOST_AUTO_TEST_CASE( testPixelDrivenBackProjector2D_BufferFailure )
+{
+	astra::float32 angles[2] = { 0.0f, 1.0f };
+	astra::CVolumeGeometry2D vg(300000, 1);
+	astra::CParallelProjectionGeometry2D pg(2, 4, 1.0f, angles);
+	astra::CFloat32ProjectionData2D sino(&pg, 1.0f);
+	astra::CFloat32VolumeData2D vol(&vg, 0.0f);
+	astra::CPixelDrivenBackProjector2D bp(&pg, &vg);
+	BOOST_REQUIRE(bp.isInitialized());
+
+	// leave room for the padded sinogram, but not for the row band buffer
+	astra::CMemoryBudget& budget = astra::CMemoryBudget::getSingleton();
+	size_t iLimit = budget.getLimit();
+	budget.setLimit(budget.getUsed() + (1 << 20));
+	BOOST_CHECK(!bp.backProject(&sino, &vol));
+	budget.setLimit(iLimit);
+}
+
+BOOST_AUTO_TEST_CASE( testPixelDrivenBackProjector2D_SirtWeights )
+{
+	astra::float32 angles[30];
+	for (int i = 0; i < 30; ++i)
+		angles[i] = i * 3.14159265f / 30;
+	astra::CVolumeGeometry2D vg(32, 32);
+	astra::CParallelProjectionGeometry2D pg(30, 48, 1.0f, angles);
+	astra::CParallelBeamLineKernelProjector2D proj(&pg, &vg);
+
+	astra::CFloat32ProjectionData2D sino(&pg, 1.0f);
+	astra::CFloat32VolumeData2D rec(&vg, 0.0f);
+	CTestSirt sirt;
+	BOOST_REQUIRE(sirt.initialize(&proj, &sino, &rec));
+	sirt.setPixelDriven(true);
+	sirt.run(1);
+
+	// 1 / (pixel-driven backprojection of ones), not of the projector's
+	astra::CFloat32VolumeData2D ref(&vg, 0.0f);
+	astra::CFloat32ProjectionData2D ones(&pg, 1.0f);
+	astra::CPixelDrivenBackProjector2D bp(&pg, &vg);
+	BOOST_REQUIRE(bp.backProject(&ones, &ref));
+	const astra::CFloat32VolumeData2D* pWeights = sirt.getPixelWeights();
+	for (int i = 0; i < ref.getSize(); ++i)
+		BOOST_REQUIRE_CLOSE(pWeights->getDataConst()[i], 1.0f / ref.getDataConst()[i], 1e-3);
+}
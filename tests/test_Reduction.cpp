@@ -0,0 +1,104 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+
+#include <vector>
+
+#include "astra/Reduction.h"
+#include "astra/WorkerPool.h"
+#include "astra/CglsAlgorithm.h"
+#include "astra/AnalyticPhantom.h"
+#include "astra/ParallelBeamLineKernelProjector2D.h"
+#include "astra/ParallelProjectionGeometry2D.h"
+#include "astra/VolumeGeometry2D.h"
+#include "astra/Float32VolumeData2D.h"
+#include "astra/Float32ProjectionData2D.h"
+
+BOOST_AUTO_TEST_CASE( testReduction_Accuracy )
+{
+	// 0.1f is not exact, so compare to the double sum of the float values
+	std::vector<float> data(1000003, 0.1f);
+	double fExact = 1000003 * (double)0.1f;
+	BOOST_CHECK_CLOSE(astra::reduceSum(&data[0], data.size()), fExact, 1e-10);
+	BOOST_CHECK_CLOSE(astra::reduceSquaredNorm(&data[0], data.size()), fExact * 0.1f, 1e-10);
+
+	std::vector<float> b(data.size(), 2.0f);
+	BOOST_CHECK_CLOSE(astra::reduceDot(&data[0], &b[0], data.size()), 2 * fExact, 1e-10);
+
+	BOOST_CHECK_EQUAL(astra::reduceSum(&data[0], 0), 0.0);
+	BOOST_CHECK_CLOSE(astra::reduceSum(&data[0], 5), 5 * (double)0.1f, 1e-10);
+}
+
+BOOST_AUTO_TEST_CASE( testReduction_Reproducible )
+{
+	std::vector<float> data(500000);
+	for (size_t i = 0; i < data.size(); ++i)
+		data[i] = (float)((i * 7919) % 1000) * 1e-3f - 0.3f;
+
+	astra::SWorkerPoolParams saved = astra::CWorkerPool::getGlobalParams();
+	astra::SWorkerPoolParams params;
+
+	params.iThreadCount = 1;
+	astra::CWorkerPool::setGlobalParams(params);
+	double fSum1 = astra::reduceSum(&data[0], data.size());
+
+	params.iThreadCount = 3;
+	astra::CWorkerPool::setGlobalParams(params);
+	double fSum3 = astra::reduceSum(&data[0], data.size());
+
+	astra::CWorkerPool::setGlobalParams(saved);
+
+	BOOST_CHECK_EQUAL(fSum1, fSum3);
+}
+
+BOOST_AUTO_TEST_CASE( testReduction_CglsResidual )
+{
+	astra::float32 angles[45];
+	for (int i = 0; i < 45; ++i)
+		angles[i] = i * 3.14159265f / 45;
+	astra::CVolumeGeometry2D vg(48, 48);
+	astra::CParallelProjectionGeometry2D pg(45, 64, 1.0f, angles);
+	astra::CParallelBeamLineKernelProjector2D proj(&pg, &vg);
+
+	astra::CFloat32ProjectionData2D sino(&pg, 0.0f);
+	astra::CEllipsePhantom2D::createSheppLogan(22.0).project(&sino);
+	astra::CFloat32VolumeData2D rec(&vg, 0.0f);
+
+	astra::CCglsAlgorithm cgls(&proj, &sino, &rec);
+	astra::float32 fNorm0, fNorm1;
+	BOOST_CHECK(!cgls.getResidualNorm(fNorm0));
+	cgls.run(2);
+	BOOST_REQUIRE(cgls.getResidualNorm(fNorm0));
+	cgls.run(10);
+	BOOST_REQUIRE(cgls.getResidualNorm(fNorm1));
+	BOOST_CHECK(fNorm1 < fNorm0);
+	BOOST_CHECK(fNorm1 > 0.0f);
+}
@@ -0,0 +1,104 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+
+#include "astra/ScratchArena.h"
+#include "astra/Float32VolumeData2D.h"
+#include "astra/VolumeGeometry2D.h"
+
+BOOST_AUTO_TEST_CASE( testScratchArena_ClassSize )
+{
+	BOOST_CHECK_EQUAL(astra::CScratchArena::getClassSize(1), 4096U);
+	BOOST_CHECK_EQUAL(astra::CScratchArena::getClassSize(4097), 6144U);
+	BOOST_CHECK_EQUAL(astra::CScratchArena::getClassSize(6145), 8192U);
+	BOOST_CHECK_EQUAL(astra::CScratchArena::getClassSize(1 << 20), 1U << 20);
+}
+
+BOOST_AUTO_TEST_CASE( testScratchArena_Reuse )
+{
+	astra::CScratchArena& arena = astra::CScratchArena::getSingleton();
+	arena.trim();
+
+	size_t iClass;
+	void* p = arena.allocate(100000, iClass);
+	BOOST_REQUIRE(p);
+	BOOST_CHECK_EQUAL((size_t)p % astra::CScratchArena::ALIGNMENT, 0U);
+	BOOST_CHECK(iClass >= 100000);
+
+	arena.release(p, iClass);
+	BOOST_CHECK_EQUAL(arena.getCachedBytes(), iClass);
+
+	// same size class gets the same buffer back
+	size_t iClass2;
+	void* p2 = arena.allocate(iClass - 10, iClass2);
+	BOOST_CHECK_EQUAL(p2, p);
+	BOOST_CHECK_EQUAL(arena.getCachedBytes(), 0U);
+	arena.release(p2, iClass2);
+
+	arena.trim();
+	BOOST_CHECK_EQUAL(arena.getCachedBytes(), 0U);
+}
+
+BOOST_AUTO_TEST_CASE( testScratchArena_CacheLimit )
+{
+	astra::CScratchArena& arena = astra::CScratchArena::getSingleton();
+	arena.trim();
+	size_t iLimit = arena.getCacheLimit();
+	arena.setCacheLimit(8192);
+
+	size_t iClass1, iClass2;
+	void* p1 = arena.allocate(8192, iClass1);
+	void* p2 = arena.allocate(8192, iClass2);
+	arena.release(p1, iClass1);
+	arena.release(p2, iClass2);
+	BOOST_CHECK_EQUAL(arena.getCachedBytes(), 8192U);
+
+	arena.setCacheLimit(iLimit);
+	arena.trim();
+}
+
+BOOST_AUTO_TEST_CASE( testScratchArena_CustomMemory )
+{
+	astra::CScratchArena& arena = astra::CScratchArena::getSingleton();
+	arena.trim();
+
+	astra::CVolumeGeometry2D geom(64, 32);
+	{
+		astra::CFloat32VolumeData2D data(&geom, arena.createCustomMemory(64*32));
+		BOOST_REQUIRE(data.isInitialized());
+		BOOST_CHECK_EQUAL((size_t)data.getData() % astra::CScratchArena::ALIGNMENT, 0U);
+		data.setData(1.0f);
+		BOOST_CHECK_EQUAL(data.getData()[64*32-1], 1.0f);
+	}
+	BOOST_CHECK_EQUAL(arena.getCachedBytes(), astra::CScratchArena::getClassSize(64*32*sizeof(astra::float32)));
+
+	arena.trim();
+}
@@ -0,0 +1,148 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+
+#include <cmath>
+
+#include "astra/SeparableFootprintProjector3D.h"
+#include "astra/LinearKernelProjector3D.h"
+#include "astra/BrickedVolume3D.h"
+#include "astra/CglsAlgorithm3D.h"
+#include "astra/SparseMatrix.h"
+#include "astra/VolumeGeometry3D.h"
+#include "astra/ConeProjectionGeometry3D.h"
+#include "astra/ConeVecProjectionGeometry3D.h"
+#include "astra/Float32ProjectionData3DMemory.h"
+#include "astra/Float32VolumeData3DMemory.h"
+
+struct TestSeparableFootprint3D {
+	TestSeparableFootprint3D()
+		: geom(16, 16, 12),
+		  cone(4, 14, 24, 1.5f, 1.5f, angles, 40.0f, 20.0f),
+		  vol(&geom, 0.0f)
+	{
+		// a smooth blob, so that all kernels approximate the same integrals
+		for (int z = 0; z < 12; ++z)
+			for (int y = 0; y < 16; ++y)
+				for (int x = 0; x < 16; ++x) {
+					const float r2 = (x - 7.5f) * (x - 7.5f) + (y - 8.5f) * (y - 8.5f) + (z - 5.5f) * (z - 5.5f);
+					vol.getRow(y, z)[x] = std::exp(-r2 / 18.0f);
+				}
+	}
+
+	static const float angles[4];
+	astra::CVolumeGeometry3D geom;
+	astra::CConeProjectionGeometry3D cone;
+	astra::CFloat32VolumeData3DMemory vol;
+};
+
+const float TestSeparableFootprint3D::angles[4] = { 0.0f, 0.6f, 1.7f, 2.9f };
+
+BOOST_FIXTURE_TEST_CASE( testSeparableFootprint3D_Accuracy, TestSeparableFootprint3D )
+{
+	astra::CBrickedVolume3D bricked(16, 16, 12);
+	BOOST_REQUIRE(bricked.copyFrom(&vol));
+	astra::CFloat32ProjectionData3DMemory ref(&cone, 0.0f);
+	BOOST_REQUIRE(astra::forwardProjectBricked(&bricked, &geom, &ref));
+
+	for (int tt = 0; tt < 2; ++tt) {
+		astra::CSeparableFootprintProjector3D projector(&cone, &geom, tt != 0);
+		BOOST_REQUIRE(projector.isInitialized());
+		astra::CFloat32ProjectionData3DMemory proj(&cone, 0.0f);
+		BOOST_REQUIRE(projector.forwardProject(&vol, &proj));
+
+		double fDiff = 0.0, fNorm = 0.0;
+		for (int i = 0; i < proj.getSize(); ++i) {
+			const double d = proj.getDataConst()[i] - ref.getDataConst()[i];
+			fDiff += d * d;
+			fNorm += (double)ref.getDataConst()[i] * ref.getDataConst()[i];
+		}
+		BOOST_CHECK_LT(std::sqrt(fDiff / fNorm), 0.03);
+	}
+}
+
+BOOST_FIXTURE_TEST_CASE( testSeparableFootprint3D_Matched, TestSeparableFootprint3D )
+{
+	astra::CSeparableFootprintProjector3D projector(&cone, &geom, true);
+	BOOST_REQUIRE(projector.isInitialized());
+	astra::CFloat32ProjectionData3DMemory proj(&cone, 0.0f);
+	BOOST_REQUIRE(projector.forwardProject(&vol, &proj));
+
+	// the explicit matrix has the same weights
+	astra::CSparseMatrix* pMatrix = projector.getMatrix();
+	BOOST_REQUIRE(pMatrix);
+	const float* pfVol = vol.getDataConst();
+	for (unsigned int r = 0; r < pMatrix->m_iHeight; ++r) {
+		double fSum = 0.0;
+		for (unsigned long j = pMatrix->m_plRowStarts[r]; j < pMatrix->m_plRowStarts[r + 1]; ++j)
+			fSum += pMatrix->m_pfValues[j] * pfVol[pMatrix->m_piColIndices[j]];
+		BOOST_REQUIRE_SMALL(fSum - proj.getDataConst()[r], 1e-3);
+	}
+	delete pMatrix;
+
+	// the backprojection is the transpose: <A x, y> = <x, A' y>
+	astra::CFloat32ProjectionData3DMemory y(&cone, 0.0f);
+	for (int i = 0; i < y.getSize(); ++i)
+		y.getData()[i] = (float)((i * 5) % 7) + 1.0f;
+	astra::CFloat32VolumeData3DMemory bp(&geom, 1.0f);
+	BOOST_REQUIRE(projector.backProject(&y, &bp));
+	double fLeft = 0.0, fRight = 0.0;
+	for (int i = 0; i < proj.getSize(); ++i)
+		fLeft += (double)proj.getDataConst()[i] * y.getDataConst()[i];
+	for (int i = 0; i < vol.getSize(); ++i)
+		fRight += (double)pfVol[i] * bp.getDataConst()[i];
+	BOOST_CHECK_CLOSE(fLeft, fRight, 1e-3);
+
+	// matched, so CGLS converges
+	astra::CFloat32VolumeData3DMemory rec(&geom, 0.0f);
+	astra::CCglsAlgorithm3D cgls;
+	BOOST_REQUIRE(cgls.initialize(&projector, &proj, &rec));
+	astra::float32 fFirst, fLast;
+	cgls.run(1);
+	BOOST_REQUIRE(cgls.getResidualNorm(fFirst));
+	cgls.run(20);
+	BOOST_REQUIRE(cgls.getResidualNorm(fLast));
+	BOOST_CHECK_LT(fLast, 0.05f * fFirst);
+}
+
+BOOST_AUTO_TEST_CASE( testSeparableFootprint3D_Geometry )
+{
+	astra::CVolumeGeometry3D geom(8, 8, 8);
+	astra::SConeProjection p = { 0.0, -30.0, 0.0,  -6.0, 15.0, -6.0,  1.0, 0.0, 0.0,  0.0, 0.0, 1.0 };
+	astra::CConeVecProjectionGeometry3D upright(1, 12, 12, &p);
+	astra::CSeparableFootprintProjector3D projector;
+	BOOST_CHECK(projector.initialize(&upright, &geom));
+
+	// a detector rolled about the beam axis doesn't separate
+	p.fDetUZ = 0.1;
+	astra::CConeVecProjectionGeometry3D rolled(1, 12, 12, &p);
+	BOOST_CHECK(!projector.initialize(&rolled, &geom));
+}
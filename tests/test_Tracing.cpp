@@ -0,0 +1,87 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "astra/Tracing.h"
+
+namespace {
+
+std::string readFile(const char* _sFilename)
+{
+	std::ifstream f(_sFilename);
+	std::stringstream s;
+	s << f.rdbuf();
+	return s.str();
+}
+
+}
+
+BOOST_AUTO_TEST_CASE( testTracing_Scopes )
+{
+	const char* sFile = "test_Tracing.json";
+
+	BOOST_REQUIRE(!astra::CTracer::isEnabled());
+	{
+		astra::CTraceScope scope("test", "ignored");
+		BOOST_CHECK(!scope.isActive());
+	}
+
+	volatile double zero = 0.0;
+	astra::CTracer::start(sFile);
+	astra::CTracer::setThreadName("main \"thread\"");
+	{
+		astra::CTraceScope scope("test", "outer");
+		BOOST_CHECK(scope.isActive());
+		scope.addArg("bytes", 1024.0);
+		scope.addArg("nan", 0.0 / zero);
+		scope.addDims("dims", 2, 3, 4);
+		astra::CTraceScope inner("test", "inner");
+	}
+	BOOST_REQUIRE(astra::CTracer::stop());
+	BOOST_CHECK(!astra::CTracer::isEnabled());
+	BOOST_CHECK(!astra::CTracer::stop());
+
+	std::string s = readFile(sFile);
+	remove(sFile);
+
+	BOOST_CHECK_EQUAL(s.compare(0, 15, "{\"traceEvents\":"), 0);
+	BOOST_CHECK(s.find("\"name\":\"main \\\"thread\\\"\"") != std::string::npos);
+	BOOST_CHECK(s.find("\"name\":\"outer\",\"cat\":\"test\",\"ph\":\"B\"") != std::string::npos);
+	BOOST_CHECK(s.find("\"name\":\"inner\",\"cat\":\"test\",\"ph\":\"E\"") != std::string::npos);
+	BOOST_CHECK(s.find("\"args\":{\"bytes\":1024,\"nan\":null,\"dims\":\"2 x 3 x 4\"}") != std::string::npos);
+	BOOST_CHECK(s.find("ignored") == std::string::npos);
+}
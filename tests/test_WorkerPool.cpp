@@ -0,0 +1,121 @@
+/*
+-----------------------------------------------------------------------
+Copyright: 2010-2018, imec Vision Lab, University of Antwerp
+           2014-2018, CWI, Amsterdam
+
+Contact: astra@astra-toolbox.com
+Website: http://www.astra-toolbox.com/
+
+This file is part of the ASTRA Toolbox.
+
+
+The ASTRA Toolbox is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+The ASTRA Toolbox is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with the ASTRA Toolbox. If not, see <http://www.gnu.org/licenses/>.
+
+-----------------------------------------------------------------------
+*/
+
+
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <boost/test/auto_unit_test.hpp>
+
+#include <vector>
+
+#include "astra/WorkerPool.h"
+
+namespace {
+
+struct FillRange {
+	std::vector<int>* m_pData;
+	void operator()(int _iFrom, int _iTo) const {
+		for (int i = _iFrom; i < _iTo; ++i)
+			(*m_pData)[i] += i;
+	}
+};
+
+struct NestedRange {
+	std::vector<int>* m_pData;
+	int m_iInner;
+	void operator()(int _iFrom, int _iTo) const {
+		for (int i = _iFrom; i < _iTo; ++i) {
+			FillRange f;
+			f.m_pData = m_pData;
+			astra::CWorkerPool::getSingleton().parallelFor(i * m_iInner, (i+1) * m_iInner, f);
+		}
+	}
+};
+
+class CountTask : public astra::CWorkerTask {
+public:
+	CountTask() : m_iRuns(0) { }
+	virtual void run() { m_iRuns++; }
+	int m_iRuns;
+};
+
+}
+
+BOOST_AUTO_TEST_CASE( testWorkerPool_ParallelFor )
+{
+	std::vector<int> data(10007, 0);
+	FillRange f;
+	f.m_pData = &data;
+	astra::CWorkerPool::getSingleton().parallelFor(0, (int)data.size(), f);
+
+	for (int i = 0; i < (int)data.size(); ++i)
+		BOOST_REQUIRE_EQUAL(data[i], i);
+}
+
+BOOST_AUTO_TEST_CASE( testWorkerPool_Nested )
+{
+	std::vector<int> data(64 * 101, 0);
+	NestedRange f;
+	f.m_pData = &data;
+	f.m_iInner = 101;
+	astra::CWorkerPool::getSingleton().parallelFor(0, 64, f);
+
+	for (int i = 0; i < (int)data.size(); ++i)
+		BOOST_REQUIRE_EQUAL(data[i], i);
+}
+
+BOOST_AUTO_TEST_CASE( testWorkerPool_TaskGroup )
+{
+	std::vector<CountTask> tasks(100);
+	astra::CTaskGroup group;
+	for (unsigned int i = 0; i < tasks.size(); ++i)
+		astra::CWorkerPool::getSingleton().submit(&tasks[i], &group);
+	group.wait();
+
+	BOOST_CHECK(group.isDone());
+	for (unsigned int i = 0; i < tasks.size(); ++i)
+		BOOST_CHECK_EQUAL(tasks[i].m_iRuns, 1);
+}
+
+BOOST_AUTO_TEST_CASE( testWorkerPool_Restart )
+{
+	astra::SWorkerPoolParams params = astra::CWorkerPool::getGlobalParams();
+	astra::SWorkerPoolParams p2 = params;
+	p2.iThreadCount = 3;
+	astra::CWorkerPool::setGlobalParams(p2);
+	BOOST_CHECK_EQUAL(astra::CWorkerPool::getSingleton().getThreadCount(), 3);
+
+	std::vector<int> data(1000, 0);
+	FillRange f;
+	f.m_pData = &data;
+	astra::CWorkerPool::getSingleton().parallelFor(0, (int)data.size(), f);
+	for (int i = 0; i < (int)data.size(); ++i)
+		BOOST_REQUIRE_EQUAL(data[i], i);
+
+	astra::CWorkerPool::setGlobalParams(params);
+}